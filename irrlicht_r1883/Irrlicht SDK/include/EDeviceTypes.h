@@ -0,0 +1,30 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __E_DEVICE_TYPES_H_INCLUDED__
+#define __E_DEVICE_TYPES_H_INCLUDED__
+
+namespace irr
+{
+
+	//! An enum for the types of devices the Irrlicht Engine can create.
+	enum E_DEVICE_TYPE
+	{
+		//! The window device of the platform the engine was compiled
+		//! for, e.g. Win32, X11 or SDL.
+		EIDT_BEST,
+
+		//! A device without a window. The software drivers render
+		//! into an image in memory, which can be retrieved with
+		//! IrrlichtDevice::getFrameImage() after each frame. It needs
+		//! no display and supports only video::EDT_SOFTWARE,
+		//! video::EDT_BURNINGSVIDEO and video::EDT_NULL.
+		EIDT_OFFSCREEN
+	};
+
+} // end namespace irr
+
+
+#endif
+
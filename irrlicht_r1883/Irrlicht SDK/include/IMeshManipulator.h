@@ -154,12 +154,54 @@ namespace scene
 		virtual IMesh* createMeshUniquePrimitives(IMesh* mesh) const = 0;
 
 		//! Creates a copy of a mesh with vertices welded
-		/** \param mesh Input mesh
+		/** Vertices are welded if their positions, normals, tangents
+		and texture coordinates differ by at most the tolerance, and
+		their colors by at most the color tolerance. The vertices are
+		found with a spatial hash of their positions, so large meshes
+		are welded in linear time. Buffers with 32 bit indices are
+		copied into a CDynamicMeshBuffer with 32 bit indices.
+		\param mesh Input mesh
 		\param tolerance The threshold for vertex comparisons.
+		\param colorTolerance Largest difference of each color
+		channel of welded vertices.
+		\param weldedCount If not 0, receives the amount of vertices
+		removed from all buffers.
 		\return Mesh without redundant vertices. If you no longer need
 		the cloned mesh, you should call IMesh::drop(). See
 		IReferenceCounted::drop() for more information. */
-		virtual IMesh* createMeshWelded(IMesh* mesh, f32 tolerance=core::ROUNDING_ERROR_32) const = 0;
+		virtual IMesh* createMeshWelded(IMesh* mesh, f32 tolerance=core::ROUNDING_ERROR_32,
+			u32 colorTolerance=0, u32* weldedCount=0) const = 0;
+
+		//! Reorders the triangles and vertices of a mesh for the vertex cache
+		/** The triangles of each buffer are reordered with Tom
+		Forsyth's linear speed vertex cache optimization, so that fewer
+		vertices are transformed again after leaving the post transform
+		cache. Only triangle lists are supported. Buffers whose new
+		order would not transform fewer vertices in the FIFO cache
+		of getAverageCacheMissRatio() are left unchanged.
+		\param mesh Mesh to optimize, its buffers are changed in place.
+		\param reorderVertices If true, the vertices are stored in the
+		order of their first use for better vertex fetch locality. Must
+		be false if the vertex indices are referenced elsewhere, e.g. by
+		the weights of a skinned mesh.
+		\param reduceOverdraw If true, clusters of triangles facing
+		outward are drawn first, which trades a little of the cache
+		efficiency for less overdraw.
+		\param acmrBefore If not 0, receives the average cache miss
+		ratio of the mesh before the optimization.
+		\param acmrAfter If not 0, receives the average cache miss ratio
+		of the mesh after the optimization. */
+		virtual void optimizeVertexCache(IMesh* mesh, bool reorderVertices=true,
+			bool reduceOverdraw=false, f32* acmrBefore=0, f32* acmrAfter=0) const = 0;
+
+		//! Get the average cache miss ratio of a mesh
+		/** Simulates a FIFO post transform vertex cache.
+		\param mesh Input mesh
+		\param cacheSize Amount of vertices in the cache.
+		\return Average amount of vertices transformed per triangle,
+		between 0.5 for an ideal order of a large regular mesh and 3 if
+		no vertex is reused. */
+		virtual f32 getAverageCacheMissRatio(IMesh* mesh, u32 cacheSize=16) const = 0;
 
 		//! Get amount of polygons in mesh.
 		/** \param mesh Input mesh
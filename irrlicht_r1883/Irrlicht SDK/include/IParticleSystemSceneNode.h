@@ -64,6 +64,16 @@ public:
 	Default is true. */
 	virtual void setParticlesAreGlobal(bool global=true) = 0;
 
+	//! Selects the packed particle storage
+	/** When enabled, expired particles are replaced by the last particle
+	instead of closing the gap, so the particles do not keep their order.
+	Positions and speeds are kept in separate streams which are moved with
+	SIMD code. The system is no longer limited to 16250 particles and uses
+	32 bit indices when needed, and large systems are moved and turned into
+	vertices on worker threads. Disabled by default.
+	\param on True to use the packed storage. */
+	virtual void setPackedParticles(bool on) = 0;
+
 	//! Gets the particle emitter, which creates the particles.
 	/** \return The particle emitter. Can be 0 if none is set. */
 	virtual IParticleEmitter* getEmitter() =0;
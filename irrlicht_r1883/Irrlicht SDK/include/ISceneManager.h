@@ -8,6 +8,7 @@
 #include "IReferenceCounted.h"
 #include "irrArray.h"
 #include "vector3d.h"
+#include "matrix4.h"
 #include "dimension2d.h"
 #include "SColor.h"
 #include "ETerrainElements.h"
@@ -91,6 +92,7 @@ namespace scene
 	class IMesh;
 	class IMeshBuffer;
 	class IAnimatedMesh;
+	class ISkinnedMesh;
 	class IMeshCache;
 	class ISceneNode;
 	class ICameraSceneNode;
@@ -1031,6 +1033,31 @@ namespace scene
 		virtual u32 registerNodeForRendering(ISceneNode* node,
 			E_SCENE_NODE_RENDER_PASS pass = ESNRP_AUTOMATIC) = 0;
 
+		//! Skins several skinned meshes in parallel.
+		/** Calls ISkinnedMesh::skinMesh() for each mesh, spread over the
+		worker threads of the scene manager, and returns when all meshes are
+		skinned. Animate the meshes with ISkinnedMesh::animateMesh() first.
+		A mesh must not appear more than once in the list.
+		\param meshes Array of meshes to skin.
+		\param count Amount of meshes in the array. */
+		virtual void skinMeshes(ISkinnedMesh* const* meshes, u32 count) = 0;
+
+		//! Enables culling of scene nodes with a hierarchical spatial index.
+		/** By default each registered scene node is tested against the view
+		frustum on its own. With the index enabled, nodes using EAC_BOX or
+		EAC_FRUSTUM_BOX culling are kept in a bounding volume hierarchy of
+		their world boxes, which is updated incrementally when a node moves,
+		and whole subtrees outside the frustum are rejected at once. Both
+		culling types are then tested with the world box against the frustum
+		planes. The number of tree nodes tested and of scene nodes culled in
+		the last frame are stored in the "culling_visited" and
+		"culling_culled" parameters.
+		\param enable True to use the index, false for per node culling. */
+		virtual void setHierarchicalCulling(bool enable) = 0;
+
+		//! Returns if scene nodes are culled with a hierarchical spatial index.
+		virtual bool getHierarchicalCulling() const = 0;
+
 		//! Draws all the scene nodes.
 		/** This can only be invoked between
 		 IVideoDriver::beginScene() and IVideoDriver::endScene(). Please note that
@@ -1200,6 +1227,22 @@ namespace scene
 		virtual ITriangleSelector* createOctTreeTriangleSelector(IMesh* mesh,
 			ISceneNode* node, s32 minimalPolysPerNode=32) = 0;
 
+		//! Creates a Triangle Selector, optimized by a bounding volume hierarchy.
+		/** Like the octtree selector, this one is meant for huge amounts of
+		 triangles. The triangles are kept in the space of the mesh, and the
+		 selector finds the triangle hit by a line by walking the hierarchy, so
+		 ISceneCollisionManager::getCollisionPoint() does not have to copy and
+		 test the triangles. It is not automaticly attached to the scene node.
+		 \param mesh: Mesh of which the triangles are taken.
+		 \param node: Scene node of which visibility and transformation is used.
+		 \param maximalPolysPerLeaf: Nodes of the hierarchy with more polygons
+		 than this are split.
+		 \return Returns the selector, or null if not successful.
+		 If you no longer need the selector, you should call ITriangleSelector::drop().
+		 See IReferenceCounted::drop() for more information. */
+		virtual ITriangleSelector* createBVHTriangleSelector(IMesh* mesh,
+			ISceneNode* node, s32 maximalPolysPerLeaf=4) = 0;
+
 		//! Creates a meta triangle selector.
 		/** A meta triangle selector is nothing more than a
 		 collection of one or more triangle selectors providing together
@@ -1268,6 +1311,20 @@ namespace scene
 		 pass currently is active they can render the correct part of their geometry. */
 		virtual E_SCENE_NODE_RENDER_PASS getSceneNodeRenderPass() const = 0;
 
+		//! Queues a mesh buffer for state sorted rendering.
+		/** Scene nodes may call this from their render() method instead of
+		setting the material and drawing the buffer themselves. The buffer is
+		only queued during the solid render pass and if the parameter
+		RENDER_QUEUE_ENABLE is set, otherwise the node has to draw it on its
+		own. The mesh buffer and material have to stay valid until drawAll()
+		returns.
+		\param mb Mesh buffer to draw.
+		\param material Material to draw the buffer with.
+		\param transform World transformation of the buffer.
+		\return True if the buffer was queued, false if the caller has to draw it. */
+		virtual bool queueMeshBuffer(IMeshBuffer* mb, const video::SMaterial& material,
+			const core::matrix4& transform) = 0;
+
 		//! Returns the default scene node factory which can create all built in scene nodes
 		virtual ISceneNodeFactory* getDefaultSceneNodeFactory() = 0;
 
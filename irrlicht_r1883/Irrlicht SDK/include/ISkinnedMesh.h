@@ -69,6 +69,15 @@ namespace scene
 		//! Preforms a software skin on this mesh based of joint positions
 		virtual void skinMesh() = 0;
 
+		//! Selects the packed software skinning path
+		/** When enabled, skinMesh() uses influence lists grouped per vertex
+		which are built once, and transforms each skinned vertex with its
+		blended joint matrix in a single linear pass per mesh buffer instead
+		of scattering every weight of every joint. Results only differ by
+		floating point rounding. Disabled by default.
+		\param on True to use the packed path. */
+		virtual void setPackedSkinning(bool on) = 0;
+
 		//! converts the vertex type of all meshbuffers to tangents. eg for bumpmapping
 		virtual void convertMeshToTangents() = 0;
 
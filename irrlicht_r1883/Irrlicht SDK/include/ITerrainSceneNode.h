@@ -158,6 +158,23 @@ namespace scene
 		virtual bool addHeightMap(f32* data, u32 width,
 			video::SColor vertexColor = video::SColor ( 255, 255, 255, 255 ), s32 smoothFactor = 0 ) =0;
 
+		//! Changes the heights of a rectangular part of the terrain.
+		/** Only the vertices and normals in and around the region, the
+		bounding boxes of the patches touching it and their triangles in
+		the terrain triangle selectors are updated. If the render buffer
+		is kept in a hardware buffer, only the changed vertices are
+		uploaded. The heights are not smoothed.
+		\param data Heights of the region, sizeX*sizeZ values laid out
+		like the data of addHeightMap(), so the height of the heightmap
+		position (x+i, z+j) is data[i*sizeZ+j].
+		\param x First x position of the region in the heightmap.
+		\param z First z position of the region in the heightmap.
+		\param sizeX Number of heightmap positions in x direction.
+		\param sizeZ Number of heightmap positions in z direction.
+		\return False if there is no heightmap yet or the region is not
+		inside of it. */
+		virtual bool updateHeightMap(const f32* data, s32 x, s32 z, s32 sizeX, s32 sizeZ) =0;
+
 		//! Initializes the terrain data.  Loads the vertices from the heightMapFile.
 		/** The data is interpreted as signed integers of the given bit size. Allowed
 		values are 8, 16, and 32. The heightmap must be square. */
@@ -166,6 +166,39 @@ public:
 	/** \return Returns true if this is a render target, otherwise false. */
 	virtual bool isRenderTarget() const { return false; }
 
+	//! Returns the size of the copy of the image kept in system memory.
+	/** Drivers which upload textures to the graphics card keep this
+	copy for lock(). It can be freed with releaseImage().
+	\return Size of the copy in bytes, 0 if there is none. */
+	virtual u32 getImageMemorySize() const { return 0; }
+
+	//! Returns the size of the pixel data used for rendering.
+	/** \return Size of the texture and its mip maps in bytes. */
+	virtual u32 getTextureMemorySize() const { return 0; }
+
+	//! Frees the copy of the image kept in system memory.
+	/** The texture is still drawn as before. Locking it afterwards
+	reads the pixels back from the texture.
+	\return True if memory was freed. */
+	virtual bool releaseImage() { return false; }
+
+	//! Frees all pixel data of the texture.
+	/** The texture keeps its name, sizes and color format, but cannot
+	be drawn or locked until restore() is called. This is used by the
+	video driver to stay within the texture budget, see
+	IVideoDriver::setTextureBudget().
+	\return True if the texture was evicted. */
+	virtual bool evict() { return false; }
+
+	//! Returns whether the pixel data of the texture were freed by evict()
+	virtual bool isEvicted() const { return false; }
+
+	//! Creates the pixel data of an evicted texture again.
+	/** \param image Image with the content of the texture. It should
+	have the original size of the texture.
+	\return True if the texture can be used again. */
+	virtual bool restore(IImage* image) { return false; }
+
 	//! Returns name of texture (in most cases this is the filename)
 	const core::stringc& getName() const { return Name; }
 
@@ -0,0 +1,41 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_TEXTURE_RELOAD_CALLBACK_H_INCLUDED__
+#define __I_TEXTURE_RELOAD_CALLBACK_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+
+namespace irr
+{
+namespace video
+{
+	class ITexture;
+	class IImage;
+
+//! Interface for loading textures again which were evicted by the video driver.
+/** When textures use more memory than allowed by
+IVideoDriver::setTextureBudget(), the least recently used ones are evicted.
+Without a callback, only textures loaded from files are evicted, and they are
+loaded from the file with the name of the texture again. Set an own callback
+with IVideoDriver::setTextureReloadCallBack() to evict all textures, for
+example if they were created from downloaded data. */
+class ITextureReloadCallBack : public virtual IReferenceCounted
+{
+public:
+
+	//! Called when an evicted texture is used again.
+	/** \param texture: The texture which has to be restored. Its name and
+	original size are the same as before.
+	\return Image with the content of the texture, or 0 if it cannot be
+	loaded. The image is dropped by the driver afterwards. */
+	virtual IImage* OnReloadTexture(const ITexture* texture) = 0;
+};
+
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
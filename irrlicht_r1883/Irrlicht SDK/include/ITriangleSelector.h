@@ -81,6 +81,28 @@ public:
 	virtual void getTriangles(core::triangle3df* triangles, s32 arraySize,
 		s32& outTriangleCount, const core::line3d<f32>& line,
 		const core::matrix4* transform=0) const = 0;
+
+	//! Returns if the selector finds the triangle hit by a line itself.
+	/** If true, ISceneCollisionManager::getCollisionPoint() uses
+	getCollisionPoint() of the selector instead of testing all triangles
+	returned by getTriangles(). */
+	virtual bool hasCollisionPoint() const
+	{
+		return false;
+	}
+
+	//! Gets the triangle hit by a 3d line nearest to the start of the line.
+	/** Only implemented by selectors which return true in
+	hasCollisionPoint().
+	\param line: The line, the hit has to be between its start and end.
+	\param outIntersection: Where the line hits the triangle.
+	\param outTriangle: The triangle which is hit.
+	\return Returns true if a triangle was hit. */
+	virtual bool getCollisionPoint(const core::line3d<f32>& line,
+		core::vector3df& outIntersection, core::triangle3df& outTriangle) const
+	{
+		return false;
+	}
 };
 
 } // end namespace scene
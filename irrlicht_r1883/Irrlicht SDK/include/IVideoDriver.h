@@ -38,6 +38,7 @@ namespace video
 	struct S3DVertex2TCoords;
 	struct S3DVertexTangents;
 	struct SLight;
+	class ITextureReloadCallBack;
 	struct SExposedVideoData;
 	class IImageLoader;
 	class IImageWriter;
@@ -265,12 +266,73 @@ namespace video
 		0 or another texture first. */
 		virtual void removeAllTextures() = 0;
 
+		//! Limits the memory used by textures.
+		/** The budgets are checked at the end of each frame. When the
+		copies of images kept in system memory exceed their budget, the
+		copies of the least recently used textures are freed, see
+		ITexture::releaseImage(). When the textures exceed their
+		budget, the least recently used textures which were not drawn
+		in this frame are evicted, see ITexture::evict(). Evicted
+		textures stay valid and are loaded again as soon as they are
+		drawn. Render targets are never evicted.
+		\param imageBytes Maximal size of the copies of images kept in
+		system memory, 0 for no limit.
+		\param textureBytes Maximal size of the textures used for
+		rendering, 0 for no limit. */
+		virtual void setTextureBudget(u32 imageBytes, u32 textureBytes) = 0;
+
+		//! Sets the callback which loads evicted textures again.
+		/** Without a callback, only textures loaded from files are
+		evicted, and are loaded from the file with the name of the
+		texture again. With a callback, all textures can be evicted.
+		\param callback The callback, or 0 to load textures from
+		files again. It is grabbed by the driver. */
+		virtual void setTextureReloadCallBack(ITextureReloadCallBack* callback) = 0;
+
+		//! Returns the memory used by all textures.
+		/** \param imageBytes Receives the size of the copies of images
+		kept in system memory.
+		\param textureBytes Receives the size of the textures used for
+		rendering. */
+		virtual void getTextureMemoryUsage(u32& imageBytes, u32& textureBytes) const = 0;
+
+		//! Loads an evicted texture again.
+		/** Textures are loaded again automatically when they are drawn.
+		Call this before accessing the pixels of a texture which might
+		have been evicted, for example before ITexture::lock().
+		\param texture The texture.
+		\return True if the texture can be used, false if it was evicted
+		and could not be loaded again. */
+		virtual bool makeTextureResident(ITexture* texture) = 0;
+
 		//! Remove hardware buffer
 		virtual void removeHardwareBuffer(const scene::IMeshBuffer* mb) = 0;
 
 		//! Remove all hardware buffers
 		virtual void removeAllHardwareBuffers() = 0;
 
+		//! Uploads a range of vertices of a mesh buffer to its hardware buffer
+		/** Use this instead of setting the vertices dirty if only some
+		of them changed, then only the range is copied to the hardware
+		buffer instead of all vertices.
+		\param mb Mesh buffer whose vertices changed.
+		\param first Index of the first changed vertex.
+		\param count Number of changed vertices.
+		\return True if the range was uploaded. False if the mesh buffer
+		has no hardware buffer, the hardware buffer is out of date anyway
+		or the driver cannot update parts of it. The vertices have to be
+		set dirty in this case. */
+		virtual bool updateHardwareBufferVertices(const scene::IMeshBuffer* mb, u32 first, u32 count) = 0;
+
+		//! Uploads a range of indices of a mesh buffer to its hardware buffer
+		/** Works like updateHardwareBufferVertices(), for indices.
+		\param mb Mesh buffer whose indices changed.
+		\param first Index of the first changed index.
+		\param count Number of changed indices.
+		\return True if the range was uploaded. False if the indices
+		have to be set dirty instead. */
+		virtual bool updateHardwareBufferIndices(const scene::IMeshBuffer* mb, u32 first, u32 count) = 0;
+
 		//! Creates a 1bit alpha channel of the texture based of an color key.
 		/** This makes the texture transparent at the regions where
 		this color key can be found when using for example draw2DImage
@@ -533,6 +595,28 @@ namespace video
 				SColor color=SColor(255,255,255,255),
 				bool useAlphaChannelOfTexture=false) = 0;
 
+		//! Draws a set of 2d images from one texture at arbitrary positions.
+		/** Drivers which support it send all images in a single draw
+		call, so this is the way to draw text or sprites taken from a
+		texture atlas. All drawings are clipped against clipRect (if != 0).
+		\param texture Texture to be drawn.
+		\param positions Upper left 2d destination position of each image.
+		\param sourceRects Source rectangle of each image, one per position.
+		\param clipRect Pointer to rectangle on the screen where the
+		images are clipped to. If this pointer is 0 then the images are
+		not clipped.
+		\param color Color with which the images are drawn.
+		Note that the alpha component is used. If alpha is other than
+		255, the images will be transparent.
+		\param useAlphaChannelOfTexture: If true, the alpha channel of
+		the texture is used to draw the images. */
+		virtual void draw2DImageBatch(const video::ITexture* texture,
+				const core::array<core::position2d<s32> >& positions,
+				const core::array<core::rect<s32> >& sourceRects,
+				const core::rect<s32>* clipRect=0,
+				SColor color=SColor(255,255,255,255),
+				bool useAlphaChannelOfTexture=false) = 0;
+
 		//! Draws a part of the texture into the rectangle. Note that colors must be an array of 4 colors if used.
 		/** Suggested and first implemented by zola.
 		\param texture The texture to draw from
@@ -965,6 +1049,20 @@ namespace video
 		*/
 		virtual void clearZBuffer() = 0;
 
+		//! Sets the number of threads used for drawing triangles.
+		/** Only the Burning's Video driver supports this, the other
+		drivers ignore it. With more than one thread, the driver
+		collects the triangles and draws them in horizontal bands of
+		the render target, one band per thread at a time. This is done
+		before the render target is accessed, for example by endScene(),
+		setRenderTarget(), createScreenShot() or 2d drawing. The image
+		is the same as when drawing with one thread. Textures used by
+		collected triangles should not be changed before that.
+		\param threadCount Number of threads including the calling
+		thread, 0 for one per processor. 1 draws each triangle at once,
+		which is the default. */
+		virtual void setRasterizerThreadCount(u32 threadCount) = 0;
+
 		//! Make a screenshot of the last rendered frame.
 		/** \return An image created from the last rendered frame. */
 		virtual IImage* createScreenShot() = 0;
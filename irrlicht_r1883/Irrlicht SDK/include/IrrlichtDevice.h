@@ -218,6 +218,19 @@ namespace irr
 		*/
 		virtual bool activateJoysticks(core::array<SJoystickInfo> & joystickInfo) = 0;
 
+		//! Returns the image an offscreen device renders into.
+		/** Only devices created with the device type EIDT_OFFSCREEN
+		have such an image. It has the WindowSize of the creation
+		parameters and the color format video::ECF_A8R8G8B8, and holds
+		the frame shown by the last IVideoDriver::endScene() call. If
+		the creation parameter WithAlphaChannel is false, all pixels
+		are opaque. The image is owned by the device. Grab it to keep
+		the frame, the device then renders the next frame into a new
+		image.
+		\return Pointer to the image, or 0 if the device has a window
+		or no frame was rendered yet. */
+		virtual video::IImage* getFrameImage() = 0;
+
 // >> Add by uirou for IME Window start
 		virtual void focusIn(){};
 		virtual void focusOut(){};
@@ -5,6 +5,7 @@
 #ifndef __I_IRRLICHT_CREATION_PARAMETERS_H_INCLUDED__
 #define __I_IRRLICHT_CREATION_PARAMETERS_H_INCLUDED__
 
+#include "EDeviceTypes.h"
 #include "EDriverTypes.h"
 #include "dimension2d.h"
 
@@ -18,6 +19,7 @@ namespace irr
 	{
 		//! Constructs a SIrrlichtCreationParameters structure with default values.
 		SIrrlichtCreationParameters() :
+			DeviceType(EIDT_BEST),
 			DriverType(video::EDT_BURNINGSVIDEO),
 			WindowSize(core::dimension2d<s32>(800, 600)),
 			Bits(16),
@@ -41,6 +43,7 @@ namespace irr
 
 		SIrrlichtCreationParameters& operator=(const SIrrlichtCreationParameters& other)
 		{
+			DeviceType = other.DeviceType;
 			DriverType = other.DriverType;
 			WindowSize = other.WindowSize;
 			Bits = other.Bits;
@@ -58,6 +61,12 @@ namespace irr
 		}
 
 		//! Type of the device.
+		/** EIDT_BEST creates the window device of the platform.
+		EIDT_OFFSCREEN creates a device without a window, which renders
+		into an image of WindowSize pixels. Default: EIDT_BEST. */
+		E_DEVICE_TYPE DeviceType;
+
+		//! Type of the video driver.
 		/** This can currently be video::EDT_NULL, video::EDT_SOFTWARE,
 		video::EDT_BURNINGSVIDEO, video::EDT_DIRECT3D8,
 		video::EDT_DIRECT3D9, and video::EDT_OPENGL.
@@ -29,6 +29,21 @@ namespace scene
 	**/
 	const c8* const ALLOW_ZWRITE_ON_TRANSPARENT = "Allow_ZWrite_On_Transparent";
 
+	//! Name of the parameter for enabling the state sorted render queue
+	/** When set, the scene manager collects the mesh buffers of all solid
+	scene nodes which support it (see ISceneManager::queueMeshBuffer())
+	during the solid pass, sorts them by material renderer, textures and
+	depth, and draws them grouped by state. Redundant material changes are
+	skipped. The number of queued buffers and of material and texture
+	changes of the last frame are stored in the "queued",
+	"material_changes" and "texture_changes" parameters.
+	Use it like this:
+	\code
+	SceneManager->getParameters()->setAttribute(scene::RENDER_QUEUE_ENABLE, true);
+	\endcode
+	**/
+	const c8* const RENDER_QUEUE_ENABLE = "Render_Queue";
+
 	//! Name of the parameter for changing the texture path of the built-in csm loader.
 	/** Use it like this:
 	\code
@@ -115,6 +130,26 @@ namespace scene
 	const c8* const OBJ_LOADER_IGNORE_GROUPS = "OBJ_IgnoreGroups";
 
 
+	//! Flag to reorder the triangles of loaded meshes for the vertex cache
+	/** When set, ISceneManager::getMesh() applies
+	IMeshManipulator::optimizeVertexCache() to each loaded mesh before it
+	is added to the mesh cache. The vertices of skinned meshes keep their
+	order, meshes with animation frames (md2, md3) and bsp levels are not
+	changed. The cache miss ratios before and after are logged.
+	Use it like this:
+	\code
+	SceneManager->getParameters()->setAttribute(scene::MESH_OPTIMIZE_VERTEX_CACHE, true);
+	\endcode
+	**/
+	const c8* const MESH_OPTIMIZE_VERTEX_CACHE = "Mesh_OptimizeVertexCache";
+
+	//! Flag to also reorder the triangles of loaded meshes for less overdraw
+	/** Only used together with MESH_OPTIMIZE_VERTEX_CACHE, see the
+	reduceOverdraw parameter of IMeshManipulator::optimizeVertexCache().
+	**/
+	const c8* const MESH_OPTIMIZE_OVERDRAW = "Mesh_OptimizeOverdraw";
+
+
 	//! Flag set as parameter when the scene manager is used as editor
 	/** In this way special animators like deletion animators can be stopped from
 	deleting scene nodes for example */
@@ -39,6 +39,7 @@
 #include "dimension2d.h"
 #include "ECullingTypes.h"
 #include "EDebugSceneTypes.h"
+#include "EDeviceTypes.h"
 #include "EDriverFeatures.h"
 #include "EDriverTypes.h"
 #include "EGUIAlignment.h"
@@ -142,6 +143,7 @@
 #include "ITerrainSceneNode.h"
 #include "ITextSceneNode.h"
 #include "ITexture.h"
+#include "ITextureReloadCallBack.h"
 #include "ITimer.h"
 #include "ITriangleSelector.h"
 #include "IVertexBuffer.h"
@@ -0,0 +1,551 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CBVHTriangleSelector.h"
+#include "ISceneNode.h"
+
+#include "os.h"
+#include <float.h> // For FLT_MAX
+
+namespace irr
+{
+namespace scene
+{
+
+//! maximal depth of the hierarchy, deeper nodes become leaves
+static const u32 BVHMaxDepth = 48;
+
+//! size of the traversal stacks, the depth plus one is enough
+static const u32 BVHStackSize = 64;
+
+//! number of bins of the surface area heuristic
+static const u32 BVHBinCount = 16;
+
+//! part of the triangles which is still to be put into the hierarchy
+struct SBVHBuildJob
+{
+	u32 First;
+	u32 Count;
+	u32 Depth;
+
+	//! node whose second child this is, or -1
+	s32 Parent;
+};
+
+
+//! intersects the line start + t*dir with a box, for t between 0 and maxT
+static inline bool intersectBox(const core::aabbox3d<f32>& box, const core::vector3df& start,
+		const core::vector3df& invDir, f32 maxT, f32& outT)
+{
+	f32 t1 = (box.MinEdge.X - start.X) * invDir.X;
+	f32 t2 = (box.MaxEdge.X - start.X) * invDir.X;
+	f32 tmin = core::min_(t1, t2);
+	f32 tmax = core::max_(t1, t2);
+
+	t1 = (box.MinEdge.Y - start.Y) * invDir.Y;
+	t2 = (box.MaxEdge.Y - start.Y) * invDir.Y;
+	tmin = core::max_(tmin, core::min_(t1, t2));
+	tmax = core::min_(tmax, core::max_(t1, t2));
+
+	t1 = (box.MinEdge.Z - start.Z) * invDir.Z;
+	t2 = (box.MaxEdge.Z - start.Z) * invDir.Z;
+	tmin = core::max_(tmin, core::min_(t1, t2));
+	tmax = core::min_(tmax, core::max_(t1, t2));
+
+	tmin = core::max_(tmin, 0.f);
+	tmax = core::min_(tmax, maxT);
+
+	outT = tmin;
+	return tmin <= tmax;
+}
+
+
+//! intersects the line start + t*dir with a triangle, both sides of it are hit
+static inline bool intersectTriangle(const core::triangle3df& triangle, const core::vector3df& start,
+		const core::vector3df& dir, f32& outT)
+{
+	const core::vector3df edge1 = triangle.pointB - triangle.pointA;
+	const core::vector3df edge2 = triangle.pointC - triangle.pointA;
+
+	const core::vector3df p = dir.crossProduct(edge2);
+	const f32 det = edge1.dotProduct(p);
+	if (det == 0.f)
+		return false;
+
+	const f32 invDet = 1.f / det;
+	const core::vector3df s = start - triangle.pointA;
+
+	const f32 u = s.dotProduct(p) * invDet;
+	if (u < 0.f || u > 1.f)
+		return false;
+
+	const core::vector3df q = s.crossProduct(edge1);
+	const f32 v = dir.dotProduct(q) * invDet;
+	if (v < 0.f || u + v > 1.f)
+		return false;
+
+	outT = edge2.dotProduct(q) * invDet;
+	return outT >= 0.f;
+}
+
+
+//! reciprocal of the direction, zero components become huge
+static inline core::vector3df getInverseDirection(const core::vector3df& dir)
+{
+	return core::vector3df(
+		dir.X != 0.f ? 1.f / dir.X : FLT_MAX,
+		dir.Y != 0.f ? 1.f / dir.Y : FLT_MAX,
+		dir.Z != 0.f ? 1.f / dir.Z : FLT_MAX);
+}
+
+
+//! constructor
+CBVHTriangleSelector::CBVHTriangleSelector(const IMesh* mesh,
+		const ISceneNode* node, s32 maximalPolysPerLeaf)
+	: CTriangleSelector(mesh, node), MaximalPolysPerLeaf(core::max_(maximalPolysPerLeaf, 1))
+{
+	#ifdef _DEBUG
+	setDebugName("CBVHTriangleSelector");
+	#endif
+
+	if (!Triangles.empty())
+	{
+		u32 start = os::Timer::getRealTime();
+
+		buildHierarchy();
+
+		u32 end = os::Timer::getRealTime();
+		c8 tmp[255];
+		sprintf(tmp, "Needed %ums to create BVHTriangleSelector.(%u nodes, %u polys)",
+			end - start, Nodes.size(), Triangles.size());
+		os::Printer::log(tmp, ELL_INFORMATION);
+	}
+}
+
+
+//! creates the nodes and sorts the triangles into the order of the leaves
+void CBVHTriangleSelector::buildHierarchy()
+{
+	const u32 triangleCount = Triangles.size();
+
+	core::array<u32> order(triangleCount);
+	core::array<core::vector3df> centers(triangleCount);
+	for (u32 i=0; i<triangleCount; ++i)
+	{
+		order.push_back(i);
+		centers.push_back((Triangles[i].pointA + Triangles[i].pointB + Triangles[i].pointC) / 3.f);
+	}
+
+	Nodes.reallocate(2 * triangleCount / MaximalPolysPerLeaf + 1);
+
+	core::array<SBVHBuildJob> jobs;
+	SBVHBuildJob job;
+	job.First = 0;
+	job.Count = triangleCount;
+	job.Depth = 0;
+	job.Parent = -1;
+	jobs.push_back(job);
+
+	while (!jobs.empty())
+	{
+		job = jobs.getLast();
+		jobs.set_used(jobs.size() - 1);
+
+		const u32 nodeIndex = Nodes.size();
+		if (job.Parent != -1)
+			Nodes[job.Parent].Index = nodeIndex;
+
+		SBVHNode node;
+		node.Index = job.First;
+		node.Count = job.Count;
+		node.Box.reset(Triangles[order[job.First]].pointA);
+		core::aabbox3d<f32> centerBox(centers[order[job.First]]);
+
+		for (u32 i=job.First; i<job.First+job.Count; ++i)
+		{
+			const core::triangle3df& triangle = Triangles[order[i]];
+			node.Box.addInternalPoint(triangle.pointA);
+			node.Box.addInternalPoint(triangle.pointB);
+			node.Box.addInternalPoint(triangle.pointC);
+			centerBox.addInternalPoint(centers[order[i]]);
+		}
+
+		Nodes.push_back(node);
+
+		if ((s32)job.Count <= MaximalPolysPerLeaf || job.Depth >= BVHMaxDepth)
+			continue;
+
+		// split along the longest axis of the triangle centers
+		const core::vector3df extent = centerBox.getExtent();
+		u32 axis = 0;
+		if (extent.Y > extent.X)
+			axis = 1;
+		if (extent.Z > (&extent.X)[axis])
+			axis = 2;
+
+		const f32 low = (&centerBox.MinEdge.X)[axis];
+		const f32 size = (&extent.X)[axis];
+		u32 leftCount = 0;
+
+		if (size > 0.f)
+		{
+			// choose the split between the bins with the surface area heuristic
+			const f32 scale = BVHBinCount / size;
+			u32 binCount[BVHBinCount];
+			core::aabbox3d<f32> binBox[BVHBinCount];
+			memset(binCount, 0, sizeof(binCount));
+
+			for (u32 i=job.First; i<job.First+job.Count; ++i)
+			{
+				const u32 bin = core::min_((u32)(((&centers[order[i]].X)[axis] - low) * scale), BVHBinCount - 1);
+				const core::triangle3df& triangle = Triangles[order[i]];
+				if (!binCount[bin]++)
+					binBox[bin].reset(triangle.pointA);
+				else
+					binBox[bin].addInternalPoint(triangle.pointA);
+				binBox[bin].addInternalPoint(triangle.pointB);
+				binBox[bin].addInternalPoint(triangle.pointC);
+			}
+
+			// cost of the bins right of each split
+			f32 rightCost[BVHBinCount];
+			core::aabbox3d<f32> box;
+			u32 count = 0;
+			for (u32 b=BVHBinCount-1; b>0; --b)
+			{
+				if (binCount[b])
+				{
+					if (!count)
+						box = binBox[b];
+					else
+						box.addInternalBox(binBox[b]);
+					count += binCount[b];
+				}
+				rightCost[b] = count ? box.getArea() * count : 0.f;
+			}
+
+			f32 bestCost = FLT_MAX;
+			u32 bestBin = 0;
+			count = 0;
+			for (u32 b=0; b<BVHBinCount-1; ++b)
+			{
+				if (binCount[b])
+				{
+					if (!count)
+						box = binBox[b];
+					else
+						box.addInternalBox(binBox[b]);
+					count += binCount[b];
+				}
+
+				if (!count || count == job.Count)
+					continue;
+
+				const f32 cost = box.getArea() * count + rightCost[b+1];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestBin = b;
+				}
+			}
+
+			// move the triangles of the left bins to the front
+			if (bestCost < FLT_MAX)
+			{
+				u32 i = job.First;
+				u32 j = job.First + job.Count;
+				while (i < j)
+				{
+					const u32 bin = core::min_((u32)(((&centers[order[i]].X)[axis] - low) * scale), BVHBinCount - 1);
+					if (bin <= bestBin)
+						++i;
+					else
+					{
+						--j;
+						const u32 tmp = order[i];
+						order[i] = order[j];
+						order[j] = tmp;
+					}
+				}
+				leftCount = i - job.First;
+			}
+		}
+
+		// all centers are in one place, halve the triangles
+		if (!leftCount || leftCount == job.Count)
+			leftCount = job.Count / 2;
+
+		Nodes[nodeIndex].Count = 0;
+
+		// the second child sets the index of the parent, the first one is
+		// taken from the stack next so it directly follows its parent.
+		SBVHBuildJob child;
+		child.Depth = job.Depth + 1;
+
+		child.First = job.First + leftCount;
+		child.Count = job.Count - leftCount;
+		child.Parent = nodeIndex;
+		jobs.push_back(child);
+
+		child.First = job.First;
+		child.Count = leftCount;
+		child.Parent = -1;
+		jobs.push_back(child);
+	}
+
+	core::array<core::triangle3df> sorted(triangleCount);
+	for (u32 i=0; i<triangleCount; ++i)
+		sorted.push_back(Triangles[order[i]]);
+	Triangles = sorted;
+}
+
+
+//! transforms a line into the space of the triangles
+core::line3d<f32> CBVHTriangleSelector::getObjectLine(const core::line3d<f32>& line) const
+{
+	core::line3d<f32> objectLine = line;
+
+	if (SceneNode)
+	{
+		core::matrix4 mat = SceneNode->getAbsoluteTransformation();
+		mat.makeInverse();
+		mat.transformVect(objectLine.start);
+		mat.transformVect(objectLine.end);
+	}
+
+	return objectLine;
+}
+
+
+//! copies and transforms a triangle into the output array
+void CBVHTriangleSelector::writeTriangle(const core::triangle3df& triangle,
+		const core::matrix4& mat, core::triangle3df* triangles, s32& trianglesWritten) const
+{
+	core::triangle3df& out = triangles[trianglesWritten++];
+	out = triangle;
+	mat.transformVect(out.pointA);
+	mat.transformVect(out.pointB);
+	mat.transformVect(out.pointC);
+}
+
+
+//! Gets all triangles which lie within a specific bounding box.
+void CBVHTriangleSelector::getTriangles(core::triangle3df* triangles,
+					s32 arraySize, s32& outTriangleCount,
+					const core::aabbox3d<f32>& box,
+					const core::matrix4* transform) const
+{
+	core::matrix4 mat;
+	core::aabbox3d<f32> invbox = box;
+
+	if (SceneNode)
+	{
+		mat = SceneNode->getAbsoluteTransformation();
+		mat.makeInverse();
+		mat.transformBoxEx(invbox);
+	}
+
+	mat.makeIdentity();
+
+	if (transform)
+		mat = *transform;
+
+	if (SceneNode)
+		mat *= SceneNode->getAbsoluteTransformation();
+
+	s32 trianglesWritten = 0;
+	u32 stack[BVHStackSize];
+	u32 stackSize = 0;
+
+	if (!Nodes.empty())
+		stack[stackSize++] = 0;
+
+	while (stackSize && trianglesWritten < arraySize)
+	{
+		const u32 n = stack[--stackSize];
+		const SBVHNode& node = Nodes[n];
+
+		if (!node.Box.intersectsWithBox(invbox))
+			continue;
+
+		if (node.Count)
+		{
+			for (u32 i=node.Index; i<node.Index+node.Count && trianglesWritten < arraySize; ++i)
+			{
+				const core::triangle3df& triangle = Triangles[i];
+				core::aabbox3d<f32> triangleBox(triangle.pointA);
+				triangleBox.addInternalPoint(triangle.pointB);
+				triangleBox.addInternalPoint(triangle.pointC);
+
+				if (triangleBox.intersectsWithBox(invbox))
+					writeTriangle(triangle, mat, triangles, trianglesWritten);
+			}
+		}
+		else
+		{
+			stack[stackSize++] = node.Index;
+			stack[stackSize++] = n + 1;
+		}
+	}
+
+	outTriangleCount = trianglesWritten;
+}
+
+
+//! Gets all triangles which have or may have contact with a 3d line.
+void CBVHTriangleSelector::getTriangles(core::triangle3df* triangles, s32 arraySize,
+		s32& outTriangleCount, const core::line3d<f32>& line,
+		const core::matrix4* transform) const
+{
+	const core::line3d<f32> objectLine = getObjectLine(line);
+	const core::vector3df invDir = getInverseDirection(objectLine.getVector());
+
+	core::matrix4 mat;
+
+	if (transform)
+		mat = *transform;
+
+	if (SceneNode)
+		mat *= SceneNode->getAbsoluteTransformation();
+
+	s32 trianglesWritten = 0;
+	u32 stack[BVHStackSize];
+	u32 stackSize = 0;
+
+	if (!Nodes.empty())
+		stack[stackSize++] = 0;
+
+	while (stackSize && trianglesWritten < arraySize)
+	{
+		const u32 n = stack[--stackSize];
+		const SBVHNode& node = Nodes[n];
+
+		f32 t;
+		if (!intersectBox(node.Box, objectLine.start, invDir, 1.f, t))
+			continue;
+
+		if (node.Count)
+		{
+			for (u32 i=node.Index; i<node.Index+node.Count && trianglesWritten < arraySize; ++i)
+				writeTriangle(Triangles[i], mat, triangles, trianglesWritten);
+		}
+		else
+		{
+			stack[stackSize++] = node.Index;
+			stack[stackSize++] = n + 1;
+		}
+	}
+
+	outTriangleCount = trianglesWritten;
+}
+
+
+//! Gets the triangle hit by a 3d line nearest to its start
+bool CBVHTriangleSelector::getCollisionPoint(const core::line3d<f32>& line,
+		core::vector3df& outIntersection, core::triangle3df& outTriangle) const
+{
+	if (Nodes.empty())
+		return false;
+
+	// the line is moved into the space of the triangles instead of
+	// transforming them, the position on the line stays the same.
+	const core::line3d<f32> objectLine = getObjectLine(line);
+	const core::vector3df dir = objectLine.getVector();
+	const core::vector3df invDir = getInverseDirection(dir);
+
+	f32 nearest = 1.f;
+	s32 hit = -1;
+
+	// nodes to visit, with the position on the line where it enters their box
+	struct SStackEntry
+	{
+		u32 Node;
+		f32 T;
+	};
+
+	SStackEntry stack[BVHStackSize];
+	u32 stackSize = 0;
+
+	f32 t;
+	if (intersectBox(Nodes[0].Box, objectLine.start, invDir, nearest, t))
+	{
+		stack[0].Node = 0;
+		stack[0].T = t;
+		stackSize = 1;
+	}
+
+	while (stackSize)
+	{
+		const SStackEntry entry = stack[--stackSize];
+
+		// a nearer triangle was found after the node was put on the stack
+		if (entry.T > nearest)
+			continue;
+
+		const SBVHNode& node = Nodes[entry.Node];
+
+		if (node.Count)
+		{
+			for (u32 i=node.Index; i<node.Index+node.Count; ++i)
+			{
+				if (intersectTriangle(Triangles[i], objectLine.start, dir, t) && t < nearest)
+				{
+					nearest = t;
+					hit = i;
+				}
+			}
+			continue;
+		}
+
+		// the nearer child is visited first
+		const u32 first = entry.Node + 1;
+		const u32 second = node.Index;
+		f32 tFirst, tSecond;
+		const bool hitFirst = intersectBox(Nodes[first].Box, objectLine.start, invDir, nearest, tFirst);
+		const bool hitSecond = intersectBox(Nodes[second].Box, objectLine.start, invDir, nearest, tSecond);
+
+		if (hitFirst && hitSecond && tFirst <= tSecond)
+		{
+			stack[stackSize].Node = second;
+			stack[stackSize++].T = tSecond;
+			stack[stackSize].Node = first;
+			stack[stackSize++].T = tFirst;
+		}
+		else
+		{
+			if (hitFirst)
+			{
+				stack[stackSize].Node = first;
+				stack[stackSize++].T = tFirst;
+			}
+			if (hitSecond)
+			{
+				stack[stackSize].Node = second;
+				stack[stackSize++].T = tSecond;
+			}
+		}
+	}
+
+	if (hit == -1)
+		return false;
+
+	outTriangle = Triangles[hit];
+	outIntersection = objectLine.start + dir * nearest;
+
+	if (SceneNode)
+	{
+		const core::matrix4& mat = SceneNode->getAbsoluteTransformation();
+		mat.transformVect(outTriangle.pointA);
+		mat.transformVect(outTriangle.pointB);
+		mat.transformVect(outTriangle.pointC);
+		mat.transformVect(outIntersection);
+	}
+
+	return true;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,78 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_BVH_TRIANGLE_SELECTOR_H_INCLUDED__
+#define __C_BVH_TRIANGLE_SELECTOR_H_INCLUDED__
+
+#include "CTriangleSelector.h"
+
+namespace irr
+{
+namespace scene
+{
+
+class ISceneNode;
+
+//! Triangle selector which keeps the triangles in a bounding volume hierarchy
+/** The triangles are kept in the space of the mesh, lines and boxes are
+transformed into it instead. Lines are tested against the hierarchy directly,
+so the nearest hit is found without copying any triangles. */
+class CBVHTriangleSelector : public CTriangleSelector
+{
+public:
+
+	//! Constructs a selector based on a mesh
+	CBVHTriangleSelector(const IMesh* mesh, const ISceneNode* node, s32 maximalPolysPerLeaf);
+
+	//! Gets all triangles which lie within a specific bounding box.
+	virtual void getTriangles(core::triangle3df* triangles, s32 arraySize, s32& outTriangleCount,
+		const core::aabbox3d<f32>& box, const core::matrix4* transform=0) const;
+
+	//! Gets all triangles which have or may have contact with a 3d line.
+	virtual void getTriangles(core::triangle3df* triangles, s32 arraySize,
+		s32& outTriangleCount, const core::line3d<f32>& line,
+		const core::matrix4* transform=0) const;
+
+	//! Returns true, the nearest triangle hit by a line is searched in the hierarchy
+	virtual bool hasCollisionPoint() const { return true; }
+
+	//! Gets the triangle hit by a 3d line nearest to its start
+	virtual bool getCollisionPoint(const core::line3d<f32>& line,
+		core::vector3df& outIntersection, core::triangle3df& outTriangle) const;
+
+private:
+
+	//! node of the hierarchy, 32 bytes
+	/** The first child of an inner node directly follows it. */
+	struct SBVHNode
+	{
+		core::aabbox3d<f32> Box;
+
+		//! first triangle of a leaf, or the second child of an inner node
+		u32 Index;
+
+		//! number of triangles of a leaf, 0 for inner nodes
+		u32 Count;
+	};
+
+	//! creates the nodes and sorts the triangles into the order of the leaves
+	void buildHierarchy();
+
+	//! transforms a line into the space of the triangles
+	core::line3d<f32> getObjectLine(const core::line3d<f32>& line) const;
+
+	//! copies and transforms a triangle into the output array
+	void writeTriangle(const core::triangle3df& triangle, const core::matrix4& mat,
+		core::triangle3df* triangles, s32& trianglesWritten) const;
+
+	core::array<SBVHNode> Nodes;
+	s32 MaximalPolysPerLeaf;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+
+#endif
+
@@ -0,0 +1,238 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
+#include "CBurningBinner.h"
+#include "CSoftwareTexture2.h"
+#include "CThreadPool.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! constructor
+CBurningBinner::CBurningBinner(IDepthBuffer* depthBuffer, u32 threadCount)
+: Pool(0), BandHeight(1), BandCount(0)
+{
+	Pool = threadCount ? new CThreadPool(threadCount) : CThreadPool::createSharedPool();
+
+	const u32 slots = Pool->getThreadCount();
+	Shaders.set_used(slots * ETR2_COUNT);
+	for (u32 i=0; i<slots; ++i)
+		createBurningShaders(Shaders.pointer() + i * ETR2_COUNT, depthBuffer);
+}
+
+
+//! destructor
+CBurningBinner::~CBurningBinner()
+{
+	clear();
+
+	for (u32 i=0; i<Shaders.size(); ++i)
+		if (Shaders[i])
+			Shaders[i]->drop();
+
+	Pool->drop();
+}
+
+
+//! Sets the renderer and the material of the following triangles
+void CBurningBinner::setMaterial(EBurningFFShader type, const SBurningShaderMaterial& material)
+{
+	SState state;
+	state.Type = type;
+	state.Material = material;
+
+	// replace the last state if no triangle uses it
+	if (!States.empty() && (Triangles.empty() || Triangles.getLast().State != States.size() - 1))
+		States.getLast() = state;
+	else
+		States.push_back(state);
+}
+
+
+//! Sets the textures of the following triangles
+void CBurningBinner::setTextures(const IBurningShader* shader)
+{
+	STextureSet set;
+	u32 i;
+
+	for (i=0; i!=BURNING_MATERIAL_MAX_TEXTURES; ++i)
+		set.IT[i] = shader->getTextureParam(i);
+
+	if (!TextureSets.empty())
+	{
+		const STextureSet& last = TextureSets.getLast();
+		for (i=0; i!=BURNING_MATERIAL_MAX_TEXTURES; ++i)
+		{
+			const sInternalTexture& a = set.IT[i];
+			const sInternalTexture& b = last.IT[i];
+			if (a.Texture != b.Texture || a.data != b.data ||
+				a.textureXMask != b.textureXMask || a.textureYMask != b.textureYMask ||
+				a.pitchlog2 != b.pitchlog2 || a.lodLevel != b.lodLevel)
+				break;
+		}
+
+		if (i == BURNING_MATERIAL_MAX_TEXTURES)
+			return;
+	}
+
+	// the mip map level is kept as well, the texture may recreate it before the flush
+	for (i=0; i!=BURNING_MATERIAL_MAX_TEXTURES; ++i)
+	{
+		CSoftwareTexture2* texture = set.IT[i].Texture;
+		if (!texture)
+			continue;
+
+		texture->grab();
+		Held.push_back(texture);
+
+		CImage* level = texture->getTexture();
+		if (level)
+		{
+			level->grab();
+			Held.push_back(level);
+		}
+	}
+
+	TextureSets.push_back(set);
+}
+
+
+//! Adds a projected triangle
+void CBurningBinner::addTriangle(const s4DVertex* a, const s4DVertex* b, const s4DVertex* c)
+{
+	STriangle triangle;
+	triangle.State = States.size() - 1;
+	triangle.Textures = TextureSets.size() - 1;
+	Triangles.push_back(triangle);
+
+	Vertices.push_back(*a);
+	Vertices.push_back(*b);
+	Vertices.push_back(*c);
+}
+
+
+//! Draws all triangles added since the last flush into a render target
+void CBurningBinner::flush(video::IImage* surface, const core::rect<s32>& viewPort)
+{
+	if (Triangles.empty() || !surface)
+	{
+		clear();
+		return;
+	}
+
+	// a few bands per thread, so threads with cheap bands take more of them
+	const s32 height = surface->getDimension().Height;
+	const s32 threads = (s32) Pool->getThreadCount();
+	BandHeight = core::s32_max(8, (height + threads * 4 - 1) / (threads * 4));
+	BandCount = (u32) core::s32_max(1, (height + BandHeight - 1) / BandHeight);
+
+	while (Bins.size() < BandCount)
+		Bins.push_back(core::array<u32>());
+
+	u32 i;
+	for (i=0; i<BandCount; ++i)
+		Bins[i].set_used(0);
+
+	// the rows drawn are within the floor of the highest and the lowest vertex
+	const f32 bandScale = 1.f / (f32) BandHeight;
+	const f32 lastBand = (f32) (BandCount - 1);
+	for (i=0; i<Triangles.size(); ++i)
+	{
+		const s4DVertex* v = Vertices.const_pointer() + i * 3;
+		f32 top = core::min_(v[0].Pos.y, v[1].Pos.y, v[2].Pos.y) * bandScale;
+		f32 bottom = core::max_(v[0].Pos.y, v[1].Pos.y, v[2].Pos.y) * bandScale;
+
+		// rows outside of the render target belong to the first or the last band
+		if (!(top >= 0.f))
+			top = 0.f;
+		else if (top > lastBand)
+			top = lastBand;
+
+		if (!(bottom <= lastBand))
+			bottom = lastBand;
+		else if (bottom < 0.f)
+			bottom = 0.f;
+
+		const s32 last = core::floor32(bottom);
+		for (s32 b=core::floor32(top); b<=last; ++b)
+			Bins[b].push_back(i);
+	}
+
+	for (i=0; i<Shaders.size(); ++i)
+		if (Shaders[i])
+			Shaders[i]->setRenderTarget(surface, viewPort);
+
+	Pool->run(drawBand, this, BandCount);
+
+	clear();
+}
+
+
+//! draws the triangles of one band
+void CBurningBinner::drawBand(void* userData, u32 band, u32 slot)
+{
+	const CBurningBinner* binner = (const CBurningBinner*) userData;
+	IBurningShader* const * shaders = binner->Shaders.const_pointer() + slot * ETR2_COUNT;
+	const core::array<u32>& bin = binner->Bins[band];
+
+	// the outer bands take all rows above and below the render target
+	const s32 yStart = band ? (s32) band * binner->BandHeight : -0x7FFFFFFF;
+	const s32 yEnd = band + 1 < binner->BandCount ? (s32) (band + 1) * binner->BandHeight : 0x7FFFFFFF;
+
+	IBurningShader* shader = 0;
+	u32 state = 0xFFFFFFFF;
+	u32 textures = 0xFFFFFFFF;
+
+	for (u32 i=0; i<bin.size(); ++i)
+	{
+		const STriangle& triangle = binner->Triangles[bin[i]];
+
+		if (triangle.State != state)
+		{
+			state = triangle.State;
+			const SState& s = binner->States[state];
+			shader = shaders[s.Type];
+			setBurningShaderMaterial(shader, s.Type, s.Material);
+			shader->setRenderBand(yStart, yEnd);
+			textures = 0xFFFFFFFF;
+		}
+
+		if (triangle.Textures != textures)
+		{
+			textures = triangle.Textures;
+			const STextureSet& set = binner->TextureSets[textures];
+			for (u32 t=0; t!=BURNING_MATERIAL_MAX_TEXTURES; ++t)
+				shader->setTextureParam(t, set.IT[t]);
+		}
+
+		const s4DVertex* v = binner->Vertices.const_pointer() + bin[i] * 3;
+		shader->drawTriangle(v, v + 1, v + 2);
+	}
+}
+
+
+//! Forgets all triangles added since the last flush
+void CBurningBinner::clear()
+{
+	for (u32 i=0; i<Held.size(); ++i)
+		Held[i]->drop();
+
+	Held.set_used(0);
+	States.set_used(0);
+	TextureSets.set_used(0);
+	Triangles.set_used(0);
+	Vertices.set_used(0);
+}
+
+
+} // end namespace video
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
@@ -0,0 +1,106 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_BURNING_BINNER_H_INCLUDED__
+#define __C_BURNING_BINNER_H_INCLUDED__
+
+#include "SoftwareDriver2_compile_config.h"
+#include "IBurningShader.h"
+
+namespace irr
+{
+	class CThreadPool;
+
+namespace video
+{
+
+//! Collects the projected triangles of the Burning's Video driver and draws them with several threads.
+/** The render target is split into bands of rows. Each triangle is added to
+the bins of the bands it touches, and each band is drawn by one thread with its
+own set of triangle renderers, in the order the triangles were added. The
+renderers step over the rows outside of their band, so the interpolation and
+the pixels are the same as when drawing with one thread. */
+class CBurningBinner
+{
+public:
+
+	//! constructor
+	/** \param depthBuffer: Zbuffer shared by the renderers of all threads.
+	\param threadCount: Number of threads including the caller, 0 for one
+	per processor. */
+	CBurningBinner(IDepthBuffer* depthBuffer, u32 threadCount);
+
+	//! destructor
+	~CBurningBinner();
+
+	//! Sets the renderer and the material of the following triangles
+	void setMaterial(EBurningFFShader type, const SBurningShaderMaterial& material);
+
+	//! Sets the textures of the following triangles
+	/** Copies the texture states selected by setTextureParam() of the
+	renderer of the driver, and keeps the textures and their mip map levels
+	until the triangles are drawn. */
+	void setTextures(const IBurningShader* shader);
+
+	//! Adds a projected triangle
+	void addTriangle(const s4DVertex* a, const s4DVertex* b, const s4DVertex* c);
+
+	//! Returns true if no triangles were added since the last flush
+	bool isEmpty() const { return Triangles.empty(); }
+
+	//! Draws all triangles added since the last flush into a render target
+	void flush(video::IImage* surface, const core::rect<s32>& viewPort);
+
+	//! Forgets all triangles added since the last flush
+	void clear();
+
+private:
+
+	struct SState
+	{
+		EBurningFFShader Type;
+		SBurningShaderMaterial Material;
+	};
+
+	struct STextureSet
+	{
+		sInternalTexture IT[ BURNING_MATERIAL_MAX_TEXTURES ];
+	};
+
+	struct STriangle
+	{
+		u32 State;
+		u32 Textures;
+	};
+
+	//! draws the triangles of one band
+	static void drawBand(void* userData, u32 band, u32 slot);
+
+	CThreadPool* Pool;
+
+	//! one set of renderers per thread of the pool
+	core::array<IBurningShader*> Shaders;
+
+	core::array<SState> States;
+	core::array<STextureSet> TextureSets;
+	core::array<STriangle> Triangles;
+
+	//! three projected vertices per triangle
+	core::array<s4DVertex> Vertices;
+
+	//! indices of the triangles touching each band
+	core::array< core::array<u32> > Bins;
+
+	//! textures and mip map levels used by the collected triangles
+	core::array<IReferenceCounted*> Held;
+
+	s32 BandHeight;
+	u32 BandCount;
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -486,9 +486,9 @@ bool CD3D8Driver::reset()
 
 	for (i=0; i<Textures.size(); ++i)
 	{
-		if (Textures[i].Surface->isRenderTarget())
+		if (Textures.getObject(i)->isRenderTarget())
 		{
-			IDirect3DTexture8* tex = ((CD3D8Texture*)(Textures[i].Surface))->getDX8Texture();
+			IDirect3DTexture8* tex = ((CD3D8Texture*)(Textures.getObject(i)))->getDX8Texture();
 			if (tex)
 				tex->Release();
 		}
@@ -499,8 +499,8 @@ bool CD3D8Driver::reset()
 
 	for (i=0; i<Textures.size(); ++i)
 	{
-		if (Textures[i].Surface->isRenderTarget())
-			((CD3D8Texture*)(Textures[i].Surface))->createRenderTarget();
+		if (Textures.getObject(i)->isRenderTarget())
+			((CD3D8Texture*)(Textures.getObject(i)))->createRenderTarget();
 	}
 
 	if (FAILED(hr))
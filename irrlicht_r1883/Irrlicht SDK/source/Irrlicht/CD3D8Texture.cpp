@@ -8,6 +8,7 @@
 #define _IRR_DONT_DO_MEMORY_DEBUGGING_HERE
 #include "CD3D8Texture.h"
 #include "CD3D8Driver.h"
+#include "CImageResampler.h"
 #include "os.h"
 
 
@@ -202,7 +203,9 @@ bool CD3D8Texture::copyTexture(video::IImage* image)
 		}
 
 		Pitch = rect.Pitch;
-		image->copyToScaling(rect.pBits, TextureSize.Width, TextureSize.Height, ColorFormat, Pitch);
+		CImageResampler::resize(image->lock(), image->getDimension(), image->getPitch(),
+			image->getColorFormat(), rect.pBits, TextureSize, Pitch, ColorFormat);
+		image->unlock();
 
 		hr = Texture->UnlockRect(0);
 		if (FAILED(hr))
@@ -412,15 +415,12 @@ bool CD3D8Texture::createMipMaps(u32 level)
 	}
 	else
 	{
-		if (upperDesc.Format == D3DFMT_A1R5G5B5)
-			copy16BitMipMap((char*)upperlr.pBits, (char*)lowerlr.pBits,
-							lowerDesc.Width, lowerDesc.Height,
-							upperlr.Pitch, lowerlr.Pitch);
-		else
-		if (upperDesc.Format == D3DFMT_A8R8G8B8)
-			copy32BitMipMap((char*)upperlr.pBits, (char*)lowerlr.pBits,
-							lowerDesc.Width, lowerDesc.Height,
-							upperlr.Pitch, lowerlr.Pitch);
+		if ((upperDesc.Format == D3DFMT_A1R5G5B5) ||
+			(upperDesc.Format == D3DFMT_R5G6B5) ||
+			(upperDesc.Format == D3DFMT_A8R8G8B8))
+			CImageResampler::createMipMap(upperlr.pBits,
+					core::dimension2d<s32>(upperDesc.Width, upperDesc.Height),
+					upperlr.Pitch, lowerlr.pBits, lowerlr.Pitch, ColorFormat);
 		else
 			os::Printer::log("Unsupported mipmap format, cannot copy.", ELL_WARNING);
 	}
@@ -469,87 +469,6 @@ ECOLOR_FORMAT CD3D8Texture::getColorFormatFromD3DFormat(D3DFORMAT format)
 
 
 
-void CD3D8Texture::copy16BitMipMap(char* src, char* tgt,
-				   s32 width, s32 height,
-				   s32 pitchsrc, s32 pitchtgt) const
-{
-	u16 c;
-
-	for (int x=0; x<width; ++x)
-	{
-		for (int y=0; y<height; ++y)
-		{
-			s32 a=0, r=0, g=0, b=0;
-
-			for (int dx=0; dx<2; ++dx)
-			{
-				for (int dy=0; dy<2; ++dy)
-				{
-					int tgx = (x*2)+dx;
-					int tgy = (y*2)+dy;
-
-					c = *(u16*)((void*)&src[(tgx*2)+(tgy*pitchsrc)]);
-
-					a += getAlpha(c);
-					r += getRed(c);
-					g += getGreen(c);
-					b += getBlue(c);
-				}
-			}
-
-			a /= 4;
-			r /= 4;
-			g /= 4;
-			b /= 4;
-
-			c = ((a & 0x1) <<15) | ((r & 0x1F)<<10) | ((g & 0x1F)<<5) | (b & 0x1F);
-			*(u16*)((void*)&tgt[(x*2)+(y*pitchtgt)]) = c;
-		}
-	}
-}
-
-
-void CD3D8Texture::copy32BitMipMap(char* src, char* tgt,
-				   s32 width, s32 height,
-				   s32 pitchsrc, s32 pitchtgt) const
-{
-	SColor c;
-
-	for (int x=0; x<width; ++x)
-	{
-		for (int y=0; y<height; ++y)
-		{
-			s32 a=0, r=0, g=0, b=0;
-
-			for (int dx=0; dx<2; ++dx)
-			{
-				for (int dy=0; dy<2; ++dy)
-				{
-					int tgx = (x*2)+dx;
-					int tgy = (y*2)+dy;
-
-					c = *(u32*)((void*)&src[(tgx<<2)+(tgy*pitchsrc)]);
-
-					a += c.getAlpha();
-					r += c.getRed();
-					g += c.getGreen();
-					b += c.getBlue();
-				}
-			}
-
-			a >>= 2;
-			r >>= 2;
-			g >>= 2;
-			b >>= 2;
-
-			c = ((a & 0xff)<<24) | ((r & 0xff)<<16) | ((g & 0xff)<<8) | (b & 0xff);
-			*(u32*)((void*)&tgt[(x*4)+(y*pitchtgt)]) = c.color;
-		}
-	}
-}
-
-
-
 void CD3D8Texture::createRenderTarget()
 {
 	TextureSize.Width = getTextureSizeFromSurfaceSize(TextureSize.Width);
@@ -92,12 +92,6 @@ private:
 
 	bool createMipMaps(u32 level=1);
 
-	void copy16BitMipMap(char* src, char* tgt,
-		s32 width, s32 height, s32 pitchsrc, s32 pitchtgt) const;
-
-	void copy32BitMipMap(char* src, char* tgt,
-		s32 width, s32 height, s32 pitchsrc, s32 pitchtgt) const;
-
 	IDirect3DDevice8* Device;
 	IDirect3DTexture8* Texture;
 	IDirect3DSurface8* RTTSurface;
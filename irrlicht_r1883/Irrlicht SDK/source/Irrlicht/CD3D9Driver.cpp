@@ -918,6 +918,56 @@ bool CD3D9Driver::updateVertexHardwareBuffer(SHWBufferLink_d3d9 *HWBuffer)
 }
 
 
+//! copies a range of vertices to the hardware buffer
+bool CD3D9Driver::updateVertexHardwareBufferRange(SHWBufferLink *HWBuffer, u32 first, u32 count)
+{
+	if (!HWBuffer)
+		return false;
+
+	SHWBufferLink_d3d9* link = (SHWBufferLink_d3d9*)HWBuffer;
+	const scene::IMeshBuffer* mb = link->MeshBuffer;
+	const u32 vertexSize = getVertexPitchFromType(mb->getVertexType());
+
+	if (!link->vertexBuffer || (first+count)*vertexSize > link->vertexBufferSize)
+		return false;
+
+	// no discard, the other vertices are kept
+	void* pLockedBuffer = 0;
+	if (FAILED(link->vertexBuffer->Lock(first * vertexSize, count * vertexSize, (void**)&pLockedBuffer, 0)))
+		return false;
+
+	memcpy(pLockedBuffer, static_cast<const u8*>(mb->getVertices()) + first*vertexSize, count * vertexSize);
+	link->vertexBuffer->Unlock();
+
+	return true;
+}
+
+
+//! copies a range of indices to the hardware buffer
+bool CD3D9Driver::updateIndexHardwareBufferRange(SHWBufferLink *HWBuffer, u32 first, u32 count)
+{
+	if (!HWBuffer)
+		return false;
+
+	SHWBufferLink_d3d9* link = (SHWBufferLink_d3d9*)HWBuffer;
+	const scene::IMeshBuffer* mb = link->MeshBuffer;
+	const u32 indexSize = (mb->getIndexType() == EIT_32BIT) ? 4 : 2;
+
+	if (!link->indexBuffer || (first+count)*indexSize > link->indexBufferSize)
+		return false;
+
+	// no discard, the other indices are kept
+	void* pIndices = 0;
+	if (FAILED(link->indexBuffer->Lock(first * indexSize, count * indexSize, (void**)&pIndices, 0)))
+		return false;
+
+	memcpy(pIndices, static_cast<const u8*>((const void*)mb->getIndices()) + first*indexSize, count * indexSize);
+	link->indexBuffer->Unlock();
+
+	return true;
+}
+
+
 bool CD3D9Driver::updateIndexHardwareBuffer(SHWBufferLink_d3d9 *HWBuffer)
 {
 	if (!HWBuffer)
@@ -1450,6 +1500,87 @@ void CD3D9Driver::draw2DImage(const video::ITexture* texture,
 }
 
 
+//! Draws a set of 2d images from one texture at arbitrary positions.
+void CD3D9Driver::draw2DImageBatch(const video::ITexture* texture,
+				const core::array<core::position2d<s32> >& positions,
+				const core::array<core::rect<s32> >& sourceRects,
+				const core::rect<s32>* clipRect, SColor color,
+				bool useAlphaChannelOfTexture)
+{
+	if (!texture)
+		return;
+
+	if (!setTexture(0, const_cast<video::ITexture*>(texture)))
+		return;
+
+	const core::dimension2d<s32>& renderTargetSize = getCurrentRenderTargetSize();
+
+	s32 xPlus = -renderTargetSize.Width / 2;
+	f32 xFact = 2.0f / renderTargetSize.Width;
+
+	s32 yPlus = renderTargetSize.Height / 2;
+	f32 yFact = 2.0f / renderTargetSize.Height;
+
+	const f32 invW = 1.f / texture->getOriginalSize().Width;
+	const f32 invH = 1.f / texture->getOriginalSize().Height;
+
+	const u32 count = core::min_(positions.size(), sourceRects.size());
+
+	// 16 bit indices, so the quads are sent in chunks
+	const u32 maxQuads = 16384;
+	core::array<S3DVertex> vtx(core::min_(count, maxQuads) * 4);
+	core::array<u16> indices(core::min_(count, maxQuads) * 6);
+
+	setRenderStates2DMode(color.getAlpha()<255, true, useAlphaChannelOfTexture);
+	setVertexShader(EVT_STANDARD);
+
+	for (u32 i=0; i<count; ++i)
+	{
+		core::position2d<s32> targetPos(positions[i]);
+		core::rect<s32> sourceRect(sourceRects[i]);
+		if (sourceRect.isValid() && clip2DImage(targetPos, sourceRect, clipRect))
+		{
+			const core::rect<f32> tcoords(
+					((f32)sourceRect.UpperLeftCorner.X+0.5f) * invW,
+					((f32)sourceRect.UpperLeftCorner.Y+0.5f) * invH,
+					((f32)sourceRect.LowerRightCorner.X+0.5f) * invW,
+					((f32)sourceRect.LowerRightCorner.Y+0.5f) * invH);
+
+			const core::rect<s32> poss(targetPos, sourceRect.getSize());
+
+			const u16 first = (u16)vtx.size();
+			vtx.push_back(S3DVertex((f32)(poss.UpperLeftCorner.X+xPlus) * xFact, (f32)(yPlus-poss.UpperLeftCorner.Y) * yFact, 0.0f,
+					0.0f, 0.0f, 0.0f, color,
+					tcoords.UpperLeftCorner.X, tcoords.UpperLeftCorner.Y));
+			vtx.push_back(S3DVertex((f32)(poss.LowerRightCorner.X+xPlus) * xFact, (f32)(yPlus-poss.UpperLeftCorner.Y) * yFact, 0.0f,
+					0.0f, 0.0f, 0.0f, color,
+					tcoords.LowerRightCorner.X, tcoords.UpperLeftCorner.Y));
+			vtx.push_back(S3DVertex((f32)(poss.LowerRightCorner.X+xPlus) * xFact, (f32)(yPlus-poss.LowerRightCorner.Y) * yFact, 0.0f,
+					0.0f, 0.0f, 0.0f, color,
+					tcoords.LowerRightCorner.X, tcoords.LowerRightCorner.Y));
+			vtx.push_back(S3DVertex((f32)(poss.UpperLeftCorner.X+xPlus) * xFact, (f32)(yPlus-poss.LowerRightCorner.Y) * yFact, 0.0f,
+					0.0f, 0.0f, 0.0f, color,
+					tcoords.UpperLeftCorner.X, tcoords.LowerRightCorner.Y));
+
+			indices.push_back(first);
+			indices.push_back(first+1);
+			indices.push_back(first+2);
+			indices.push_back(first);
+			indices.push_back(first+2);
+			indices.push_back(first+3);
+		}
+
+		if (vtx.size() && (vtx.size() == maxQuads*4 || i+1 == count))
+		{
+			pID3DDevice->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, vtx.size(), indices.size()/3,
+				indices.const_pointer(), D3DFMT_INDEX16, vtx.const_pointer(), sizeof(S3DVertex));
+			vtx.set_used(0);
+			indices.set_used(0);
+		}
+	}
+}
+
+
 //!Draws a 2d rectangle with a gradient.
 void CD3D9Driver::draw2DRectangle(const core::rect<s32>& position,
 	SColor colorLeftUp, SColor colorRightUp, SColor colorLeftDown, SColor colorRightDown,
@@ -2308,9 +2439,9 @@ bool CD3D9Driver::reset()
 
 	for (i=0; i<Textures.size(); ++i)
 	{
-		if (Textures[i].Surface->isRenderTarget())
+		if (Textures.getObject(i)->isRenderTarget())
 		{
-			IDirect3DBaseTexture9* tex = ((CD3D9Texture*)(Textures[i].Surface))->getDX9Texture();
+			IDirect3DBaseTexture9* tex = ((CD3D9Texture*)(Textures.getObject(i)))->getDX9Texture();
 			if (tex)
 				tex->Release();
 		}
@@ -2345,8 +2476,8 @@ bool CD3D9Driver::reset()
 	// restore RTTs
 	for (i=0; i<Textures.size(); ++i)
 	{
-		if (Textures[i].Surface->isRenderTarget())
-			((CD3D9Texture*)(Textures[i].Surface))->createRenderTarget();
+		if (Textures.getObject(i)->isRenderTarget())
+			((CD3D9Texture*)(Textures.getObject(i)))->createRenderTarget();
 	}
 
 	if (FAILED(hr))
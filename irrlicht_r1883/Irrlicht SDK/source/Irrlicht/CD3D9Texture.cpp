@@ -8,6 +8,7 @@
 #define _IRR_DONT_DO_MEMORY_DEBUGGING_HERE
 #include "CD3D9Texture.h"
 #include "CD3D9Driver.h"
+#include "CImageResampler.h"
 #include "os.h"
 
 #include <d3dx9tex.h>
@@ -223,15 +224,12 @@ bool CD3D9Texture::createMipMaps(u32 level)
 	}
 	else
 	{
-		if ((upperDesc.Format == D3DFMT_A1R5G5B5) || (upperDesc.Format == D3DFMT_R5G6B5))
-			copy16BitMipMap((char*)upperlr.pBits, (char*)lowerlr.pBits,
-					lowerDesc.Width, lowerDesc.Height,
-					upperlr.Pitch, lowerlr.Pitch);
-		else
-		if (upperDesc.Format == D3DFMT_A8R8G8B8)
-			copy32BitMipMap((char*)upperlr.pBits, (char*)lowerlr.pBits,
-					lowerDesc.Width, lowerDesc.Height,
-					upperlr.Pitch, lowerlr.Pitch);
+		if ((upperDesc.Format == D3DFMT_A1R5G5B5) ||
+			(upperDesc.Format == D3DFMT_R5G6B5) ||
+			(upperDesc.Format == D3DFMT_A8R8G8B8))
+			CImageResampler::createMipMap(upperlr.pBits,
+					core::dimension2d<s32>(upperDesc.Width, upperDesc.Height),
+					upperlr.Pitch, lowerlr.pBits, lowerlr.Pitch, ColorFormat);
 		else
 			os::Printer::log("Unsupported mipmap format, cannot copy.", ELL_WARNING);
 	}
@@ -370,7 +368,9 @@ bool CD3D9Texture::copyTexture(IImage * image)
 		}
 
 		Pitch = rect.Pitch;
-		image->copyToScaling(rect.pBits, TextureSize.Width, TextureSize.Height, ColorFormat, Pitch);
+		CImageResampler::resize(image->lock(), image->getDimension(), image->getPitch(),
+			image->getColorFormat(), rect.pBits, TextureSize, Pitch, ColorFormat);
+		image->unlock();
 
 		hr = Texture->UnlockRect(0);
 		if (FAILED(hr))
@@ -520,91 +520,6 @@ bool CD3D9Texture::hasMipMaps() const
 }
 
 
-void CD3D9Texture::copy16BitMipMap(char* src, char* tgt,
-				   s32 width, s32 height,
-				   s32 pitchsrc, s32 pitchtgt) const
-{
-	for (s32 y=0; y<height; ++y)
-	{
-		for (s32 x=0; x<width; ++x)
-		{
-			u32 a=0, r=0, g=0, b=0;
-
-			for (s32 dy=0; dy<2; ++dy)
-			{
-				const s32 tgy = (y*2)+dy;
-				for (s32 dx=0; dx<2; ++dx)
-				{
-					const s32 tgx = (x*2)+dx;
-
-					SColor c;
-					if (ColorFormat == ECF_A1R5G5B5)
-						c = A1R5G5B5toA8R8G8B8(*(u16*)(&src[(tgx*2)+(tgy*pitchsrc)]));
-					else
-						c = R5G6B5toA8R8G8B8(*(u16*)(&src[(tgx*2)+(tgy*pitchsrc)]));
-
-					a += c.getAlpha();
-					r += c.getRed();
-					g += c.getGreen();
-					b += c.getBlue();
-				}
-			}
-
-			a /= 4;
-			r /= 4;
-			g /= 4;
-			b /= 4;
-
-			u16 c;
-			if (ColorFormat == ECF_A1R5G5B5)
-				c = RGBA16(r,g,b,a);
-			else
-				c = A8R8G8B8toR5G6B5(SColor(a,r,g,b).color);
-			*(u16*)(&tgt[(x*2)+(y*pitchtgt)]) = c;
-		}
-	}
-}
-
-
-void CD3D9Texture::copy32BitMipMap(char* src, char* tgt,
-				   s32 width, s32 height,
-				   s32 pitchsrc, s32 pitchtgt) const
-{
-	for (s32 y=0; y<height; ++y)
-	{
-		for (s32 x=0; x<width; ++x)
-		{
-			u32 a=0, r=0, g=0, b=0;
-			SColor c;
-
-			for (s32 dy=0; dy<2; ++dy)
-			{
-				const s32 tgy = (y*2)+dy;
-				for (s32 dx=0; dx<2; ++dx)
-				{
-					const s32 tgx = (x*2)+dx;
-
-					c = *(u32*)(&src[(tgx*4)+(tgy*pitchsrc)]);
-
-					a += c.getAlpha();
-					r += c.getRed();
-					g += c.getGreen();
-					b += c.getBlue();
-				}
-			}
-
-			a /= 4;
-			r /= 4;
-			g /= 4;
-			b /= 4;
-
-			c.set(a, r, g, b);
-			*(u32*)(&tgt[(x*4)+(y*pitchtgt)]) = c.color;
-		}
-	}
-}
-
-
 //! Regenerates the mip map levels of the texture. Useful after locking and
 //! modifying the texture
 void CD3D9Texture::regenerateMipMapLevels()
@@ -91,14 +91,6 @@ private:
 	//! Helper function for mipmap generation.
 	bool createMipMaps(u32 level=1);
 
-	//! Helper function for mipmap generation.
-	void copy16BitMipMap(char* src, char* tgt,
-		s32 width, s32 height,  s32 pitchsrc, s32 pitchtgt) const;
-
-	//! Helper function for mipmap generation.
-	void copy32BitMipMap(char* src, char* tgt,
-		s32 width, s32 height,  s32 pitchsrc, s32 pitchtgt) const;
-
 	//! set Pitch based on the d3d format
 	void setPitch(D3DFORMAT d3dformat);
 
@@ -0,0 +1,442 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageResampler.h"
+#include "CColorConverter.h"
+#include "irrArray.h"
+#include "irrMath.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _IRR_RESAMPLE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+	//! weights of the source pixels for each target pixel along one axis
+	struct SFilterWeights
+	{
+		//! number of source pixels for each target pixel
+		u32 Taps;
+
+		//! source pixel and weight of each tap, Taps entries per target pixel
+		core::array<s32> Index;
+		core::array<f32> Weight;
+	};
+
+
+	f32 filterKernel(f32 x, CImageResampler::E_FILTER filter)
+	{
+		x = fabsf(x);
+
+		if (filter == CImageResampler::EF_BILINEAR)
+			return x < 1.f ? 1.f - x : 0.f;
+
+		// lanczos, sinc(x) * sinc(x/3)
+		if (x < 0.00001f)
+			return 1.f;
+		if (x >= 3.f)
+			return 0.f;
+		const f32 px = core::PI * x;
+		return 3.f * sinf(px) * sinf(px / 3.f) / (px * px);
+	}
+
+
+	void computeWeights(SFilterWeights& weights, s32 sourceSize, s32 targetSize,
+			CImageResampler::E_FILTER filter)
+	{
+		const f32 radius = filter == CImageResampler::EF_BILINEAR ? 1.f : 3.f;
+		const f32 ratio = (f32)sourceSize / (f32)targetSize;
+
+		// when scaling down, the filter is widened to cover all source pixels
+		const f32 scale = core::max_(ratio, 1.f);
+		const f32 support = radius * scale;
+
+		weights.Taps = (u32)ceilf(2.f * support) + 1;
+		weights.Index.set_used(targetSize * weights.Taps);
+		weights.Weight.set_used(targetSize * weights.Taps);
+
+		for (s32 i=0; i<targetSize; ++i)
+		{
+			const f32 center = (i + 0.5f) * ratio - 0.5f;
+			const s32 first = (s32)ceilf(center - support);
+			const u32 base = i * weights.Taps;
+
+			f32 sum = 0.f;
+			for (u32 t=0; t<weights.Taps; ++t)
+			{
+				const s32 pos = first + (s32)t;
+				const f32 w = filterKernel((pos - center) / scale, filter);
+
+				// pixels outside of the image repeat the border
+				weights.Index[base + t] = core::s32_clamp(pos, 0, sourceSize - 1);
+				weights.Weight[base + t] = w;
+				sum += w;
+			}
+
+			const f32 normalize = sum != 0.f ? 1.f / sum : 0.f;
+			for (u32 t=0; t<weights.Taps; ++t)
+				weights.Weight[base + t] *= normalize;
+		}
+	}
+
+
+	//! reads a pixel of 3 or 4 bytes into the lowest bytes of an integer
+	inline s32 readPixel(const u8* p, u32 bpp)
+	{
+		if (bpp == 4)
+		{
+			s32 pixel;
+			memcpy(&pixel, p, 4);
+			return pixel;
+		}
+		return p[0] | (p[1] << 8) | (p[2] << 16);
+	}
+
+
+	//! adds a weighted source row to the accumulated row, which has 4 floats per pixel
+	void accumulateRow(f32* acc, const u8* row, s32 width, u32 bpp, f32 weight)
+	{
+#ifdef _IRR_RESAMPLE_WITH_SSE2_
+		const __m128 w = _mm_set1_ps(weight);
+		const __m128i zero = _mm_setzero_si128();
+		s32 x = 0;
+
+		if (bpp == 4)
+		{
+			// 4 pixels at once
+			for (; x+4 <= width; x+=4)
+			{
+				const __m128i p = _mm_loadu_si128((const __m128i*)(row + x*4));
+				const __m128i lo = _mm_unpacklo_epi8(p, zero);
+				const __m128i hi = _mm_unpackhi_epi8(p, zero);
+				f32* a = acc + x*4;
+
+				_mm_storeu_ps(a, _mm_add_ps(_mm_loadu_ps(a),
+					_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), w)));
+				_mm_storeu_ps(a+4, _mm_add_ps(_mm_loadu_ps(a+4),
+					_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), w)));
+				_mm_storeu_ps(a+8, _mm_add_ps(_mm_loadu_ps(a+8),
+					_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), w)));
+				_mm_storeu_ps(a+12, _mm_add_ps(_mm_loadu_ps(a+12),
+					_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), w)));
+			}
+		}
+
+		for (; x<width; ++x)
+		{
+			const __m128i p = _mm_cvtsi32_si128(readPixel(row + x*bpp, bpp));
+			const __m128 c = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(p, zero), zero));
+			_mm_storeu_ps(acc + x*4, _mm_add_ps(_mm_loadu_ps(acc + x*4), _mm_mul_ps(c, w)));
+		}
+#else
+		for (s32 x=0; x<width; ++x)
+		{
+			const u8* p = row + x*bpp;
+			f32* a = acc + x*4;
+			for (u32 c=0; c<bpp; ++c)
+				a[c] += p[c] * weight;
+		}
+#endif
+	}
+
+
+	//! filters the accumulated row horizontally into a target row
+	void filterRow(u8* target, const f32* acc, const SFilterWeights& weights,
+			s32 width, u32 bpp)
+	{
+		const s32* index = weights.Index.const_pointer();
+		const f32* weight = weights.Weight.const_pointer();
+
+		for (s32 x=0; x<width; ++x)
+		{
+			u8* p = target + x*bpp;
+
+#ifdef _IRR_RESAMPLE_WITH_SSE2_
+			__m128 sum = _mm_setzero_ps();
+			for (u32 t=0; t<weights.Taps; ++t)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(acc + index[t]*4), _mm_set1_ps(weight[t])));
+
+			// round and saturate, lanczos can leave the range of the channels
+			__m128i c = _mm_cvtps_epi32(sum);
+			c = _mm_packs_epi32(c, c);
+			c = _mm_packus_epi16(c, c);
+			const s32 pixel = _mm_cvtsi128_si32(c);
+
+			if (bpp == 4)
+				memcpy(p, &pixel, 4);
+			else
+			{
+				p[0] = (u8)pixel;
+				p[1] = (u8)(pixel >> 8);
+				p[2] = (u8)(pixel >> 16);
+			}
+#else
+			f32 sum[4] = { 0.f, 0.f, 0.f, 0.f };
+			for (u32 t=0; t<weights.Taps; ++t)
+			{
+				const f32* a = acc + index[t]*4;
+				for (u32 c=0; c<bpp; ++c)
+					sum[c] += a[c] * weight[t];
+			}
+
+			for (u32 c=0; c<bpp; ++c)
+				p[c] = (u8)(core::clamp(sum[c], 0.f, 255.f) + 0.5f);
+#endif
+
+			index += weights.Taps;
+			weight += weights.Taps;
+		}
+	}
+
+
+	//! averages 2x2 blocks of 32 bit pixels
+	void createMipMapRow32(u8* target, const u8* row0, const u8* row1, s32 width, u32 dx)
+	{
+		s32 x = 0;
+
+#ifdef _IRR_RESAMPLE_WITH_SSE2_
+		if (dx)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i two = _mm_set1_epi16(2);
+
+			// 4 target pixels from 8 pixels of each source row
+			for (; x+4 <= width; x+=4)
+			{
+				const __m128i a0 = _mm_loadu_si128((const __m128i*)(row0 + x*8));
+				const __m128i a1 = _mm_loadu_si128((const __m128i*)(row0 + x*8 + 16));
+				const __m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + x*8));
+				const __m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + x*8 + 16));
+
+				// vertical sums, two pixels per register
+				const __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+				const __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+				const __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+				const __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+				// horizontal sums of the pixel pairs
+				__m128i d0 = _mm_add_epi16(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+				__m128i d1 = _mm_add_epi16(_mm_unpacklo_epi64(s2, s3), _mm_unpackhi_epi64(s2, s3));
+				d0 = _mm_srli_epi16(_mm_add_epi16(d0, two), 2);
+				d1 = _mm_srli_epi16(_mm_add_epi16(d1, two), 2);
+
+				_mm_storeu_si128((__m128i*)(target + x*4), _mm_packus_epi16(d0, d1));
+			}
+		}
+#endif
+
+		for (; x<width; ++x)
+		{
+			const u32 i = x*8;
+			for (u32 c=0; c<4; ++c)
+				target[x*4 + c] = (u8)((row0[i+c] + row0[i+dx+c] + row1[i+c] + row1[i+dx+c] + 2) >> 2);
+		}
+	}
+
+
+	//! averages 2x2 blocks of 24 bit pixels
+	void createMipMapRow24(u8* target, const u8* row0, const u8* row1, s32 width, u32 dx)
+	{
+		for (s32 x=0; x<width; ++x)
+		{
+			const u32 i = x*6;
+			for (u32 c=0; c<3; ++c)
+				target[x*3 + c] = (u8)((row0[i+c] + row0[i+dx+c] + row1[i+c] + row1[i+dx+c] + 2) >> 2);
+		}
+	}
+
+
+	//! averages 2x2 blocks of 16 bit pixels
+	void createMipMapRow16(u8* target, const u8* row0, const u8* row1, s32 width, u32 dx,
+			ECOLOR_FORMAT format)
+	{
+		const u16* r0 = (const u16*)row0;
+		const u16* r1 = (const u16*)row1;
+		const u32 d = dx / 2;
+
+		for (s32 x=0; x<width; ++x)
+		{
+			u32 a=0, r=0, g=0, b=0;
+			const u16 block[4] = { r0[x*2], r0[x*2+d], r1[x*2], r1[x*2+d] };
+
+			for (u32 i=0; i<4; ++i)
+			{
+				const SColor c(format == ECF_A1R5G5B5 ?
+					A1R5G5B5toA8R8G8B8(block[i]) : R5G6B5toA8R8G8B8(block[i]));
+				a += c.getAlpha();
+				r += c.getRed();
+				g += c.getGreen();
+				b += c.getBlue();
+			}
+
+			const SColor c((a+2) >> 2, (r+2) >> 2, (g+2) >> 2, (b+2) >> 2);
+			((u16*)target)[x] = format == ECF_A1R5G5B5 ?
+				A8R8G8B8toA1R5G5B5(c.color) : A8R8G8B8toR5G6B5(c.color);
+		}
+	}
+
+} // end anonymous namespace
+
+
+//! Creates the next mip map level by averaging blocks of 2x2 pixels
+void CImageResampler::createMipMap(const void* source, const core::dimension2d<s32>& sourceSize,
+		u32 sourcePitch, void* target, u32 targetPitch, ECOLOR_FORMAT format)
+{
+	if (!source || !target || sourceSize.Width <= 0 || sourceSize.Height <= 0)
+		return;
+
+	const core::dimension2d<s32> size = getMipMapSize(sourceSize);
+
+	u32 bpp;
+	switch (format)
+	{
+		case ECF_A8R8G8B8:
+			bpp = 4;
+			break;
+		case ECF_R8G8B8:
+			bpp = 3;
+			break;
+		default:
+			bpp = 2;
+			break;
+	}
+
+	// a source of width or height 1 uses the same pixels twice
+	const u32 dx = sourceSize.Width > 1 ? bpp : 0;
+	const u32 dy = sourceSize.Height > 1 ? sourcePitch : 0;
+
+	for (s32 y=0; y<size.Height; ++y)
+	{
+		const u8* row0 = (const u8*)source + 2*y*dy;
+		const u8* row1 = row0 + dy;
+		u8* out = (u8*)target + y*targetPitch;
+
+		switch (bpp)
+		{
+			case 4:
+				createMipMapRow32(out, row0, row1, size.Width, dx);
+				break;
+			case 3:
+				createMipMapRow24(out, row0, row1, size.Width, dx);
+				break;
+			default:
+				createMipMapRow16(out, row0, row1, size.Width, dx, format);
+				break;
+		}
+	}
+}
+
+
+//! Creates the next mip map level of an image
+void CImageResampler::createMipMap(IImage* source, IImage* target)
+{
+	if (!source || !target)
+		return;
+
+	createMipMap(source->lock(), source->getDimension(), source->getPitch(),
+		target->lock(), target->getPitch(), source->getColorFormat());
+
+	target->unlock();
+	source->unlock();
+}
+
+
+//! Scales pixels to an arbitrary size with a separable filter
+void CImageResampler::resize(const void* source, const core::dimension2d<s32>& sourceSize,
+		u32 sourcePitch, ECOLOR_FORMAT sourceFormat,
+		void* target, const core::dimension2d<s32>& targetSize,
+		u32 targetPitch, ECOLOR_FORMAT targetFormat, E_FILTER filter)
+{
+	if (!source || !target || sourceSize.Width <= 0 || sourceSize.Height <= 0 ||
+		targetSize.Width <= 0 || targetSize.Height <= 0)
+		return;
+
+	if (sourceSize == targetSize)
+	{
+		for (s32 y=0; y<targetSize.Height; ++y)
+			CColorConverter::convert_viaFormat((const u8*)source + y*sourcePitch, sourceFormat,
+				targetSize.Width, (u8*)target + y*targetPitch, targetFormat);
+		return;
+	}
+
+	// the filter works on 8 bit channels, other formats are converted
+	// through A8R8G8B8, the converters from 16 to 24 bit mix up the channels
+	const ECOLOR_FORMAT format = (targetFormat == ECF_R8G8B8 &&
+		(sourceFormat == ECF_R8G8B8 || sourceFormat == ECF_A8R8G8B8)) ? ECF_R8G8B8 : ECF_A8R8G8B8;
+	const u32 bpp = format == ECF_R8G8B8 ? 3 : 4;
+
+	const u8* src = (const u8*)source;
+	u32 pitch = sourcePitch;
+	u8* converted = 0;
+	if (sourceFormat != format)
+	{
+		pitch = sourceSize.Width * bpp;
+		converted = new u8[pitch * sourceSize.Height];
+		for (s32 y=0; y<sourceSize.Height; ++y)
+			CColorConverter::convert_viaFormat(src + y*sourcePitch, sourceFormat,
+				sourceSize.Width, converted + y*pitch, format);
+		src = converted;
+	}
+
+	u8* row = 0;
+	if (targetFormat != format)
+		row = new u8[targetSize.Width * bpp];
+
+	SFilterWeights horizontal, vertical;
+	computeWeights(horizontal, sourceSize.Width, targetSize.Width, filter);
+	computeWeights(vertical, sourceSize.Height, targetSize.Height, filter);
+
+	// the source rows of each target row are filtered vertically first
+	core::array<f32> acc;
+	acc.set_used(sourceSize.Width * 4);
+
+	for (s32 y=0; y<targetSize.Height; ++y)
+	{
+		memset(acc.pointer(), 0, acc.size() * sizeof(f32));
+
+		const u32 base = y * vertical.Taps;
+		for (u32 t=0; t<vertical.Taps; ++t)
+		{
+			if (vertical.Weight[base + t] != 0.f)
+				accumulateRow(acc.pointer(), src + vertical.Index[base + t] * pitch,
+					sourceSize.Width, bpp, vertical.Weight[base + t]);
+		}
+
+		u8* out = (u8*)target + y*targetPitch;
+		filterRow(row ? row : out, acc.const_pointer(), horizontal, targetSize.Width, bpp);
+
+		if (row)
+			CColorConverter::convert_viaFormat(row, format, targetSize.Width, out, targetFormat);
+	}
+
+	delete [] row;
+	delete [] converted;
+}
+
+
+//! Scales an image to the size of the target image
+void CImageResampler::resize(IImage* source, IImage* target, E_FILTER filter)
+{
+	if (!source || !target)
+		return;
+
+	resize(source->lock(), source->getDimension(), source->getPitch(), source->getColorFormat(),
+		target->lock(), target->getDimension(), target->getPitch(), target->getColorFormat(), filter);
+
+	target->unlock();
+	source->unlock();
+}
+
+
+} // end namespace video
+} // end namespace irr
+
@@ -0,0 +1,73 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IMAGE_RESAMPLER_H_INCLUDED__
+#define __C_IMAGE_RESAMPLER_H_INCLUDED__
+
+#include "IImage.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Filtered scaling of images, used by the drivers for mip maps and for
+//! scaling textures to sizes supported by the hardware.
+/** A8R8G8B8 and R8G8B8 data is filtered directly, with SSE2 if available.
+Other formats are converted to A8R8G8B8 for scaling, and mip maps of 16 bit
+formats are averaged per pixel. */
+class CImageResampler
+{
+public:
+
+	//! Filters for scaling to arbitrary sizes
+	enum E_FILTER
+	{
+		//! Triangle filter, widened when scaling down so all pixels contribute
+		EF_BILINEAR = 0,
+
+		//! Lanczos filter with 3 lobes, sharper than bilinear
+		EF_LANCZOS
+	};
+
+	//! Returns the size of the next mip map level
+	static core::dimension2d<s32> getMipMapSize(const core::dimension2d<s32>& size)
+	{
+		return core::dimension2d<s32>(size.Width > 1 ? size.Width >> 1 : 1,
+			size.Height > 1 ? size.Height >> 1 : 1);
+	}
+
+	//! Creates the next mip map level by averaging blocks of 2x2 pixels
+	/** The target has the size returned by getMipMapSize() and the format
+	of the source. An odd last row or column of the source is ignored.
+	\param source: Pixels of the source level.
+	\param sourceSize: Size of the source level.
+	\param sourcePitch: Bytes per row of the source.
+	\param target: Receives the pixels of the next level.
+	\param targetPitch: Bytes per row of the target.
+	\param format: Color format of both levels. */
+	static void createMipMap(const void* source, const core::dimension2d<s32>& sourceSize,
+		u32 sourcePitch, void* target, u32 targetPitch, ECOLOR_FORMAT format);
+
+	//! Creates the next mip map level of an image
+	/** The target must have the size returned by getMipMapSize() and the
+	color format of the source. */
+	static void createMipMap(IImage* source, IImage* target);
+
+	//! Scales pixels to an arbitrary size with a separable filter
+	/** Source and target may have different color formats. */
+	static void resize(const void* source, const core::dimension2d<s32>& sourceSize,
+		u32 sourcePitch, ECOLOR_FORMAT sourceFormat,
+		void* target, const core::dimension2d<s32>& targetSize,
+		u32 targetPitch, ECOLOR_FORMAT targetFormat, E_FILTER filter=EF_BILINEAR);
+
+	//! Scales an image to the size of the target image
+	static void resize(IImage* source, IImage* target, E_FILTER filter=EF_BILINEAR);
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -1622,6 +1622,9 @@ void CIrrDeviceLinux::pollJoysticks()
 
 IRRLICHT_API IrrlichtDevice* IRRCALLCONV createDeviceEx(const SIrrlichtCreationParameters& param)
 {
+	if (param.DeviceType == EIDT_OFFSCREEN)
+		return createOffscreenDevice(param);
+
 	CIrrDeviceLinux* dev = new CIrrDeviceLinux(param);
 
 	if (dev && !dev->getVideoDriver() && param.DriverType != video::EDT_NULL)
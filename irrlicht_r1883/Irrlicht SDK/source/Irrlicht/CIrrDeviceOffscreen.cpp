@@ -0,0 +1,233 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CIrrDeviceOffscreen.h"
+#include "IrrCompileConfig.h"
+#include "CImage.h"
+#include "CColorConverter.h"
+#include "os.h"
+
+#ifdef _IRR_WINDOWS_API_
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace irr
+{
+
+//! constructor
+CIrrDeviceOffscreen::CIrrDeviceOffscreen(const SIrrlichtCreationParameters& params)
+: CIrrDeviceStub(params), Frame(0), Close(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CIrrDeviceOffscreen");
+	#endif
+
+	createDriver();
+
+	if (VideoDriver)
+		createGUIAndScene();
+}
+
+
+//! destructor
+CIrrDeviceOffscreen::~CIrrDeviceOffscreen()
+{
+	if (Frame)
+		Frame->drop();
+}
+
+
+//! create the driver
+void CIrrDeviceOffscreen::createDriver()
+{
+	switch(CreationParams.DriverType)
+	{
+	case video::EDT_SOFTWARE:
+		#ifdef _IRR_COMPILE_WITH_SOFTWARE_
+		VideoDriver = video::createSoftwareDriver(CreationParams.WindowSize, false, FileSystem, this);
+		#else
+		os::Printer::log("No Software driver support compiled in.", ELL_ERROR);
+		#endif
+		break;
+
+	case video::EDT_BURNINGSVIDEO:
+		#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+		VideoDriver = video::createSoftwareDriver2(CreationParams.WindowSize, false, FileSystem, this);
+		#else
+		os::Printer::log("Burning's video driver was not compiled in.", ELL_ERROR);
+		#endif
+		break;
+
+	case video::EDT_NULL:
+		VideoDriver = video::createNullDriver(FileSystem, CreationParams.WindowSize);
+		break;
+
+	default:
+		os::Printer::log("The offscreen device supports only the software drivers and the null driver.", ELL_ERROR);
+		break;
+	}
+}
+
+
+//! runs the device. Returns false if device wants to be deleted
+bool CIrrDeviceOffscreen::run()
+{
+	os::Timer::tick();
+	return !Close;
+}
+
+
+//! Cause the device to temporarily pause execution and let other processes to run
+// This should bring down processor usage without major performance loss for Irrlicht
+void CIrrDeviceOffscreen::yield()
+{
+#ifdef _IRR_WINDOWS_API_
+	Sleep(1);
+#else
+	struct timespec ts = {0,0};
+	nanosleep(&ts, NULL);
+#endif
+}
+
+
+//! Pause execution and let other processes to run for a specified amount of time.
+void CIrrDeviceOffscreen::sleep(u32 timeMs, bool pauseTimer)
+{
+	const bool wasStopped = Timer ? Timer->isStopped() : true;
+
+	if (pauseTimer && !wasStopped)
+		Timer->stop();
+
+#ifdef _IRR_WINDOWS_API_
+	Sleep(timeMs);
+#else
+	struct timespec ts;
+	ts.tv_sec = (time_t) (timeMs / 1000);
+	ts.tv_nsec = (long) (timeMs % 1000) * 1000000;
+	nanosleep(&ts, NULL);
+#endif
+
+	if (pauseTimer && !wasStopped)
+		Timer->start();
+}
+
+
+//! sets the caption of the window
+void CIrrDeviceOffscreen::setWindowCaption(const wchar_t* text)
+{
+}
+
+
+//! returns if window is active. if not, nothing need to be drawn
+bool CIrrDeviceOffscreen::isWindowActive() const
+{
+	return true;
+}
+
+
+//! returns if window has focus.
+bool CIrrDeviceOffscreen::isWindowFocused() const
+{
+	return false;
+}
+
+
+//! returns if window is minimized.
+bool CIrrDeviceOffscreen::isWindowMinimized() const
+{
+	return false;
+}
+
+
+//! returns color format of the window.
+video::ECOLOR_FORMAT CIrrDeviceOffscreen::getColorFormat() const
+{
+	return video::ECF_A8R8G8B8;
+}
+
+
+//! presents a surface by copying it into the frame image
+bool CIrrDeviceOffscreen::present(video::IImage* surface, void* windowId, core::rect<s32>* src)
+{
+	// a grabbed frame is kept, the new one goes into another image
+	if (Frame && Frame->getReferenceCount() > 1)
+	{
+		Frame->drop();
+		Frame = 0;
+	}
+
+	if (!Frame)
+		Frame = new video::CImage(video::ECF_A8R8G8B8, CreationParams.WindowSize);
+
+	const core::dimension2d<s32>& size = Frame->getDimension();
+	const s32 width = core::min_(surface->getDimension().Width, size.Width);
+	const s32 height = core::min_(surface->getDimension().Height, size.Height);
+
+	const u8* srcData = (const u8*) surface->lock();
+	u8* destData = (u8*) Frame->lock();
+
+	for (s32 y=0; y<height; ++y)
+	{
+		video::CColorConverter::convert_viaFormat(srcData, surface->getColorFormat(),
+			width, destData, video::ECF_A8R8G8B8);
+
+		// like a window, the frame has no alpha channel
+		if (!CreationParams.WithAlphaChannel)
+		{
+			u32* p = (u32*) destData;
+			for (s32 x=0; x<width; ++x)
+				p[x] |= 0xFF000000;
+		}
+
+		srcData += surface->getPitch();
+		destData += Frame->getPitch();
+	}
+
+	Frame->unlock();
+	surface->unlock();
+
+	return true;
+}
+
+
+//! notifies the device that it should close itself
+void CIrrDeviceOffscreen::closeDevice()
+{
+	Close = true;
+}
+
+
+//! Sets if the window should be resizeable in windowed mode.
+void CIrrDeviceOffscreen::setResizeAble(bool resize)
+{
+}
+
+
+//! Returns the image the last frame was presented into
+video::IImage* CIrrDeviceOffscreen::getFrameImage()
+{
+	return Frame;
+}
+
+
+//! creates a device without a window
+IrrlichtDevice* createOffscreenDevice(const SIrrlichtCreationParameters& params)
+{
+	CIrrDeviceOffscreen* dev = new CIrrDeviceOffscreen(params);
+
+	if (dev && !dev->getVideoDriver() && params.DriverType != video::EDT_NULL)
+	{
+		dev->drop();
+		dev = 0;
+	}
+
+	return dev;
+}
+
+
+} // end namespace irr
+
@@ -0,0 +1,85 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IRR_DEVICE_OFFSCREEN_H_INCLUDED__
+#define __C_IRR_DEVICE_OFFSCREEN_H_INCLUDED__
+
+#include "CIrrDeviceStub.h"
+#include "IImagePresenter.h"
+
+namespace irr
+{
+namespace video
+{
+	class CImage;
+}
+
+	//! Device without a window, the software drivers present into an image
+	/** The device uses no display, so several devices can render on
+	different threads at the same time. Besides the logger and the timer of
+	the engine, the devices share the thread pool of CThreadPool::
+	createSharedPool(), which is used by the particle systems, the terrain,
+	the skinning and the rasterizer threads of Burning's Video. Its reference
+	count is guarded by a lock and batches from different threads run one
+	after another. Create and drop the devices one after another. */
+	class CIrrDeviceOffscreen : public CIrrDeviceStub, video::IImagePresenter
+	{
+	public:
+
+		//! constructor
+		CIrrDeviceOffscreen(const SIrrlichtCreationParameters& params);
+
+		//! destructor
+		virtual ~CIrrDeviceOffscreen();
+
+		//! runs the device. Returns false if device wants to be deleted
+		virtual bool run();
+
+		//! Cause the device to temporarily pause execution and let other processes to run
+		// This should bring down processor usage without major performance loss for Irrlicht
+		virtual void yield();
+
+		//! Pause execution and let other processes to run for a specified amount of time.
+		virtual void sleep(u32 timeMs, bool pauseTimer);
+
+		//! sets the caption of the window
+		virtual void setWindowCaption(const wchar_t* text);
+
+		//! returns if window is active. if not, nothing need to be drawn
+		virtual bool isWindowActive() const;
+
+		//! returns if window has focus.
+		virtual bool isWindowFocused() const;
+
+		//! returns if window is minimized.
+		virtual bool isWindowMinimized() const;
+
+		//! returns color format of the window.
+		virtual video::ECOLOR_FORMAT getColorFormat() const;
+
+		//! presents a surface by copying it into the frame image
+		virtual bool present(video::IImage* surface, void* windowId=0, core::rect<s32>* src=0);
+
+		//! notifies the device that it should close itself
+		virtual void closeDevice();
+
+		//! Sets if the window should be resizeable in windowed mode.
+		virtual void setResizeAble(bool resize=false);
+
+		//! Returns the image the last frame was presented into
+		virtual video::IImage* getFrameImage();
+
+	private:
+
+		//! create the driver
+		void createDriver();
+
+		video::CImage* Frame;
+		bool Close;
+	};
+
+} // end namespace irr
+
+#endif
+
@@ -794,6 +794,9 @@ void CIrrDeviceSDL::createKeyMap()
 
 IRRLICHT_API IrrlichtDevice* IRRCALLCONV createDeviceEx(const SIrrlichtCreationParameters& param)
 {
+	if (param.DeviceType == EIDT_OFFSCREEN)
+		return createOffscreenDevice(param);
+
 	CIrrDeviceSDL* dev = new CIrrDeviceSDL(param);
 
 	if (dev && !dev->getVideoDriver() && param.DriverType != video::EDT_NULL)
@@ -257,5 +257,12 @@ bool CIrrDeviceStub::activateJoysticks(core::array<SJoystickInfo> & joystickInfo
 	return false;
 }
 
+
+//! Devices with a window present the frames there
+video::IImage* CIrrDeviceStub::getFrameImage()
+{
+	return 0;
+}
+
 } // end namespace irr
 
@@ -34,6 +34,8 @@ namespace irr
 		IFileSystem* createFileSystem();
 	}
 
+	IrrlichtDevice* createOffscreenDevice(const SIrrlichtCreationParameters& params);
+
 	namespace video
 	{
 		IVideoDriver* createSoftwareDriver(const core::dimension2d<s32>& windowSize,
@@ -110,6 +112,9 @@ namespace irr
 		//! Activate any joysticks, and generate events for them.
 		virtual bool activateJoysticks(core::array<SJoystickInfo> & joystickInfo);
 
+		//! Returns the image an offscreen device renders into, 0 for devices with a window
+		virtual video::IImage* getFrameImage();
+
 	protected:
 
 		void createGUIAndScene();
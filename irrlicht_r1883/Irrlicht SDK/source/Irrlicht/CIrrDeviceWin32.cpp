@@ -1146,6 +1146,9 @@ void CIrrDeviceWin32::pollJoysticks()
 IRRLICHT_API IrrlichtDevice* IRRCALLCONV createDeviceEx(
 	const SIrrlichtCreationParameters& parameters)
 {
+	if (parameters.DeviceType == EIDT_OFFSCREEN)
+		return createOffscreenDevice(parameters);
+
 	CIrrDeviceWin32* dev = new CIrrDeviceWin32(parameters);
 
 	if (dev && !dev->getVideoDriver() && parameters.DriverType != video::EDT_NULL)
@@ -779,6 +779,9 @@ void CIrrDeviceWinCE::setResizeAble(bool resize)
 IRRLICHT_API IrrlichtDevice* IRRCALLCONV createDeviceEx(
 		const SIrrlichtCreationParameters& parameters)
 {
+	if (parameters.DeviceType == EIDT_OFFSCREEN)
+		return createOffscreenDevice(parameters);
+
 	CIrrDeviceWinCE* dev = new CIrrDeviceWinCE(parameters);
 
 	if (dev && !dev->getVideoDriver() && parameters.DriverType != video::EDT_NULL)
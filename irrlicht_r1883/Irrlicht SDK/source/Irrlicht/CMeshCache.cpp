@@ -23,12 +23,10 @@ void CMeshCache::addMesh(const c8* filename, IAnimatedMesh* mesh)
 {
 	mesh->grab();
 
-	MeshEntry e;
-	e.Mesh = mesh;
-	e.Name = filename;
-	e.Name.make_lower();
+	core::stringc name = filename;
+	name.make_lower();
 
-	Meshes.push_back(e);
+	Meshes.insert(name, mesh);
 }
 
 
@@ -37,15 +35,9 @@ void CMeshCache::removeMesh(const IAnimatedMesh* const mesh)
 {
 	if ( !mesh )
 		return;
-	for (u32 i=0; i<Meshes.size(); ++i)
-	{
-		if (Meshes[i].Mesh == mesh)
-		{
-			Meshes[i].Mesh->drop();
-			Meshes.erase(i);
-			return;
-		}
-	}
+
+	if (Meshes.remove(mesh))
+		mesh->drop();
 }
 
 
@@ -56,10 +48,11 @@ void CMeshCache::removeMesh(const IMesh* const mesh)
 		return;
 	for (u32 i=0; i<Meshes.size(); ++i)
 	{
-		if (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh)
+		IAnimatedMesh* amesh = Meshes.getObject(i);
+		if (amesh->getMesh(0) == mesh)
 		{
-			Meshes[i].Mesh->drop();
-			Meshes.erase(i);
+			Meshes.remove(amesh);
+			amesh->drop();
 			return;
 		}
 	}
@@ -76,11 +69,7 @@ u32 CMeshCache::getMeshCount() const
 //! Returns current number of the mesh
 s32 CMeshCache::getMeshIndex(const IAnimatedMesh* const mesh) const
 {
-	for (u32 i=0; i<Meshes.size(); ++i)
-		if (Meshes[i].Mesh == mesh)
-			return (s32)i;
-
-	return -1;
+	return Meshes.getIndex(mesh);
 }
 
 
@@ -90,8 +79,9 @@ s32 CMeshCache::getMeshIndex(const IMesh* const mesh) const
 {
 	for (u32 i=0; i<Meshes.size(); ++i)
 	{
-		if (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh)
-			return (s32)i;
+		IAnimatedMesh* amesh = Meshes.getObject(i);
+		if (amesh->getMesh(0) == mesh)
+			return Meshes.getIndex(amesh);
 	}
 
 	return -1;
@@ -104,18 +94,16 @@ IAnimatedMesh* CMeshCache::getMeshByIndex(u32 number)
 	if (number >= Meshes.size())
 		return 0;
 
-	return Meshes[number].Mesh;
+	return Meshes.getByIndex(number);
 }
 
 
 //! Returns a mesh based on its file name.
 IAnimatedMesh* CMeshCache::getMeshByFilename(const c8* filename)
 {
-	MeshEntry e;
-	e.Name = filename;
-	e.Name.make_lower();
-	s32 id = Meshes.binary_search(e);
-	return (id != -1) ? Meshes[id].Mesh : 0;
+	core::stringc name = filename;
+	name.make_lower();
+	return Meshes.find(name.c_str());
 }
 
 
@@ -125,7 +113,7 @@ const c8* CMeshCache::getMeshFilename(u32 number) const
 	if (number >= Meshes.size())
 		return 0;
 
-	return Meshes[number].Name.c_str();
+	return Meshes.getNameByIndex(number).c_str();
 }
 
 
@@ -136,13 +124,8 @@ const c8* CMeshCache::getMeshFilename(const IAnimatedMesh* const mesh) const
 	if(!mesh)
 		return 0;
 
-	for (u32 i=0; i<Meshes.size(); ++i)
-	{
-		if (Meshes[i].Mesh == mesh)
-			return Meshes[i].Name.c_str();
-	}
-
-	return 0;
+	const core::stringc* name = Meshes.getName(mesh);
+	return name ? name->c_str() : 0;
 }
 
 
@@ -156,8 +139,9 @@ const c8* CMeshCache::getMeshFilename(const IMesh* const mesh) const
 	{
 		// IMesh may actually be an IAnimatedMesh, so do a direct comparison
 		// as well as getting an IMesh from our stored IAnimatedMeshes
-		if (Meshes[i].Mesh && (Meshes[i].Mesh == mesh || Meshes[i].Mesh->getMesh(0) == mesh))
-			return Meshes[i].Name.c_str(); 
+		IAnimatedMesh* amesh = Meshes.getObject(i);
+		if (amesh == mesh || amesh->getMesh(0) == mesh)
+			return Meshes.getName(amesh)->c_str();
 	}
 
 	return 0;
@@ -171,26 +155,14 @@ bool CMeshCache::setMeshFilename(u32 index, const c8* filename)
 	if (index >= Meshes.size())
 		return false;
 
-	Meshes[index].Name = filename;
-	Meshes.sort();
-	return true;
+	return Meshes.rename(Meshes.getByIndex(index), filename);
 }
 
 
 //! Renames a loaded mesh, if possible.
 bool CMeshCache::setMeshFilename(const IAnimatedMesh* const mesh, const c8* filename)
 {
-	for (u32 i=0; i<Meshes.size(); ++i)
-	{
-		if (Meshes[i].Mesh == mesh)
-		{
-			Meshes[i].Name = filename;
-			Meshes.sort();
-			return true;
-		}
-	}
-
-	return false;
+	return Meshes.rename(const_cast<IAnimatedMesh*>(mesh), filename);
 }
 
 
@@ -199,12 +171,9 @@ bool CMeshCache::setMeshFilename(const IMesh* const mesh, const c8* filename)
 {
 	for (u32 i=0; i<Meshes.size(); ++i)
 	{
-		if (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh)
-		{
-			Meshes[i].Name = filename;
-			Meshes.sort();
-			return true;
-		}
+		IAnimatedMesh* amesh = Meshes.getObject(i);
+		if (amesh->getMesh(0) == mesh)
+			return Meshes.rename(amesh, filename);
 	}
 
 	return false;
@@ -222,7 +191,7 @@ bool CMeshCache::isMeshLoaded(const c8* filename)
 void CMeshCache::clear()
 {
 	for (u32 i=0; i<Meshes.size(); ++i)
-		Meshes[i].Mesh->drop();
+		Meshes.getObject(i)->drop();
 
 	Meshes.clear();
 }
@@ -230,13 +199,14 @@ void CMeshCache::clear()
 //! Clears all meshes that are held in the mesh cache but not used anywhere else.
 void CMeshCache::clearUnusedMeshes()
 {
-	for (u32 i=0; i<Meshes.size(); ++i)
+	// backwards, removing an entry moves the last one into its place
+	for (u32 i=Meshes.size(); i>0; --i)
 	{
-		if (Meshes[i].Mesh->getReferenceCount() == 1)
+		IAnimatedMesh* mesh = Meshes.getObject(i-1);
+		if (mesh->getReferenceCount() == 1)
 		{
-			Meshes[i].Mesh->drop();
-			Meshes.erase(i);
-			--i;
+			Meshes.remove(mesh);
+			mesh->drop();
 		}
 	}
 }
@@ -6,7 +6,7 @@
 #define __C_MESH_CACHE_H_INCLUDED__
 
 #include "IMeshCache.h"
-#include "irrArray.h"
+#include "CNameHashTable.h"
 
 namespace irr
 {
@@ -97,19 +97,8 @@ namespace scene
 
 	protected:
 
-		struct MeshEntry
-		{
-			core::stringc Name;
-			IAnimatedMesh* Mesh;
-
-			bool operator < (const MeshEntry& other) const
-			{
-				return (Name < other.Name);
-			}
-		};
-
-		//! loaded meshes
-		core::array<MeshEntry> Meshes;
+		//! loaded meshes by name and by pointer, indices are in the order of the names
+		CNameHashTable<IAnimatedMesh> Meshes;
 	};
 
 
@@ -5,6 +5,7 @@
 #include "CMeshManipulator.h"
 #include "SMesh.h"
 #include "CMeshBuffer.h"
+#include "CDynamicMeshBuffer.h"
 #include "SAnimatedMesh.h"
 #include "os.h"
 
@@ -543,170 +544,771 @@ IMesh* CMeshManipulator::createMeshUniquePrimitives(IMesh* mesh) const
 	return clone;
 }
 
+//! returns true if no color channel differs by more than tolerance
+static inline bool weldColorEquals(const video::SColor& a, const video::SColor& b, u32 tolerance)
+{
+	if (!tolerance)
+		return a == b;
+
+	const s32 t = (s32) tolerance;
+	return core::abs_((s32) a.getAlpha() - (s32) b.getAlpha()) <= t &&
+		core::abs_((s32) a.getRed() - (s32) b.getRed()) <= t &&
+		core::abs_((s32) a.getGreen() - (s32) b.getGreen()) <= t &&
+		core::abs_((s32) a.getBlue() - (s32) b.getBlue()) <= t;
+}
+
+
+//! returns true if two vertices can be welded
+static inline bool weldEquals(const video::S3DVertex& a, const video::S3DVertex& b,
+		f32 tolerance, u32 colorTolerance)
+{
+	return a.Pos.equals(b.Pos, tolerance) &&
+		a.Normal.equals(b.Normal, tolerance) &&
+		core::equals(a.TCoords.X, b.TCoords.X, tolerance) &&
+		core::equals(a.TCoords.Y, b.TCoords.Y, tolerance) &&
+		weldColorEquals(a.Color, b.Color, colorTolerance);
+}
+
+
+//! returns true if two vertices can be welded
+static inline bool weldEquals(const video::S3DVertex2TCoords& a, const video::S3DVertex2TCoords& b,
+		f32 tolerance, u32 colorTolerance)
+{
+	return weldEquals((const video::S3DVertex&) a, (const video::S3DVertex&) b, tolerance, colorTolerance) &&
+		core::equals(a.TCoords2.X, b.TCoords2.X, tolerance) &&
+		core::equals(a.TCoords2.Y, b.TCoords2.Y, tolerance);
+}
+
+
+//! returns true if two vertices can be welded
+static inline bool weldEquals(const video::S3DVertexTangents& a, const video::S3DVertexTangents& b,
+		f32 tolerance, u32 colorTolerance)
+{
+	return weldEquals((const video::S3DVertex&) a, (const video::S3DVertex&) b, tolerance, colorTolerance) &&
+		a.Tangent.equals(b.Tangent, tolerance) &&
+		a.Binormal.equals(b.Binormal, tolerance);
+}
+
+
+//! returns the cell of a coordinate in the welding grid
+static inline u32 weldCell(f32 x, f32 minimum, f32 invCellSize)
+{
+	const f32 cell = (x - minimum) * invCellSize;
+
+	// also catches NaN
+	if (!(cell > 0.f))
+		return 0;
+
+	return cell < (f32) (1<<22) ? (u32) cell : (1<<22);
+}
+
+
+//! returns the bucket of a grid cell
+static inline u32 weldBucket(u32 x, u32 y, u32 z, u32 mask)
+{
+	return ((x * 73856093u) ^ (y * 19349663u) ^ (z * 83492791u)) & mask;
+}
+
+
+//! Finds the vertices of a buffer which can be welded
+/** The positions are quantized into a grid with cells at least as large as the
+tolerance, and the vertices kept are hashed by their cell. A vertex is only
+compared with the vertices kept in the cells within tolerance of it, which
+are up to 3 cells along each axis, so up to 27 cells.
+\param redirects: Receives the index of the kept vertex for each vertex.
+\param kept: Receives the indices of the vertices kept. */
+template <class T>
+static void weldVertices(const T* v, u32 vertexCount, f32 tolerance, u32 colorTolerance,
+		core::array<u32>& redirects, core::array<u32>& kept)
+{
+	redirects.set_used(vertexCount);
+	kept.set_used(0);
+
+	if (!vertexCount)
+		return;
+
+	core::aabbox3df box(v[0].Pos);
+	u32 i;
+	for (i=1; i<vertexCount; ++i)
+		box.addInternalPoint(v[i].Pos);
+
+	// the grid is limited to 2^20 cells along the largest side of the box
+	const core::vector3df extent = box.getExtent();
+	const f32 cellSize = core::max_(tolerance, core::ROUNDING_ERROR_32,
+		core::max_(extent.X, extent.Y, extent.Z) / (f32) (1<<20));
+	const f32 invCellSize = 1.f / cellSize;
+
+	u32 bucketCount = 2;
+	while (bucketCount < vertexCount * 2)
+		bucketCount <<= 1;
+	const u32 mask = bucketCount - 1;
+
+	// chains of kept vertices, indexed by bucket and by the welded index
+	core::array<u32> buckets;
+	buckets.set_used(bucketCount);
+	for (i=0; i<bucketCount; ++i)
+		buckets[i] = 0xFFFFFFFF;
+
+	core::array<u32> chain;
+	chain.reallocate(vertexCount);
+	kept.reallocate(vertexCount);
+
+	const core::vector3df& m = box.MinEdge;
+
+	for (i=0; i<vertexCount; ++i)
+	{
+		const core::vector3df& p = v[i].Pos;
+
+		const u32 x0 = weldCell(p.X - tolerance, m.X, invCellSize);
+		const u32 x1 = weldCell(p.X + tolerance, m.X, invCellSize);
+		const u32 y0 = weldCell(p.Y - tolerance, m.Y, invCellSize);
+		const u32 y1 = weldCell(p.Y + tolerance, m.Y, invCellSize);
+		const u32 z0 = weldCell(p.Z - tolerance, m.Z, invCellSize);
+		const u32 z1 = weldCell(p.Z + tolerance, m.Z, invCellSize);
+
+		// prefer the vertex kept first, so the result does not depend on the hashing
+		u32 found = 0xFFFFFFFF;
+		for (u32 z=z0; z<=z1; ++z)
+			for (u32 y=y0; y<=y1; ++y)
+				for (u32 x=x0; x<=x1; ++x)
+				{
+					for (u32 k=buckets[weldBucket(x, y, z, mask)]; k!=0xFFFFFFFF; k=chain[k])
+					{
+						if (k < found && weldEquals(v[i], v[kept[k]], tolerance, colorTolerance))
+							found = k;
+					}
+				}
+
+		if (found != 0xFFFFFFFF)
+		{
+			redirects[i] = found;
+			continue;
+		}
+
+		const u32 bucket = weldBucket(weldCell(p.X, m.X, invCellSize),
+			weldCell(p.Y, m.Y, invCellSize), weldCell(p.Z, m.Z, invCellSize), mask);
+
+		redirects[i] = kept.size();
+		chain.push_back(buckets[bucket]);
+		buckets[bucket] = kept.size();
+		kept.push_back(i);
+	}
+}
+
+
+//! Copies the kept vertices and the redirected 16 bit indices into a buffer
+template <class TBuffer, class TVertex>
+static void copyWelded(TBuffer* buffer, const TVertex* v, const u16* indices, u32 indexCount,
+		const core::array<u32>& redirects, const core::array<u32>& kept)
+{
+	u32 i;
+
+	buffer->Vertices.set_used(kept.size());
+	for (i=0; i<kept.size(); ++i)
+		buffer->Vertices[i] = v[kept[i]];
+
+	buffer->Indices.set_used(indexCount);
+	for (i=0; i<indexCount; ++i)
+		buffer->Indices[i] = (u16) redirects[indices[i]];
+}
+
+
 //! Creates a copy of a mesh, which will have identical vertices welded together
-IMesh* CMeshManipulator::createMeshWelded(IMesh *mesh, f32 tolerance) const
+IMesh* CMeshManipulator::createMeshWelded(IMesh *mesh, f32 tolerance, u32 colorTolerance, u32* weldedCount) const
 {
+	if (weldedCount)
+		*weldedCount = 0;
+
+	if (!mesh)
+		return 0;
+
 	SMesh* clone = new SMesh();
 	clone->BoundingBox = mesh->getBoundingBox();
 
-	core::array<u16> redirects;
+	core::array<u32> redirects;
+	core::array<u32> kept;
 
 	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
 	{
-		// reset redirect list
-		redirects.set_used(mesh->getMeshBuffer(b)->getVertexCount());
+		const IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		const video::E_VERTEX_TYPE vertexType = mb->getVertexType();
+		const void* vertices = mb->getVertices();
+		const u32 vertexCount = mb->getVertexCount();
+		const u32 indexCount = mb->getIndexCount();
+
+		switch(vertexType)
+		{
+		case video::EVT_STANDARD:
+			weldVertices((const video::S3DVertex*) vertices, vertexCount,
+				tolerance, colorTolerance, redirects, kept);
+			break;
+		case video::EVT_2TCOORDS:
+			weldVertices((const video::S3DVertex2TCoords*) vertices, vertexCount,
+				tolerance, colorTolerance, redirects, kept);
+			break;
+		case video::EVT_TANGENTS:
+			weldVertices((const video::S3DVertexTangents*) vertices, vertexCount,
+				tolerance, colorTolerance, redirects, kept);
+			break;
+		default:
+			os::Printer::log("Cannot create welded mesh, vertex type unsupported", ELL_ERROR);
+			continue;
+		}
 
-		u16* indices = 0;
-		u32 indexCount = 0;
-		core::array<u16>* outIdx = 0;
+		if (weldedCount)
+			*weldedCount += vertexCount - kept.size();
 
-		switch(mesh->getMeshBuffer(b)->getVertexType())
+		// 32 bit indices are kept, the welded buffer may still need them
+		if (mb->getIndexType() == video::EIT_32BIT)
+		{
+			CDynamicMeshBuffer* buffer = new CDynamicMeshBuffer(vertexType, video::EIT_32BIT);
+			buffer->BoundingBox = mb->getBoundingBox();
+			buffer->Material = mb->getMaterial();
+
+			const u32 pitch = video::getVertexPitchFromType(vertexType);
+			IVertexBuffer& vb = buffer->getVertexBuffer();
+			vb.reallocate(kept.size());
+			u32 i;
+			for (i=0; i<kept.size(); ++i)
+				vb.push_back(*(const video::S3DVertex*) ((const u8*) vertices + kept[i] * pitch));
+
+			IIndexBuffer& ib = buffer->getIndexBuffer();
+			ib.set_used(indexCount);
+			const u32* indices = (const u32*) mb->getIndices();
+			u32* outIndices = (u32*) ib.pointer();
+			for (i=0; i<indexCount; ++i)
+				outIndices[i] = redirects[indices[i]];
+
+			clone->addMeshBuffer(buffer);
+			buffer->drop();
+			continue;
+		}
+
+		switch(vertexType)
 		{
 		case video::EVT_STANDARD:
 		{
 			SMeshBuffer* buffer = new SMeshBuffer();
-			buffer->BoundingBox = mesh->getMeshBuffer(b)->getBoundingBox();
-			buffer->Material = mesh->getMeshBuffer(b)->getMaterial();
+			buffer->BoundingBox = mb->getBoundingBox();
+			buffer->Material = mb->getMaterial();
+			copyWelded(buffer, (const video::S3DVertex*) vertices,
+				mb->getIndices(), indexCount, redirects, kept);
+			clone->addMeshBuffer(buffer);
+			buffer->drop();
+			break;
+		}
+		case video::EVT_2TCOORDS:
+		{
+			SMeshBufferLightMap* buffer = new SMeshBufferLightMap();
+			buffer->BoundingBox = mb->getBoundingBox();
+			buffer->Material = mb->getMaterial();
+			copyWelded(buffer, (const video::S3DVertex2TCoords*) vertices,
+				mb->getIndices(), indexCount, redirects, kept);
 			clone->addMeshBuffer(buffer);
 			buffer->drop();
+			break;
+		}
+		case video::EVT_TANGENTS:
+		{
+			SMeshBufferTangents* buffer = new SMeshBufferTangents();
+			buffer->BoundingBox = mb->getBoundingBox();
+			buffer->Material = mb->getMaterial();
+			copyWelded(buffer, (const video::S3DVertexTangents*) vertices,
+				mb->getIndices(), indexCount, redirects, kept);
+			clone->addMeshBuffer(buffer);
+			buffer->drop();
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	return clone;
+}
 
-			video::S3DVertex* v =
-					(video::S3DVertex*)mesh->getMeshBuffer(b)->getVertices();
 
-			u32 vertexCount = mesh->getMeshBuffer(b)->getVertexCount();
+//! size of the cache simulated by the vertex cache optimizer
+const u32 VERTEX_CACHE_OPTIMIZE_SIZE = 32;
+
+//! largest valence scored by the vertex cache optimizer, higher ones score the same
+const u32 VERTEX_CACHE_MAX_VALENCE = 32;
+
+//! size of the FIFO cache used to check that an optimized order is better
+const u32 VERTEX_CACHE_FIFO_SIZE = 16;
+
+
+//! Scores of the vertices by cache position and by valence
+/** The weights are the ones from Tom Forsyth's "Linear-Speed Vertex Cache
+Optimisation": the vertices of the last triangle score the same, older ones
+less, and vertices with few remaining triangles score higher so that they
+are finished before they leave the cache. */
+struct SVertexCacheScores
+{
+	SVertexCacheScores()
+	{
+		u32 i;
+		for (i=0; i<VERTEX_CACHE_OPTIMIZE_SIZE; ++i)
+		{
+			if (i < 3)
+				Position[i] = 0.75f;
+			else
+				Position[i] = powf(1.f - (f32) (i - 3) / (f32) (VERTEX_CACHE_OPTIMIZE_SIZE - 3), 1.5f);
+		}
+
+		Valence[0] = 0.f;
+		for (i=1; i<=VERTEX_CACHE_MAX_VALENCE; ++i)
+			Valence[i] = 2.f / sqrtf((f32) i);
+	}
+
+	//! returns the score of a vertex, -1 if it has no triangles left
+	f32 get(s32 position, u32 valence) const
+	{
+		if (!valence)
+			return -1.f;
+
+		const f32 s = Valence[core::min_(valence, VERTEX_CACHE_MAX_VALENCE)];
+		return position < 0 ? s : s + Position[position];
+	}
+
+	f32 Position[VERTEX_CACHE_OPTIMIZE_SIZE];
+	f32 Valence[VERTEX_CACHE_MAX_VALENCE + 1];
+};
+
+
+//! Reorders triangles for the post transform vertex cache
+/** Greedily emits the triangle with the highest score among the triangles of
+the vertices in a simulated LRU cache, so this is linear in the triangle count.
+\param indices: Indices of a triangle list, reordered in place.
+\param hardBoundaries: If not 0, receives the first triangle of each run
+started without any vertex in the cache. */
+static void optimizeTriangleOrder(core::array<u32>& indices, u32 vertexCount,
+		core::array<u32>* hardBoundaries)
+{
+	static const SVertexCacheScores scores;
+
+	const u32 triangleCount = indices.size() / 3;
+	if (!triangleCount)
+		return;
+
+	u32 i, j;
+
+	// triangles of each vertex, the remaining ones are kept at the start of each list
+	core::array<u32> valence;
+	valence.set_used(vertexCount);
+	for (i=0; i<vertexCount; ++i)
+		valence[i] = 0;
+	for (i=0; i<triangleCount * 3; ++i)
+		++valence[indices[i]];
+
+	core::array<u32> offsets;
+	offsets.set_used(vertexCount);
+	u32 offset = 0;
+	for (i=0; i<vertexCount; ++i)
+	{
+		offsets[i] = offset;
+		offset += valence[i];
+		valence[i] = 0;
+	}
+
+	core::array<u32> adjacency;
+	adjacency.set_used(triangleCount * 3);
+	for (i=0; i<triangleCount * 3; ++i)
+	{
+		const u32 v = indices[i];
+		adjacency[offsets[v] + valence[v]++] = i / 3;
+	}
+
+	core::array<s32> cachePosition;
+	core::array<f32> vertexScore;
+	cachePosition.set_used(vertexCount);
+	vertexScore.set_used(vertexCount);
+	for (i=0; i<vertexCount; ++i)
+	{
+		cachePosition[i] = -1;
+		vertexScore[i] = scores.get(-1, valence[i]);
+	}
+
+	core::array<bool> emitted;
+	emitted.set_used(triangleCount);
+	for (i=0; i<triangleCount; ++i)
+		emitted[i] = false;
 
-			indices = mesh->getMeshBuffer(b)->getIndices();
-			indexCount = mesh->getMeshBuffer(b)->getIndexCount();
-			outIdx = &buffer->Indices;
+	core::array<u32> result;
+	result.reallocate(triangleCount * 3);
 
-			buffer->Vertices.reallocate(vertexCount);
+	u32 cache[VERTEX_CACHE_OPTIMIZE_SIZE + 3];
+	u32 newCache[VERTEX_CACHE_OPTIMIZE_SIZE + 3];
+	u32 cacheCount = 0;
 
-			for (u32 i=0; i < vertexCount; ++i)
+	u32 best = 0xFFFFFFFF;
+	u32 nextUnused = 0;
+
+	if (hardBoundaries)
+		hardBoundaries->set_used(0);
+
+	for (u32 n=0; n<triangleCount; ++n)
+	{
+		// dead end, continue with the next triangle in the original order
+		if (best == 0xFFFFFFFF)
+		{
+			while (emitted[nextUnused])
+				++nextUnused;
+			best = nextUnused;
+
+			if (hardBoundaries)
+				hardBoundaries->push_back(n);
+		}
+
+		emitted[best] = true;
+		const u32* tri = indices.const_pointer() + best * 3;
+
+		u32 newCount = 0;
+		for (j=0; j<3; ++j)
+		{
+			const u32 v = tri[j];
+			result.push_back(v);
+
+			// remove the triangle from the remaining ones of the vertex
+			const u32 first = offsets[v];
+			const u32 last = first + --valence[v];
+			for (u32 k=first; k<last; ++k)
 			{
-				bool found = false;
-				for (u32 j=0; j < i; ++j)
+				if (adjacency[k] == best)
 				{
-					if ( v[i].Pos.equals( v[j].Pos, tolerance) &&
-						 v[i].Normal.equals( v[j].Normal, tolerance) &&
-						 v[i].TCoords.equals( v[j].TCoords ) &&
-						(v[i].Color == v[j].Color) )
-					{
-						redirects[i] = redirects[j];
-						found = true;
-						break;
-					}
+					adjacency[k] = adjacency[last];
+					adjacency[last] = best;
+					break;
 				}
-				if (!found)
+			}
+
+			newCache[newCount++] = v;
+		}
+
+		// the vertices of the triangle move to the front of the cache
+		for (j=0; j<cacheCount; ++j)
+		{
+			const u32 v = cache[j];
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newCache[newCount++] = v;
+		}
+
+		for (j=0; j<newCount; ++j)
+		{
+			const u32 v = newCache[j];
+			cachePosition[v] = j < VERTEX_CACHE_OPTIMIZE_SIZE ? (s32) j : -1;
+			vertexScore[v] = scores.get(cachePosition[v], valence[v]);
+		}
+
+		cacheCount = core::min_(newCount, VERTEX_CACHE_OPTIMIZE_SIZE);
+		memcpy(cache, newCache, cacheCount * sizeof(u32));
+
+		// the next triangle is the best one using a cached vertex
+		best = 0xFFFFFFFF;
+		f32 bestScore = -1.f;
+		for (j=0; j<cacheCount; ++j)
+		{
+			const u32 v = cache[j];
+			const u32 first = offsets[v];
+			const u32 last = first + valence[v];
+			for (u32 k=first; k<last; ++k)
+			{
+				const u32* t = indices.const_pointer() + adjacency[k] * 3;
+				const f32 score = vertexScore[t[0]] + vertexScore[t[1]] + vertexScore[t[2]];
+				if (score > bestScore)
 				{
-					redirects[i] = buffer->Vertices.size();
-					buffer->Vertices.push_back(v[i]);
+					bestScore = score;
+					best = adjacency[k];
 				}
 			}
-			
-			break;
 		}
-		case video::EVT_2TCOORDS:
+	}
+
+	indices = result;
+}
+
+
+//! Returns the vertices transformed by a FIFO cache for some triangles of an index list
+static u32 countCacheMisses(const u32* indices, u32 indexCount, u32 cacheSize,
+		core::array<u32>& timestamps, u32& time)
+{
+	u32 misses = 0;
+	for (u32 i=0; i<indexCount; ++i)
+	{
+		u32& stamp = timestamps[indices[i]];
+		if (time - stamp > cacheSize)
 		{
-			SMeshBufferLightMap* buffer = new SMeshBufferLightMap();
-			buffer->BoundingBox = mesh->getMeshBuffer(b)->getBoundingBox();
-			buffer->Material = mesh->getMeshBuffer(b)->getMaterial();
-			clone->addMeshBuffer(buffer);
-			buffer->drop();
+			stamp = time++;
+			++misses;
+		}
+	}
+	return misses;
+}
+
+
+//! Returns the vertices transformed by a FIFO cache for a whole index list
+static u32 countCacheMisses(const core::array<u32>& indices, u32 vertexCount, u32 cacheSize,
+		core::array<u32>& timestamps)
+{
+	timestamps.set_used(vertexCount);
+	for (u32 i=0; i<vertexCount; ++i)
+		timestamps[i] = 0;
+	u32 time = cacheSize + 1;
+
+	return countCacheMisses(indices.const_pointer(), indices.size(), cacheSize, timestamps, time);
+}
 
-			video::S3DVertex2TCoords* v =
-					(video::S3DVertex2TCoords*)mesh->getMeshBuffer(b)->getVertices();
 
-			u32 vertexCount = mesh->getMeshBuffer(b)->getVertexCount();
+//! cluster of triangles reordered for less overdraw
+struct SOverdrawCluster
+{
+	u32 Start;
+	u32 End;
+	f32 Key;
 
-			indices = mesh->getMeshBuffer(b)->getIndices();
-			indexCount = mesh->getMeshBuffer(b)->getIndexCount();
-			outIdx = &buffer->Indices;
+	//! clusters facing outward most come first
+	bool operator<(const SOverdrawCluster& other) const
+	{
+		return Key > other.Key;
+	}
+};
+
+
+//! Reorders clusters of triangles so that triangles facing outward are drawn first
+/** The cache optimized order is split at the hard boundaries, and where the
+cache miss ratio of a cluster has reached the one of its run, as described in
+"Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" by Sander,
+Nehab and Barczak. The clusters are sorted by how much they face away from the
+center of the buffer, which is a good guess for an order with less overdraw
+from most directions. */
+static void optimizeOverdraw(core::array<u32>& indices, const IMeshBuffer* mb,
+		const core::array<u32>& hardBoundaries, u32 cacheSize)
+{
+	const u32 triangleCount = indices.size() / 3;
+	if (triangleCount < 2)
+		return;
 
-			buffer->Vertices.reallocate(vertexCount);
+	u32 i;
+
+	core::array<u32> timestamps;
+	timestamps.set_used(mb->getVertexCount());
+	for (i=0; i<timestamps.size(); ++i)
+		timestamps[i] = 0;
+	u32 time = cacheSize + 1;
 
-			for (u32 i=0; i < vertexCount; ++i)
+	core::array<u32> boundaries;
+	for (u32 h=0; h<hardBoundaries.size(); ++h)
+	{
+		const u32 start = hardBoundaries[h];
+		const u32 end = h + 1 < hardBoundaries.size() ? hardBoundaries[h+1] : triangleCount;
+
+		// a cluster ends when its ratio is within 5% of the one of the whole run
+		const f32 threshold = 1.05f * (f32) countCacheMisses(indices.const_pointer() + start * 3,
+			(end - start) * 3, cacheSize, timestamps, time) / (f32) (end - start);
+		time += cacheSize + 1;
+
+		boundaries.push_back(start);
+		u32 misses = 0;
+		u32 first = start;
+		for (i=start; i<end; ++i)
+		{
+			misses += countCacheMisses(indices.const_pointer() + i * 3, 3, cacheSize, timestamps, time);
+			if (i + 1 < end && (f32) misses <= threshold * (f32) (i + 1 - first))
 			{
-				bool found = false;
-				for (u32 j=0; j < i; ++j)
-				{
-					if ( v[i].Pos.equals( v[j].Pos, tolerance) &&
-						 v[i].Normal.equals( v[j].Normal, tolerance) &&
-						 v[i].TCoords.equals( v[j].TCoords ) &&
-						 v[i].TCoords2.equals( v[j].TCoords2 ) &&
-						(v[i].Color == v[j].Color) )
-					{
-						redirects[i] = redirects[j];
-						found = true;
-						break;
-					}
-				}
-				if (!found)
-				{
-					redirects[i] = buffer->Vertices.size();
-					buffer->Vertices.push_back(v[i]);
-				}
+				boundaries.push_back(i + 1);
+				time += cacheSize + 1;
+				misses = 0;
+				first = i + 1;
 			}
-			break;
 		}
-		case video::EVT_TANGENTS:
+	}
+
+	if (boundaries.size() < 2)
+		return;
+
+	core::vector3df center(0.f, 0.f, 0.f);
+	for (i=0; i<indices.size(); ++i)
+		center += mb->getPosition(indices[i]);
+	center /= (f32) indices.size();
+
+	// pushed one by one, an array resized with set_used() would not be sorted
+	core::array<SOverdrawCluster> clusters;
+	clusters.reallocate(boundaries.size());
+	for (u32 c=0; c<boundaries.size(); ++c)
+	{
+		SOverdrawCluster cluster;
+		cluster.Start = boundaries[c];
+		cluster.End = c + 1 < boundaries.size() ? boundaries[c+1] : triangleCount;
+
+		// centroid and area weighted normal of the cluster
+		core::vector3df centroid(0.f, 0.f, 0.f);
+		core::vector3df normal(0.f, 0.f, 0.f);
+		for (i=cluster.Start; i<cluster.End; ++i)
 		{
-			SMeshBufferTangents* buffer = new SMeshBufferTangents();
-			buffer->BoundingBox = mesh->getMeshBuffer(b)->getBoundingBox();
-			buffer->Material = mesh->getMeshBuffer(b)->getMaterial();
-			clone->addMeshBuffer(buffer);
-			buffer->drop();
+			const core::vector3df& a = mb->getPosition(indices[i*3]);
+			const core::vector3df& b = mb->getPosition(indices[i*3+1]);
+			const core::vector3df& d = mb->getPosition(indices[i*3+2]);
+			centroid += a + b + d;
+			normal += (b - a).crossProduct(d - a);
+		}
+		centroid /= (f32) ((cluster.End - cluster.Start) * 3);
+		normal.normalize();
 
-			video::S3DVertexTangents* v =
-					(video::S3DVertexTangents*)mesh->getMeshBuffer(b)->getVertices();
+		cluster.Key = (centroid - center).dotProduct(normal);
+		clusters.push_back(cluster);
+	}
+
+	clusters.sort();
+
+	core::array<u32> result;
+	result.reallocate(indices.size());
+	for (u32 c=0; c<clusters.size(); ++c)
+		for (i=clusters[c].Start * 3; i<clusters[c].End * 3; ++i)
+			result.push_back(indices[i]);
+
+	indices = result;
+}
+
+
+//! Reorders the triangles and vertices of a mesh for the vertex cache
+void CMeshManipulator::optimizeVertexCache(IMesh* mesh, bool reorderVertices,
+		bool reduceOverdraw, f32* acmrBefore, f32* acmrAfter) const
+{
+	if (acmrBefore)
+		*acmrBefore = getAverageCacheMissRatio(mesh);
+
+	if (!mesh)
+		return;
+
+	core::array<u32> indices;
+	core::array<u32> hardBoundaries;
+	core::array<u32> remap;
+	core::array<u32> timestamps;
+	core::array<u8> vertices;
+
+	const u32 bcount = mesh->getMeshBufferCount();
+	for (u32 b=0; b<bcount; ++b)
+	{
+		IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		const u32 vertexCount = mb->getVertexCount();
+		const u32 indexCount = mb->getIndexCount() - mb->getIndexCount() % 3;
+		const bool is32Bit = mb->getIndexType() == video::EIT_32BIT;
+
+		if (indexCount < 6)
+			continue;
+
+		u32 i;
+		indices.set_used(indexCount);
+		if (is32Bit)
+			memcpy(indices.pointer(), mb->getIndices(), indexCount * sizeof(u32));
+		else
+		{
+			const u16* idx = mb->getIndices();
+			for (i=0; i<indexCount; ++i)
+				indices[i] = idx[i];
+		}
+
+		// leave buffers with broken indices alone
+		for (i=0; i<indexCount; ++i)
+			if (indices[i] >= vertexCount)
+				break;
+		if (i != indexCount)
+			continue;
 
-			u32 vertexCount = mesh->getMeshBuffer(b)->getVertexCount();
+		const u32 missesBefore = countCacheMisses(indices, vertexCount, VERTEX_CACHE_FIFO_SIZE, timestamps);
 
-			indices = mesh->getMeshBuffer(b)->getIndices();
-			indexCount = mesh->getMeshBuffer(b)->getIndexCount();
-			outIdx = &buffer->Indices;
+		optimizeTriangleOrder(indices, vertexCount, reduceOverdraw ? &hardBoundaries : 0);
 
-			buffer->Vertices.reallocate(vertexCount);
+		if (reduceOverdraw)
+			optimizeOverdraw(indices, mb, hardBoundaries, VERTEX_CACHE_FIFO_SIZE);
 
-			for (u32 i=0; i < vertexCount; ++i)
+		// buffers which are ordered well already are left alone
+		if (countCacheMisses(indices, vertexCount, VERTEX_CACHE_FIFO_SIZE, timestamps) >= missesBefore)
+			continue;
+
+		// vertices are stored in the order they are first used, unused ones at the end
+		if (reorderVertices)
+		{
+			remap.set_used(vertexCount);
+			for (i=0; i<vertexCount; ++i)
+				remap[i] = 0xFFFFFFFF;
+
+			u32 next = 0;
+			for (i=0; i<indexCount; ++i)
 			{
-				bool found = false;
-				for (u32 j=0; j < i; ++j)
-				{
-					if ( v[i].Pos.equals( v[j].Pos, tolerance) &&
-						 v[i].Normal.equals( v[j].Normal, tolerance) &&
-						 v[i].TCoords.equals( v[j].TCoords ) &&
-						 v[i].Tangent.equals( v[j].Tangent, tolerance ) &&
-						 v[i].Binormal.equals( v[j].Binormal, tolerance ) &&
-						(v[i].Color == v[j].Color) )
-					{
-						redirects[i] = redirects[j];
-						found = true;
-						break;
-					}
-				}
-				if (!found)
-				{
-					redirects[i] = buffer->Vertices.size();
-					buffer->Vertices.push_back(v[i]);
-				}
+				u32& r = remap[indices[i]];
+				if (r == 0xFFFFFFFF)
+					r = next++;
+				indices[i] = r;
 			}
-			break;
+			for (i=0; i<vertexCount; ++i)
+				if (remap[i] == 0xFFFFFFFF)
+					remap[i] = next++;
+
+			const u32 pitch = video::getVertexPitchFromType(mb->getVertexType());
+			u8* data = (u8*) mb->getVertices();
+			vertices.set_used(vertexCount * pitch);
+			memcpy(vertices.pointer(), data, vertexCount * pitch);
+			for (i=0; i<vertexCount; ++i)
+				memcpy(data + remap[i] * pitch, vertices.const_pointer() + i * pitch, pitch);
 		}
-		default:
-			os::Printer::log("Cannot create welded mesh, vertex type unsupported", ELL_ERROR);
-			break;
+
+		if (is32Bit)
+			memcpy(mb->getIndices(), indices.const_pointer(), indexCount * sizeof(u32));
+		else
+		{
+			u16* idx = mb->getIndices();
+			for (i=0; i<indexCount; ++i)
+				idx[i] = (u16) indices[i];
 		}
 
-		// write the buffer's index list
-		core::array<u16> &Indices = *outIdx;
+		mb->setDirty(reorderVertices ? EBT_VERTEX_AND_INDEX : EBT_INDEX);
+	}
+
+	if (acmrAfter)
+		*acmrAfter = getAverageCacheMissRatio(mesh);
+}
+
 
-		Indices.set_used(indexCount);
-		for (u32 i=0; i<indexCount; ++i)
+//! Returns the average amount of vertices transformed per triangle of a mesh
+f32 CMeshManipulator::getAverageCacheMissRatio(IMesh* mesh, u32 cacheSize) const
+{
+	if (!mesh)
+		return 0.f;
+
+	u32 misses = 0;
+	u32 triangles = 0;
+	core::array<u32> timestamps;
+	core::array<u32> indices;
+
+	const u32 bcount = mesh->getMeshBufferCount();
+	for (u32 b=0; b<bcount; ++b)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		const u32 vertexCount = mb->getVertexCount();
+		const u32 indexCount = mb->getIndexCount() - mb->getIndexCount() % 3;
+
+		u32 i;
+		indices.set_used(indexCount);
+		if (mb->getIndexType() == video::EIT_32BIT)
+			memcpy(indices.pointer(), mb->getIndices(), indexCount * sizeof(u32));
+		else
 		{
-			Indices[i] = redirects[ indices[i] ];
+			const u16* idx = mb->getIndices();
+			for (i=0; i<indexCount; ++i)
+				indices[i] = idx[i];
 		}
+
+		for (i=0; i<indexCount; ++i)
+			if (indices[i] >= vertexCount)
+				break;
+		if (i != indexCount)
+			continue;
+
+		misses += countCacheMisses(indices, vertexCount, cacheSize, timestamps);
+		triangles += indexCount / 3;
 	}
-	return clone;
+
+	return triangles ? (f32) misses / (f32) triangles : 0.f;
 }
 
 
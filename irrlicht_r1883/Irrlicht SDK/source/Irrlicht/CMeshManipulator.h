@@ -95,7 +95,15 @@ public:
 	virtual IMesh* createMeshUniquePrimitives(IMesh* mesh) const;
 
 	//! Creates a copy of the mesh, which will have all duplicated vertices removed, i.e. maximal amount of vertices are shared via indexing.
-	virtual IMesh* createMeshWelded(IMesh *mesh, f32 tolerance=core::ROUNDING_ERROR_32) const;
+	virtual IMesh* createMeshWelded(IMesh *mesh, f32 tolerance=core::ROUNDING_ERROR_32,
+		u32 colorTolerance=0, u32* weldedCount=0) const;
+
+	//! Reorders the triangles and vertices of a mesh for the vertex cache.
+	virtual void optimizeVertexCache(IMesh* mesh, bool reorderVertices=true,
+		bool reduceOverdraw=false, f32* acmrBefore=0, f32* acmrAfter=0) const;
+
+	//! Returns the average amount of vertices transformed per triangle of a mesh.
+	virtual f32 getAverageCacheMissRatio(IMesh* mesh, u32 cacheSize=16) const;
 
 	//! Returns amount of polygons in mesh.
 	virtual s32 getPolyCount(scene::IMesh* mesh) const;
@@ -164,8 +164,12 @@ void CMeshSceneNode::render()
 				// and solid only in solid pass
 				if (transparent == isTransparentPass) 
 				{
-					driver->setMaterial(material);
-					driver->drawMeshBuffer(mb);
+					// let the scene manager batch solid buffers by state
+					if (!SceneManager->queueMeshBuffer(mb, material, AbsoluteTransformation))
+					{
+						driver->setMaterial(material);
+						driver->drawMeshBuffer(mb);
+					}
 				}
 			}
 		}
@@ -0,0 +1,315 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_NAME_HASH_TABLE_H_INCLUDED__
+#define __C_NAME_HASH_TABLE_H_INCLUDED__
+
+#include "irrArray.h"
+#include "irrString.h"
+
+namespace irr
+{
+
+//! Objects registered by name, used by the texture and mesh caches.
+/** Adding, finding and removing an object takes constant time, objects
+are found by their name and by their pointer. Several objects may have the
+same name. Access by index is in the order of the names, like the sorted
+arrays used before. This order is only sorted again when it is used after
+objects were added or removed. The hashes of the names are computed once
+when an object is added, and reused when the table grows. */
+template <class T>
+class CNameHashTable
+{
+public:
+
+	//! constructor
+	CNameHashTable() : OrderValid(true) {}
+
+	//! Returns the number of objects
+	u32 size() const
+	{
+		return Entries.size();
+	}
+
+	//! Returns an object in no particular order, for walking over all of them
+	T* getObject(u32 i) const
+	{
+		return Entries[i].Object;
+	}
+
+	//! Adds an object
+	void insert(const core::stringc& name, T* object)
+	{
+		if (2 * (Entries.size() + 1) > Slots[0].size())
+			resize(core::max_(Slots[0].size() * 2, 32u));
+
+		SEntry entry;
+		entry.Name = name;
+		entry.Object = object;
+		entry.Hash[0] = hashName(name.c_str());
+		entry.Hash[1] = hashObject(object);
+		Entries.push_back(entry);
+
+		insertSlot(0, Entries.size() - 1);
+		insertSlot(1, Entries.size() - 1);
+		OrderValid = false;
+	}
+
+	//! Returns the first object found with this name, or 0
+	T* find(const c8* name) const
+	{
+		if (!Entries.size())
+			return 0;
+
+		const u32 hash = hashName(name);
+		const u32 mask = Slots[0].size() - 1;
+
+		for (u32 i=hash & mask; Slots[0][i] != -1; i=(i+1) & mask)
+		{
+			const SEntry& entry = Entries[Slots[0][i]];
+			if (entry.Hash[0] == hash && entry.Name == name)
+				return entry.Object;
+		}
+
+		return 0;
+	}
+
+	//! Removes an object, returns false if it is not in the table
+	bool remove(const T* object)
+	{
+		const s32 slot = findObjectSlot(object);
+		if (slot == -1)
+			return false;
+
+		const s32 index = Slots[1][slot];
+		removeSlot(1, slot);
+		removeSlot(0, findSlot(0, index));
+
+		// the last entry fills the gap
+		const s32 last = Entries.size() - 1;
+		if (index != last)
+		{
+			Slots[0][findSlot(0, last)] = index;
+			Slots[1][findSlot(1, last)] = index;
+			Entries[index] = Entries[last];
+		}
+
+		Entries.erase(last);
+		OrderValid = false;
+		return true;
+	}
+
+	//! Changes the name of an object, returns false if it is not in the table
+	bool rename(T* object, const core::stringc& name)
+	{
+		if (!remove(object))
+			return false;
+
+		insert(name, object);
+		return true;
+	}
+
+	//! Returns the name of an object, or 0 if it is not in the table
+	const core::stringc* getName(const T* object) const
+	{
+		const s32 slot = findObjectSlot(object);
+		return slot != -1 ? &Entries[Slots[1][slot]].Name : 0;
+	}
+
+	//! Returns the index of an object in the order of the names, or -1
+	s32 getIndex(const T* object) const
+	{
+		const s32 slot = findObjectSlot(object);
+		if (slot == -1)
+			return -1;
+
+		updateOrder();
+		return Positions[Slots[1][slot]];
+	}
+
+	//! Returns an object by its index in the order of the names
+	T* getByIndex(u32 index) const
+	{
+		updateOrder();
+		return Entries[Order[index]].Object;
+	}
+
+	//! Returns a name by its index in the order of the names
+	const core::stringc& getNameByIndex(u32 index) const
+	{
+		updateOrder();
+		return Entries[Order[index]].Name;
+	}
+
+	//! Removes all objects
+	void clear()
+	{
+		Entries.clear();
+		Slots[0].clear();
+		Slots[1].clear();
+		Order.clear();
+		Positions.clear();
+		OrderValid = true;
+	}
+
+	//! Hash of a name
+	static u32 hashName(const c8* name)
+	{
+		// FNV-1a
+		u32 hash = 2166136261u;
+		for (; *name; ++name)
+			hash = (hash ^ (u8)*name) * 16777619u;
+		return hash;
+	}
+
+private:
+
+	struct SEntry
+	{
+		core::stringc Name;
+		T* Object;
+
+		//! hash of the name and of the object pointer
+		u32 Hash[2];
+	};
+
+	//! sorts entries by name, entries of the same name stay in a fixed order
+	struct SSortKey
+	{
+		const core::stringc* Name;
+		s32 Entry;
+
+		bool operator < (const SSortKey& other) const
+		{
+			if (*Name < *other.Name)
+				return true;
+			if (*other.Name < *Name)
+				return false;
+			return Entry < other.Entry;
+		}
+	};
+
+	static u32 hashObject(const T* object)
+	{
+		u32 hash = (u32)((size_t)object >> 3);
+		hash = (hash ^ (hash >> 16)) * 0x45d9f3b;
+		return hash ^ (hash >> 16);
+	}
+
+	//! puts an entry into the first free slot of the table
+	void insertSlot(u32 table, s32 entry)
+	{
+		const u32 mask = Slots[table].size() - 1;
+		u32 i = Entries[entry].Hash[table] & mask;
+		while (Slots[table][i] != -1)
+			i = (i+1) & mask;
+		Slots[table][i] = entry;
+	}
+
+	//! returns the slot of an entry
+	u32 findSlot(u32 table, s32 entry) const
+	{
+		const u32 mask = Slots[table].size() - 1;
+		u32 i = Entries[entry].Hash[table] & mask;
+		while (Slots[table][i] != entry)
+			i = (i+1) & mask;
+		return i;
+	}
+
+	//! returns the slot of an object in the object table, or -1
+	s32 findObjectSlot(const T* object) const
+	{
+		if (!Entries.size())
+			return -1;
+
+		const u32 mask = Slots[1].size() - 1;
+		for (u32 i=hashObject(object) & mask; Slots[1][i] != -1; i=(i+1) & mask)
+		{
+			if (Entries[Slots[1][i]].Object == object)
+				return i;
+		}
+
+		return -1;
+	}
+
+	//! empties a slot, and moves later entries of the probe sequence into the gap
+	void removeSlot(u32 table, u32 i)
+	{
+		core::array<s32>& slots = Slots[table];
+		const u32 mask = slots.size() - 1;
+		slots[i] = -1;
+
+		for (u32 j=(i+1) & mask; slots[j] != -1; j=(j+1) & mask)
+		{
+			const u32 home = Entries[slots[j]].Hash[table] & mask;
+
+			// stays if its home is cyclically in (i, j]
+			if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+				continue;
+
+			slots[i] = slots[j];
+			slots[j] = -1;
+			i = j;
+		}
+	}
+
+	//! changes the number of slots, the entries are put in again with their hashes
+	void resize(u32 slotCount)
+	{
+		for (u32 t=0; t<2; ++t)
+		{
+			Slots[t].set_used(slotCount);
+			for (u32 i=0; i<slotCount; ++i)
+				Slots[t][i] = -1;
+		}
+
+		for (u32 e=0; e<Entries.size(); ++e)
+		{
+			insertSlot(0, e);
+			insertSlot(1, e);
+		}
+	}
+
+	//! sorts the entries by name for the access by index
+	void updateOrder() const
+	{
+		if (OrderValid)
+			return;
+
+		core::array<SSortKey> keys(Entries.size());
+		for (u32 i=0; i<Entries.size(); ++i)
+		{
+			SSortKey key;
+			key.Name = &Entries[i].Name;
+			key.Entry = i;
+			keys.push_back(key);
+		}
+		keys.sort();
+
+		Order.set_used(Entries.size());
+		Positions.set_used(Entries.size());
+		for (u32 i=0; i<keys.size(); ++i)
+		{
+			Order[i] = keys[i].Entry;
+			Positions[keys[i].Entry] = i;
+		}
+
+		OrderValid = true;
+	}
+
+	core::array<SEntry> Entries;
+
+	//! entry indices by hash of the name and by hash of the object, -1 if free
+	core::array<s32> Slots[2];
+
+	//! entries in the order of their names, and the position of each entry in it
+	mutable core::array<s32> Order;
+	mutable core::array<s32> Positions;
+	mutable bool OrderValid;
+};
+
+} // end namespace irr
+
+#endif
+
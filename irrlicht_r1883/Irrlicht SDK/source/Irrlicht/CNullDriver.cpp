@@ -69,7 +69,7 @@ IImageWriter* createImageWriterPPM();
 
 //! constructor
 CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<s32>& screenSize)
-: FileSystem(io), MeshManipulator(0), ViewPort(0,0,0,0), ScreenSize(screenSize),
+: TextureResidency(this), FileSystem(io), MeshManipulator(0), ViewPort(0,0,0,0), ScreenSize(screenSize),
 	PrimitivesDrawn(0), TextureCreationFlags(0), AllowZWriteOnTransparent(false)
 {
 	#ifdef _DEBUG
@@ -196,9 +196,10 @@ void CNullDriver::addExternalImageWriter(IImageWriter* writer)
 void CNullDriver::deleteAllTextures()
 {
 	for (u32 i=0; i<Textures.size(); ++i)
-		Textures[i].Surface->drop();
+		Textures.getObject(i)->drop();
 
 	Textures.clear();
+	TextureResidency.clear();
 }
 
 
@@ -218,6 +219,7 @@ bool CNullDriver::endScene()
 {
 	FPSCounter.registerFrame(os::Timer::getRealTime(), PrimitivesDrawn);
 	updateAllHardwareBuffers();
+	TextureResidency.endFrame();
 	return true;
 }
 
@@ -265,14 +267,10 @@ void CNullDriver::removeTexture(ITexture* texture)
 	if (!texture)
 		return;
 
-	for (u32 i=0; i<Textures.size(); ++i)
-	{
-		if (Textures[i].Surface == texture)
-		{
-			texture->drop();
-			Textures.erase(i);
-		}
-	}
+	TextureResidency.removeTexture(texture);
+
+	while (Textures.remove(texture))
+		texture->drop();
 }
 
 
@@ -284,11 +282,46 @@ void CNullDriver::removeAllTextures()
 }
 
 
+//! Limits the memory used by textures.
+void CNullDriver::setTextureBudget(u32 imageBytes, u32 textureBytes)
+{
+	TextureResidency.setBudget(imageBytes, textureBytes);
+}
+
+
+//! Sets the callback which loads evicted textures again.
+void CNullDriver::setTextureReloadCallBack(ITextureReloadCallBack* callback)
+{
+	TextureResidency.setReloadCallBack(callback);
+}
+
+
+//! Returns the memory used by all textures.
+void CNullDriver::getTextureMemoryUsage(u32& imageBytes, u32& textureBytes) const
+{
+	TextureResidency.getMemoryUsage(imageBytes, textureBytes);
+}
+
+
+//! Loads an evicted texture again.
+bool CNullDriver::makeTextureResident(ITexture* texture)
+{
+	return texture && useTexture(texture);
+}
+
+
+//! marks a texture as used in this frame, and loads it again if it was evicted
+bool CNullDriver::useTexture(const ITexture* texture)
+{
+	return TextureResidency.useTexture(texture);
+}
+
+
 //! Returns a texture by index
 ITexture* CNullDriver::getTextureByIndex(u32 i)
 {
 	if ( i < Textures.size() )
-		return Textures[i].Surface;
+		return Textures.getByIndex(i);
 
 	return 0;
 }
@@ -311,22 +344,23 @@ void CNullDriver::renameTexture(ITexture* texture, const c8* newName)
 	core::stringc& name = const_cast<core::stringc&>(texture->getName());
 	name = newName;
 
-	Textures.sort();
+	Textures.rename(texture, name);
 }
 
 
 //! loads a Texture
 ITexture* CNullDriver::getTexture(const c8* filename)
 {
-	// Identify textures by their absolute filenames if possible.
-	core::stringc absolutePath = FileSystem->getAbsolutePath(filename);
-
-	ITexture* texture = findTexture(absolutePath.c_str());
+	// Try the raw filename first, it is already absolute or in an archive
+	// most of the time, and resolving the path costs more than the lookup.
+	ITexture* texture = findTexture(filename);
 	if (texture)
 		return texture;
 
-	// Then try the raw filename, which might be in an Archive
-	texture = findTexture(filename);
+	// Identify textures by their absolute filenames if possible.
+	core::stringc absolutePath = FileSystem->getAbsolutePath(filename);
+
+	texture = findTexture(absolutePath.c_str());
 	if (texture)
 		return texture;
 
@@ -347,6 +381,8 @@ ITexture* CNullDriver::getTexture(const c8* filename)
 		if (texture)
 		{
 			addTexture(texture);
+			// it can be loaded from its file again after it was evicted
+			TextureResidency.addTexture(texture, true);
 			texture->drop(); // drop it because we created it, one grab too much
 		}
 		else
@@ -413,18 +449,12 @@ void CNullDriver::addTexture(video::ITexture* texture)
 {
 	if (texture)
 	{
-		SSurface s;
-		s.Surface = texture;
 		texture->grab();
+		TextureResidency.addTexture(texture, false);
 
-		Textures.push_back(s);
-
-		// the new texture is now at the end of the texture list. when searching for
-		// the next new texture, the texture array will be sorted and the index of this texture
-		// will be changed. to let the order be more consistent to the user, sort
-		// the textures now already although this isn't necessary:
-
-		Textures.sort();
+		// getTextureByIndex() still returns the textures in the order
+		// of their names, the table sorts them when it is called next.
+		Textures.insert(texture->getName(), texture);
 	}
 }
 
@@ -436,15 +466,7 @@ video::ITexture* CNullDriver::findTexture(const c8* filename)
 	if (!filename)
 		filename = "";
 
-	SSurface s;
-	SDummyTexture dummy(filename);
-	s.Surface = &dummy;
-
-	s32 index = Textures.binary_search(s);
-	if (index != -1)
-		return Textures[index].Surface;
-
-	return 0;
+	return Textures.find(filename);
 }
 
 
@@ -661,6 +683,43 @@ void CNullDriver::draw2DImage(const video::ITexture* texture,
 
 
 
+//! Draws a set of 2d images from one texture at arbitrary positions.
+void CNullDriver::draw2DImageBatch(const video::ITexture* texture,
+				const core::array<core::position2d<s32> >& positions,
+				const core::array<core::rect<s32> >& sourceRects,
+				const core::rect<s32>* clipRect, SColor color,
+				bool useAlphaChannelOfTexture)
+{
+	const u32 count = core::min_(positions.size(), sourceRects.size());
+
+	for (u32 i=0; i<count; ++i)
+		draw2DImage(texture, positions[i], sourceRects[i],
+				clipRect, color, useAlphaChannelOfTexture);
+}
+
+
+//! clips a 2d image against the clip rectangle and the render target
+bool CNullDriver::clip2DImage(core::position2d<s32>& targetPos, core::rect<s32>& sourceRect,
+		const core::rect<s32>* clipRect) const
+{
+	core::rect<s32> target(targetPos, sourceRect.getSize());
+
+	core::rect<s32> bounds(core::position2d<s32>(0,0), getCurrentRenderTargetSize());
+	if (clipRect)
+		bounds.clipAgainst(*clipRect);
+
+	const core::rect<s32> unclipped(target);
+	target.clipAgainst(bounds);
+	if (target.getWidth() <= 0 || target.getHeight() <= 0)
+		return false;
+
+	sourceRect.UpperLeftCorner += target.UpperLeftCorner - unclipped.UpperLeftCorner;
+	sourceRect.LowerRightCorner += target.LowerRightCorner - unclipped.LowerRightCorner;
+	targetPos = target.UpperLeftCorner;
+	return true;
+}
+
+
 //! Draws a part of the texture into the rectangle.
 void CNullDriver::draw2DImage(const video::ITexture* texture, const core::rect<s32>& destRect,
 	const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect,
@@ -1361,6 +1420,48 @@ void CNullDriver::removeAllHardwareBuffers()
 		deleteHardwareBuffer(HWBufferMap.getRoot()->getValue());
 }
 
+//! Uploads a range of vertices of a mesh buffer to its hardware buffer
+bool CNullDriver::updateHardwareBufferVertices(const scene::IMeshBuffer* mb, u32 first, u32 count)
+{
+	if (!mb || first+count > mb->getVertexCount())
+		return false;
+
+	core::map<const scene::IMeshBuffer*,SHWBufferLink*>::Node* node = HWBufferMap.find(mb);
+	if (!node)
+		return false;
+
+	// a buffer which has to be uploaded completely anyway is left alone
+	SHWBufferLink *HWBuffer=node->getValue();
+	if (HWBuffer->Mapped_Vertex==scene::EHM_NEVER || HWBuffer->ChangedID_Vertex != mb->getChangedID_Vertex())
+		return false;
+
+	if (!count)
+		return true;
+
+	return updateVertexHardwareBufferRange(HWBuffer, first, count);
+}
+
+//! Uploads a range of indices of a mesh buffer to its hardware buffer
+bool CNullDriver::updateHardwareBufferIndices(const scene::IMeshBuffer* mb, u32 first, u32 count)
+{
+	if (!mb || first+count > mb->getIndexCount())
+		return false;
+
+	core::map<const scene::IMeshBuffer*,SHWBufferLink*>::Node* node = HWBufferMap.find(mb);
+	if (!node)
+		return false;
+
+	// a buffer which has to be uploaded completely anyway is left alone
+	SHWBufferLink *HWBuffer=node->getValue();
+	if (HWBuffer->Mapped_Index==scene::EHM_NEVER || HWBuffer->ChangedID_Index != mb->getChangedID_Index())
+		return false;
+
+	if (!count)
+		return true;
+
+	return updateIndexHardwareBufferRange(HWBuffer, first, count);
+}
+
 bool CNullDriver::isHardwareBufferRecommend(const scene::IMeshBuffer* mb)
 {
 	if (!mb || (mb->getHardwareMappingHint_Index()==scene::EHM_NEVER && mb->getHardwareMappingHint_Vertex()==scene::EHM_NEVER))
@@ -1841,6 +1942,12 @@ void CNullDriver::clearZBuffer()
 }
 
 
+//! Sets the number of threads used for drawing triangles.
+void CNullDriver::setRasterizerThreadCount(u32 threadCount)
+{
+}
+
+
 //! Returns a pointer to the mesh manipulator.
 scene::IMeshManipulator* CNullDriver::getMeshManipulator()
 {
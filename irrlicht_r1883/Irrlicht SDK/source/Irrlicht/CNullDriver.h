@@ -19,6 +19,8 @@
 #include "SVertexIndex.h"
 #include "SLight.h"
 #include "SExposedVideoData.h"
+#include "CNameHashTable.h"
+#include "CTextureResidencyManager.h"
 
 namespace irr
 {
@@ -168,6 +170,14 @@ namespace video
 			const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect = 0,
 			SColor color=SColor(255,255,255,255), bool useAlphaChannelOfTexture=false);
 
+		//! Draws a set of 2d images from one texture at arbitrary positions.
+		virtual void draw2DImageBatch(const video::ITexture* texture,
+				const core::array<core::position2d<s32> >& positions,
+				const core::array<core::rect<s32> >& sourceRects,
+				const core::rect<s32>* clipRect=0,
+				SColor color=SColor(255,255,255,255),
+				bool useAlphaChannelOfTexture=false);
+
 		//! Draws a part of the texture into the rectangle.
 		virtual void draw2DImage(const video::ITexture* texture, const core::rect<s32>& destRect,
 			const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect = 0,
@@ -269,6 +279,18 @@ namespace video
 		//! memory.
 		virtual void removeAllTextures();
 
+		//! Limits the memory used by textures.
+		virtual void setTextureBudget(u32 imageBytes, u32 textureBytes);
+
+		//! Sets the callback which loads evicted textures again.
+		virtual void setTextureReloadCallBack(ITextureReloadCallBack* callback);
+
+		//! Returns the memory used by all textures.
+		virtual void getTextureMemoryUsage(u32& imageBytes, u32& textureBytes) const;
+
+		//! Loads an evicted texture again.
+		virtual bool makeTextureResident(ITexture* texture);
+
 		//! Creates a render target texture.
 		virtual ITexture* addRenderTargetTexture(const core::dimension2d<s32>& size,
 				const c8* name);
@@ -371,6 +393,18 @@ namespace video
 		//! Remove all hardware buffers
 		virtual void removeAllHardwareBuffers();
 
+		//! Uploads a range of vertices of a mesh buffer to its hardware buffer
+		virtual bool updateHardwareBufferVertices(const scene::IMeshBuffer* mb, u32 first, u32 count);
+
+		//! copies a range of vertices to the hardware buffer (only some drivers can)
+		virtual bool updateVertexHardwareBufferRange(SHWBufferLink *HWBuffer, u32 first, u32 count) {return false;}
+
+		//! Uploads a range of indices of a mesh buffer to its hardware buffer
+		virtual bool updateHardwareBufferIndices(const scene::IMeshBuffer* mb, u32 first, u32 count);
+
+		//! copies a range of indices to the hardware buffer (only some drivers can)
+		virtual bool updateIndexHardwareBufferRange(SHWBufferLink *HWBuffer, u32 first, u32 count) {return false;}
+
 		//! is vbo recommended on this mesh?
 		virtual bool isHardwareBufferRecommend(const scene::IMeshBuffer* mb);
 
@@ -473,6 +507,9 @@ namespace video
 		//! Clears the ZBuffer.
 		virtual void clearZBuffer();
 
+		//! Sets the number of threads used for drawing triangles.
+		virtual void setRasterizerThreadCount(u32 threadCount);
+
 		//! Returns an image created from the last rendered frame.
 		virtual IImage* createScreenShot();
 
@@ -527,6 +564,11 @@ namespace video
 		//! adds a surface, not loaded or created by the Irrlicht Engine
 		void addTexture(video::ITexture* surface);
 
+		//! marks a texture as used in this frame, and loads it again if it was evicted
+		/** Drivers call this before drawing with a texture. Returns false
+		if the texture was evicted and could not be loaded again. */
+		bool useTexture(const ITexture* texture);
+
 		//! Creates a texture from a loaded IImage.
 		virtual ITexture* addTexture(const c8* name, IImage* image);
 
@@ -537,6 +579,11 @@ namespace video
 		//! checks triangle count and print warning if wrong
 		bool checkPrimitiveCount(u32 prmcnt) const;
 
+		//! clips a 2d image against the clip rectangle and the render target
+		/** \return False if nothing of the image is left. */
+		bool clip2DImage(core::position2d<s32>& targetPos, core::rect<s32>& sourceRect,
+				const core::rect<s32>* clipRect) const;
+
 		// adds a material renderer and drops it afterwards. To be used for internal creation
 		s32 addAndDropMaterialRenderer(IMaterialRenderer* m);
 
@@ -563,40 +610,15 @@ namespace video
 			return (f32) getAverage ( p[(y * pitch) + x] );
 		}
 
-		struct SSurface
-		{
-			video::ITexture* Surface;
-
-			bool operator < (const SSurface& other) const
-			{
-				return Surface->getName() < other.Surface->getName();
-			}
-		};
-
 		struct SMaterialRenderer
 		{
 			core::stringc Name;
 			IMaterialRenderer* Renderer;
 		};
 
-		struct SDummyTexture : public ITexture
-		{
-			SDummyTexture(const char* name) : ITexture(name), size(0,0) {};
-
-			virtual void* lock(bool readOnly = false) { return 0; };
-			virtual void unlock(){}
-			virtual const core::dimension2d<s32>& getOriginalSize() const { return size; }
-			virtual const core::dimension2d<s32>& getSize() const { return size; }
-			virtual E_DRIVER_TYPE getDriverType() const { return video::EDT_NULL; }
-			virtual ECOLOR_FORMAT getColorFormat() const { return video::ECF_A1R5G5B5; };
-			virtual u32 getPitch() const { return 0; }
-			virtual void regenerateMipMapLevels() {};
-			core::dimension2d<s32> size;
-		};
-
-
-
-		core::array<SSurface> Textures;
+		//! textures by name and by pointer, getTextureByIndex() is in the order of the names
+		CNameHashTable<ITexture> Textures;
+		CTextureResidencyManager TextureResidency;
 		core::array<video::IImageLoader*> SurfaceLoader;
 		core::array<video::IImageWriter*> SurfaceWriter;
 		core::array<SLight> Lights;
@@ -481,6 +481,8 @@ bool COpenGLDriver::genericDriverInit(const core::dimension2d<s32>& screenSize,
 		os::Printer::log("GLSL not available.", ELL_INFORMATION);
 
 	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	// images and small mip map levels have rows without padding
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 	// Reset The Current Viewport
 	glViewport(0, 0, screenSize.Width, screenSize.Height);
@@ -813,6 +815,80 @@ bool COpenGLDriver::updateVertexHardwareBuffer(SHWBufferLink_opengl *HWBuffer)
 }
 
 
+//! copies a range of vertices to the hardware buffer
+bool COpenGLDriver::updateVertexHardwareBufferRange(SHWBufferLink *HWBuffer, u32 first, u32 count)
+{
+	if (!HWBuffer || !FeatureAvailable[IRR_ARB_vertex_buffer_object])
+		return false;
+
+#if defined(GL_ARB_vertex_buffer_object)
+	SHWBufferLink_opengl* link = (SHWBufferLink_opengl*)HWBuffer;
+	const scene::IMeshBuffer* mb = link->MeshBuffer;
+	const E_VERTEX_TYPE vType=mb->getVertexType();
+	const u32 vertexSize = getVertexPitchFromType(vType);
+
+	if (!link->vbo_verticesID || link->vbo_verticesSize < (first+count)*vertexSize)
+		return false;
+
+	if (vType!=EVT_STANDARD && vType!=EVT_2TCOORDS && vType!=EVT_TANGENTS)
+		return false;
+
+	//buffer vertex data, and convert colours...
+	const u8* vertices = static_cast<const u8*>(mb->getVertices()) + first*vertexSize;
+	core::array<c8> buffer(vertexSize * count);
+	memcpy(buffer.pointer(), vertices, vertexSize * count);
+
+	// all vertex types start with the members of S3DVertex
+	for (u32 i=0; i<count; i++)
+	{
+		const S3DVertex* po = reinterpret_cast<const S3DVertex*>(vertices + i*vertexSize);
+		S3DVertex* pb = reinterpret_cast<S3DVertex*>(buffer.pointer() + i*vertexSize);
+		po->Color.toOpenGLColor((u8*)&(pb->Color.color));
+	}
+
+	extGlBindBuffer(GL_ARRAY_BUFFER, link->vbo_verticesID);
+
+	glGetError(); // clear error storage
+	extGlBufferSubData(GL_ARRAY_BUFFER, first * vertexSize, count * vertexSize, buffer.const_pointer());
+
+	extGlBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	return (glGetError() == GL_NO_ERROR);
+#else
+	return false;
+#endif
+}
+
+
+//! copies a range of indices to the hardware buffer
+bool COpenGLDriver::updateIndexHardwareBufferRange(SHWBufferLink *HWBuffer, u32 first, u32 count)
+{
+	if (!HWBuffer || !FeatureAvailable[IRR_ARB_vertex_buffer_object])
+		return false;
+
+#if defined(GL_ARB_vertex_buffer_object)
+	SHWBufferLink_opengl* link = (SHWBufferLink_opengl*)HWBuffer;
+	const scene::IMeshBuffer* mb = link->MeshBuffer;
+	const u32 indexSize = (mb->getIndexType() == EIT_32BIT) ? sizeof(u32) : sizeof(u16);
+
+	if (!link->vbo_indicesID || link->vbo_indicesSize < (first+count)*indexSize)
+		return false;
+
+	extGlBindBuffer(GL_ELEMENT_ARRAY_BUFFER, link->vbo_indicesID);
+
+	glGetError(); // clear error storage
+	extGlBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first * indexSize, count * indexSize,
+		static_cast<const u8*>((const void*)mb->getIndices()) + first*indexSize);
+
+	extGlBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	return (glGetError() == GL_NO_ERROR);
+#else
+	return false;
+#endif
+}
+
+
 bool COpenGLDriver::updateIndexHardwareBuffer(SHWBufferLink_opengl *HWBuffer)
 {
 	if (!HWBuffer)
@@ -1570,6 +1646,65 @@ void COpenGLDriver::draw2DImage(const video::ITexture* texture,
 }
 
 
+//! Draws a set of 2d images from one texture at arbitrary positions.
+void COpenGLDriver::draw2DImageBatch(const video::ITexture* texture,
+				const core::array<core::position2d<s32> >& positions,
+				const core::array<core::rect<s32> >& sourceRects,
+				const core::rect<s32>* clipRect, SColor color,
+				bool useAlphaChannelOfTexture)
+{
+	if (!texture)
+		return;
+
+	disableTextures(1);
+	if (!setTexture(0, texture))
+		return;
+	setRenderStates2DMode(color.getAlpha()<255, true, useAlphaChannelOfTexture);
+
+	glColor4ub(color.getRed(), color.getGreen(), color.getBlue(), color.getAlpha());
+
+	// texcoords need to be flipped horizontally for RTTs
+	const bool isRTT = texture->isRenderTarget();
+	const core::dimension2d<s32>& ss = texture->getOriginalSize();
+	const f32 invW = 1.f / static_cast<f32>(ss.Width);
+	const f32 invH = 1.f / static_cast<f32>(ss.Height);
+
+	const u32 count = core::min_(positions.size(), sourceRects.size());
+
+	glBegin(GL_QUADS);
+
+	for (u32 i=0; i<count; ++i)
+	{
+		core::position2d<s32> targetPos(positions[i]);
+		core::rect<s32> sourceRect(sourceRects[i]);
+		if (!sourceRect.isValid() || !clip2DImage(targetPos, sourceRect, clipRect))
+			continue;
+
+		const core::rect<f32> tcoords(
+				sourceRect.UpperLeftCorner.X * invW,
+				(isRTT?sourceRect.LowerRightCorner.Y:sourceRect.UpperLeftCorner.Y) * invH,
+				sourceRect.LowerRightCorner.X * invW,
+				(isRTT?sourceRect.UpperLeftCorner.Y:sourceRect.LowerRightCorner.Y) * invH);
+
+		const core::rect<s32> poss(targetPos, sourceRect.getSize());
+
+		glTexCoord2f(tcoords.UpperLeftCorner.X, tcoords.UpperLeftCorner.Y);
+		glVertex2f(GLfloat(poss.UpperLeftCorner.X), GLfloat(poss.UpperLeftCorner.Y));
+
+		glTexCoord2f(tcoords.LowerRightCorner.X, tcoords.UpperLeftCorner.Y);
+		glVertex2f(GLfloat(poss.LowerRightCorner.X), GLfloat(poss.UpperLeftCorner.Y));
+
+		glTexCoord2f(tcoords.LowerRightCorner.X, tcoords.LowerRightCorner.Y);
+		glVertex2f(GLfloat(poss.LowerRightCorner.X), GLfloat(poss.LowerRightCorner.Y));
+
+		glTexCoord2f(tcoords.UpperLeftCorner.X, tcoords.LowerRightCorner.Y);
+		glVertex2f(GLfloat(poss.UpperLeftCorner.X), GLfloat(poss.LowerRightCorner.Y));
+	}
+
+	glEnd();
+}
+
+
 //! draw a 2d rectangle
 void COpenGLDriver::draw2DRectangle(SColor color, const core::rect<s32>& position,
 		const core::rect<s32>* clip)
@@ -1668,8 +1803,20 @@ bool COpenGLDriver::setTexture(u32 stage, const video::ITexture* texture)
 	if (stage >= MaxTextureUnits)
 		return false;
 
+	// an evicted texture gets a new name when it is loaded again
+	if (texture && texture->isEvicted())
+	{
+		for (u32 i=0; i<MaxTextureUnits; ++i)
+			if (CurrentTexture[i]==texture)
+				setTexture(i, 0);
+	}
+
 	if (CurrentTexture[stage]==texture)
+	{
+		if (texture)
+			useTexture(texture);
 		return true;
+	}
 
 	if (MultiTextureExtension)
 		extGlActiveTexture(GL_TEXTURE0_ARB + stage);
@@ -1690,6 +1837,13 @@ bool COpenGLDriver::setTexture(u32 stage, const video::ITexture* texture)
 			return false;
 		}
 
+		if (!useTexture(texture))
+		{
+			glDisable(GL_TEXTURE_2D);
+			CurrentTexture[stage]=0;
+			return false;
+		}
+
 		glEnable(GL_TEXTURE_2D);
 		glBindTexture(GL_TEXTURE_2D,
 			static_cast<const COpenGLTexture*>(texture)->getOpenGLTextureName());
@@ -125,6 +125,12 @@ namespace video
 		//! updates hardware buffer if needed
 		virtual bool updateHardwareBuffer(SHWBufferLink *HWBuffer);
 
+		//! copies a range of vertices to the hardware buffer
+		virtual bool updateVertexHardwareBufferRange(SHWBufferLink *HWBuffer, u32 first, u32 count);
+
+		//! copies a range of indices to the hardware buffer
+		virtual bool updateIndexHardwareBufferRange(SHWBufferLink *HWBuffer, u32 first, u32 count);
+
 		//! Create hardware buffer from mesh
 		virtual SHWBufferLink *createHardwareBuffer(const scene::IMeshBuffer* mb);
 
@@ -179,6 +185,14 @@ namespace video
 				SColor color=SColor(255,255,255,255),
 				bool useAlphaChannelOfTexture=false);
 
+		//! Draws a set of 2d images from one texture at arbitrary positions.
+		virtual void draw2DImageBatch(const video::ITexture* texture,
+				const core::array<core::position2d<s32> >& positions,
+				const core::array<core::rect<s32> >& sourceRects,
+				const core::rect<s32>* clipRect=0,
+				SColor color=SColor(255,255,255,255),
+				bool useAlphaChannelOfTexture=false);
+
 		//! Draws a part of the texture into the rectangle.
 		virtual void draw2DImage(const video::ITexture* texture, const core::rect<s32>& destRect,
 			const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect = 0,
@@ -12,6 +12,7 @@
 #include "os.h"
 #include "CImage.h"
 #include "CColorConverter.h"
+#include "CImageResampler.h"
 
 #include "irrString.h"
 
@@ -33,6 +34,13 @@ COpenGLTexture::COpenGLTexture(IImage* origImage, const char* name, COpenGLDrive
 	#endif
 
 	HasMipMaps = Driver->getTextureCreationFlag(ETCF_CREATE_MIP_MAPS);
+	createTexture(origImage);
+}
+
+
+//! creates the OpenGL texture from an image
+void COpenGLTexture::createTexture(IImage* origImage)
+{
 	getImageData(origImage);
 
 	glGenTextures(1, &TextureName);
@@ -43,7 +51,7 @@ COpenGLTexture::COpenGLTexture(IImage* origImage, const char* name, COpenGLDrive
 	{
 		Image = new CImage(ColorFormat, TextureSize);
 		// scale texture
-		origImage->copyToScaling(Image);
+		CImageResampler::resize(origImage, Image);
 	}
 	copyTexture();
 	if (!KeepImage)
@@ -233,11 +241,21 @@ void* COpenGLTexture::lock(bool readOnly)
 {
 	ReadOnlyLock |= readOnly;
 
+	if (isEvicted())
+		return 0;
+
 	if (!Image || IsRenderTarget)
 	{
-		// prepare the data storage if necessary
+		// prepare the data storage if necessary. Render targets are
+		// read in 32 bit, other textures in the format they were
+		// uploaded with, after their image was released.
 		if (!Image)
-			Image = new CImage(ECF_A8R8G8B8, ImageSize);
+		{
+			if (IsRenderTarget)
+				Image = new CImage(ECF_A8R8G8B8, ImageSize);
+			else
+				Image = new CImage(ColorFormat, TextureSize);
+		}
 		if (!Image)
 			return 0;
 
@@ -251,33 +269,38 @@ void* COpenGLTexture::lock(bool readOnly)
 		glGetIntegerv(GL_TEXTURE_BINDING_2D, &tmpTexture);
 		glBindTexture(GL_TEXTURE_2D, TextureName);
 
-		// allows to read pixels in top-to-bottom order
+		if (!IsRenderTarget)
+			glGetTexImage(GL_TEXTURE_2D, 0, PixelFormat, PixelType, pPixels);
+		else
+		{
+			// allows to read pixels in top-to-bottom order
 #ifdef GL_MESA_pack_invert
-		if (Driver->queryOpenGLFeature(COpenGLExtensionHandler::IRR_MESA_pack_invert))
-			glPixelStorei(GL_PACK_INVERT_MESA, GL_TRUE);
+			if (Driver->queryOpenGLFeature(COpenGLExtensionHandler::IRR_MESA_pack_invert))
+				glPixelStorei(GL_PACK_INVERT_MESA, GL_TRUE);
 #endif
 
-		glGetTexImage(GL_TEXTURE_2D, 0, GL_BGRA_EXT, GL_UNSIGNED_BYTE, pPixels);
+			glGetTexImage(GL_TEXTURE_2D, 0, GL_BGRA_EXT, GL_UNSIGNED_BYTE, pPixels);
 
 #ifdef GL_MESA_pack_invert
-		if (Driver->queryOpenGLFeature(COpenGLExtensionHandler::IRR_MESA_pack_invert))
-			glPixelStorei(GL_PACK_INVERT_MESA, GL_FALSE);
-		else
+			if (Driver->queryOpenGLFeature(COpenGLExtensionHandler::IRR_MESA_pack_invert))
+				glPixelStorei(GL_PACK_INVERT_MESA, GL_FALSE);
+			else
 #endif
-		{
-			// opengl images are horizontally flipped, so we have to fix that here.
-			const s32 pitch=Image->getPitch();
-			u8* p2 = pPixels + (ImageSize.Height - 1) * pitch;
-			u8* tmpBuffer = new u8[pitch];
-			for (s32 i=0; i < ImageSize.Height; i += 2)
 			{
-				memcpy(tmpBuffer, pPixels, pitch);
-				memcpy(pPixels, p2, pitch);
-				memcpy(p2, tmpBuffer, pitch);
-				pPixels += pitch;
-				p2 -= pitch;
+				// opengl images are horizontally flipped, so we have to fix that here.
+				const s32 pitch=Image->getPitch();
+				u8* p2 = pPixels + (ImageSize.Height - 1) * pitch;
+				u8* tmpBuffer = new u8[pitch];
+				for (s32 i=0; i < ImageSize.Height; i += 2)
+				{
+					memcpy(tmpBuffer, pPixels, pitch);
+					memcpy(pPixels, p2, pitch);
+					memcpy(p2, tmpBuffer, pitch);
+					pPixels += pitch;
+					p2 -= pitch;
+				}
+				delete [] tmpBuffer;
 			}
-			delete [] tmpBuffer;
 		}
 		Image->unlock();
 
@@ -295,7 +318,12 @@ void COpenGLTexture::unlock()
 		return;
 	Image->unlock();
 	if (!ReadOnlyLock)
+	{
 		copyTexture(false);
+		// the mip maps cannot be created later without the image
+		if (!KeepImage && !IsRenderTarget)
+			regenerateMipMapLevels();
+	}
 	ReadOnlyLock = false;
 	if (!KeepImage)
 	{
@@ -367,24 +395,31 @@ void COpenGLTexture::regenerateMipMapLevels()
 	if ((Image->getDimension().Width==1) && (Image->getDimension().Height==1))
 		return;
 
-	// Manually create mipmaps
-	u32 width=Image->getDimension().Width;
-	u32 height=Image->getDimension().Height;
+	// Manually create mipmaps, each level from the one before
+	const u32 bpp = Image->getBytesPerPixel();
+	core::dimension2d<s32> size = Image->getDimension();
+	const core::dimension2d<s32> firstSize = CImageResampler::getMipMapSize(size);
+	u8* levels = new u8[2 * firstSize.Width * firstSize.Height * bpp];
+	u8* target = levels;
+	const u8* source = (const u8*)Image->lock();
+	u32 pitch = Image->getPitch();
 	u32 i=0;
-	u8* target = new u8[Image->getImageDataSizeInBytes()];
 	do
 	{
-		if (width>1)
-			width>>=1;
-		if (height>1)
-			height>>=1;
+		const core::dimension2d<s32> newSize = CImageResampler::getMipMapSize(size);
+		CImageResampler::createMipMap(source, size, pitch, target,
+				newSize.Width*bpp, Image->getColorFormat());
 		++i;
-		Image->copyToScaling(target, width, height, Image->getColorFormat());
-		glTexImage2D(GL_TEXTURE_2D, i, InternalFormat, width, height,
+		glTexImage2D(GL_TEXTURE_2D, i, InternalFormat, newSize.Width, newSize.Height,
 				0, PixelFormat, PixelType, target);
+
+		source = target;
+		target = (target == levels) ? levels + firstSize.Width * firstSize.Height * bpp : levels;
+		size = newSize;
+		pitch = size.Width*bpp;
 	}
-	while (width!=1 || height!=1);
-	delete [] target;
+	while (size.Width!=1 || size.Height!=1);
+	delete [] levels;
 	Image->unlock();
 }
 
@@ -401,6 +436,81 @@ void COpenGLTexture::setIsRenderTarget(bool isTarget)
 }
 
 
+//! Returns the size of the copy of the image kept in system memory
+u32 COpenGLTexture::getImageMemorySize() const
+{
+	return Image ? Image->getImageDataSizeInBytes() : 0;
+}
+
+
+//! Returns the size of the OpenGL texture and its mip maps
+u32 COpenGLTexture::getTextureMemorySize() const
+{
+	if (!TextureName)
+		return 0;
+
+	u32 size = TextureSize.Width * TextureSize.Height *
+		CImage::getBitsPerPixelFromFormat(ColorFormat) / 8;
+	if (HasMipMaps)
+		size += size / 3;
+	return size;
+}
+
+
+//! Frees the copy of the image kept in system memory
+bool COpenGLTexture::releaseImage()
+{
+	if (!Image)
+		return false;
+
+	// lock() reads the pixels back from the texture from now on
+	Image->drop();
+	Image = 0;
+	KeepImage = false;
+	return true;
+}
+
+
+//! Deletes the OpenGL texture and the copy of the image
+bool COpenGLTexture::evict()
+{
+	if (IsRenderTarget || !TextureName)
+		return false;
+
+	if (Image)
+		Image->drop();
+	Image = 0;
+
+	glDeleteTextures(1, &TextureName);
+	TextureName = 0;
+	return true;
+}
+
+
+//! Returns whether the OpenGL texture was deleted by evict()
+bool COpenGLTexture::isEvicted() const
+{
+	return !TextureName && !IsRenderTarget;
+}
+
+
+//! Creates the OpenGL texture again
+bool COpenGLTexture::restore(IImage* image)
+{
+	if (!isEvicted() || !image)
+		return false;
+
+	// keep the texture bound by the driver
+	GLint tmpTexture;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &tmpTexture);
+
+	createTexture(image);
+
+	glBindTexture(GL_TEXTURE_2D, tmpTexture);
+	return TextureName != 0;
+}
+
+
 bool COpenGLTexture::isFrameBufferObject() const
 {
 	return false;
@@ -99,6 +99,24 @@ public:
 	//! sets whether this texture is intended to be used as a render target.
 	void setIsRenderTarget(bool isTarget);
 
+	//! Returns the size of the copy of the image kept in system memory
+	virtual u32 getImageMemorySize() const;
+
+	//! Returns the size of the OpenGL texture and its mip maps
+	virtual u32 getTextureMemorySize() const;
+
+	//! Frees the copy of the image kept in system memory
+	virtual bool releaseImage();
+
+	//! Deletes the OpenGL texture and the copy of the image
+	virtual bool evict();
+
+	//! Returns whether the OpenGL texture was deleted by evict()
+	virtual bool isEvicted() const;
+
+	//! Creates the OpenGL texture again
+	virtual bool restore(IImage* image);
+
 protected:
 
 	//! protected constructor with basic setup, no GL texture name created, for derived classes
@@ -110,6 +128,9 @@ protected:
 	//! convert the image into an internal image with better properties for this driver.
 	void getImageData(IImage* image);
 
+	//! creates the OpenGL texture from an image
+	void createTexture(IImage* image);
+
 	//! copies the texture into an OpenGL texture.
 	//! \param: newTexture is true if method is called from a newly created texture for the first time. Otherwise call with false to improve memory handling.
 	void copyTexture(bool newTexture=true);
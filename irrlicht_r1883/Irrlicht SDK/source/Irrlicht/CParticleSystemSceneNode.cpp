@@ -21,12 +21,24 @@
 #include "CParticleRotationAffector.h"
 #include "CParticleScaleAffector.h"
 #include "SViewFrustum.h"
+#include "CThreadPool.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define _IRR_PARTICLES_WITH_SSE_
+#include <xmmintrin.h>
+#endif
 
 namespace irr
 {
 namespace scene
 {
 
+//! most particles 16 bit indices can address, 4 vertices each
+static const u32 MaxParticles16Bit = 0x10000 / 4;
+
+//! particles per job of the packed storage
+static const u32 ParticlesPerJob = 2048;
+
 //! constructor
 CParticleSystemSceneNode::CParticleSystemSceneNode(bool createDefaultEmitter,
 	ISceneNode* parent, ISceneManager* mgr, s32 id,
@@ -34,7 +46,8 @@ CParticleSystemSceneNode::CParticleSystemSceneNode(bool createDefaultEmitter,
 	const core::vector3df& scale)
 	: IParticleSystemSceneNode(parent, mgr, id, position, rotation, scale),
 	Emitter(0), ParticleSize(core::dimension2d<f32>(5.0f, 5.0f)), LastEmitTime(0),
-	MaxParticles(0xffff), Buffer(0), ParticlesAreGlobal(true)
+	MaxParticles(0xffff), Buffer(0), ParticlesAreGlobal(true), PackedParticles(false),
+	WorkerPool(0), MoveScale(0.f)
 {
 	#ifdef _DEBUG
 	setDebugName("CParticleSystemSceneNode");
@@ -57,6 +70,8 @@ CParticleSystemSceneNode::~CParticleSystemSceneNode()
 		Emitter->drop();
 	if (Buffer)
 		Buffer->drop();
+	if (WorkerPool)
+		WorkerPool->drop();
 
 	removeAllAffectors();
 }
@@ -321,52 +336,29 @@ void CParticleSystemSceneNode::render()
 
 #endif
 
-	// reallocate arrays, if they are too small
-	reallocateBuffers();
-
-	// create particle vertex data
-	s32 idx = 0;
-	for (u32 i=0; i<Particles.size(); ++i)
-	{
-		const SParticle& particle = Particles[i];
-
-		#if 0
-			core::vector3df horizontal = camera->getUpVector().crossProduct(view);
-			horizontal.normalize();
-			horizontal *= 0.5f * particle.size.Width;
-
-			core::vector3df vertical = horizontal.crossProduct(view);
-			vertical.normalize();
-			vertical *= 0.5f * particle.size.Height;
-
-		#else
-			f32 f;
-
-			f = 0.5f * particle.size.Width;
-			const core::vector3df horizontal ( m[0] * f, m[4] * f, m[8] * f );
-
-			f = -0.5f * particle.size.Height;
-			const core::vector3df vertical ( m[1] * f, m[5] * f, m[9] * f );
-		#endif
-
-		Buffer->Vertices[0+idx].Pos = particle.pos + horizontal + vertical;
-		Buffer->Vertices[0+idx].Color = particle.color;
-		Buffer->Vertices[0+idx].Normal = view;
+	// only some drivers take 32 bit indices, the others get parts which fit 16 bit ones
+	const video::E_DRIVER_TYPE type = driver->getDriverType();
+	const bool indices32 = (type == video::EDT_OPENGL || type == video::EDT_DIRECT3D9);
 
-		Buffer->Vertices[1+idx].Pos = particle.pos + horizontal - vertical;
-		Buffer->Vertices[1+idx].Color = particle.color;
-		Buffer->Vertices[1+idx].Normal = view;
+	u32 perCall = core::max_(driver->getMaximalPrimitiveCount() / 2, 1u);
+	if (!indices32)
+		perCall = core::min_(perCall, MaxParticles16Bit);
 
-		Buffer->Vertices[2+idx].Pos = particle.pos - horizontal - vertical;
-		Buffer->Vertices[2+idx].Color = particle.color;
-		Buffer->Vertices[2+idx].Normal = view;
+	// reallocate arrays, if they are too small
+	reallocateBuffers(indices32);
 
-		Buffer->Vertices[3+idx].Pos = particle.pos - horizontal + vertical;
-		Buffer->Vertices[3+idx].Color = particle.color;
-		Buffer->Vertices[3+idx].Normal = view;
+	// create particle vertex data
+	BillboardView = view;
+	BillboardHorizontal.set(m[0], m[4], m[8]);
+	BillboardVertical.set(m[1], m[5], m[9]);
 
-		idx +=4;
+	if (PackedParticles)
+	{
+		const u32 jobCount = getJobCount();
+		WorkerPool->run(vertexJob, this, jobCount);
 	}
+	else
+		createVertices(0, Particles.size());
 
 	// render all
 	core::matrix4 mat;
@@ -376,8 +368,18 @@ void CParticleSystemSceneNode::render()
 
 	driver->setMaterial(Buffer->Material);
 
-	driver->drawVertexPrimitiveList(Buffer->getVertices(), Particles.size()*4,
-		Buffer->getIndices(), Particles.size()*2, video::EVT_STANDARD, EPT_TRIANGLES,Buffer->getIndexType());
+	// draw in parts the driver can handle
+	for (u32 first=0; first<Particles.size(); first+=perCall)
+	{
+		const u32 count = core::min_(Particles.size() - first, perCall);
+
+		if (count <= MaxParticles16Bit)
+			driver->drawVertexPrimitiveList(&Buffer->Vertices[first*4], count*4,
+				Buffer->getIndices(), count*2, video::EVT_STANDARD, EPT_TRIANGLES, video::EIT_16BIT);
+		else
+			driver->drawVertexPrimitiveList(&Buffer->Vertices[first*4], count*4,
+				Indices32.const_pointer(), count*2, video::EVT_STANDARD, EPT_TRIANGLES, video::EIT_32BIT);
+	}
 
 	// for debug purposes only:
 	if ( DebugDataVisible & scene::EDS_BBOX )
@@ -420,23 +422,45 @@ void CParticleSystemSceneNode::doParticleSystem(u32 time)
 		if (newParticles && array)
 		{
 			s32 j=Particles.size();
-			if (newParticles > 16250-j)
+			if (!PackedParticles && newParticles > 16250-j)
 				newParticles=16250-j;
-			Particles.set_used(j+newParticles);
-			for (s32 i=j; i<j+newParticles; ++i)
+			if (newParticles > 0)
 			{
-				Particles[i]=array[i-j];
-				AbsoluteTransformation.rotateVect(Particles[i].startVector);
-				if (ParticlesAreGlobal)
-					AbsoluteTransformation.transformVect(Particles[i].pos);
+				Particles.set_used(j+newParticles);
+				for (s32 i=j; i<j+newParticles; ++i)
+				{
+					Particles[i]=array[i-j];
+					AbsoluteTransformation.rotateVect(Particles[i].startVector);
+					if (ParticlesAreGlobal)
+						AbsoluteTransformation.transformVect(Particles[i].pos);
+
+					if (PackedParticles)
+					{
+						PosX.push_back(Particles[i].pos.X);
+						PosY.push_back(Particles[i].pos.Y);
+						PosZ.push_back(Particles[i].pos.Z);
+						VecX.push_back(Particles[i].vector.X);
+						VecY.push_back(Particles[i].vector.Y);
+						VecZ.push_back(Particles[i].vector.Z);
+					}
+				}
 			}
 		}
 	}
 
-	// run affectors
-	core::list<IParticleAffector*>::Iterator ait = AffectorList.begin();
-	for (; ait != AffectorList.end(); ++ait)
-		(*ait)->affect(now, Particles.pointer(), Particles.size());
+	// run affectors, they work on whole particles
+	if (!AffectorList.empty())
+	{
+		if (PackedParticles)
+			unpackParticles();
+
+		core::list<IParticleAffector*>::Iterator ait = AffectorList.begin();
+		for (; ait != AffectorList.end(); ++ait)
+			(*ait)->affect(now, Particles.pointer(), Particles.size());
+
+		if (PackedParticles)
+			packParticles();
+	}
 
 	if (ParticlesAreGlobal)
 		Buffer->BoundingBox.reset(AbsoluteTransformation.getTranslation());
@@ -446,17 +470,64 @@ void CParticleSystemSceneNode::doParticleSystem(u32 time)
 	// animate all particles
 	f32 scale = (f32)timediff;
 
-	for (u32 i=0; i<Particles.size();)
+	if (PackedParticles)
 	{
-		if (now > Particles[i].endTime)
-			Particles.erase(i);
-		else
+		// remove expired particles by moving the last one into their place
+		for (u32 i=0; i<Particles.size();)
 		{
-			Particles[i].pos += (Particles[i].vector * scale);
-			Buffer->BoundingBox.addInternalPoint(Particles[i].pos);
-			++i;
+			if (now > Particles[i].endTime)
+			{
+				const u32 last = Particles.size() - 1;
+				Particles[i] = Particles[last];
+				PosX[i] = PosX[last];
+				PosY[i] = PosY[last];
+				PosZ[i] = PosZ[last];
+				VecX[i] = VecX[last];
+				VecY[i] = VecY[last];
+				VecZ[i] = VecZ[last];
+
+				Particles.set_used(last);
+				PosX.set_used(last);
+				PosY.set_used(last);
+				PosZ.set_used(last);
+				VecX.set_used(last);
+				VecY.set_used(last);
+				VecZ.set_used(last);
+			}
+			else
+				++i;
+		}
+
+		if (!Particles.empty())
+		{
+			MoveScale = scale;
+
+			const u32 jobCount = getJobCount();
+			JobBoxes.set_used(jobCount);
+			WorkerPool->run(moveJob, this, jobCount);
+
+			for (u32 j=0; j<jobCount; ++j)
+				Buffer->BoundingBox.addInternalBox(JobBoxes[j]);
 		}
 	}
+	else
+	{
+		// close the gaps of expired particles in one pass, keeping the order
+		u32 alive = 0;
+		for (u32 i=0; i<Particles.size(); ++i)
+		{
+			if (now > Particles[i].endTime)
+				continue;
+
+			if (alive != i)
+				Particles[alive] = Particles[i];
+
+			Particles[alive].pos += (Particles[alive].vector * scale);
+			Buffer->BoundingBox.addInternalPoint(Particles[alive].pos);
+			++alive;
+		}
+		Particles.set_used(alive);
+	}
 
 	const f32 m = (ParticleSize.Width > ParticleSize.Height ? ParticleSize.Width : ParticleSize.Height) * 0.5f;
 	Buffer->BoundingBox.MaxEdge.X += m;
@@ -484,6 +555,208 @@ void CParticleSystemSceneNode::setParticlesAreGlobal(bool global)
 }
 
 
+//! Selects the packed particle storage
+void CParticleSystemSceneNode::setPackedParticles(bool on)
+{
+	if (on == PackedParticles)
+		return;
+
+	if (on)
+	{
+		PackedParticles = true;
+		packParticles();
+	}
+	else
+	{
+		unpackParticles();
+		PackedParticles = false;
+
+		PosX.clear();
+		PosY.clear();
+		PosZ.clear();
+		VecX.clear();
+		VecY.clear();
+		VecZ.clear();
+		Indices32.clear();
+
+		// the unpacked storage keeps to 16 bit indices
+		if (Particles.size() > 16250)
+			Particles.set_used(16250);
+	}
+}
+
+
+//! copies positions and speeds from the packed streams into the particles
+void CParticleSystemSceneNode::unpackParticles()
+{
+	for (u32 i=0; i<Particles.size(); ++i)
+	{
+		Particles[i].pos.set(PosX[i], PosY[i], PosZ[i]);
+		Particles[i].vector.set(VecX[i], VecY[i], VecZ[i]);
+	}
+}
+
+
+//! copies positions and speeds from the particles into the packed streams
+void CParticleSystemSceneNode::packParticles()
+{
+	const u32 count = Particles.size();
+	PosX.set_used(count);
+	PosY.set_used(count);
+	PosZ.set_used(count);
+	VecX.set_used(count);
+	VecY.set_used(count);
+	VecZ.set_used(count);
+
+	for (u32 i=0; i<count; ++i)
+	{
+		PosX[i] = Particles[i].pos.X;
+		PosY[i] = Particles[i].pos.Y;
+		PosZ[i] = Particles[i].pos.Z;
+		VecX[i] = Particles[i].vector.X;
+		VecY[i] = Particles[i].vector.Y;
+		VecZ[i] = Particles[i].vector.Z;
+	}
+}
+
+
+//! returns the number of jobs for the particles, and creates the worker pool when needed
+u32 CParticleSystemSceneNode::getJobCount()
+{
+	if (!WorkerPool)
+		WorkerPool = CThreadPool::createSharedPool();
+
+	return (Particles.size() + ParticlesPerJob - 1) / ParticlesPerJob;
+}
+
+
+void CParticleSystemSceneNode::moveJob(void* userData, u32 job, u32 slot)
+{
+	CParticleSystemSceneNode* node = (CParticleSystemSceneNode*)userData;
+	const u32 first = job * ParticlesPerJob;
+	const u32 last = core::min_(first + ParticlesPerJob, node->Particles.size());
+	node->movePackedParticles(first, last, node->JobBoxes[job]);
+}
+
+
+void CParticleSystemSceneNode::vertexJob(void* userData, u32 job, u32 slot)
+{
+	CParticleSystemSceneNode* node = (CParticleSystemSceneNode*)userData;
+	const u32 first = job * ParticlesPerJob;
+	const u32 last = core::min_(first + ParticlesPerJob, node->Particles.size());
+	node->createVertices(first, last);
+}
+
+
+//! moves the packed particles of one job and returns their box
+void CParticleSystemSceneNode::movePackedParticles(u32 first, u32 last, core::aabbox3df& box)
+{
+	f32* px = PosX.pointer();
+	f32* py = PosY.pointer();
+	f32* pz = PosZ.pointer();
+	const f32* vx = VecX.const_pointer();
+	const f32* vy = VecY.const_pointer();
+	const f32* vz = VecZ.const_pointer();
+	const f32 scale = MoveScale;
+
+	px[first] += vx[first] * scale;
+	py[first] += vy[first] * scale;
+	pz[first] += vz[first] * scale;
+	box.reset(px[first], py[first], pz[first]);
+
+	u32 i = first + 1;
+
+#ifdef _IRR_PARTICLES_WITH_SSE_
+	if (i + 4 <= last)
+	{
+		const __m128 s = _mm_set1_ps(scale);
+		__m128 minX = _mm_set1_ps(box.MinEdge.X);
+		__m128 minY = _mm_set1_ps(box.MinEdge.Y);
+		__m128 minZ = _mm_set1_ps(box.MinEdge.Z);
+		__m128 maxX = minX;
+		__m128 maxY = minY;
+		__m128 maxZ = minZ;
+
+		for (; i + 4 <= last; i += 4)
+		{
+			const __m128 x = _mm_add_ps(_mm_loadu_ps(px+i), _mm_mul_ps(_mm_loadu_ps(vx+i), s));
+			const __m128 y = _mm_add_ps(_mm_loadu_ps(py+i), _mm_mul_ps(_mm_loadu_ps(vy+i), s));
+			const __m128 z = _mm_add_ps(_mm_loadu_ps(pz+i), _mm_mul_ps(_mm_loadu_ps(vz+i), s));
+			_mm_storeu_ps(px+i, x);
+			_mm_storeu_ps(py+i, y);
+			_mm_storeu_ps(pz+i, z);
+
+			minX = _mm_min_ps(minX, x);
+			minY = _mm_min_ps(minY, y);
+			minZ = _mm_min_ps(minZ, z);
+			maxX = _mm_max_ps(maxX, x);
+			maxY = _mm_max_ps(maxY, y);
+			maxZ = _mm_max_ps(maxZ, z);
+		}
+
+		f32 lo[3][4];
+		f32 hi[3][4];
+		_mm_storeu_ps(lo[0], minX);
+		_mm_storeu_ps(lo[1], minY);
+		_mm_storeu_ps(lo[2], minZ);
+		_mm_storeu_ps(hi[0], maxX);
+		_mm_storeu_ps(hi[1], maxY);
+		_mm_storeu_ps(hi[2], maxZ);
+
+		for (u32 k=0; k<4; ++k)
+		{
+			box.addInternalPoint(lo[0][k], lo[1][k], lo[2][k]);
+			box.addInternalPoint(hi[0][k], hi[1][k], hi[2][k]);
+		}
+	}
+#endif
+
+	for (; i<last; ++i)
+	{
+		px[i] += vx[i] * scale;
+		py[i] += vy[i] * scale;
+		pz[i] += vz[i] * scale;
+		box.addInternalPoint(px[i], py[i], pz[i]);
+	}
+}
+
+
+//! creates the billboards of the particles of one job
+void CParticleSystemSceneNode::createVertices(u32 first, u32 last)
+{
+	video::S3DVertex* vertices = Buffer->Vertices.pointer();
+
+	for (u32 i=first; i<last; ++i)
+	{
+		const SParticle& particle = Particles[i];
+
+		const core::vector3df pos = PackedParticles ?
+			core::vector3df(PosX[i], PosY[i], PosZ[i]) : particle.pos;
+
+		const core::vector3df horizontal = BillboardHorizontal * (0.5f * particle.size.Width);
+		const core::vector3df vertical = BillboardVertical * (-0.5f * particle.size.Height);
+
+		video::S3DVertex* v = vertices + i*4;
+
+		v[0].Pos = pos + horizontal + vertical;
+		v[0].Color = particle.color;
+		v[0].Normal = BillboardView;
+
+		v[1].Pos = pos + horizontal - vertical;
+		v[1].Color = particle.color;
+		v[1].Normal = BillboardView;
+
+		v[2].Pos = pos - horizontal - vertical;
+		v[2].Color = particle.color;
+		v[2].Normal = BillboardView;
+
+		v[3].Pos = pos - horizontal + vertical;
+		v[3].Color = particle.color;
+		v[3].Normal = BillboardView;
+	}
+}
+
+
 //! Sets the size of all particles.
 void CParticleSystemSceneNode::setParticleSize(const core::dimension2d<f32> &size)
 {
@@ -498,16 +771,15 @@ void CParticleSystemSceneNode::setParticleSize(const core::dimension2d<f32> &siz
 }
 
 
-void CParticleSystemSceneNode::reallocateBuffers()
+void CParticleSystemSceneNode::reallocateBuffers(bool indices32)
 {
-	if (Particles.size() * 4 > Buffer->getVertexCount() ||
-			Particles.size() * 6 > Buffer->getIndexCount())
+	u32 i;
+
+	if (Particles.size() * 4 > Buffer->getVertexCount())
 	{
 		u32 oldSize = Buffer->getVertexCount();
 		Buffer->Vertices.set_used(Particles.size() * 4);
 
-		u32 i;
-
 		// fill remaining vertices
 		for (i=oldSize; i<Buffer->Vertices.size(); i+=4)
 		{
@@ -516,20 +788,42 @@ void CParticleSystemSceneNode::reallocateBuffers()
 			Buffer->Vertices[2+i].TCoords.set(1.0f, 1.0f);
 			Buffer->Vertices[3+i].TCoords.set(1.0f, 0.0f);
 		}
+	}
 
-		// fill remaining indices
+	// fill remaining indices, 16 bit ones as far as they reach
+	const u32 count16 = core::min_(Particles.size(), MaxParticles16Bit);
+	if (count16 * 6 > Buffer->getIndexCount())
+	{
 		u32 oldIdxSize = Buffer->getIndexCount();
-		u32 oldvertices = oldSize;
-		Buffer->Indices.set_used(Particles.size() * 6);
+		u32 oldvertices = oldIdxSize / 6 * 4;
+		Buffer->Indices.set_used(count16 * 6);
 
 		for (i=oldIdxSize; i<Buffer->Indices.size(); i+=6)
 		{
-			Buffer->Indices[0+i] = (u16)0+oldvertices;
-			Buffer->Indices[1+i] = (u16)2+oldvertices;
-			Buffer->Indices[2+i] = (u16)1+oldvertices;
-			Buffer->Indices[3+i] = (u16)0+oldvertices;
-			Buffer->Indices[4+i] = (u16)3+oldvertices;
-			Buffer->Indices[5+i] = (u16)2+oldvertices;
+			Buffer->Indices[0+i] = (u16)(0+oldvertices);
+			Buffer->Indices[1+i] = (u16)(2+oldvertices);
+			Buffer->Indices[2+i] = (u16)(1+oldvertices);
+			Buffer->Indices[3+i] = (u16)(0+oldvertices);
+			Buffer->Indices[4+i] = (u16)(3+oldvertices);
+			Buffer->Indices[5+i] = (u16)(2+oldvertices);
+			oldvertices += 4;
+		}
+	}
+
+	if (indices32 && Particles.size() > MaxParticles16Bit && Particles.size() * 6 > Indices32.size())
+	{
+		u32 oldIdxSize = Indices32.size();
+		u32 oldvertices = oldIdxSize / 6 * 4;
+		Indices32.set_used(Particles.size() * 6);
+
+		for (i=oldIdxSize; i<Indices32.size(); i+=6)
+		{
+			Indices32[0+i] = 0+oldvertices;
+			Indices32[1+i] = 2+oldvertices;
+			Indices32[2+i] = 1+oldvertices;
+			Indices32[3+i] = 0+oldvertices;
+			Indices32[4+i] = 3+oldvertices;
+			Indices32[5+i] = 2+oldvertices;
 			oldvertices += 4;
 		}
 	}
@@ -544,6 +838,7 @@ void CParticleSystemSceneNode::serializeAttributes(io::IAttributes* out, io::SAt
 	out->addBool("GlobalParticles", ParticlesAreGlobal);
 	out->addFloat("ParticleWidth", ParticleSize.Width);
 	out->addFloat("ParticleHeight", ParticleSize.Height);
+	out->addBool("PackedParticles", PackedParticles);
 
 	// write emitter
 
@@ -585,6 +880,7 @@ void CParticleSystemSceneNode::deserializeAttributes(io::IAttributes* in, io::SA
 	ParticlesAreGlobal = in->getAttributeAsBool("GlobalParticles");
 	ParticleSize.Width = in->getAttributeAsFloat("ParticleWidth");
 	ParticleSize.Height = in->getAttributeAsFloat("ParticleHeight");
+	setPackedParticles(in->getAttributeAsBool("PackedParticles"));
 
 	// read emitter
 
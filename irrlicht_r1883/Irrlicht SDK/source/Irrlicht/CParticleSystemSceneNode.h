@@ -12,6 +12,8 @@
 
 namespace irr
 {
+class CThreadPool;
+
 namespace scene
 {
 
@@ -187,6 +189,9 @@ public:
 	//! ignore it. Default is true.
 	virtual void setParticlesAreGlobal(bool global=true);
 
+	//! Selects the packed particle storage
+	virtual void setPackedParticles(bool on);
+
 	//! Writes attributes of the scene node.
 	virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const;
 
@@ -199,7 +204,25 @@ public:
 private:
 
 	void doParticleSystem(u32 time);
-	void reallocateBuffers();
+	void reallocateBuffers(bool indices32);
+
+	//! copies positions and speeds from the packed streams into the particles
+	void unpackParticles();
+
+	//! copies positions and speeds from the particles into the packed streams
+	void packParticles();
+
+	//! moves the packed particles of one job and returns their box
+	void movePackedParticles(u32 first, u32 last, core::aabbox3df& box);
+
+	//! creates the billboards of the particles of one job
+	void createVertices(u32 first, u32 last);
+
+	//! returns the number of jobs for the particles, and creates the worker pool when needed
+	u32 getJobCount();
+
+	static void moveJob(void* userData, u32 job, u32 slot);
+	static void vertexJob(void* userData, u32 job, u32 slot);
 
 	core::list<IParticleAffector*> AffectorList;
 	IParticleEmitter* Emitter;
@@ -219,6 +242,26 @@ private:
 	E_PARTICLES_PRIMITIVE ParticlePrimitive;
 
 	bool ParticlesAreGlobal;
+
+	//! packed storage: position and speed streams, valid while PackedParticles is set
+	bool PackedParticles;
+	core::array<f32> PosX;
+	core::array<f32> PosY;
+	core::array<f32> PosZ;
+	core::array<f32> VecX;
+	core::array<f32> VecY;
+	core::array<f32> VecZ;
+
+	//! indices for more particles than 16 bit indices can address
+	core::array<u32> Indices32;
+
+	//! state of the jobs of the current update or render
+	CThreadPool* WorkerPool;
+	core::array<core::aabbox3df> JobBoxes;
+	f32 MoveScale;
+	core::vector3df BillboardView;
+	core::vector3df BillboardHorizontal;
+	core::vector3df BillboardVertical;
 };
 
 } // end namespace scene
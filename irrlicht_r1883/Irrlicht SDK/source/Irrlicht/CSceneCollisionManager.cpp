@@ -161,6 +161,14 @@ bool CSceneCollisionManager::getCollisionPoint(const core::line3d<f32>& ray,
 		return false;
 	}
 
+	// the selector can search its triangles itself
+	if (selector->hasCollisionPoint())
+	{
+		const bool found = selector->getCollisionPoint(ray, outIntersection, outTriangle);
+		_IRR_IMPLEMENT_MANAGED_MARSHALLING_BUGFIX;
+		return found;
+	}
+
 	s32 totalcnt = selector->getTriangleCount();
 	Triangles.set_used(totalcnt);
 
@@ -16,6 +16,7 @@
 #include "IReadFile.h"
 #include "EMaterialTypes.h"
 #include "IGPUProgrammingServices.h"
+#include "ISkinnedMesh.h"
 
 #include "os.h"
 
@@ -134,6 +135,7 @@
 #include "CSceneCollisionManager.h"
 #include "CTriangleSelector.h"
 #include "COctTreeTriangleSelector.h"
+#include "CBVHTriangleSelector.h"
 #include "CTriangleBBSelector.h"
 #include "CMetaTriangleSelector.h"
 #include "CTerrainTriangleSelector.h"
@@ -166,8 +168,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 		gui::IGUIEnvironment* gui)
 : ISceneNode(0, 0), Driver(driver), FileSystem(fs), GUIEnvironment(gui),
 	CursorControl(cursorControl), CollisionManager(0),
-	ActiveCamera(0), ShadowColor(150,0,0,0), AmbientLight(0,0,0,0),
-	MeshCache(cache), CurrentRendertime(ESNRP_COUNT),
+	RenderQueueActive(false), CullingFrame(0), HierarchicalCulling(false),
+	DeferCulling(false), UseCullingIndex(false), WorkerPool(0), ActiveCamera(0), ShadowColor(150,0,0,0),
+	AmbientLight(0,0,0,0), MeshCache(cache), CurrentRendertime(ESNRP_COUNT),
 	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type")
 {
 	#ifdef _DEBUG
@@ -282,6 +285,9 @@ CSceneManager::~CSceneManager()
 	if (CollisionManager)
 		CollisionManager->drop();
 
+	if (WorkerPool)
+		WorkerPool->drop();
+
 	if (GUIEnvironment)
 		GUIEnvironment->drop();
 
@@ -339,6 +345,7 @@ IAnimatedMesh* CSceneManager::getMesh(const c8* filename)
 			msh = MeshLoaderList[i]->createMesh(file);
 			if (msh)
 			{
+				optimizeLoadedMesh(msh, filename);
 				MeshCache->addMesh(filename, msh);
 				msh->drop();
 				break;
@@ -379,6 +386,7 @@ IAnimatedMesh* CSceneManager::getMesh(io::IReadFile* file)
 			msh = MeshLoaderList[i]->createMesh(file);
 			if (msh)
 			{
+				optimizeLoadedMesh(msh, file->getFileName());
 				MeshCache->addMesh(file->getFileName(), msh);
 				msh->drop();
 				break;
@@ -395,6 +403,45 @@ IAnimatedMesh* CSceneManager::getMesh(io::IReadFile* file)
 }
 
 
+//! optimizes a loaded mesh for the vertex cache if requested by the parameters
+void CSceneManager::optimizeLoadedMesh(IAnimatedMesh* mesh, const c8* filename)
+{
+	if (!Driver || !Parameters.getAttributeAsBool(MESH_OPTIMIZE_VERTEX_CACHE))
+		return;
+
+	IMesh* target = 0;
+	bool reorderVertices = true;
+
+	switch (mesh->getMeshType())
+	{
+	case EAMT_SKINNED:
+		// the weights reference the vertices by index
+		target = mesh;
+		reorderVertices = false;
+		break;
+	case EAMT_MD2:
+	case EAMT_MD3:
+	case EAMT_BSP:
+		break;
+	default:
+		if (mesh->getFrameCount() == 1)
+			target = mesh->getMesh(0);
+		break;
+	}
+
+	if (!target)
+		return;
+
+	f32 before, after;
+	Driver->getMeshManipulator()->optimizeVertexCache(target, reorderVertices,
+		Parameters.getAttributeAsBool(MESH_OPTIMIZE_OVERDRAW), &before, &after);
+
+	c8 tmp[255];
+	sprintf(tmp, "Optimized mesh for the vertex cache, ACMR %.3f to %.3f", before, after);
+	os::Printer::log(tmp, filename, ELL_INFORMATION);
+}
+
+
 //! returns the video driver
 video::IVideoDriver* CSceneManager::getVideoDriver()
 {
@@ -1162,6 +1209,13 @@ bool CSceneManager::isCulled(const ISceneNode* node)
 		return false;
 	}
 
+	// nodes deferred to the hierarchical culling have already been tested
+	if (UseCullingIndex)
+	{
+		_IRR_IMPLEMENT_MANAGED_MARSHALLING_BUGFIX;
+		return !CullingIndex.isVisible(node, CullingFrame);
+	}
+
 	switch ( node->getAutomaticCulling() )
 	{
 		// can be seen by a bounding box ?
@@ -1224,6 +1278,15 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 {
 	u32 taken = 0;
 
+	// boxed geometry is culled all at once after every node registered
+	if (DeferCulling &&
+		(time == ESNRP_SOLID || time == ESNRP_TRANSPARENT || time == ESNRP_AUTOMATIC) &&
+		(node->getAutomaticCulling() == EAC_BOX || node->getAutomaticCulling() == EAC_FRUSTUM_BOX))
+	{
+		DeferredNodeList.push_back(DeferredNodeEntry(node, time));
+		return 1;
+	}
+
 	switch(time)
 	{
 		// take camera if it doesn't exists
@@ -1337,6 +1400,11 @@ void CSceneManager::drawAll()
 	Parameters.setAttribute ( "culled", 0 );
 	Parameters.setAttribute ( "calls", 0 );
 	Parameters.setAttribute ( "drawn", 0 );
+	Parameters.setAttribute ( "queued", 0 );
+	Parameters.setAttribute ( "material_changes", 0 );
+	Parameters.setAttribute ( "texture_changes", 0 );
+	Parameters.setAttribute ( "culling_visited", 0 );
+	Parameters.setAttribute ( "culling_culled", 0 );
 
 	// reset all transforms
 	video::IVideoDriver* driver = getVideoDriver();
@@ -1368,8 +1436,13 @@ void CSceneManager::drawAll()
 	}
 
 	// let all nodes register themselves
+	++CullingFrame;
+	DeferCulling = HierarchicalCulling && ActiveCamera;
 	OnRegisterSceneNode();
 
+	if (DeferCulling)
+		cullDeferredNodes();
+
 	u32 i; // new ISO for scoping problem in some compilers
 
 	//render camera scenes
@@ -1414,9 +1487,14 @@ void CSceneManager::drawAll()
 		CurrentRendertime = ESNRP_SOLID;
 		SolidNodeList.sort(); // sort by textures
 
+		RenderQueueActive = Parameters.getAttributeAsBool(RENDER_QUEUE_ENABLE);
+
 		for (i=0; i<SolidNodeList.size(); ++i)
 			SolidNodeList[i].Node->render();
 
+		RenderQueueActive = false;
+		drawRenderQueue();
+
 		Parameters.setAttribute ( "drawn", (s32) SolidNodeList.size() );
 
 		SolidNodeList.set_used(0);
@@ -1452,6 +1530,68 @@ void CSceneManager::drawAll()
 }
 
 
+//! culls the deferred nodes with the culling index and registers the visible ones
+void CSceneManager::cullDeferredNodes()
+{
+	u32 i;
+
+	DeferCulling = false;
+
+	for (i=0; i<DeferredNodeList.size(); ++i)
+		CullingIndex.update(DeferredNodeList[i].Node, CullingFrame);
+
+	// nodes which did not register this frame are invisible or gone
+	CullingIndex.removeStale(CullingFrame);
+	CullingIndex.cull(*ActiveCamera->getViewFrustum(), CullingFrame);
+
+	UseCullingIndex = true;
+	for (i=0; i<DeferredNodeList.size(); ++i)
+		registerNodeForRendering(DeferredNodeList[i].Node, DeferredNodeList[i].Pass);
+	UseCullingIndex = false;
+
+	DeferredNodeList.set_used(0);
+
+	Parameters.setAttribute ( "culling_visited", (s32) CullingIndex.getVisitedCount() );
+	Parameters.setAttribute ( "culling_culled", (s32) CullingIndex.getCulledCount() );
+}
+
+
+//! job of skinMeshes()
+static void skinMeshJob(void* userData, u32 job, u32 slot)
+{
+	((ISkinnedMesh* const*)userData)[job]->skinMesh();
+}
+
+
+//! Skins several skinned meshes in parallel.
+void CSceneManager::skinMeshes(ISkinnedMesh* const* meshes, u32 count)
+{
+	if (!meshes || !count)
+		return;
+
+	if (!WorkerPool)
+		WorkerPool = CThreadPool::createSharedPool();
+
+	WorkerPool->run(skinMeshJob, (void*)meshes, count);
+}
+
+
+//! Enables culling of scene nodes with a hierarchical spatial index.
+void CSceneManager::setHierarchicalCulling(bool enable)
+{
+	HierarchicalCulling = enable;
+	if (!enable)
+		CullingIndex.clear();
+}
+
+
+//! Returns if scene nodes are culled with a hierarchical spatial index.
+bool CSceneManager::getHierarchicalCulling() const
+{
+	return HierarchicalCulling;
+}
+
+
 //! Sets the color of stencil buffers shadows drawn by the scene manager.
 void CSceneManager::setShadowColor(video::SColor color)
 {
@@ -1609,6 +1749,17 @@ ITriangleSelector* CSceneManager::createOctTreeTriangleSelector(IMesh* mesh,
 }
 
 
+//! Creates a triangle selector, optimized by a bounding volume hierarchy.
+ITriangleSelector* CSceneManager::createBVHTriangleSelector(IMesh* mesh,
+		ISceneNode* node, s32 maximalPolysPerLeaf)
+{
+	if (!mesh || !node)
+		return 0;
+
+	return new CBVHTriangleSelector(mesh, node, maximalPolysPerLeaf);
+}
+
+
 
 //! Creates a meta triangle selector.
 IMetaTriangleSelector* CSceneManager::createMetaTriangleSelector()
@@ -1787,6 +1938,65 @@ E_SCENE_NODE_RENDER_PASS CSceneManager::getSceneNodeRenderPass() const
 }
 
 
+//! Queues a mesh buffer for state sorted rendering.
+bool CSceneManager::queueMeshBuffer(IMeshBuffer* mb, const video::SMaterial& material,
+		const core::matrix4& transform)
+{
+	if (!RenderQueueActive || !mb)
+		return false;
+
+	RenderQueue.push_back(RenderQueueEntry(mb, &material, transform, camWorldPos));
+	return true;
+}
+
+
+//! draws the render queue grouped by material
+void CSceneManager::drawRenderQueue()
+{
+	if (RenderQueue.empty())
+		return;
+
+	RenderQueue.sort();
+
+	s32 materialChanges = 0;
+	s32 textureChanges = 0;
+	const video::SMaterial* last = 0;
+	const video::ITexture* textures[video::MATERIAL_MAX_TEXTURES] = {0};
+
+	for (u32 i=0; i<RenderQueue.size(); ++i)
+	{
+		const RenderQueueEntry& e = RenderQueue[i];
+
+		// entries sharing a material are adjacent after sorting, equal
+		// materials of different owners are caught by the compare
+		if (!last || (e.Material != last && *e.Material != *last))
+		{
+			for (u32 t=0; t<video::MATERIAL_MAX_TEXTURES; ++t)
+			{
+				if (e.Material->getTexture(t) != textures[t])
+				{
+					textures[t] = e.Material->getTexture(t);
+					++textureChanges;
+				}
+			}
+
+			Driver->setMaterial(*e.Material);
+			++materialChanges;
+		}
+		last = e.Material;
+
+		Driver->setTransform(video::ETS_WORLD, e.Transform);
+		Driver->drawMeshBuffer(e.MeshBuffer);
+	}
+
+	Parameters.setAttribute ( "queued", (s32) RenderQueue.size() );
+	Parameters.setAttribute ( "material_changes", materialChanges );
+	Parameters.setAttribute ( "texture_changes", textureChanges );
+
+	RenderQueue.set_used(0);
+}
+
+
 
 //! Returns an interface to the mesh cache which is shared beween all existing scene managers.
 IMeshCache* CSceneManager::getMeshCache()
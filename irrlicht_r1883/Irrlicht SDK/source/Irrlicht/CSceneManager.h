@@ -12,7 +12,10 @@
 #include "irrString.h"
 #include "irrArray.h"
 #include "IMeshLoader.h"
+#include "IMeshBuffer.h"
 #include "CAttributes.h"
+#include "CSceneNodeCullingIndex.h"
+#include "CThreadPool.h"
 
 namespace irr
 {
@@ -108,6 +111,15 @@ namespace scene
 		//! draws all scene nodes
 		virtual void drawAll();
 
+		//! Skins several skinned meshes in parallel.
+		virtual void skinMeshes(ISkinnedMesh* const* meshes, u32 count);
+
+		//! Enables culling of scene nodes with a hierarchical spatial index.
+		virtual void setHierarchicalCulling(bool enable);
+
+		//! Returns if scene nodes are culled with a hierarchical spatial index.
+		virtual bool getHierarchicalCulling() const;
+
 		//! Adds a scene node for rendering using a octtree to the scene graph. This a good method for rendering
 		//! scenes with lots of geometry. The Octree is built on the fly from the mesh, much
 		//! faster then a bsp tree.
@@ -351,6 +363,10 @@ namespace scene
 		virtual ITriangleSelector* createOctTreeTriangleSelector(IMesh* mesh,
 			ISceneNode* node, s32 minimalPolysPerNode);
 
+		//! Creates a triangle selector, optimized by a bounding volume hierarchy.
+		virtual ITriangleSelector* createBVHTriangleSelector(IMesh* mesh,
+			ISceneNode* node, s32 maximalPolysPerLeaf);
+
 		//! Creates a simple dynamic ITriangleSelector, based on a axis aligned bounding box.
 		virtual ITriangleSelector* createTriangleSelectorFromBoundingBox(
 			ISceneNode* node);
@@ -410,6 +426,10 @@ namespace scene
 		//! Returns current render pass.
 		virtual E_SCENE_NODE_RENDER_PASS getSceneNodeRenderPass() const;
 
+		//! Queues a mesh buffer for state sorted rendering.
+		virtual bool queueMeshBuffer(IMeshBuffer* mb, const video::SMaterial& material,
+			const core::matrix4& transform);
+
 		//! Creates a new scene manager.
 		virtual ISceneManager* createNewSceneManager(bool cloneContent);
 
@@ -485,9 +505,18 @@ namespace scene
 		//! returns if node is culled
 		bool isCulled(const ISceneNode* node);
 
+		//! optimizes a loaded mesh for the vertex cache if requested by the parameters
+		void optimizeLoadedMesh(IAnimatedMesh* mesh, const c8* filename);
+
 		//! clears the deletion list
 		void clearDeletionList();
 
+		//! draws the render queue grouped by material
+		void drawRenderQueue();
+
+		//! culls the deferred nodes with the culling index and registers the visible ones
+		void cullDeferredNodes();
+
 		//! writes a scene node
 		void writeSceneNode(io::IXMLWriter* writer, ISceneNode* node, ISceneUserDataSerializer* userDataSerializer);
 
@@ -541,6 +570,55 @@ namespace scene
 			f32 Distance;
 		};
 
+		//! node registration waiting for the hierarchical culling
+		struct DeferredNodeEntry
+		{
+			DeferredNodeEntry(ISceneNode* n, E_SCENE_NODE_RENDER_PASS pass)
+				: Node(n), Pass(pass) {}
+
+			ISceneNode* Node;
+			E_SCENE_NODE_RENDER_PASS Pass;
+		};
+
+		//! mesh buffer queued for state sorted rendering
+		struct RenderQueueEntry
+		{
+			RenderQueueEntry(IMeshBuffer* mb, const video::SMaterial* material,
+					const core::matrix4& transform, const core::vector3df& camera)
+				: MeshBuffer(mb), Material(material), Transform(transform)
+			{
+				core::vector3df center = mb->getBoundingBox().getCenter();
+				Transform.transformVect(center);
+				Distance = center.getDistanceFromSQ(camera);
+			}
+
+			//! sort by material renderer, textures, material and front to back
+			bool operator < (const RenderQueueEntry& other) const
+			{
+				if (Material->MaterialType != other.Material->MaterialType)
+					return Material->MaterialType < other.Material->MaterialType;
+
+				for (u32 i=0; i<video::MATERIAL_MAX_TEXTURES; ++i)
+				{
+					const video::ITexture* a = Material->getTexture(i);
+					const video::ITexture* b = other.Material->getTexture(i);
+					if (a != b)
+						return a < b;
+				}
+
+				if (Material != other.Material)
+					return Material < other.Material;
+
+				return Distance < other.Distance;
+			}
+
+			IMeshBuffer* MeshBuffer;
+			const video::SMaterial* Material;
+			core::matrix4 Transform;
+			private:
+			f32 Distance;
+		};
+
 		//! sort on distance (sphere) to camera
 		struct DistanceNodeEntry
 		{
@@ -586,6 +664,19 @@ namespace scene
 		core::array<ISceneNode*> SkyBoxList;
 		core::array<DefaultNodeEntry> SolidNodeList;
 		core::array<TransparentNodeEntry> TransparentNodeList;
+		core::array<RenderQueueEntry> RenderQueue;
+		bool RenderQueueActive;
+
+		//! hierarchical culling
+		CSceneNodeCullingIndex CullingIndex;
+		core::array<DeferredNodeEntry> DeferredNodeList;
+		u32 CullingFrame;
+		bool HierarchicalCulling;
+		bool DeferCulling;
+		bool UseCullingIndex;
+
+		//! worker threads, created on first use
+		CThreadPool* WorkerPool;
 
 		core::array<IMeshLoader*> MeshLoaderList;
 		core::array<ISceneNode*> DeletionList;
@@ -0,0 +1,545 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CSceneNodeCullingIndex.h"
+#include "ISceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! returns the union of two boxes
+static inline core::aabbox3d<f32> mergeBoxes(const core::aabbox3d<f32>& a, const core::aabbox3d<f32>& b)
+{
+	core::aabbox3d<f32> box(a);
+	box.addInternalBox(b);
+	return box;
+}
+
+//! enlarges a box, so small movements do not need a tree update
+static inline core::aabbox3d<f32> looseBox(const core::aabbox3d<f32>& box)
+{
+	const core::vector3df margin = box.getExtent() * 0.125f + core::vector3df(0.01f, 0.01f, 0.01f);
+	return core::aabbox3d<f32>(box.MinEdge - margin, box.MaxEdge + margin);
+}
+
+
+//! constructor
+CSceneNodeCullingIndex::CSceneNodeCullingIndex()
+: Root(-1), FreeList(-1), LeafCount(0), Visited(0), Culled(0)
+{
+}
+
+
+//! Inserts a node, or refreshes its box if its transformation or bounding box changed
+void CSceneNodeCullingIndex::update(ISceneNode* node, u32 frame)
+{
+	const core::aabbox3d<f32>& local = node->getBoundingBox();
+	const core::matrix4& transform = node->getAbsoluteTransformation();
+
+	s32 leaf = findLeaf(node);
+	if (leaf != -1)
+	{
+		STreeNode& n = Nodes[leaf];
+		n.UpdateFrame = frame;
+
+		if (n.LocalBox == local && n.Transform == transform)
+			return;
+
+		n.LocalBox = local;
+		n.Transform = transform;
+		n.WorldBox = local;
+		transform.transformBoxEx(n.WorldBox);
+
+		// still inside the loose box, the tree is valid as it is
+		if (n.WorldBox.isFullInside(n.Box))
+			return;
+
+		removeLeaf(leaf);
+		Nodes[leaf].Box = looseBox(Nodes[leaf].WorldBox);
+		insertLeaf(leaf);
+		return;
+	}
+
+	leaf = allocateNode();
+
+	STreeNode& n = Nodes[leaf];
+	n.LocalBox = local;
+	n.Transform = transform;
+	n.WorldBox = local;
+	transform.transformBoxEx(n.WorldBox);
+	n.Box = looseBox(n.WorldBox);
+	n.Node = node;
+	n.UpdateFrame = frame;
+	n.VisibleFrame = frame - 1;
+	n.Height = 0;
+
+	addKey(node, leaf);
+	insertLeaf(leaf);
+	++LeafCount;
+}
+
+
+//! Removes all nodes which were not updated in the given frame
+void CSceneNodeCullingIndex::removeStale(u32 frame)
+{
+	// leaves never change their index, only inner nodes are rearranged
+	for (u32 i=0; i<Nodes.size(); ++i)
+	{
+		if (Nodes[i].Height != 0 || Nodes[i].UpdateFrame == frame)
+			continue;
+
+		removeKey(Nodes[i].Node);
+		removeLeaf(i);
+		freeNode(i);
+		--LeafCount;
+	}
+}
+
+
+//! Marks all nodes which intersect the frustum as visible in the given frame
+void CSceneNodeCullingIndex::cull(const SViewFrustum& frustum, u32 frame)
+{
+	const u32 allPlanes = (1 << SViewFrustum::VF_PLANE_COUNT) - 1;
+	u32 visible = 0;
+
+	Visited = 0;
+	Stack.set_used(0);
+	if (Root != -1)
+		Stack.push_back(SStackEntry(Root, allPlanes));
+
+	while (!Stack.empty())
+	{
+		const SStackEntry e = Stack.getLast();
+		Stack.set_used(Stack.size()-1);
+
+		STreeNode& n = Nodes[e.Node];
+		u32 planes = e.Planes;
+
+		// a parent fully inside the frustum needs no further tests
+		if (planes)
+		{
+			++Visited;
+
+			const core::aabbox3d<f32>& box = n.Height ? n.Box : n.WorldBox;
+			bool outside = false;
+
+			for (u32 i=0; i<SViewFrustum::VF_PLANE_COUNT; ++i)
+			{
+				if (!(planes & (1 << i)))
+					continue;
+
+				const core::EIntersectionRelation3D rel = box.classifyPlaneRelation(frustum.planes[i]);
+				if (rel == core::ISREL3D_FRONT)
+				{
+					outside = true;
+					break;
+				}
+				if (rel == core::ISREL3D_BACK)
+					planes &= ~(1 << i);
+			}
+
+			if (outside)
+				continue;
+		}
+
+		if (n.Height == 0)
+		{
+			n.VisibleFrame = frame;
+			++visible;
+		}
+		else
+		{
+			const s32 child1 = n.Child1;
+			const s32 child2 = n.Child2;
+			Stack.push_back(SStackEntry(child1, planes));
+			Stack.push_back(SStackEntry(child2, planes));
+		}
+	}
+
+	Culled = LeafCount - visible;
+}
+
+
+//! Returns true if the node is in the index
+bool CSceneNodeCullingIndex::contains(const ISceneNode* node) const
+{
+	return findLeaf(node) != -1;
+}
+
+
+//! Returns true if the node was found visible by cull() in the given frame
+bool CSceneNodeCullingIndex::isVisible(const ISceneNode* node, u32 frame) const
+{
+	const s32 leaf = findLeaf(node);
+	return leaf != -1 && Nodes[leaf].VisibleFrame == frame;
+}
+
+
+//! Removes all nodes
+void CSceneNodeCullingIndex::clear()
+{
+	Nodes.clear();
+	Slots.clear();
+	Stack.clear();
+	Root = -1;
+	FreeList = -1;
+	LeafCount = 0;
+	Visited = 0;
+	Culled = 0;
+}
+
+
+s32 CSceneNodeCullingIndex::allocateNode()
+{
+	s32 index;
+	if (FreeList != -1)
+	{
+		index = FreeList;
+		FreeList = Nodes[index].Parent;
+	}
+	else
+	{
+		index = (s32)Nodes.size();
+		Nodes.push_back(STreeNode());
+	}
+
+	STreeNode& n = Nodes[index];
+	n.Node = 0;
+	n.Parent = -1;
+	n.Child1 = -1;
+	n.Child2 = -1;
+	n.Height = 0;
+	n.UpdateFrame = 0;
+	n.VisibleFrame = 0;
+	return index;
+}
+
+
+void CSceneNodeCullingIndex::freeNode(s32 index)
+{
+	Nodes[index].Node = 0;
+	Nodes[index].Height = -1;
+	Nodes[index].Parent = FreeList;
+	FreeList = index;
+}
+
+
+//! inserts a leaf next to the sibling which increases the surface area least
+void CSceneNodeCullingIndex::insertLeaf(s32 leaf)
+{
+	if (Root == -1)
+	{
+		Root = leaf;
+		Nodes[leaf].Parent = -1;
+		return;
+	}
+
+	const core::aabbox3d<f32> leafBox = Nodes[leaf].Box;
+
+	s32 index = Root;
+	while (Nodes[index].Height > 0)
+	{
+		const STreeNode& n = Nodes[index];
+		const f32 area = n.Box.getArea();
+		const f32 combinedArea = mergeBoxes(n.Box, leafBox).getArea();
+
+		// cost of a new parent for this node and the leaf
+		const f32 cost = 2.f * combinedArea;
+
+		// minimum cost of pushing the leaf further down
+		const f32 inheritance = 2.f * (combinedArea - area);
+
+		const STreeNode& c1 = Nodes[n.Child1];
+		f32 cost1 = mergeBoxes(c1.Box, leafBox).getArea() + inheritance;
+		if (c1.Height > 0)
+			cost1 -= c1.Box.getArea();
+
+		const STreeNode& c2 = Nodes[n.Child2];
+		f32 cost2 = mergeBoxes(c2.Box, leafBox).getArea() + inheritance;
+		if (c2.Height > 0)
+			cost2 -= c2.Box.getArea();
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = (cost1 < cost2) ? n.Child1 : n.Child2;
+	}
+
+	const s32 sibling = index;
+	const s32 oldParent = Nodes[sibling].Parent;
+	const s32 newParent = allocateNode();
+
+	STreeNode& p = Nodes[newParent];
+	p.Parent = oldParent;
+	p.Box = mergeBoxes(leafBox, Nodes[sibling].Box);
+	p.Height = Nodes[sibling].Height + 1;
+	p.Child1 = sibling;
+	p.Child2 = leaf;
+
+	if (oldParent != -1)
+	{
+		if (Nodes[oldParent].Child1 == sibling)
+			Nodes[oldParent].Child1 = newParent;
+		else
+			Nodes[oldParent].Child2 = newParent;
+	}
+	else
+		Root = newParent;
+
+	Nodes[sibling].Parent = newParent;
+	Nodes[leaf].Parent = newParent;
+
+	refit(newParent);
+}
+
+
+//! removes a leaf from the tree, the leaf itself is not freed
+void CSceneNodeCullingIndex::removeLeaf(s32 leaf)
+{
+	if (leaf == Root)
+	{
+		Root = -1;
+		return;
+	}
+
+	const s32 parent = Nodes[leaf].Parent;
+	const s32 grandParent = Nodes[parent].Parent;
+	const s32 sibling = (Nodes[parent].Child1 == leaf) ? Nodes[parent].Child2 : Nodes[parent].Child1;
+
+	if (grandParent != -1)
+	{
+		if (Nodes[grandParent].Child1 == parent)
+			Nodes[grandParent].Child1 = sibling;
+		else
+			Nodes[grandParent].Child2 = sibling;
+		Nodes[sibling].Parent = grandParent;
+		freeNode(parent);
+
+		refit(grandParent);
+	}
+	else
+	{
+		Root = sibling;
+		Nodes[sibling].Parent = -1;
+		freeNode(parent);
+	}
+
+	Nodes[leaf].Parent = -1;
+}
+
+
+//! rebalances and updates boxes and heights from a node up to the root
+void CSceneNodeCullingIndex::refit(s32 index)
+{
+	while (index != -1)
+	{
+		index = balance(index);
+
+		STreeNode& n = Nodes[index];
+		const STreeNode& c1 = Nodes[n.Child1];
+		const STreeNode& c2 = Nodes[n.Child2];
+
+		n.Height = 1 + core::max_(c1.Height, c2.Height);
+		n.Box = mergeBoxes(c1.Box, c2.Box);
+
+		index = n.Parent;
+	}
+}
+
+
+//! rotates the higher child up if the subtree is unbalanced, returns the new subtree root
+s32 CSceneNodeCullingIndex::balance(s32 iA)
+{
+	STreeNode& A = Nodes[iA];
+	if (A.Height < 2)
+		return iA;
+
+	const s32 iB = A.Child1;
+	const s32 iC = A.Child2;
+	STreeNode& B = Nodes[iB];
+	STreeNode& C = Nodes[iC];
+
+	const s32 diff = C.Height - B.Height;
+
+	// rotate C up
+	if (diff > 1)
+	{
+		const s32 iF = C.Child1;
+		const s32 iG = C.Child2;
+		STreeNode& F = Nodes[iF];
+		STreeNode& G = Nodes[iG];
+
+		C.Child1 = iA;
+		C.Parent = A.Parent;
+		A.Parent = iC;
+
+		if (C.Parent != -1)
+		{
+			if (Nodes[C.Parent].Child1 == iA)
+				Nodes[C.Parent].Child1 = iC;
+			else
+				Nodes[C.Parent].Child2 = iC;
+		}
+		else
+			Root = iC;
+
+		if (F.Height > G.Height)
+		{
+			C.Child2 = iF;
+			A.Child2 = iG;
+			G.Parent = iA;
+			A.Box = mergeBoxes(B.Box, G.Box);
+			C.Box = mergeBoxes(A.Box, F.Box);
+			A.Height = 1 + core::max_(B.Height, G.Height);
+			C.Height = 1 + core::max_(A.Height, F.Height);
+		}
+		else
+		{
+			C.Child2 = iG;
+			A.Child2 = iF;
+			F.Parent = iA;
+			A.Box = mergeBoxes(B.Box, F.Box);
+			C.Box = mergeBoxes(A.Box, G.Box);
+			A.Height = 1 + core::max_(B.Height, F.Height);
+			C.Height = 1 + core::max_(A.Height, G.Height);
+		}
+
+		return iC;
+	}
+
+	// rotate B up
+	if (diff < -1)
+	{
+		const s32 iD = B.Child1;
+		const s32 iE = B.Child2;
+		STreeNode& D = Nodes[iD];
+		STreeNode& E = Nodes[iE];
+
+		B.Child1 = iA;
+		B.Parent = A.Parent;
+		A.Parent = iB;
+
+		if (B.Parent != -1)
+		{
+			if (Nodes[B.Parent].Child1 == iA)
+				Nodes[B.Parent].Child1 = iB;
+			else
+				Nodes[B.Parent].Child2 = iB;
+		}
+		else
+			Root = iB;
+
+		if (D.Height > E.Height)
+		{
+			B.Child2 = iD;
+			A.Child1 = iE;
+			E.Parent = iA;
+			A.Box = mergeBoxes(C.Box, E.Box);
+			B.Box = mergeBoxes(A.Box, D.Box);
+			A.Height = 1 + core::max_(C.Height, E.Height);
+			B.Height = 1 + core::max_(A.Height, D.Height);
+		}
+		else
+		{
+			B.Child2 = iE;
+			A.Child1 = iD;
+			D.Parent = iA;
+			A.Box = mergeBoxes(C.Box, D.Box);
+			B.Box = mergeBoxes(A.Box, E.Box);
+			A.Height = 1 + core::max_(C.Height, D.Height);
+			B.Height = 1 + core::max_(A.Height, E.Height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+
+//! returns the first slot to probe for a node, the slot count is a power of two
+u32 CSceneNodeCullingIndex::getHomeSlot(const ISceneNode* node) const
+{
+	u32 h = (u32)((size_t)node >> 3) * 2654435761u;
+	h ^= h >> 16;
+	return h & (Slots.size() - 1);
+}
+
+
+s32 CSceneNodeCullingIndex::findLeaf(const ISceneNode* node) const
+{
+	if (Slots.empty())
+		return -1;
+
+	const u32 mask = Slots.size() - 1;
+	for (u32 i=getHomeSlot(node); Slots[i].Key; i=(i+1) & mask)
+	{
+		if (Slots[i].Key == node)
+			return Slots[i].Leaf;
+	}
+	return -1;
+}
+
+
+void CSceneNodeCullingIndex::addKey(const ISceneNode* node, s32 leaf)
+{
+	// keep the table at most half full
+	if ((LeafCount + 1) * 2 > Slots.size())
+	{
+		core::array<SHashSlot> old(Slots);
+
+		u32 size = Slots.empty() ? 64 : Slots.size() * 2;
+		Slots.set_used(size);
+		for (u32 i=0; i<size; ++i)
+			Slots[i].Key = 0;
+
+		for (u32 i=0; i<old.size(); ++i)
+		{
+			if (old[i].Key)
+				addKey(old[i].Key, old[i].Leaf);
+		}
+	}
+
+	const u32 mask = Slots.size() - 1;
+	u32 i = getHomeSlot(node);
+	while (Slots[i].Key)
+		i = (i+1) & mask;
+
+	Slots[i].Key = node;
+	Slots[i].Leaf = leaf;
+}
+
+
+void CSceneNodeCullingIndex::removeKey(const ISceneNode* node)
+{
+	const u32 mask = Slots.size() - 1;
+	u32 i = getHomeSlot(node);
+	while (Slots[i].Key != node)
+		i = (i+1) & mask;
+
+	// shift following entries of the probe sequence back into the hole
+	u32 j = i;
+	for (;;)
+	{
+		j = (j+1) & mask;
+		if (!Slots[j].Key)
+			break;
+
+		const u32 home = getHomeSlot(Slots[j].Key);
+		const bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+		if (stays)
+			continue;
+
+		Slots[i] = Slots[j];
+		i = j;
+	}
+
+	Slots[i].Key = 0;
+}
+
+} // end namespace scene
+} // end namespace irr
+
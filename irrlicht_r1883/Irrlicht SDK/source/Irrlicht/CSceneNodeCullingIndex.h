@@ -0,0 +1,124 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_NODE_CULLING_INDEX_H_INCLUDED__
+#define __C_SCENE_NODE_CULLING_INDEX_H_INCLUDED__
+
+#include "irrArray.h"
+#include "aabbox3d.h"
+#include "matrix4.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+class ISceneNode;
+
+//! Bounding volume hierarchy over the world boxes of scene nodes.
+/** Leaves store a loose, slightly enlarged box, so a node is only moved
+in the tree when it leaves that box. The tree is kept balanced by rotations.
+Scene node pointers are only dereferenced in update(), so nodes which were
+deleted since the last frame are harmless until removeStale() drops them. */
+class CSceneNodeCullingIndex
+{
+public:
+
+	//! constructor
+	CSceneNodeCullingIndex();
+
+	//! Inserts a node, or refreshes its box if its transformation or bounding box changed
+	void update(ISceneNode* node, u32 frame);
+
+	//! Removes all nodes which were not updated in the given frame
+	void removeStale(u32 frame);
+
+	//! Marks all nodes which intersect the frustum as visible in the given frame
+	void cull(const SViewFrustum& frustum, u32 frame);
+
+	//! Returns true if the node is in the index
+	bool contains(const ISceneNode* node) const;
+
+	//! Returns true if the node was found visible by cull() in the given frame
+	bool isVisible(const ISceneNode* node, u32 frame) const;
+
+	//! Removes all nodes
+	void clear();
+
+	//! Returns the number of indexed scene nodes
+	u32 getNodeCount() const { return LeafCount; }
+
+	//! Returns the number of tree nodes tested against the frustum by the last cull()
+	u32 getVisitedCount() const { return Visited; }
+
+	//! Returns the number of scene nodes rejected by the last cull()
+	u32 getCulledCount() const { return Culled; }
+
+private:
+
+	struct STreeNode
+	{
+		//! loose box for leaves, union of both children otherwise
+		core::aabbox3d<f32> Box;
+
+		//! leaves only: world box of the scene node, and what it was built from
+		core::aabbox3d<f32> WorldBox;
+		core::aabbox3d<f32> LocalBox;
+		core::matrix4 Transform;
+		const ISceneNode* Node;
+		u32 UpdateFrame;
+		u32 VisibleFrame;
+
+		//! parent, or next free node for unused nodes
+		s32 Parent;
+		s32 Child1;
+		s32 Child2;
+
+		//! 0 for leaves, -1 for unused nodes
+		s32 Height;
+	};
+
+	struct SHashSlot
+	{
+		const ISceneNode* Key;
+		s32 Leaf;
+	};
+
+	struct SStackEntry
+	{
+		SStackEntry(s32 node, u32 planes) : Node(node), Planes(planes) {}
+
+		s32 Node;
+		//! frustum planes the box still has to be tested against
+		u32 Planes;
+	};
+
+	s32 allocateNode();
+	void freeNode(s32 index);
+	void insertLeaf(s32 leaf);
+	void removeLeaf(s32 leaf);
+	void refit(s32 index);
+	s32 balance(s32 index);
+
+	u32 getHomeSlot(const ISceneNode* node) const;
+	s32 findLeaf(const ISceneNode* node) const;
+	void addKey(const ISceneNode* node, s32 leaf);
+	void removeKey(const ISceneNode* node);
+
+	core::array<STreeNode> Nodes;
+	core::array<SHashSlot> Slots;
+	core::array<SStackEntry> Stack;
+	s32 Root;
+	s32 FreeList;
+	u32 LeafCount;
+	u32 Visited;
+	u32 Culled;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -10,6 +10,11 @@
 #include "IAnimatedMeshSceneNode.h"
 #include "os.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define _IRR_SKIN_WITH_SSE_
+#include <xmmintrin.h>
+#endif
+
 namespace irr
 {
 namespace scene
@@ -20,7 +25,8 @@ namespace scene
 CSkinnedMesh::CSkinnedMesh()
 : SkinningBuffers(0), HasAnimation(0), PreparedForSkinning(0),
 	AnimationFrames(0.f), LastAnimatedFrame(0.f), LastSkinnedFrame(0.f),
-	BoneControlUsed(false), AnimateNormals(true), HardwareSkinning(0), InterpolationMode(EIM_LINEAR)
+	BoneControlUsed(false), AnimateNormals(true), HardwareSkinning(0), InterpolationMode(EIM_LINEAR),
+	PackedSkinning(false), PackedSkinningValid(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CSkinnedMesh");
@@ -449,6 +455,12 @@ void CSkinnedMesh::skinMesh()
 			}
 		}
 
+		if (PackedSkinning)
+		{
+			skinPacked();
+			return;
+		}
+
 		//clear skinning helper array
 		for (i=0; i<Vertices_Moved.size(); ++i)
 			for (u32 j=0; j<Vertices_Moved[i].size(); ++j)
@@ -519,6 +531,235 @@ void CSkinnedMesh::SkinJoint(SJoint *joint, SJoint *parentJoint)
 }
 
 
+//! Selects the packed software skinning path
+void CSkinnedMesh::setPackedSkinning(bool on)
+{
+	PackedSkinning = on;
+}
+
+
+//! builds the per vertex influence lists for the packed skinning
+void CSkinnedMesh::buildPackedSkinning()
+{
+	u32 i, j, b;
+
+	PackedSkinningValid = true;
+
+	// count the influences of each vertex
+	core::array< core::array<u32> > slot;
+	slot.reallocate(SkinningBuffers->size());
+	for (b=0; b<SkinningBuffers->size(); ++b)
+	{
+		slot.push_back(core::array<u32>());
+		slot[b].set_used((*SkinningBuffers)[b]->getVertexCount());
+		for (j=0; j<slot[b].size(); ++j)
+			slot[b][j] = 0;
+	}
+
+	for (i=0; i<AllJoints.size(); ++i)
+	{
+		const SJoint* joint = AllJoints[i];
+		for (j=0; j<joint->Weights.size(); ++j)
+			++slot[joint->Weights[j].buffer_id][joint->Weights[j].vertex_id];
+	}
+
+	// lay out the skinned vertices buffer by buffer, in vertex order
+	PackedBufferStart.set_used(0);
+	PackedVertexId.set_used(0);
+	PackedInfluenceStart.set_used(0);
+
+	u32 influences = 0;
+	for (b=0; b<SkinningBuffers->size(); ++b)
+	{
+		PackedBufferStart.push_back(PackedVertexId.size());
+		for (j=0; j<slot[b].size(); ++j)
+		{
+			const u32 count = slot[b][j];
+			if (!count)
+				continue;
+
+			// from now on slot is the insertion point of the vertex' next influence
+			slot[b][j] = influences;
+			PackedVertexId.push_back(j);
+			PackedInfluenceStart.push_back(influences);
+			influences += count;
+		}
+	}
+	PackedBufferStart.push_back(PackedVertexId.size());
+	PackedInfluenceStart.push_back(influences);
+
+	PackedJoint.set_used(influences);
+	PackedWeight.set_used(influences);
+	PackedStaticPos.set_used(PackedVertexId.size());
+	PackedStaticNormal.set_used(PackedVertexId.size());
+
+	for (i=0; i<AllJoints.size(); ++i)
+	{
+		const SJoint* joint = AllJoints[i];
+		for (j=0; j<joint->Weights.size(); ++j)
+		{
+			const SWeight& weight = joint->Weights[j];
+			const u32 k = slot[weight.buffer_id][weight.vertex_id]++;
+			PackedJoint[k] = i;
+			PackedWeight[k] = weight.strength;
+		}
+	}
+
+	// the static pose is the same in all weights of a vertex
+	for (i=0; i<AllJoints.size(); ++i)
+	{
+		const SJoint* joint = AllJoints[i];
+		for (j=0; j<joint->Weights.size(); ++j)
+		{
+			const SWeight& weight = joint->Weights[j];
+			const u32 first = PackedBufferStart[weight.buffer_id];
+			const u32 last = PackedBufferStart[weight.buffer_id+1];
+
+			// binary search the vertex in the sorted ids of its buffer
+			const core::array<u32>& ids = PackedVertexId;
+			u32 lo = first, hi = last;
+			while (lo < hi)
+			{
+				const u32 mid = (lo + hi) / 2;
+				if (ids[mid] < weight.vertex_id)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+
+			PackedStaticPos[lo] = weight.StaticPos;
+			PackedStaticNormal[lo] = weight.StaticNormal;
+		}
+	}
+}
+
+
+//! skins all buffers with the packed influence lists
+void CSkinnedMesh::skinPacked()
+{
+	u32 i;
+
+	if (!PackedSkinningValid)
+		buildPackedSkinning();
+
+	// the pull of each joint on its vertices
+	JointSkinMatrices.set_used(AllJoints.size() * 16);
+	for (i=0; i<AllJoints.size(); ++i)
+	{
+		if (!AllJoints[i]->Weights.size())
+			continue;
+
+		core::matrix4 pull(core::matrix4::EM4CONST_NOTHING);
+		pull.setbyproduct(AllJoints[i]->GlobalAnimatedMatrix, AllJoints[i]->GlobalInversedMatrix);
+
+		const core::matrix4& m = pull;
+		f32* dst = &JointSkinMatrices[i*16];
+		for (u32 k=0; k<16; ++k)
+			dst[k] = m[k];
+	}
+
+	const f32* matrices = JointSkinMatrices.const_pointer();
+	const u32* joints = PackedJoint.const_pointer();
+	const f32* weights = PackedWeight.const_pointer();
+
+	for (u32 b=0; b<SkinningBuffers->size(); ++b)
+	{
+		SSkinMeshBuffer* buffer = (*SkinningBuffers)[b];
+		const u32 first = PackedBufferStart[b];
+		const u32 last = PackedBufferStart[b+1];
+
+		if (first != last)
+		{
+			u32 pitch;
+			switch (buffer->VertexType)
+			{
+			case video::EVT_2TCOORDS:
+				pitch = sizeof(video::S3DVertex2TCoords);
+				break;
+			case video::EVT_TANGENTS:
+				pitch = sizeof(video::S3DVertexTangents);
+				break;
+			default:
+				pitch = sizeof(video::S3DVertex);
+				break;
+			}
+
+			u8* vertices = (u8*)buffer->getVertices();
+
+			for (u32 v=first; v<last; ++v)
+			{
+				video::S3DVertex* vertex = (video::S3DVertex*)(vertices + PackedVertexId[v] * pitch);
+				const core::vector3df& pos = PackedStaticPos[v];
+				const u32 end = PackedInfluenceStart[v+1];
+
+#ifdef _IRR_SKIN_WITH_SSE_
+				// blend the columns of the joint matrices
+				__m128 c0 = _mm_setzero_ps();
+				__m128 c1 = _mm_setzero_ps();
+				__m128 c2 = _mm_setzero_ps();
+				__m128 c3 = _mm_setzero_ps();
+
+				for (u32 k=PackedInfluenceStart[v]; k<end; ++k)
+				{
+					const f32* m = matrices + joints[k] * 16;
+					const __m128 w = _mm_set1_ps(weights[k]);
+					c0 = _mm_add_ps(c0, _mm_mul_ps(w, _mm_loadu_ps(m)));
+					c1 = _mm_add_ps(c1, _mm_mul_ps(w, _mm_loadu_ps(m+4)));
+					c2 = _mm_add_ps(c2, _mm_mul_ps(w, _mm_loadu_ps(m+8)));
+					c3 = _mm_add_ps(c3, _mm_mul_ps(w, _mm_loadu_ps(m+12)));
+				}
+
+				f32 out[4];
+				__m128 r = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(pos.X)));
+				r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(pos.Y)));
+				r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(pos.Z)));
+				_mm_storeu_ps(out, r);
+				vertex->Pos.set(out[0], out[1], out[2]);
+
+				if (AnimateNormals)
+				{
+					const core::vector3df& normal = PackedStaticNormal[v];
+					r = _mm_mul_ps(c0, _mm_set1_ps(normal.X));
+					r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(normal.Y)));
+					r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(normal.Z)));
+					_mm_storeu_ps(out, r);
+					vertex->Normal.set(out[0], out[1], out[2]);
+				}
+#else
+				f32 c[16] = {0};
+
+				for (u32 k=PackedInfluenceStart[v]; k<end; ++k)
+				{
+					const f32* m = matrices + joints[k] * 16;
+					const f32 w = weights[k];
+					for (u32 n=0; n<16; ++n)
+						c[n] += w * m[n];
+				}
+
+				vertex->Pos.set(
+					pos.X*c[0] + pos.Y*c[4] + pos.Z*c[8] + c[12],
+					pos.X*c[1] + pos.Y*c[5] + pos.Z*c[9] + c[13],
+					pos.X*c[2] + pos.Y*c[6] + pos.Z*c[10] + c[14]);
+
+				if (AnimateNormals)
+				{
+					const core::vector3df& normal = PackedStaticNormal[v];
+					vertex->Normal.set(
+						normal.X*c[0] + normal.Y*c[4] + normal.Z*c[8],
+						normal.X*c[1] + normal.Y*c[5] + normal.Z*c[9],
+						normal.X*c[2] + normal.Y*c[6] + normal.Z*c[10]);
+				}
+#endif
+			}
+
+			buffer->boundingBoxNeedsRecalculated();
+		}
+
+		buffer->setDirty(EBT_VERTEX);
+	}
+}
+
+
 E_ANIMATED_MESH_TYPE CSkinnedMesh::getMeshType() const
 {
 	return EAMT_SKINNED;
@@ -857,6 +1098,8 @@ void CSkinnedMesh::checkForAnimation()
 
 		// normalize weights
 		normalizeWeights();
+
+		PackedSkinningValid = false;
 	}
 }
 
@@ -1189,6 +1432,7 @@ CSkinnedMesh::SWeight *CSkinnedMesh::createWeight(SJoint *joint)
 		return 0;
 
 	joint->Weights.push_back(SWeight());
+	PackedSkinningValid = false;
 	return &joint->Weights.getLast();
 }
 
@@ -45,6 +45,9 @@ namespace scene
 		//! Preforms a software skin on this mesh based of joint positions
 		virtual void skinMesh();
 
+		//! Selects the packed software skinning path
+		virtual void setPackedSkinning(bool on);
+
 		//! returns amount of mesh buffers.
 		virtual u32 getMeshBufferCount() const;
 
@@ -165,6 +168,12 @@ private:
 
 		void SkinJoint(SJoint *Joint, SJoint *ParentJoint);
 
+		//! builds the per vertex influence lists for the packed skinning
+		void buildPackedSkinning();
+
+		//! skins all buffers with the packed influence lists
+		void skinPacked();
+
 		void calculateTangents(core::vector3df& normal,
 			core::vector3df& tangent, core::vector3df& binormal,
 			core::vector3df& vt1, core::vector3df& vt2, core::vector3df& vt3,
@@ -197,6 +206,26 @@ private:
 		core::aabbox3d<f32> BoundingBox;
 
 		core::array< core::array<bool> > Vertices_Moved;
+
+		//! packed skinning, see setPackedSkinning()
+		bool PackedSkinning;
+		bool PackedSkinningValid;
+
+		//! skinned vertices of buffer b are [PackedBufferStart[b], PackedBufferStart[b+1])
+		core::array<u32> PackedBufferStart;
+
+		//! per skinned vertex, influences of vertex v are [PackedInfluenceStart[v], PackedInfluenceStart[v+1])
+		core::array<u32> PackedVertexId;
+		core::array<u32> PackedInfluenceStart;
+		core::array<core::vector3df> PackedStaticPos;
+		core::array<core::vector3df> PackedStaticNormal;
+
+		//! per influence
+		core::array<u32> PackedJoint;
+		core::array<f32> PackedWeight;
+
+		//! 16 floats per joint, rebuilt every frame
+		core::array<f32> JointSkinMatrices;
 	};
 
 } // end namespace scene
@@ -349,6 +349,16 @@ void CSoftwareDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCo
 //! draws a vertex primitive list
 void CSoftwareDriver::drawVertexPrimitiveList16(const void* vertices, u32 vertexCount, const u16* indexList, u32 primitiveCount, E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType)
 {
+	// load an evicted texture again, draw without it if it cannot be loaded
+	if (Texture)
+	{
+		const bool evicted = Texture->isEvicted();
+		if (!useTexture(Texture))
+			setTexture(0);
+		else if (evicted)
+			selectRightTriangleRenderer();
+	}
+
 	const u16* indexPointer=0;
 	core::array<u16> newBuffer;
 	switch (pType)
@@ -793,6 +803,9 @@ void CSoftwareDriver::draw2DImage(const video::ITexture* texture, const core::po
 			return;
 		}
 
+		if (!useTexture(texture))
+			return;
+
 		if (useAlphaChannelOfTexture)
 			((CSoftwareTexture*)texture)->getImage()->copyToWithAlpha(
 				((CImage*)RenderTargetSurface), destPos, sourceRect, color, clipRect);
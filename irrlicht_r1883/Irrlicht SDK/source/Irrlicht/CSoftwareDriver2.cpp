@@ -11,9 +11,15 @@
 #include "SoftwareDriver2_helper.h"
 #include "CSoftwareTexture2.h"
 #include "CSoftware2MaterialRenderer.h"
+#include "CBurningBinner.h"
+#include "CThreadPool.h"
 #include "S3DVertex.h"
 #include "S4DVertex.h"
 
+#ifdef SOFTWARE_DRIVER_2_SSE
+#include <xmmintrin.h>
+#endif
+
 
 #define MAT_TEXTURE(tex) ( (video::CSoftwareTexture2*) Material.org.getTexture ( tex ) )
 
@@ -29,7 +35,7 @@ CBurningVideoDriver::CBurningVideoDriver(const core::dimension2d<s32>& windowSiz
 : CNullDriver(io, windowSize), BackBuffer(0), Presenter(presenter),
 	WindowId(0), SceneSourceRect(0),
 	RenderTargetTexture(0), RenderTargetSurface(0), CurrentShader(0),
-	 DepthBuffer(0), CurrentOut ( 12 * 2, 128 ), Temp ( 12 * 2, 128 )
+	CurrentShaderType(ETR_INVALID), Binner(0), DepthBuffer(0), CurrentOut ( 12 * 2, 128 ), Temp ( 12 * 2, 128 )
 {
 	#ifdef _DEBUG
 	setDebugName("CBurningVideoDriver");
@@ -47,35 +53,7 @@ CBurningVideoDriver::CBurningVideoDriver(const core::dimension2d<s32>& windowSiz
 
 	// create triangle renderers
 
-	irr::memset32 ( BurningShader, 0, sizeof ( BurningShader ) );
-	//BurningShader[ETR_FLAT] = createTRFlat2(DepthBuffer);
-	//BurningShader[ETR_FLAT_WIRE] = createTRFlatWire2(DepthBuffer);
-	BurningShader[ETR_GOURAUD] = createTriangleRendererGouraud2(DepthBuffer);
-	BurningShader[ETR_GOURAUD_ALPHA] = createTriangleRendererGouraudAlpha2(DepthBuffer );
-	BurningShader[ETR_GOURAUD_ALPHA_NOZ] = createTRGouraudAlphaNoZ2(DepthBuffer );
-	//BurningShader[ETR_GOURAUD_WIRE] = createTriangleRendererGouraudWire2(DepthBuffer);
-	//BurningShader[ETR_TEXTURE_FLAT] = createTriangleRendererTextureFlat2(DepthBuffer);
-	//BurningShader[ETR_TEXTURE_FLAT_WIRE] = createTriangleRendererTextureFlatWire2(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD] = createTriangleRendererTextureGouraud2(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP] = createTriangleRendererTextureLightMap2_M1(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M2] = createTriangleRendererTextureLightMap2_M2(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M4] = createTriangleRendererGTextureLightMap2_M4(DepthBuffer);
-	BurningShader[ETR_TEXTURE_LIGHTMAP_M4] = createTriangleRendererTextureLightMap2_M4(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_ADD] = createTriangleRendererTextureLightMap2_Add(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD_DETAIL_MAP] = createTriangleRendererTextureDetailMap2(DepthBuffer);
-
-	BurningShader[ETR_TEXTURE_GOURAUD_WIRE] = createTriangleRendererTextureGouraudWire2(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD_NOZ] = createTRTextureGouraudNoZ2();
-	BurningShader[ETR_TEXTURE_GOURAUD_ADD] = createTRTextureGouraudAdd2(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD_ADD_NO_Z] = createTRTextureGouraudAddNoZ2(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD_VERTEX_ALPHA] = createTriangleRendererTextureVertexAlpha2 ( DepthBuffer );
-
-	BurningShader[ETR_TEXTURE_GOURAUD_ALPHA] = createTRTextureGouraudAlpha(DepthBuffer );
-	BurningShader[ETR_TEXTURE_GOURAUD_ALPHA_NOZ] = createTRTextureGouraudAlphaNoZ( DepthBuffer );
-
-	BurningShader[ETR_TEXTURE_BLEND] = createTRTextureBlend( DepthBuffer );
-
-	BurningShader[ETR_REFERENCE] = createTriangleRendererReference ( DepthBuffer );
+	createBurningShaders ( BurningShader, DepthBuffer );
 
 
 	// add the same renderer for all solid types
@@ -128,6 +106,8 @@ CBurningVideoDriver::CBurningVideoDriver(const core::dimension2d<s32>& windowSiz
 //! destructor
 CBurningVideoDriver::~CBurningVideoDriver()
 {
+	delete Binner;
+
 	// delete Backbuffer
 	if (BackBuffer)
 		BackBuffer->drop();
@@ -244,31 +224,12 @@ void CBurningVideoDriver::setCurrentShader()
 	//shader = ETR_REFERENCE;
 
 	// switchToTriangleRenderer
+	CurrentShaderType = shader;
 	CurrentShader = BurningShader[shader];
 	if ( CurrentShader )
 	{
-		CurrentShader->setZCompareFunc ( Material.org.ZBuffer );
-		switch ( shader )
-		{
-			case ETR_TEXTURE_GOURAUD_ALPHA:
-			case ETR_TEXTURE_GOURAUD_ALPHA_NOZ:
-				CurrentShader->setParam ( 0, Material.org.MaterialTypeParam );
-				break;
-
-			case EMT_ONETEXTURE_BLEND:
-			{
-				E_BLEND_FACTOR srcFact,dstFact;
-				E_MODULATE_FUNC modulate;
-				unpack_texureBlendFunc ( srcFact, dstFact, modulate, Material.org.MaterialTypeParam );
-				CurrentShader->setParam ( 0, Material.org.MaterialTypeParam );
-			}
-			break;
-			default:
-			break;
-		}
-
 		CurrentShader->setRenderTarget(RenderTargetSurface, ViewPort);
-		CurrentShader->setMaterial ( Material );
+		setBurningShaderMaterial ( CurrentShader, shader, Material );
 	}
 }
 
@@ -387,6 +348,8 @@ void CBurningVideoDriver::setMaterial(const SMaterial& material)
 bool CBurningVideoDriver::beginScene(bool backBuffer, bool zBuffer,
 		SColor color, void* windowId, core::rect<s32>* sourceRect)
 {
+	flushTriangles();
+
 	CNullDriver::beginScene(backBuffer, zBuffer, color, windowId, sourceRect);
 	WindowId = windowId;
 	SceneSourceRect = sourceRect;
@@ -404,6 +367,8 @@ bool CBurningVideoDriver::beginScene(bool backBuffer, bool zBuffer,
 //! presents the rendered scene on the screen, returns false if failed
 bool CBurningVideoDriver::endScene()
 {
+	flushTriangles();
+
 	CNullDriver::endScene();
 
 	return Presenter->present(BackBuffer, WindowId, SceneSourceRect);
@@ -420,6 +385,8 @@ bool CBurningVideoDriver::setRenderTarget(video::ITexture* texture, bool clearBa
 		return false;
 	}
 
+	flushTriangles();
+
 	if (RenderTargetTexture)
 		RenderTargetTexture->drop();
 
@@ -451,6 +418,8 @@ bool CBurningVideoDriver::setRenderTarget(video::ITexture* texture, bool clearBa
 //! sets a render target
 void CBurningVideoDriver::setRenderTarget(video::CImage* image)
 {
+	flushTriangles();
+
 	if (RenderTargetSurface)
 		RenderTargetSurface->drop();
 
@@ -887,11 +856,33 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex,
 #endif
 
 	// transfer texture coordinates
+	VertexCache_fillTexCoords ( dest, (S3DVertex*) source );
+
+	dest[0].flag = dest[1].flag = vSize[VertexCache.vType].Format;
+
+	// test vertex
+	dest[0].flag |= clipToFrustumTest ( dest);
+
+	// to DC Space, project homogenous vertex
+	if ( (dest[0].flag & VERTEX4D_CLIPMASK ) == VERTEX4D_INSIDE )
+	{
+		ndc_2_dc_and_project2 ( (const s4DVertex**) &dest, 1 );
+	}
+
+	//return dest;
+}
+
+
+/*!
+	transfer and transform the texture coordinates of a vertex
+*/
+void CBurningVideoDriver::VertexCache_fillTexCoords ( s4DVertex *dest, const S3DVertex *source ) const
+{
 	if ( Transformation [ ETS_TEXTURE_0 ].isIdentity )
 	{
 		// only look on first transform
 		irr::memcpy32_small ( &dest->Tex[0],
-						&((S3DVertex*) source )->TCoords,
+						&source->TCoords,
 						vSize[VertexCache.vType].TexSize * ( sizeof ( f32 ) * 2 )
 					);
 	}
@@ -908,7 +899,7 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex,
 				Uw  Vw  0  0
 	*/
 
-		const core::vector2d<f32> *src = &((S3DVertex*) source )->TCoords;
+		const core::vector2d<f32> *src = &source->TCoords;
 		u32 t;
 
 		for ( t = 0; t != vSize[VertexCache.vType].TexSize; ++t )
@@ -935,21 +926,132 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex,
 		}
 
 	}
+}
 
-	dest[0].flag = dest[1].flag = vSize[VertexCache.vType].Format;
+#ifdef SOFTWARE_DRIVER_2_SSE
 
-	// test vertex
-	dest[0].flag |= clipToFrustumTest ( dest);
+//! transforms four points given as x, y and z vectors, same operation order as matrix4::transformVect
+static inline void transformVect4 ( __m128 *out, const core::matrix4 &m, const __m128 &x, const __m128 &y, const __m128 &z )
+{
+	for ( u32 i = 0; i != 4; ++i )
+	{
+		out[i] = _mm_add_ps ( _mm_mul_ps ( x, _mm_set1_ps ( m[i] ) ), _mm_mul_ps ( y, _mm_set1_ps ( m[i+4] ) ) );
+		out[i] = _mm_add_ps ( out[i], _mm_mul_ps ( z, _mm_set1_ps ( m[i+8] ) ) );
+		out[i] = _mm_add_ps ( out[i], _mm_set1_ps ( m[i+12] ) );
+	}
+}
 
-	// to DC Space, project homogenous vertex
-	if ( (dest[0].flag & VERTEX4D_CLIPMASK ) == VERTEX4D_INSIDE )
+//! squared length of four vectors
+static inline __m128 lengthSQ4 ( const __m128 &x, const __m128 &y, const __m128 &z )
+{
+	return _mm_add_ps ( _mm_add_ps ( _mm_mul_ps ( x, x ), _mm_mul_ps ( y, y ) ), _mm_mul_ps ( z, z ) );
+}
+
+//! normalizes four vectors like sVec4::normalize_xyz
+static inline void normalize4 ( __m128 &x, __m128 &y, __m128 &z )
+{
+	const __m128 l = _mm_div_ps ( _mm_set1_ps ( 1.f ), _mm_sqrt_ps ( lengthSQ4 ( x, y, z ) ) );
+	x = _mm_mul_ps ( x, l );
+	y = _mm_mul_ps ( y, l );
+	z = _mm_mul_ps ( z, l );
+}
+
+
+/*!
+	fill four cache entries at once
+	the vertices are transformed and clip tested as structure of arrays
+*/
+void CBurningVideoDriver::VertexCache_fill4 ( const u32 *sourceIndex, const u32 *destIndex )
+{
+	const S3DVertex * source[4];
+	s4DVertex * dest[4];
+	u32 g;
+
+	for ( g = 0; g != 4; ++g )
 	{
-		ndc_2_dc_and_project2 ( (const s4DVertex**) &dest, 1 );
+		source[g] = (const S3DVertex*) ( (u8*) VertexCache.vertices + ( sourceIndex[g] * vSize[VertexCache.vType].Pitch ) );
+		dest[g] = (s4DVertex *) ( (u8*) VertexCache.mem.data + ( destIndex[g] << ( SIZEOF_SVERTEX_LOG2 + 1  ) ) );
+
+		// store info
+		VertexCache.info[ destIndex[g] ].index = sourceIndex[g];
+		VertexCache.info[ destIndex[g] ].hit = 0;
 	}
 
-	//return dest;
+	// transform Model * World * Camera * Projection * NDCSpace matrix
+	__m128 pos[4];
+	transformVect4 ( pos, Transformation [ ETS_CURRENT].m,
+		_mm_set_ps ( source[3]->Pos.X, source[2]->Pos.X, source[1]->Pos.X, source[0]->Pos.X ),
+		_mm_set_ps ( source[3]->Pos.Y, source[2]->Pos.Y, source[1]->Pos.Y, source[0]->Pos.Y ),
+		_mm_set_ps ( source[3]->Pos.Z, source[2]->Pos.Z, source[1]->Pos.Z, source[0]->Pos.Z ) );
+
+	// test vertices, dot products with the NDCPlanes
+	const __m128 sign = _mm_set1_ps ( -0.f );
+	const __m128 nx = _mm_xor_ps ( pos[0], sign );
+	const __m128 ny = _mm_xor_ps ( pos[1], sign );
+	const __m128 nz = _mm_xor_ps ( pos[2], sign );
+	const __m128 nw = _mm_xor_ps ( pos[3], sign );
+
+	__m128 plane[6];
+	plane[0] = _mm_add_ps ( nz, nw );
+	plane[1] = _mm_add_ps ( pos[2], nw );
+	plane[2] = _mm_add_ps ( pos[0], nw );
+	plane[3] = _mm_add_ps ( nx, nw );
+	plane[4] = _mm_add_ps ( pos[1], nw );
+	plane[5] = _mm_add_ps ( ny, nw );
+
+	s32 mask[6];
+#ifdef IRRLICHT_FAST_MATH
+	// sign bits, near and far swapped like in clipToFrustumTest
+	mask[0] = _mm_movemask_ps ( plane[1] );
+	mask[1] = _mm_movemask_ps ( plane[0] );
+	for ( g = 2; g != 6; ++g )
+		mask[g] = _mm_movemask_ps ( plane[g] );
+#else
+	for ( g = 0; g != 6; ++g )
+		mask[g] = _mm_movemask_ps ( _mm_cmple_ps ( plane[g], _mm_setzero_ps () ) );
+#endif
+
+	_MM_TRANSPOSE4_PS ( pos[0], pos[1], pos[2], pos[3] );
+
+#ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
+	// light Vertex
+	#ifdef SOFTWARE_DRIVER_2_LIGHTING
+		lightVertex4 ( dest, source );
+	#else
+		for ( g = 0; g != 4; ++g )
+			dest[g]->Color[0].setA8R8G8B8 ( source[g]->Color.color );
+	#endif
+#endif
+
+	const s4DVertex * inside[4];
+	u32 insideCount = 0;
+
+	for ( g = 0; g != 4; ++g )
+	{
+		s4DVertex * d = dest[g];
+		_mm_storeu_ps ( &d->Pos.x, pos[g] );
+
+		// transfer texture coordinates
+		VertexCache_fillTexCoords ( d, source[g] );
+
+		u32 flag = 0;
+		for ( u32 i = 0; i != 6; ++i )
+			flag |= ( ( mask[i] >> g ) & 1 ) << i;
+
+		d[0].flag = d[1].flag = vSize[VertexCache.vType].Format;
+		d[0].flag |= flag;
+
+		if ( flag == VERTEX4D_INSIDE )
+			inside[insideCount++] = d;
+	}
+
+	// to DC Space, project homogenous vertex
+	ndc_2_dc_and_project2 ( inside, insideCount );
 }
 
+#endif // SOFTWARE_DRIVER_2_SSE
+
+
 //
 
 REALINLINE s4DVertex * CBurningVideoDriver::VertexCache_getVertex ( const u32 sourceIndex )
@@ -1033,6 +1135,10 @@ REALINLINE void CBurningVideoDriver::VertexCache_get ( s4DVertex ** face )
 		}
 
 		// fill new
+		u32 fillSource[VERTEXCACHE_ELEMENT];
+		u32 fillDest[VERTEXCACHE_ELEMENT];
+		u32 fillCount = 0;
+
 		for ( i = 0; i!= fillIndex; ++i )
 		{
 			if ( info[i].hit != VERTEXCACHE_MISS )
@@ -1042,13 +1148,30 @@ REALINLINE void CBurningVideoDriver::VertexCache_get ( s4DVertex ** face )
 			{
 				if ( 0 == VertexCache.info[dIndex].hit )
 				{
-					VertexCache_fill ( info[i].index, dIndex );
+					fillSource[fillCount] = info[i].index;
+					fillDest[fillCount] = dIndex;
+					fillCount += 1;
+
 					VertexCache.info[dIndex].hit += 1;
 					info[i].hit = dIndex;
 					break;
 				}
 			}
 		}
+
+		i = 0;
+
+#ifdef SOFTWARE_DRIVER_2_SSE
+		// larger meshes fill four at once
+		if ( VertexCache.vertexCount >= VERTEXCACHE_BATCH_MIN_VERTICES )
+		{
+			for ( ; i + 4 <= fillCount; i += 4 )
+				VertexCache_fill4 ( fillSource + i, fillDest + i );
+		}
+#endif
+
+		for ( ; i != fillCount; ++i )
+			VertexCache_fill ( fillSource[i], fillDest[i] );
 	}
 
 	const u32 i0 = core::if_c_a_else_0 ( VertexCache.pType != scene::EPT_TRIANGLE_FAN, VertexCache.indicesRun );
@@ -1139,9 +1262,21 @@ void CBurningVideoDriver::drawVertexPrimitiveList16(const void* vertices, u32 ve
 
 	CNullDriver::drawVertexPrimitiveList(vertices, vertexCount, indexList, primitiveCount, vType, pType, EIT_16BIT);
 
+	// load evicted textures again, draw without those which cannot be loaded
+	for ( u32 t = 0; t != BURNING_MATERIAL_MAX_TEXTURES; ++t )
+	{
+		if ( MAT_TEXTURE ( t ) && !useTexture ( MAT_TEXTURE ( t ) ) )
+		{
+			Material.org.setTexture ( t, 0 );
+			setCurrentShader ();
+		}
+	}
+
 	if ( 0 == CurrentShader )
 		return;
 
+	if ( Binner )
+		Binner->setMaterial ( CurrentShaderType, Material );
 
 	VertexCache_reset ( vertices, vertexCount, indexList, primitiveCount, vType, pType );
 
@@ -1191,7 +1326,15 @@ void CBurningVideoDriver::drawVertexPrimitiveList16(const void* vertices, u32 ve
 			}
 
 			// rasterize
-			CurrentShader->drawTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
+			if ( Binner )
+			{
+				Binner->setTextures ( CurrentShader );
+				Binner->addTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
+			}
+			else
+			{
+				CurrentShader->drawTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
+			}
 			continue;
 		}
 
@@ -1308,13 +1451,25 @@ void CBurningVideoDriver::drawVertexPrimitiveList16(const void* vertices, u32 ve
 			select_polygon_mipmap ( CurrentOut.data, vOut, g );
 		}
 
+		if ( Binner )
+			Binner->setTextures ( CurrentShader );
+
 		// re-tesselate ( triangle-fan, 0-1-2,0-2-3.. )
 		for ( g = 0; g <= vOut - 6; g += 2 )
 		{
 			// rasterize
-			CurrentShader->drawTriangle ( CurrentOut.data + 0 + 1,
+			if ( Binner )
+			{
+				Binner->addTriangle ( CurrentOut.data + 0 + 1,
+							CurrentOut.data + g + 3,
+							CurrentOut.data + g + 5);
+			}
+			else
+			{
+				CurrentShader->drawTriangle ( CurrentOut.data + 0 + 1,
 							CurrentOut.data + g + 3,
 							CurrentOut.data + g + 5);
+			}
 		}
 
 	}
@@ -1541,6 +1696,189 @@ void CBurningVideoDriver::lightVertex ( s4DVertex *dest, const S3DVertex *source
 	dest->Color[0] = dColor;
 }
 
+#ifdef SOFTWARE_DRIVER_2_SSE
+
+/*!
+	lights four vertices at once, each light is evaluated for all four
+	in structure of arrays form, with the same operations as lightVertex
+*/
+void CBurningVideoDriver::lightVertex4 ( s4DVertex **dest, const S3DVertex **source )
+{
+	u32 g;
+
+	if ( false == Material.org.Lighting || Lights.size () == 0 )
+	{
+		for ( g = 0; g != 4; ++g )
+			lightVertex ( dest[g], source[g] );
+		return;
+	}
+
+	const __m128 zero = _mm_setzero_ps ();
+	const __m128 one = _mm_set1_ps ( 1.f );
+
+	// vertex in eye space
+	__m128 eye[4];
+	transformVect4 ( eye, Transformation[ETS_WORLD_VIEW].m,
+		_mm_set_ps ( source[3]->Pos.X, source[2]->Pos.X, source[1]->Pos.X, source[0]->Pos.X ),
+		_mm_set_ps ( source[3]->Pos.Y, source[2]->Pos.Y, source[1]->Pos.Y, source[0]->Pos.Y ),
+		_mm_set_ps ( source[3]->Pos.Z, source[2]->Pos.Z, source[1]->Pos.Z, source[0]->Pos.Z ) );
+
+	const __m128 iw = _mm_div_ps ( one, eye[3] );
+	eye[0] = _mm_mul_ps ( eye[0], iw );
+	eye[1] = _mm_mul_ps ( eye[1], iw );
+	eye[2] = _mm_mul_ps ( eye[2], iw );
+
+	__m128 unitX = eye[0];
+	__m128 unitY = eye[1];
+	__m128 unitZ = eye[2];
+	normalize4 ( unitX, unitY, unitZ );
+
+	// vertex normal in eye-space
+	const __m128 sx = _mm_set_ps ( source[3]->Normal.X, source[2]->Normal.X, source[1]->Normal.X, source[0]->Normal.X );
+	const __m128 sy = _mm_set_ps ( source[3]->Normal.Y, source[2]->Normal.Y, source[1]->Normal.Y, source[0]->Normal.Y );
+	const __m128 sz = _mm_set_ps ( source[3]->Normal.Z, source[2]->Normal.Z, source[1]->Normal.Z, source[0]->Normal.Z );
+	const core::matrix4 &n = Transformation[ETS_WORLD_VIEW_INVERSE_TRANSPOSED].m;
+
+	__m128 normalX = _mm_add_ps ( _mm_add_ps ( _mm_mul_ps ( sx, _mm_set1_ps ( n[0] ) ), _mm_mul_ps ( sy, _mm_set1_ps ( n[4] ) ) ), _mm_mul_ps ( sz, _mm_set1_ps ( n[8] ) ) );
+	__m128 normalY = _mm_add_ps ( _mm_add_ps ( _mm_mul_ps ( sx, _mm_set1_ps ( n[1] ) ), _mm_mul_ps ( sy, _mm_set1_ps ( n[5] ) ) ), _mm_mul_ps ( sz, _mm_set1_ps ( n[9] ) ) );
+	__m128 normalZ = _mm_add_ps ( _mm_add_ps ( _mm_mul_ps ( sx, _mm_set1_ps ( n[2] ) ), _mm_mul_ps ( sy, _mm_set1_ps ( n[6] ) ) ), _mm_mul_ps ( sz, _mm_set1_ps ( n[10] ) ) );
+	if ( Material.org.NormalizeNormals )
+	{
+		normalize4 ( normalX, normalY, normalZ );
+	}
+
+	// color channels a, r, g, b of four vertices
+	__m128 ambient[4];
+	__m128 diffuse[4];
+	__m128 specular[4];
+
+	// the universe started in darkness..
+	for ( g = 0; g != 4; ++g )
+	{
+		ambient[g] = zero;
+		diffuse[g] = zero;
+		specular[g] = zero;
+	}
+
+	for ( u32 i = 0; i!= LightSpace.Light.size (); ++i )
+	{
+		const SBurningShaderLight &light = LightSpace.Light[i];
+
+		__m128 vpX, vpY, vpZ;		// unit vector vertex to light
+		__m128 halfX, halfY, halfZ;	// blinn-phong reflection
+		__m128 attenuation;
+
+		switch ( light.org.Type )
+		{
+			case video::ELT_POINT:
+			{
+				// surface to light
+				vpX = _mm_sub_ps ( _mm_set1_ps ( light.posEyeSpace.x ), eye[0] );
+				vpY = _mm_sub_ps ( _mm_set1_ps ( light.posEyeSpace.y ), eye[1] );
+				vpZ = _mm_sub_ps ( _mm_set1_ps ( light.posEyeSpace.z ), eye[2] );
+
+				// irrlicht attenuation model
+				const __m128 d = _mm_sqrt_ps ( lengthSQ4 ( vpX, vpY, vpZ ) );
+				attenuation = _mm_add_ps ( _mm_set1_ps ( light.constantAttenuation ),
+									_mm_mul_ps ( _mm_set1_ps ( light.linearAttenuation ), d ) );
+				attenuation = _mm_add_ps ( attenuation,
+									_mm_mul_ps ( _mm_mul_ps ( _mm_set1_ps ( light.quadraticAttenuation ), d ), d ) );
+				attenuation = _mm_div_ps ( one, attenuation );
+
+				// normalize surface to light
+				normalize4 ( vpX, vpY, vpZ );
+
+				halfX = _mm_sub_ps ( vpX, unitX );
+				halfY = _mm_sub_ps ( vpY, unitY );
+				halfZ = _mm_sub_ps ( vpZ, unitZ );
+				normalize4 ( halfX, halfY, halfZ );
+			} break;
+
+			case video::ELT_DIRECTIONAL:
+			{
+				attenuation = one;
+				vpX = _mm_set1_ps ( light.posEyeSpace.x );
+				vpY = _mm_set1_ps ( light.posEyeSpace.y );
+				vpZ = _mm_set1_ps ( light.posEyeSpace.z );
+
+				// half angle = lightvector + eye vector ( 0, 0, 1 )
+				halfX = vpX;
+				halfY = vpY;
+				halfZ = _mm_sub_ps ( vpZ, one );
+				normalize4 ( halfX, halfY, halfZ );
+			} break;
+
+			default:
+				continue;
+		}
+
+		// build diffuse reflection
+
+		//angle between normal and light vector
+		__m128 dotVP = _mm_add_ps ( _mm_add_ps ( _mm_mul_ps ( normalX, vpX ), _mm_mul_ps ( normalY, vpY ) ), _mm_mul_ps ( normalZ, vpZ ) );
+		__m128 dotHV = _mm_add_ps ( _mm_add_ps ( _mm_mul_ps ( normalX, halfX ), _mm_mul_ps ( normalY, halfY ) ), _mm_mul_ps ( normalZ, halfZ ) );
+		dotVP = _mm_max_ps ( dotVP, zero );
+		dotHV = _mm_max_ps ( dotHV, zero );
+
+		f32 vp[4];
+		f32 hv[4];
+		f32 pf[4];
+		_mm_storeu_ps ( vp, dotVP );
+		_mm_storeu_ps ( hv, dotHV );
+
+		for ( g = 0; g != 4; ++g )
+		{
+			if ( vp[g] == 0.0 )
+			{
+				pf[g] = 0.f;
+			}
+			else
+			{
+				pf[g] = (f32)pow(hv[g], Material.org.Shininess );
+			}
+		}
+
+		// accumulate ambient
+		const __m128 diffuseFactor = _mm_mul_ps ( dotVP, attenuation );
+		const __m128 specularFactor = _mm_mul_ps ( _mm_loadu_ps ( pf ), attenuation );
+		const f32 * a = &light.AmbientColor.x;
+		const f32 * d = &light.DiffuseColor.x;
+		const f32 * s = &light.SpecularColor.x;
+
+		for ( g = 0; g != 4; ++g )
+		{
+			ambient[g] = _mm_add_ps ( ambient[g], _mm_mul_ps ( _mm_set1_ps ( a[g] ), attenuation ) );
+			diffuse[g] = _mm_add_ps ( diffuse[g], _mm_mul_ps ( _mm_set1_ps ( d[g] ), diffuseFactor ) );
+			specular[g] = _mm_add_ps ( specular[g], _mm_mul_ps ( _mm_set1_ps ( s[g] ), specularFactor ) );
+		}
+	}
+
+	__m128 dColor[4];
+	const f32 * globalAmbient = &LightSpace.Global_AmbientLight.x;
+	const f32 * emissive = &Material.EmissiveColor.x;
+	const f32 * ma = &Material.AmbientColor.x;
+	const f32 * md = &Material.DiffuseColor.x;
+	const f32 * ms = &Material.SpecularColor.x;
+
+	for ( g = 0; g != 4; ++g )
+	{
+		dColor[g] = _mm_set1_ps ( globalAmbient[g] + emissive[g] );
+		dColor[g] = _mm_add_ps ( dColor[g], _mm_mul_ps ( ambient[g], _mm_set1_ps ( ma[g] ) ) );
+		dColor[g] = _mm_add_ps ( dColor[g], _mm_mul_ps ( diffuse[g], _mm_set1_ps ( md[g] ) ) );
+		dColor[g] = _mm_add_ps ( dColor[g], _mm_mul_ps ( specular[g], _mm_set1_ps ( ms[g] ) ) );
+
+		// saturate, same operand order as core::clamp
+		dColor[g] = _mm_min_ps ( _mm_max_ps ( zero, dColor[g] ), one );
+	}
+
+	_MM_TRANSPOSE4_PS ( dColor[0], dColor[1], dColor[2], dColor[3] );
+
+	for ( g = 0; g != 4; ++g )
+		_mm_storeu_ps ( &dest[g]->Color[0].x, dColor[g] );
+}
+
+#endif // SOFTWARE_DRIVER_2_SSE
+
 #endif
 
 
@@ -1558,6 +1896,11 @@ void CBurningVideoDriver::draw2DImage(const video::ITexture* texture, const core
 			return;
 		}
 
+		if (!useTexture(texture))
+			return;
+
+		flushTriangles();
+
 		if (useAlphaChannelOfTexture)
 			((CSoftwareTexture2*)texture)->getImage()->copyToWithAlpha(
 				BackBuffer, destPos, sourceRect, color, clipRect);
@@ -1574,12 +1917,14 @@ void CBurningVideoDriver::draw2DLine(const core::position2d<s32>& start,
 					const core::position2d<s32>& end,
 					SColor color)
 {
+	flushTriangles();
 	((CImage*)BackBuffer)->drawLine(start, end, color );
 }
 
 //! Draws a pixel
 void CBurningVideoDriver::drawPixel(u32 x, u32 y, const SColor & color)
 {
+	flushTriangles();
 	((CImage*)BackBuffer)->setPixel(x, y, color);
 } 
 
@@ -1587,6 +1932,8 @@ void CBurningVideoDriver::drawPixel(u32 x, u32 y, const SColor & color)
 void CBurningVideoDriver::draw2DRectangle(SColor color, const core::rect<s32>& pos,
 									 const core::rect<s32>* clip)
 {
+	flushTriangles();
+
 	if (clip)
 	{
 		core::rect<s32> p(pos);
@@ -1612,6 +1959,8 @@ void CBurningVideoDriver::draw2DRectangle(SColor color, const core::rect<s32>& p
 //! the window was resized.
 void CBurningVideoDriver::OnResize(const core::dimension2d<s32>& size)
 {
+	flushTriangles();
+
 	// make sure width and height are multiples of 2
 	core::dimension2d<s32> realSize(size);
 
@@ -1655,6 +2004,8 @@ void CBurningVideoDriver::draw2DRectangle(const core::rect<s32>& position,
 	SColor colorLeftUp, SColor colorRightUp, SColor colorLeftDown, SColor colorRightDown,
 	const core::rect<s32>* clip)
 {
+	flushTriangles();
+
 #ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
 
 	core::rect<s32> pos = position;
@@ -1787,6 +2138,9 @@ void CBurningVideoDriver::draw3DLine(const core::vector3df& start,
 
 	vOut <<= 1;
 
+	// lines are drawn at once, after the triangles before them
+	flushTriangles();
+
 	IBurningShader * line;
 	line = BurningShader [ ETR_TEXTURE_GOURAUD_WIRE ];
 	line->setRenderTarget(RenderTargetSurface, ViewPort);
@@ -1863,9 +2217,33 @@ ITexture* CBurningVideoDriver::addRenderTargetTexture(const core::dimension2d<s3
 }
 
 
+//! Sets the number of threads used for drawing triangles.
+void CBurningVideoDriver::setRasterizerThreadCount(u32 threadCount)
+{
+	flushTriangles();
+
+	delete Binner;
+	Binner = 0;
+
+	const u32 threads = threadCount ? threadCount : CThreadPool::getProcessorCount();
+	if (threads > 1 && DepthBuffer)
+		Binner = new CBurningBinner(DepthBuffer, threadCount);
+}
+
+
+//! draws the triangles collected for the rasterizer threads
+void CBurningVideoDriver::flushTriangles()
+{
+	if (Binner && !Binner->isEmpty())
+		Binner->flush(RenderTargetSurface, ViewPort);
+}
+
+
 //! Clears the DepthBuffer.
 void CBurningVideoDriver::clearZBuffer()
 {
+	flushTriangles();
+
 	if (DepthBuffer)
 		DepthBuffer->clear();
 }
@@ -1874,6 +2252,8 @@ void CBurningVideoDriver::clearZBuffer()
 //! Returns an image created from the last rendered frame.
 IImage* CBurningVideoDriver::createScreenShot()
 {
+	flushTriangles();
+
 	if (BackBuffer)
 		return new CImage(BackBuffer->getColorFormat(), BackBuffer);
 	else
@@ -16,6 +16,8 @@ namespace irr
 {
 namespace video
 {
+	class CBurningBinner;
+
 	class CBurningVideoDriver : public CNullDriver
 	{
 	public:
@@ -121,6 +123,9 @@ namespace video
 		//! Clears the DepthBuffer.
 		virtual void clearZBuffer();
 
+		//! Sets the number of threads used for drawing triangles.
+		virtual void setRasterizerThreadCount(u32 threadCount);
+
 		//! Returns an image created from the last rendered frame.
 		virtual IImage* createScreenShot();
 
@@ -154,6 +159,9 @@ namespace video
 		//! sets a render target
 		void setRenderTarget(video::CImage* image);
 
+		//! draws the triangles collected for the rasterizer threads
+		void flushTriangles();
+
 		//! sets the current Texture
 		//bool setTexture(u32 stage, video::ITexture* texture);
 
@@ -176,6 +184,10 @@ namespace video
 
 		IBurningShader* CurrentShader;
 		IBurningShader* BurningShader[ETR2_COUNT];
+		EBurningFFShader CurrentShaderType;
+
+		//! collects triangles for several rasterizer threads, 0 when drawing at once
+		CBurningBinner* Binner;
 
 		IDepthBuffer* DepthBuffer;
 
@@ -217,6 +229,10 @@ namespace video
 		void VertexCache_get2 ( s4DVertex ** face );
 
 		void VertexCache_fill ( const u32 sourceIndex,const u32 destIndex );
+		void VertexCache_fillTexCoords ( s4DVertex *dest, const S3DVertex *source ) const;
+#ifdef SOFTWARE_DRIVER_2_SSE
+		void VertexCache_fill4 ( const u32 *sourceIndex, const u32 *destIndex );
+#endif
 		s4DVertex * VertexCache_getVertex ( const u32 sourceIndex );
 
 
@@ -228,6 +244,9 @@ namespace video
 
 #ifdef SOFTWARE_DRIVER_2_LIGHTING
 		void lightVertex ( s4DVertex *dest, const S3DVertex *source );
+	#ifdef SOFTWARE_DRIVER_2_SSE
+		void lightVertex4 ( s4DVertex **dest, const S3DVertex **source );
+	#endif
 #endif
 
 
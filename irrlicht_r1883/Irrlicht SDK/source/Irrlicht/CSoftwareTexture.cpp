@@ -6,6 +6,7 @@
 #ifdef _IRR_COMPILE_WITH_SOFTWARE_
 
 #include "CSoftwareTexture.h"
+#include "CImageResampler.h"
 #include "os.h"
 
 namespace irr
@@ -15,12 +16,19 @@ namespace video
 
 //! constructor
 CSoftwareTexture::CSoftwareTexture(IImage* image, const char* name, bool renderTarget)
-: ITexture(name), Texture(0), IsRenderTarget(renderTarget)
+: ITexture(name), Image(0), Texture(0), IsRenderTarget(renderTarget)
 {
 	#ifdef _DEBUG
 	setDebugName("CSoftwareTexture");
 	#endif
 
+	createSurfaces(image);
+}
+
+
+//! creates the surfaces from an image
+void CSoftwareTexture::createSurfaces(IImage* image)
+{
 	if (image)
 	{
 		core::dimension2d<s32> optSize;
@@ -39,7 +47,7 @@ CSoftwareTexture::CSoftwareTexture(IImage* image, const char* name, bool renderT
 		else
 		{
 			Texture = new CImage(ECF_A1R5G5B5, optSize);
-			Image->copyToScaling(Texture);
+			CImageResampler::resize(Image, Texture);
 		}
 	}
 }
@@ -61,7 +69,7 @@ CSoftwareTexture::~CSoftwareTexture()
 //! lock function
 void* CSoftwareTexture::lock(bool readOnly)
 {
-	return Image->lock();
+	return Image ? Image->lock() : 0;
 }
 
 
@@ -69,10 +77,13 @@ void* CSoftwareTexture::lock(bool readOnly)
 //! unlock function
 void CSoftwareTexture::unlock()
 {
+	if (!Image)
+		return;
+
 	if (Image != Texture)
 	{
 		os::Printer::log("Performance warning, slow unlock of non power of 2 texture.", ELL_WARNING);
-		Image->copyToScaling(Texture);
+		CImageResampler::resize(Image, Texture);
 	}
 
 	Image->unlock();
@@ -89,7 +100,8 @@ const core::dimension2d<s32>& CSoftwareTexture::getOriginalSize() const
 //! Returns (=size) of the texture.
 const core::dimension2d<s32>& CSoftwareTexture::getSize() const
 {
-	return Image->getDimension();
+	// the image has the original size, also while evicted
+	return OrigSize;
 }
 
 
@@ -140,7 +152,7 @@ ECOLOR_FORMAT CSoftwareTexture::getColorFormat() const
 //! returns pitch of texture (in bytes)
 u32 CSoftwareTexture::getPitch() const
 {
-	return Image->getDimension().Width * 2;
+	return OrigSize.Width * 2;
 }
 
 
@@ -157,6 +169,51 @@ bool CSoftwareTexture::isRenderTarget() const
 }
 
 
+//! Returns the size of the surfaces in bytes
+u32 CSoftwareTexture::getTextureMemorySize() const
+{
+	u32 size = 0;
+	if (Image)
+		size += Image->getImageDataSizeInBytes();
+	if (Texture && Texture != Image)
+		size += Texture->getImageDataSizeInBytes();
+	return size;
+}
+
+
+//! Frees the surfaces
+bool CSoftwareTexture::evict()
+{
+	if (IsRenderTarget || !Image)
+		return false;
+
+	Image->drop();
+	Image = 0;
+	if (Texture)
+		Texture->drop();
+	Texture = 0;
+	return true;
+}
+
+
+//! Returns whether the surfaces were freed
+bool CSoftwareTexture::isEvicted() const
+{
+	return !Image;
+}
+
+
+//! Creates the surfaces again
+bool CSoftwareTexture::restore(IImage* image)
+{
+	if (Image || !image)
+		return false;
+
+	createSurfaces(image);
+	return Image != 0;
+}
+
+
 } // end namespace video
 } // end namespace irr
 
@@ -60,8 +60,23 @@ public:
 	//! is it a render target?
 	virtual bool isRenderTarget() const;
 
+	//! Returns the size of the surfaces in bytes
+	virtual u32 getTextureMemorySize() const;
+
+	//! Frees the surfaces
+	virtual bool evict();
+
+	//! Returns whether the surfaces were freed
+	virtual bool isEvicted() const;
+
+	//! Creates the surfaces again
+	virtual bool restore(IImage* image);
+
 private:
 
+	//! creates the surfaces from an image
+	void createSurfaces(IImage* image);
+
 	//! returns the size of a texture which would be the optimize size for rendering it
 	inline s32 getTextureSizeFromSurfaceSize(s32 size) const;
 
@@ -8,6 +8,7 @@
 #include "SoftwareDriver2_compile_config.h"
 #include "SoftwareDriver2_helper.h"
 #include "CSoftwareTexture2.h"
+#include "CImageResampler.h"
 #include "os.h"
 
 namespace irr
@@ -29,12 +30,20 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const char* name, bool gener
 
 	memset32 ( MipMap, 0, sizeof ( MipMap ) );
 
+	createMipMaps(image);
+}
+
+
+//! creates the mipmaps from an image
+void CSoftwareTexture2::createMipMaps(IImage* image)
+{
 	if (image)
 	{
 		OrigSize = image->getDimension();
 
 		core::dimension2d<s32> optSize(
 				OrigSize.getOptimalSize(true, false, false));
+		OptSize = optSize;
 		
 		if ( OrigSize == optSize )
 		{
@@ -44,12 +53,7 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const char* name, bool gener
 		{
 			//os::Printer::log ( "Burningvideo: Warning Texture reformat", ELL_WARNING );
 			MipMap[0] = new CImage(BURNINGSHADER_COLOR_FORMAT, optSize);
-
-			// temporary CImage needed
-			CImage * temp = new CImage ( BURNINGSHADER_COLOR_FORMAT, image );
-			temp->copyToScalingBoxFilter ( MipMap[0], 0 );
-			//temp->copyToScaling(MipMap[0]);
-			temp->drop ();
+			CImageResampler::resize ( image, MipMap[0] );
 		}
 	}
 
@@ -97,13 +101,58 @@ void CSoftwareTexture2::regenerateMipMapLevels()
 		newSize.Height = core::s32_max ( 1, currentSize.Height >> SOFTWARE_DRIVER_2_MIPMAPPING_SCALE );
 
 		MipMap[i] = new CImage(BURNINGSHADER_COLOR_FORMAT, newSize);
-		MipMap[0]->copyToScalingBoxFilter( MipMap[i], 0 );
+
+		// each level is built from the one before
+		if ( newSize == CImageResampler::getMipMapSize ( currentSize ) )
+			CImageResampler::createMipMap ( c, MipMap[i] );
+		else
+			CImageResampler::resize ( c, MipMap[i] );
 		c = MipMap[i];
 		++i;
 	}
 }
 
 
+//! Returns the size of all mipmaps in bytes
+u32 CSoftwareTexture2::getTextureMemorySize() const
+{
+	u32 size = 0;
+	for ( s32 i = 0; i!= SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i )
+	{
+		if ( MipMap[i] )
+			size += MipMap[i]->getImageDataSizeInBytes();
+	}
+	return size;
+}
+
+
+//! Frees all mipmaps
+bool CSoftwareTexture2::evict()
+{
+	if ( IsRenderTarget || !MipMap[0] )
+		return false;
+
+	for ( s32 i = 0; i!= SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i )
+	{
+		if ( MipMap[i] )
+			MipMap[i]->drop();
+		MipMap[i] = 0;
+	}
+	MipMapLOD = 0;
+	return true;
+}
+
+
+//! Creates the mipmaps again
+bool CSoftwareTexture2::restore(IImage* image)
+{
+	if ( MipMap[0] || !image )
+		return false;
+
+	createMipMaps(image);
+	return MipMap[0] != 0;
+}
+
 } // end namespace video
 } // end namespace irr
 
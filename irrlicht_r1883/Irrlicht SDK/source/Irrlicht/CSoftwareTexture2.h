@@ -31,13 +31,14 @@ public:
 	//! lock function
 	virtual void* lock(bool readOnly = false)
 	{
-		return MipMap[MipMapLOD]->lock();
+		return MipMap[MipMapLOD] ? MipMap[MipMapLOD]->lock() : 0;
 	}
 
 	//! unlock function
 	virtual void unlock()
 	{
-		MipMap[MipMapLOD]->unlock();
+		if (MipMap[MipMapLOD])
+			MipMap[MipMapLOD]->unlock();
 	}
 
 	//! Returns original size of the texture.
@@ -56,7 +57,7 @@ public:
 	//! Returns (=size) of the texture.
 	virtual const core::dimension2d<s32>& getSize() const
 	{
-		return MipMap[MipMapLOD]->getDimension();
+		return MipMap[MipMapLOD] ? MipMap[MipMapLOD]->getDimension() : OptSize;
 	}
 
 	//! returns unoptimized surface
@@ -87,7 +88,7 @@ public:
 	//! returns pitch of texture (in bytes)
 	virtual u32 getPitch() const
 	{
-		return MipMap[MipMapLOD]->getPitch();
+		return MipMap[MipMapLOD] ? MipMap[MipMapLOD]->getPitch() : 0;
 	}
 
 	//! Regenerates the mip map levels of the texture. Useful after locking and 
@@ -113,9 +114,31 @@ public:
 		return IsRenderTarget;
 	}
 
+	//! Returns the size of all mipmaps in bytes
+	virtual u32 getTextureMemorySize() const;
+
+	//! Frees all mipmaps
+	virtual bool evict();
+
+	//! Returns whether the mipmaps were freed
+	virtual bool isEvicted() const
+	{
+		return !MipMap[0];
+	}
+
+	//! Creates the mipmaps again
+	virtual bool restore(IImage* image);
+
 private:
+
+	//! creates the mipmaps from an image
+	void createMipMaps(IImage* image);
+
 	core::dimension2d<s32> OrigSize;
 
+	//! size of the largest mipmap, kept while evicted
+	core::dimension2d<s32> OptSize;
+
 	CImage * MipMap[SOFTWARE_DRIVER_2_MIPMAPPING_MAX];
 
 	s32 MipMapLOD;
@@ -142,6 +142,11 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 	int xInc1 = 4;
 	int yInc1 = pitch1;
 
+	// row of dst, for skipping rows outside the render band
+	int y = aposy;
+	int xIncY = 0;
+	int yIncY = 1;
+
 	tVideoSample color;
 
 #ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
@@ -164,6 +169,7 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 		swap_xor ( dx, dy );
 		swap_xor ( xInc0, yInc0 );
 		swap_xor ( xInc1, yInc1 );
+		swap_xor ( xIncY, yIncY );
 	}
 
 	if ( 0 == dx )
@@ -190,6 +196,7 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 	run = dx;
 	while ( run )
 	{
+		if ( y >= RenderBandStart && y < RenderBandEnd )
 #ifdef CMP_Z
 		if ( *z >= dataZ )
 #endif
@@ -209,6 +216,7 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 		}
 
 		dst = (tVideoSample*) ( (u8*) dst + xInc0 );	// x += xInc
+		y += xIncY;
 #ifdef IPOL_Z
 		z = (fp24*) ( (u8*) z + xInc1 );
 #endif
@@ -220,6 +228,7 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 		if ( d > dx )
 		{
 			dst = (tVideoSample*) ( (u8*) dst + yInc0 );	// y += yInc
+			y += yIncY;
 #ifdef IPOL_Z
 			z = (fp24*) ( (u8*) z + yInc1 );
 #endif
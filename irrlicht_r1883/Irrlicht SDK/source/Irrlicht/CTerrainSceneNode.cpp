@@ -21,12 +21,25 @@
 #include "IReadFile.h"
 #include "ITextSceneNode.h"
 #include "IAnimatedMesh.h"
+#include "CThreadPool.h"
 
 namespace irr
 {
 namespace scene
 {
 
+	//! patches per job of the parallel LOD calculation
+	static const s32 PatchesPerLODJob = 1024;
+
+	//! parameters of the parallel LOD calculation
+	struct SPatchLODJobData
+	{
+		CTerrainSceneNode* Node;
+		core::vector3df CameraPosition;
+		core::aabbox3df FrustumBox;
+		s32 PatchCount;
+	};
+
 	//! constructor
 	CTerrainSceneNode::CTerrainSceneNode(ISceneNode* parent, ISceneManager* mgr,
 			io::IFileSystem* fs, s32 id, s32 maxLOD, E_TERRAIN_PATCH_SIZE patchSize,
@@ -35,7 +48,7 @@ namespace scene
 			const core::vector3df& scale)
 	: ITerrainSceneNode(parent, mgr, id, position, rotation, scale),
 	TerrainData(patchSize, maxLOD, position, rotation, scale), RenderBuffer(0),
-	VerticesToRender(0), IndicesToRender(0), DynamicSelectorUpdate(false),
+	WorkerPool(0), VerticesToRender(0), IndicesToRender(0), DynamicSelectorUpdate(false),
 	OverrideDistanceThreshold(false), UseDefaultRotationPivot(true), ForceRecalculation(false),
 	OldCameraPosition(core::vector3df(-99999.9f, -99999.9f, -99999.9f)),
 	OldCameraRotation(core::vector3df(-99999.9f, -99999.9f, -99999.9f)),
@@ -58,6 +71,9 @@ namespace scene
 	//! destructor
 	CTerrainSceneNode::~CTerrainSceneNode()
 	{
+		for (u32 i=0; i<Selectors.size(); ++i)
+			Selectors[i]->SceneNode = 0;
+
 		delete [] TerrainData.Patches;
 
 		if (FileSystem)
@@ -65,6 +81,9 @@ namespace scene
 
 		if (RenderBuffer)
 			RenderBuffer->drop();
+
+		if (WorkerPool)
+			WorkerPool->drop();
 	}
 
 
@@ -385,6 +404,85 @@ namespace scene
 		return true;
 	}
 
+	//! Changes the heights of a rectangular part of the terrain.
+	bool CTerrainSceneNode::updateHeightMap(const f32* data, s32 x, s32 z, s32 sizeX, s32 sizeZ)
+	{
+		if ( !data || !Mesh.getMeshBufferCount() || !TerrainData.Patches )
+			return false;
+
+		const s32 size = TerrainData.Size;
+		if ( x < 0 || z < 0 || sizeX <= 0 || sizeZ <= 0 || x + sizeX > size || z + sizeZ > size )
+			return false;
+
+		CDynamicMeshBuffer* mb = (CDynamicMeshBuffer*)Mesh.getMeshBuffer(0);
+		video::S3DVertex2TCoords* meshVertices = (video::S3DVertex2TCoords*)mb->getVertexBuffer().pointer();
+
+		for( s32 i = 0; i < sizeX; ++i )
+			for( s32 j = 0; j < sizeZ; ++j )
+				meshVertices[(x+i) * size + z + j].Pos.Y = data[i * sizeZ + j];
+
+		// the normals of the vertices next to the region change as well
+		const s32 firstX = core::max_( x - 1, 0 );
+		const s32 firstZ = core::max_( z - 1, 0 );
+		const s32 lastX = core::min_( x + sizeX, size - 1 );
+		const s32 lastZ = core::min_( z + sizeZ, size - 1 );
+
+		calculateNormals( mb, firstX, firstZ, lastX, lastZ );
+		mb->setDirty(EBT_VERTEX);
+
+		// Copy to the render buffer like applyTransformation() does. The rotation pivot is
+		// kept, otherwise all other vertices would have to be moved as well.
+		video::S3DVertex2TCoords* renderVertices = (video::S3DVertex2TCoords*)RenderBuffer->getVertexBuffer().pointer();
+		core::matrix4 rotMatrix;
+		rotMatrix.setRotationDegrees( TerrainData.Rotation );
+
+		for( s32 xx = firstX; xx <= lastX; ++xx )
+		{
+			for( s32 zz = firstZ; zz <= lastZ; ++zz )
+			{
+				const s32 index = xx * size + zz;
+				renderVertices[index].Pos = meshVertices[index].Pos * TerrainData.Scale + TerrainData.Position;
+
+				renderVertices[index].Pos -= TerrainData.RotationPivot;
+				rotMatrix.inverseRotateVect( renderVertices[index].Pos );
+				renderVertices[index].Pos += TerrainData.RotationPivot;
+
+				renderVertices[index].Normal = meshVertices[index].Normal;
+			}
+		}
+
+		// only upload the rows which changed
+		const u32 firstVertex = firstX * size + firstZ;
+		const u32 vertexCount = lastX * size + lastZ + 1 - firstVertex;
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+		if ( !driver || !driver->updateHardwareBufferVertices( RenderBuffer, firstVertex, vertexCount ) )
+			RenderBuffer->setDirty(EBT_VERTEX);
+
+		// patches which contain a changed vertex, a vertex on a patch edge belongs to both patches
+		const s32 firstPatchX = core::max_( ( x - 1 ) / TerrainData.CalcPatchSize, 0 );
+		const s32 firstPatchZ = core::max_( ( z - 1 ) / TerrainData.CalcPatchSize, 0 );
+		const s32 lastPatchX = core::min_( ( x + sizeX - 1 ) / TerrainData.CalcPatchSize, TerrainData.PatchCount - 1 );
+		const s32 lastPatchZ = core::min_( ( z + sizeZ - 1 ) / TerrainData.CalcPatchSize, TerrainData.PatchCount - 1 );
+
+		for( s32 px = firstPatchX; px <= lastPatchX; ++px )
+			for( s32 pz = firstPatchZ; pz <= lastPatchZ; ++pz )
+				calculatePatchBoundingBox( px, pz );
+
+		TerrainData.BoundingBox = core::aabbox3df(999999.9f, 999999.9f, 999999.9f, -999999.9f, -999999.9f, -999999.9f);
+		for( s32 i = 0; i < TerrainData.PatchCount * TerrainData.PatchCount; ++i )
+			TerrainData.BoundingBox.addInternalBox( TerrainData.Patches[i].BoundingBox );
+
+		TerrainData.Center = TerrainData.BoundingBox.getCenter();
+
+		for( u32 i = 0; i < Selectors.size(); ++i )
+			Selectors[i]->updatePatches( firstPatchX, firstPatchZ, lastPatchX, lastPatchZ );
+
+		// the patch centers moved, so the LODs may change
+		ForceRecalculation = true;
+
+		return true;
+	}
+
 	//! Initializes the terrain data. Loads the vertices from the heightMapFile
 	bool CTerrainSceneNode::loadHeightMapRAW( io::IReadFile* file, s32 bitsPerPixel, video::SColor vertexColor, s32 smoothFactor )
 	{
@@ -692,11 +790,43 @@ namespace scene
 		const SViewFrustum* frustum = SceneManager->getActiveCamera()->getViewFrustum();
 
 		// Determine each patches LOD based on distance from camera (and whether or not they are in
-		// the view frustum).
+		// the view frustum). Big terrains are split into jobs for the worker threads.
 		const s32 count = TerrainData.PatchCount * TerrainData.PatchCount;
-		for( s32 j = 0; j < count; ++j )
+		if (count <= PatchesPerLODJob)
 		{
-			if( frustum->getBoundingBox().intersectsWithBox( TerrainData.Patches[j].BoundingBox ) )
+			calculatePatchLODs(0, count, cameraPosition, frustum->getBoundingBox());
+			return;
+		}
+
+		if (!WorkerPool)
+			WorkerPool = CThreadPool::createSharedPool();
+
+		SPatchLODJobData data;
+		data.Node = this;
+		data.CameraPosition = cameraPosition;
+		data.FrustumBox = frustum->getBoundingBox();
+		data.PatchCount = count;
+		WorkerPool->run(patchLODJob, &data, (count + PatchesPerLODJob - 1) / PatchesPerLODJob);
+	}
+
+
+	//! job of preRenderLODCalculations()
+	void CTerrainSceneNode::patchLODJob(void* userData, u32 job, u32 slot)
+	{
+		const SPatchLODJobData* data = (const SPatchLODJobData*)userData;
+		const s32 first = job * PatchesPerLODJob;
+		data->Node->calculatePatchLODs(first, core::min_(first + PatchesPerLODJob, data->PatchCount),
+			data->CameraPosition, data->FrustumBox);
+	}
+
+
+	//! calculates the LOD of the patches in [first, last)
+	void CTerrainSceneNode::calculatePatchLODs(s32 first, s32 last,
+		const core::vector3df& cameraPosition, const core::aabbox3df& frustumBox)
+	{
+		for( s32 j = first; j < last; ++j )
+		{
+			if( frustumBox.intersectsWithBox( TerrainData.Patches[j].BoundingBox ) )
 			{
 				const f32 distance = (cameraPosition.X - TerrainData.Patches[j].Center.X) * (cameraPosition.X - TerrainData.Patches[j].Center.X) +
 					(cameraPosition.Y - TerrainData.Patches[j].Center.Y) * (cameraPosition.Y - TerrainData.Patches[j].Center.Y) +
@@ -745,52 +875,59 @@ namespace scene
 	template<class INDEX_TYPE>
 	void CTerrainSceneNode::preRenderIndicesCalculationsDirect(INDEX_TYPE* IndexBuffer)
 	{
-		IndicesToRender = 0;
+		// Patches keep their indices, only the ones whose LOD or stitching changed are rebuilt.
+		// The render buffer holds the visible patches in order, so it is only rewritten from
+		// the first patch which changed or moved.
+		bool changed = false;
+		u32 offset = 0;
+
+		// range of the render buffer which was rewritten
+		u32 firstChanged = 0xFFFFFFFF;
+		u32 endChanged = 0;
 
-		// Then generate the indices for all patches that are visible.
 		for( s32 i = 0; i < TerrainData.PatchCount; ++i )
 		{
 			for( s32 j = 0; j < TerrainData.PatchCount; ++j )
 			{
-				const s32 index = i * TerrainData.PatchCount + j;
-				if( TerrainData.Patches[index].CurrentLOD >= 0 )
+				updatePatchIndices( i, j );
+
+				SPatch& patch = TerrainData.Patches[i * TerrainData.PatchCount + j];
+				const u32 count = patch.Indices.size();
+
+				if ( patch.NeedsCopy || patch.IndexStart != offset )
 				{
-					s32 x = 0;
-					s32 z = 0;
+					const u32* src = patch.Indices.const_pointer();
+					for ( u32 n = 0; n < count; ++n )
+						IndexBuffer[offset + n] = static_cast<INDEX_TYPE>(src[n]);
 
-					// calculate the step we take this patch, based on the patches current LOD
-					const s32 step = 1 << TerrainData.Patches[index].CurrentLOD;
+					patch.IndexStart = offset;
+					patch.NeedsCopy = false;
 
-					// Loop through patch and generate indices
-					while( z < TerrainData.CalcPatchSize )
+					if ( count )
 					{
-						const s32 index11 = getIndex( j, i, index, x, z );
-						const s32 index21 = getIndex( j, i, index, x + step, z );
-						const s32 index12 = getIndex( j, i, index, x, z + step );
-						const s32 index22 = getIndex( j, i, index, x + step, z + step );
-
-						IndexBuffer[IndicesToRender++]= static_cast<INDEX_TYPE>(index12);
-						IndexBuffer[IndicesToRender++]= static_cast<INDEX_TYPE>(index11);
-						IndexBuffer[IndicesToRender++]= static_cast<INDEX_TYPE>(index22);
-						IndexBuffer[IndicesToRender++]= static_cast<INDEX_TYPE>(index22);
-						IndexBuffer[IndicesToRender++]= static_cast<INDEX_TYPE>(index11);
-						IndexBuffer[IndicesToRender++]= static_cast<INDEX_TYPE>(index21);
-
-						// increment index position horizontally
-						x += step;
-
-						// we've hit an edge
-						if (x >= TerrainData.CalcPatchSize)
-						{
-							x = 0;
-							z += step;
-						}
+						changed = true;
+						firstChanged = core::min_( firstChanged, offset );
+						endChanged = offset + count;
 					}
 				}
+
+				offset += count;
 			}
 		}
 
-		RenderBuffer->setDirty(EBT_INDEX);
+		changed |= (offset != IndicesToRender);
+		IndicesToRender = offset;
+
+		if (!changed)
+			return;
+
+		// only upload the indices which were rewritten, a shorter buffer needs no upload
+		if ( firstChanged < endChanged )
+		{
+			video::IVideoDriver* driver = SceneManager->getVideoDriver();
+			if ( !driver || !driver->updateHardwareBufferIndices( RenderBuffer, firstChanged, endChanged - firstChanged ) )
+				RenderBuffer->setDirty(EBT_INDEX);
+		}
 
 		if ( DynamicSelectorUpdate && TriangleSelector )
 		{
@@ -800,8 +937,109 @@ namespace scene
 	}
 
 
+	//! rebuilds the indices of a patch if its LOD or the LODs it is stitched to changed
+	void CTerrainSceneNode::updatePatchIndices(s32 patchX, s32 patchZ)
+	{
+		SPatch& patch = TerrainData.Patches[patchX * TerrainData.PatchCount + patchZ];
+		const s32 lod = patch.CurrentLOD;
+
+		// edges next to a coarser patch are stitched to its LOD, like getIndex() does
+		const SPatch* neighbours[4] = { patch.Top, patch.Bottom, patch.Left, patch.Right };
+		s32 edgeLOD[4];
+		bool same = (lod == patch.BuiltLOD);
+		for ( u32 e = 0; e < 4; ++e )
+		{
+			edgeLOD[e] = -1;
+			if ( lod >= 0 && neighbours[e] && lod < neighbours[e]->CurrentLOD )
+				edgeLOD[e] = neighbours[e]->CurrentLOD;
+			same &= (edgeLOD[e] == patch.BuiltEdgeLOD[e]);
+		}
+
+		if (same)
+			return;
+
+		patch.BuiltLOD = lod;
+		for ( u32 e = 0; e < 4; ++e )
+			patch.BuiltEdgeLOD[e] = edgeLOD[e];
+		patch.NeedsCopy = true;
+
+		if ( lod < 0 )
+		{
+			patch.Indices.set_used(0);
+			return;
+		}
 
+		const SLODTemplate& tmpl = LODTemplates[lod];
+		const u32 size = TerrainData.CalcPatchSize;
+		const u32 base = (size * patchX) * TerrainData.Size + size * patchZ;
 
+		patch.Indices.set_used( tmpl.Interior.size() + tmpl.Border.size() );
+		u32* out = patch.Indices.pointer();
+
+		const u32* interior = tmpl.Interior.const_pointer();
+		for ( u32 n = 0; n < tmpl.Interior.size(); ++n )
+			*out++ = base + interior[n];
+
+		// masks which snap edge vertices to the grid of the coarser neighbour
+		u32 mask[4];
+		for ( u32 e = 0; e < 4; ++e )
+			mask[e] = edgeLOD[e] >= 0 ? ~((1u << edgeLOD[e]) - 1) : 0xFFFFFFFF;
+
+		const u32* border = tmpl.Border.const_pointer();
+		for ( u32 n = 0; n < tmpl.Border.size(); ++n )
+		{
+			u32 vX = border[n] & 0xFFFF;
+			u32 vZ = border[n] >> 16;
+
+			if ( vZ == 0 )
+				vX &= mask[0];
+			else if ( vZ == size )
+				vX &= mask[1];
+
+			if ( vX == 0 )
+				vZ &= mask[2];
+			else if ( vX == size )
+				vZ &= mask[3];
+
+			*out++ = base + vZ * TerrainData.Size + vX;
+		}
+	}
+
+
+	//! create the index templates of all LODs
+	void CTerrainSceneNode::createLODTemplates()
+	{
+		const s32 size = TerrainData.CalcPatchSize;
+
+		LODTemplates.clear();
+		LODTemplates.reallocate(TerrainData.MaxLOD);
+
+		for ( s32 lod = 0; lod < TerrainData.MaxLOD; ++lod )
+		{
+			LODTemplates.push_back(SLODTemplate());
+			SLODTemplate& tmpl = LODTemplates.getLast();
+
+			const s32 step = 1 << lod;
+			for ( s32 z = 0; z < size; z += step )
+			{
+				for ( s32 x = 0; x < size; x += step )
+				{
+					// same triangles as getIndicesForPatch()
+					const s32 vX[6] = { x, x, x + step, x + step, x, x + step };
+					const s32 vZ[6] = { z + step, z, z + step, z + step, z, z };
+
+					const bool border = ( x == 0 || z == 0 || x + step >= size || z + step >= size );
+					for ( u32 k = 0; k < 6; ++k )
+					{
+						if ( border )
+							tmpl.Border.push_back( vX[k] | ( vZ[k] << 16 ) );
+						else
+							tmpl.Interior.push_back( vZ[k] * TerrainData.Size + vX[k] );
+					}
+				}
+			}
+		}
+	}
 
 
 	//! Render the scene node
@@ -1238,13 +1476,19 @@ namespace scene
 
 	//! calculate smooth normals
 	void CTerrainSceneNode::calculateNormals( CDynamicMeshBuffer* mb )
+	{
+		calculateNormals( mb, 0, 0, TerrainData.Size - 1, TerrainData.Size - 1 );
+	}
+
+	//! calculate smooth normals of the vertices from (firstX, firstZ) to (lastX, lastZ)
+	void CTerrainSceneNode::calculateNormals( CDynamicMeshBuffer* mb, s32 firstX, s32 firstZ, s32 lastX, s32 lastZ )
 	{
 		s32 count;
 		core::vector3df a, b, c, t;
 
-		for (s32 x=0; x<TerrainData.Size; ++x)
+		for (s32 x=firstX; x<=lastX; ++x)
 		{
-			for (s32 z=0; z<TerrainData.Size; ++z)
+			for (s32 z=firstZ; z<=lastZ; ++z)
 			{
 				count = 0;
 				core::vector3df normal;
@@ -1368,6 +1612,9 @@ namespace scene
 			delete [] TerrainData.Patches;
 
 		TerrainData.Patches = new SPatch[TerrainData.PatchCount * TerrainData.PatchCount];
+
+		createLODTemplates();
+		IndicesToRender = 0;
 	}
 
 	//! used to calculate the internal STerrainData structure both at creation and after scaling/position calls.
@@ -1383,21 +1630,11 @@ namespace scene
 				const s32 index = x * TerrainData.PatchCount + z;
 				TerrainData.Patches[index].CurrentLOD = 0;
 
-				// For each patch, calculate the bounding box (mins and maxes)
-				TerrainData.Patches[index].BoundingBox = core::aabbox3df(999999.9f, 999999.9f, 999999.9f,
-					-999999.9f, -999999.9f, -999999.9f);
-
-				for( s32 xx = x*(TerrainData.CalcPatchSize); xx <= ( x + 1 ) * TerrainData.CalcPatchSize; ++xx )
-					for( s32 zz = z*(TerrainData.CalcPatchSize); zz <= ( z + 1 ) * TerrainData.CalcPatchSize; ++zz )
-						TerrainData.Patches[index].BoundingBox.addInternalPoint( RenderBuffer->getVertexBuffer()[xx * TerrainData.Size + zz].Pos );
-
+				calculatePatchBoundingBox( x, z );
 
 				// Reconfigure the bounding box of the terrain as a whole
 				TerrainData.BoundingBox.addInternalBox( TerrainData.Patches[index].BoundingBox );
 
-				// get center of Patch
-				TerrainData.Patches[index].Center = TerrainData.Patches[index].BoundingBox.getCenter();
-
 				// Assign Neighbours
 				// Top
 				if( x > 0 )
@@ -1436,6 +1673,24 @@ namespace scene
 	}
 
 
+	//! calculate bounding box and center of a patch
+	void CTerrainSceneNode::calculatePatchBoundingBox(s32 patchX, s32 patchZ)
+	{
+		SPatch& patch = TerrainData.Patches[patchX * TerrainData.PatchCount + patchZ];
+
+		// For each patch, calculate the bounding box (mins and maxes)
+		patch.BoundingBox = core::aabbox3df(999999.9f, 999999.9f, 999999.9f,
+			-999999.9f, -999999.9f, -999999.9f);
+
+		for( s32 xx = patchX*(TerrainData.CalcPatchSize); xx <= ( patchX + 1 ) * TerrainData.CalcPatchSize; ++xx )
+			for( s32 zz = patchZ*(TerrainData.CalcPatchSize); zz <= ( patchZ + 1 ) * TerrainData.CalcPatchSize; ++zz )
+				patch.BoundingBox.addInternalPoint( RenderBuffer->getVertexBuffer()[xx * TerrainData.Size + zz].Pos );
+
+		// get center of Patch
+		patch.Center = patch.BoundingBox.getCenter();
+	}
+
+
 	//! used to calculate or recalculate the distance thresholds
 	void CTerrainSceneNode::calculateDistanceThresholds(bool scalechanged)
 	{
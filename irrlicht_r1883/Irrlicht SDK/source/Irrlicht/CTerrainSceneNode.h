@@ -15,6 +15,8 @@
 
 namespace irr
 {
+class CThreadPool;
+
 namespace io
 {
 	class IFileSystem;
@@ -23,6 +25,7 @@ namespace io
 namespace scene
 {
 	class ITextSceneNode;
+	class CTerrainTriangleSelector;
 
 	//! A scene node for displaying terrain using the geo mip map algorithm.
 	class CTerrainSceneNode : public ITerrainSceneNode
@@ -56,6 +59,9 @@ namespace scene
 		virtual bool addHeightMap(f32* data, u32 width,
 			video::SColor vertexColor = video::SColor ( 255, 255, 255, 255 ), s32 smoothFactor = 0 );
 
+		//! Changes the heights of a rectangular part of the terrain.
+		virtual bool updateHeightMap(const f32* data, s32 x, s32 z, s32 sizeX, s32 sizeZ);
+
 		//! Initializes the terrain data.  Loads the vertices from the heightMapFile.
 		virtual bool loadHeightMapRAW(io::IReadFile* file, s32 bitsPerPixel = 16,
 			video::SColor vertexColor = video::SColor ( 255, 255, 255, 255 ), s32 smoothFactor = 0 );
@@ -231,8 +237,10 @@ namespace scene
 		struct SPatch
 		{
 			SPatch()
-			: CurrentLOD(-1), Top(0), Bottom(0), Right(0), Left(0)
+			: CurrentLOD(-1), Top(0), Bottom(0), Right(0), Left(0),
+				BuiltLOD(-2), IndexStart(0), NeedsCopy(false)
 			{
+				BuiltEdgeLOD[0] = BuiltEdgeLOD[1] = BuiltEdgeLOD[2] = BuiltEdgeLOD[3] = -1;
 			}
 
 			s32			CurrentLOD;
@@ -242,6 +250,26 @@ namespace scene
 			SPatch*			Bottom;
 			SPatch*			Right;
 			SPatch*			Left;
+
+			//! indices of the patch as last built, and the LODs they were built for.
+			//! The edge LODs are the ones of coarser neighbours the edges are stitched to, or -1.
+			core::array<u32>	Indices;
+			s32			BuiltLOD;
+			s32			BuiltEdgeLOD[4];
+
+			//! where the indices are in the render buffer, and if they have to be copied there
+			u32			IndexStart;
+			bool			NeedsCopy;
+		};
+
+		//! indices of a patch at one LOD, relative to the first vertex of the patch
+		struct SLODTemplate
+		{
+			//! quads which touch no edge of the patch, as vertex offsets
+			core::array<u32> Interior;
+
+			//! quads on the edges of the patch, as vertex coordinates x | z << 16
+			core::array<u32> Border;
 		};
 
 		struct STerrainData
@@ -284,6 +312,19 @@ namespace scene
 		template<class INDEX_TYPE>
 		void preRenderIndicesCalculationsDirect(INDEX_TYPE* IndexBuffer);
 
+		//! rebuilds the indices of a patch if its LOD or the LODs it is stitched to changed
+		void updatePatchIndices(s32 patchX, s32 patchZ);
+
+		//! calculates the LOD of the patches in [first, last)
+		void calculatePatchLODs(s32 first, s32 last, const core::vector3df& cameraPosition,
+			const core::aabbox3df& frustumBox);
+
+		//! job of preRenderLODCalculations()
+		static void patchLODJob(void* userData, u32 job, u32 slot);
+
+		//! create the index templates of all LODs
+		void createLODTemplates();
+
 		//! get indices when generating index data for patches at varying levels of detail.
 		u32 getIndex(const s32 PatchX, const s32 PatchZ, const s32 PatchIndex, u32 vX, u32 vZ) const;
 
@@ -293,12 +334,18 @@ namespace scene
 		//! calculate smooth normals
 		void calculateNormals(CDynamicMeshBuffer* mb);
 
+		//! calculate smooth normals of the vertices from (firstX, firstZ) to (lastX, lastZ)
+		void calculateNormals(CDynamicMeshBuffer* mb, s32 firstX, s32 firstZ, s32 lastX, s32 lastZ);
+
 		//! create patches, stuff that needs to only be done once for patches goes here.
 		void createPatches();
 
 		//! calculate the internal STerrainData structure
 		void calculatePatchData();
 
+		//! calculate bounding box and center of a patch
+		void calculatePatchBoundingBox(s32 patchX, s32 patchZ);
+
 		//! calculate or recalculate the distance thresholds
 		void calculateDistanceThresholds(bool scalechanged = false);
 
@@ -316,6 +363,12 @@ namespace scene
 
 		CDynamicMeshBuffer *RenderBuffer;
 
+		core::array<SLODTemplate> LODTemplates;
+		CThreadPool* WorkerPool;
+
+		//! selectors created for this node, they are updated by updateHeightMap()
+		core::array<CTerrainTriangleSelector*> Selectors;
+
 		u32 VerticesToRender;
 		u32 IndicesToRender;
 
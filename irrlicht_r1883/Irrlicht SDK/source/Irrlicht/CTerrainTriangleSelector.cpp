@@ -14,12 +14,16 @@ namespace scene
 
 //! constructor
 CTerrainTriangleSelector::CTerrainTriangleSelector ( ITerrainSceneNode* node, s32 LOD )
-	: SceneNode(node)
+	: SceneNode(node), LOD(LOD)
 {
 	#ifdef _DEBUG
 	setDebugName ("CTerrainTriangleSelector");
 	#endif
 
+	// the node updates the triangles when its heights change
+	if (SceneNode)
+		static_cast<CTerrainSceneNode*>(SceneNode)->Selectors.push_back(this);
+
 	setTriangleData(node, LOD);
 }
 
@@ -27,6 +31,14 @@ CTerrainTriangleSelector::CTerrainTriangleSelector ( ITerrainSceneNode* node, s3
 //! destructor
 CTerrainTriangleSelector::~CTerrainTriangleSelector()
 {
+	if (SceneNode)
+	{
+		core::array<CTerrainTriangleSelector*>& selectors = static_cast<CTerrainSceneNode*>(SceneNode)->Selectors;
+		const s32 index = selectors.linear_search(this);
+		if (index != -1)
+			selectors.erase(index);
+	}
+
 	TrianglePatches.TrianglePatchArray.clear();
 }
 
@@ -34,46 +46,85 @@ CTerrainTriangleSelector::~CTerrainTriangleSelector()
 //! Clears and sets triangle data
 void CTerrainTriangleSelector::setTriangleData(ITerrainSceneNode* node, s32 LOD)
 {
-	core::triangle3df tri;
-	core::array<u32> indices;
-
-	// Get pointer to the GeoMipMaps vertices
-	video::S3DVertex2TCoords* vertices = static_cast<video::S3DVertex2TCoords*>(node->getRenderBuffer()->getVertices());
+	CTerrainSceneNode* terrain = static_cast<CTerrainSceneNode*>(node);
+	this->LOD = LOD;
 
 	// Clear current data
-	const s32 count = (static_cast<CTerrainSceneNode*>(node))->TerrainData.PatchCount;
+	const s32 count = terrain->TerrainData.PatchCount;
 	TrianglePatches.TotalTriangles = 0;
 	TrianglePatches.NumPatches = count*count;
 
+	TrianglePatches.TrianglePatchArray.clear();
 	TrianglePatches.TrianglePatchArray.reallocate(TrianglePatches.NumPatches);
 	for (s32 o=0; o<TrianglePatches.NumPatches; ++o)
 		TrianglePatches.TrianglePatchArray.push_back(SGeoMipMapTrianglePatch());
 
-	s32 tIndex = 0;
 	for(s32 x = 0; x < count; ++x )
 	{
 		for(s32 z = 0; z < count; ++z )
 		{
-			TrianglePatches.TrianglePatchArray[tIndex].NumTriangles = 0;
-			TrianglePatches.TrianglePatchArray[tIndex].Box = node->getBoundingBox( x, z );
-			u32 indexCount = node->getIndicesForPatch( indices, x, z, LOD );
+			setPatchTriangles( terrain, x, z );
+			TrianglePatches.TotalTriangles += TrianglePatches.TrianglePatchArray[x * count + z].NumTriangles;
+		}
+	}
+}
 
-			TrianglePatches.TrianglePatchArray[tIndex].Triangles.reallocate(indexCount/3);
-			for(u32 i = 0; i < indexCount; i += 3 )
-			{
-				tri.pointA = vertices[indices[i+0]].Pos;
-				tri.pointB = vertices[indices[i+1]].Pos;
-				tri.pointC = vertices[indices[i+2]].Pos;
-				TrianglePatches.TrianglePatchArray[tIndex].Triangles.push_back(tri);
-				++TrianglePatches.TrianglePatchArray[tIndex].NumTriangles;
-			}
 
+//! Rebuilds the triangles of the patches from (firstX, firstZ) to (lastX, lastZ)
+void CTerrainTriangleSelector::updatePatches(s32 firstX, s32 firstZ, s32 lastX, s32 lastZ)
+{
+	if (!SceneNode)
+		return;
+
+	CTerrainSceneNode* terrain = static_cast<CTerrainSceneNode*>(SceneNode);
+	const s32 count = terrain->TerrainData.PatchCount;
+
+	// the patches were set up for another heightmap
+	if (TrianglePatches.NumPatches != count*count)
+	{
+		setTriangleData(SceneNode, LOD);
+		return;
+	}
+
+	for(s32 x = firstX; x <= lastX; ++x )
+	{
+		for(s32 z = firstZ; z <= lastZ; ++z )
+		{
+			const s32 tIndex = x * count + z;
+			TrianglePatches.TotalTriangles -= TrianglePatches.TrianglePatchArray[tIndex].NumTriangles;
+			setPatchTriangles( terrain, x, z );
 			TrianglePatches.TotalTriangles += TrianglePatches.TrianglePatchArray[tIndex].NumTriangles;
-			++tIndex;
 		}
 	}
 }
 
+
+//! sets the triangles and the box of a patch
+void CTerrainTriangleSelector::setPatchTriangles(CTerrainSceneNode* node, s32 patchX, s32 patchZ)
+{
+	core::triangle3df tri;
+	core::array<u32> indices;
+
+	// Get pointer to the GeoMipMaps vertices
+	video::S3DVertex2TCoords* vertices = static_cast<video::S3DVertex2TCoords*>(node->getRenderBuffer()->getVertices());
+
+	SGeoMipMapTrianglePatch& patch = TrianglePatches.TrianglePatchArray[patchX * node->TerrainData.PatchCount + patchZ];
+	patch.NumTriangles = 0;
+	patch.Box = node->getBoundingBox( patchX, patchZ );
+	const u32 indexCount = node->getIndicesForPatch( indices, patchX, patchZ, LOD );
+
+	patch.Triangles.set_used(0);
+	patch.Triangles.reallocate(indexCount/3);
+	for(u32 i = 0; i < indexCount; i += 3 )
+	{
+		tri.pointA = vertices[indices[i+0]].Pos;
+		tri.pointB = vertices[indices[i+1]].Pos;
+		tri.pointC = vertices[indices[i+2]].Pos;
+		patch.Triangles.push_back(tri);
+		++patch.NumTriangles;
+	}
+}
+
 //! Gets all triangles.
 void CTerrainTriangleSelector::getTriangles ( core::triangle3df* triangles, s32 arraySize,
 	s32& outTriangleCount, const core::matrix4* transform ) const
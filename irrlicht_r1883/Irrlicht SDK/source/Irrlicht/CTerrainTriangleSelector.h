@@ -18,6 +18,7 @@ namespace scene
 {
 
 class ITerrainSceneNode;
+class CTerrainSceneNode;
 
 //! Triangle Selector for the TerrainSceneNode
 //! The code for the TerrainTriangleSelector is based on the GeoMipMapSelector
@@ -52,10 +53,16 @@ public:
 	//! Returns amount of all available triangles in this selector
 	virtual s32 getTriangleCount ( ) const;
 
+	//! Rebuilds the triangles of the patches from (firstX, firstZ) to (lastX, lastZ)
+	void updatePatches ( s32 firstX, s32 firstZ, s32 lastX, s32 lastZ );
+
 private:
 
 	friend class CTerrainSceneNode;
 
+	//! sets the triangles and the box of a patch
+	void setPatchTriangles ( CTerrainSceneNode* node, s32 patchX, s32 patchZ );
+
 	struct SGeoMipMapTrianglePatch
 	{
 		core::array<core::triangle3df>	Triangles;
@@ -76,7 +83,9 @@ private:
 		u32					TotalTriangles;
 	};
 
+	//! the node the triangles are taken from, 0 once it is deleted
 	ITerrainSceneNode*		SceneNode;
+	s32				LOD;
 	SGeoMipMapTrianglePatches	TrianglePatches;
 };
 
@@ -0,0 +1,241 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CTextureResidencyManager.h"
+#include "IVideoDriver.h"
+#include "ITextureReloadCallBack.h"
+#include "irrArray.h"
+#include "os.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! constructor
+CTextureResidencyManager::CTextureResidencyManager(IVideoDriver* driver)
+: Driver(driver), ReloadCallBack(0), ImageBudget(0), TextureBudget(0), Frame(1)
+{
+}
+
+
+//! destructor
+CTextureResidencyManager::~CTextureResidencyManager()
+{
+	clear();
+
+	if (ReloadCallBack)
+		ReloadCallBack->drop();
+}
+
+
+//! Starts to track a texture
+void CTextureResidencyManager::addTexture(ITexture* texture, bool reloadable)
+{
+	if (!texture)
+		return;
+
+	core::map<const ITexture*, STextureResidency*>::Node* node = Textures.find(texture);
+	if (node)
+	{
+		node->getValue()->Reloadable |= reloadable;
+		return;
+	}
+
+	STextureResidency* residency = new STextureResidency;
+	residency->Texture = texture;
+	residency->LastUsed = Frame;
+	residency->Reloadable = reloadable;
+	residency->ReloadFailed = false;
+	Textures.insert(texture, residency);
+}
+
+
+//! Stops to track a texture
+void CTextureResidencyManager::removeTexture(const ITexture* texture)
+{
+	core::map<const ITexture*, STextureResidency*>::Node* node = Textures.find(texture);
+	if (!node)
+		return;
+
+	delete node->getValue();
+	Textures.remove(texture);
+}
+
+
+//! Stops to track all textures
+void CTextureResidencyManager::clear()
+{
+	core::map<const ITexture*, STextureResidency*>::ParentFirstIterator it = Textures.getParentFirstIterator();
+	for (; !it.atEnd(); it++)
+		delete it.getNode()->getValue();
+
+	Textures.clear();
+}
+
+
+//! Sets the budgets, 0 means no limit
+void CTextureResidencyManager::setBudget(u32 imageBytes, u32 textureBytes)
+{
+	ImageBudget = imageBytes;
+	TextureBudget = textureBytes;
+}
+
+
+//! Sets the callback which loads evicted textures again
+void CTextureResidencyManager::setReloadCallBack(ITextureReloadCallBack* callback)
+{
+	if (callback)
+		callback->grab();
+
+	if (ReloadCallBack)
+		ReloadCallBack->drop();
+
+	ReloadCallBack = callback;
+
+	// the new callback may be able to load what failed before
+	core::map<const ITexture*, STextureResidency*>::ParentFirstIterator it = Textures.getParentFirstIterator();
+	for (; !it.atEnd(); it++)
+		it.getNode()->getValue()->ReloadFailed = false;
+}
+
+
+//! Returns the memory used by all tracked textures
+void CTextureResidencyManager::getMemoryUsage(u32& imageBytes, u32& textureBytes) const
+{
+	imageBytes = 0;
+	textureBytes = 0;
+
+	core::map<const ITexture*, STextureResidency*>::ParentFirstIterator it =
+		const_cast<core::map<const ITexture*, STextureResidency*>&>(Textures).getParentFirstIterator();
+	for (; !it.atEnd(); it++)
+	{
+		const ITexture* texture = it.getNode()->getValue()->Texture;
+		imageBytes += texture->getImageMemorySize();
+		textureBytes += texture->getTextureMemorySize();
+	}
+}
+
+
+//! Marks a texture as used in this frame, and loads it again if it was evicted
+bool CTextureResidencyManager::useTexture(const ITexture* texture)
+{
+	core::map<const ITexture*, STextureResidency*>::Node* node = Textures.find(texture);
+	if (!node)
+		return !texture->isEvicted();
+
+	STextureResidency* residency = node->getValue();
+	residency->LastUsed = Frame;
+
+	if (!texture->isEvicted())
+		return true;
+
+	return restore(residency);
+}
+
+
+//! loads an evicted texture again
+bool CTextureResidencyManager::restore(STextureResidency* residency)
+{
+	if (residency->ReloadFailed)
+		return false;
+
+	ITexture* texture = residency->Texture;
+	IImage* image = 0;
+
+	if (ReloadCallBack)
+		image = ReloadCallBack->OnReloadTexture(texture);
+	else if (residency->Reloadable)
+		image = Driver->createImageFromFile(texture->getName().c_str());
+
+	const bool restored = image && texture->restore(image);
+
+	if (image)
+		image->drop();
+
+	if (!restored)
+	{
+		residency->ReloadFailed = true;
+		os::Printer::log("Could not load evicted texture again", texture->getName().c_str(), ELL_WARNING);
+	}
+
+	return restored;
+}
+
+
+//! Ends a frame, frees memory until the budgets are met
+void CTextureResidencyManager::endFrame()
+{
+	if (ImageBudget || TextureBudget)
+	{
+		u32 imageBytes, textureBytes;
+		getMemoryUsage(imageBytes, textureBytes);
+
+		core::array<SCandidate> candidates;
+		core::map<const ITexture*, STextureResidency*>::ParentFirstIterator it = Textures.getParentFirstIterator();
+
+		// the copies of the images go first, the textures can still be drawn without them
+		if (ImageBudget && imageBytes > ImageBudget)
+		{
+			for (; !it.atEnd(); it++)
+			{
+				STextureResidency* residency = it.getNode()->getValue();
+				if (residency->Texture->getImageMemorySize())
+				{
+					SCandidate candidate;
+					candidate.LastUsed = residency->LastUsed;
+					candidate.Residency = residency;
+					candidates.push_back(candidate);
+				}
+			}
+			candidates.sort();
+
+			for (u32 i=0; i<candidates.size() && imageBytes > ImageBudget; ++i)
+			{
+				ITexture* texture = candidates[i].Residency->Texture;
+				const u32 size = texture->getImageMemorySize();
+				if (texture->releaseImage())
+					imageBytes -= core::min_(size, imageBytes);
+			}
+		}
+
+		// textures used in this frame or which cannot be loaded again stay
+		if (TextureBudget && textureBytes > TextureBudget)
+		{
+			candidates.set_used(0);
+			for (it = Textures.getParentFirstIterator(); !it.atEnd(); it++)
+			{
+				STextureResidency* residency = it.getNode()->getValue();
+				if (residency->LastUsed < Frame &&
+					(residency->Reloadable || ReloadCallBack) &&
+					!residency->Texture->isRenderTarget() &&
+					!residency->Texture->isEvicted())
+				{
+					SCandidate candidate;
+					candidate.LastUsed = residency->LastUsed;
+					candidate.Residency = residency;
+					candidates.push_back(candidate);
+				}
+			}
+			candidates.sort();
+
+			for (u32 i=0; i<candidates.size() && textureBytes > TextureBudget; ++i)
+			{
+				ITexture* texture = candidates[i].Residency->Texture;
+				const u32 size = texture->getTextureMemorySize();
+				if (texture->evict())
+				{
+					textureBytes -= core::min_(size, textureBytes);
+					candidates[i].Residency->ReloadFailed = false;
+				}
+			}
+		}
+	}
+
+	++Frame;
+}
+
+} // end namespace video
+} // end namespace irr
+
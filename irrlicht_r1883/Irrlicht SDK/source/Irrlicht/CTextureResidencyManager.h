@@ -0,0 +1,105 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_TEXTURE_RESIDENCY_MANAGER_H_INCLUDED__
+#define __C_TEXTURE_RESIDENCY_MANAGER_H_INCLUDED__
+
+#include "irrMap.h"
+
+namespace irr
+{
+namespace video
+{
+	class IVideoDriver;
+	class ITexture;
+	class ITextureReloadCallBack;
+
+//! Keeps the memory used by the textures of a driver within a budget.
+/** Remembers the frame each texture was last used in. At the end of a frame,
+the copies of images of the least recently used textures are released, then
+the least recently used textures are evicted, until the budgets are met.
+Evicted textures are loaded again when the driver uses them. */
+class CTextureResidencyManager
+{
+public:
+
+	//! constructor
+	CTextureResidencyManager(IVideoDriver* driver);
+
+	//! destructor
+	~CTextureResidencyManager();
+
+	//! Starts to track a texture
+	/** \param reloadable: True if the texture was loaded from the file
+	with its name, so it can be evicted without a reload callback. */
+	void addTexture(ITexture* texture, bool reloadable);
+
+	//! Stops to track a texture
+	void removeTexture(const ITexture* texture);
+
+	//! Stops to track all textures
+	void clear();
+
+	//! Sets the budgets, 0 means no limit
+	void setBudget(u32 imageBytes, u32 textureBytes);
+
+	//! Sets the callback which loads evicted textures again
+	void setReloadCallBack(ITextureReloadCallBack* callback);
+
+	//! Returns the memory used by all tracked textures
+	void getMemoryUsage(u32& imageBytes, u32& textureBytes) const;
+
+	//! Marks a texture as used in this frame, and loads it again if it was evicted
+	/** \return False if the texture is evicted and could not be loaded. */
+	bool useTexture(const ITexture* texture);
+
+	//! Ends a frame, frees memory until the budgets are met
+	void endFrame();
+
+private:
+
+	struct STextureResidency
+	{
+		ITexture* Texture;
+
+		//! frame the texture was last used in
+		u32 LastUsed;
+
+		//! the texture can be loaded from the file with its name
+		bool Reloadable;
+
+		//! loading the texture again failed, it is not tried again
+		bool ReloadFailed;
+	};
+
+	//! a texture which may give up memory, sorted by the last use
+	struct SCandidate
+	{
+		u32 LastUsed;
+		STextureResidency* Residency;
+
+		bool operator < (const SCandidate& other) const
+		{
+			return LastUsed < other.LastUsed;
+		}
+	};
+
+	//! loads an evicted texture again
+	bool restore(STextureResidency* residency);
+
+	IVideoDriver* Driver;
+	ITextureReloadCallBack* ReloadCallBack;
+
+	core::map<const ITexture*, STextureResidency*> Textures;
+
+	u32 ImageBudget;
+	u32 TextureBudget;
+	u32 Frame;
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
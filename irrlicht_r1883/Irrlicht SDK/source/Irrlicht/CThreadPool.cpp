@@ -0,0 +1,366 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CThreadPool.h"
+#include "IrrCompileConfig.h"
+#include "irrMath.h"
+
+#ifdef _IRR_WINDOWS_API_
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace irr
+{
+
+#ifdef _IRR_WINDOWS_API_
+
+struct CThreadPool::SSync
+{
+	CRITICAL_SECTION Lock;
+	CRITICAL_SECTION RunLock;
+	//! one token per worker and batch
+	HANDLE Start;
+	//! set when the last job of a batch is done
+	HANDLE Done;
+};
+
+#define LOCK(s) EnterCriticalSection(&(s)->Lock)
+#define UNLOCK(s) LeaveCriticalSection(&(s)->Lock)
+
+#else
+
+struct CThreadPool::SSync
+{
+	pthread_mutex_t Lock;
+	pthread_mutex_t RunLock;
+	pthread_cond_t Start;
+	pthread_cond_t Done;
+};
+
+#define LOCK(s) pthread_mutex_lock(&(s)->Lock)
+#define UNLOCK(s) pthread_mutex_unlock(&(s)->Lock)
+
+#endif
+
+
+struct CThreadPool::SWorker
+{
+	CThreadPool* Pool;
+	u32 Slot;
+#ifdef _IRR_WINDOWS_API_
+	HANDLE Thread;
+
+	static DWORD WINAPI entry(LPVOID data)
+	{
+		CThreadPool::workerMain((SWorker*)data);
+		return 0;
+	}
+#else
+	pthread_t Thread;
+
+	static void* entry(void* data)
+	{
+		CThreadPool::workerMain((SWorker*)data);
+		return 0;
+	}
+#endif
+};
+
+
+//! the pool returned by createSharedPool()
+static CThreadPool* SharedPool = 0;
+
+//! guards SharedPool and the reference counters of all pools
+#ifdef _IRR_WINDOWS_API_
+
+static struct SSharedPoolLock
+{
+	SSharedPoolLock() { InitializeCriticalSection(&Lock); }
+	~SSharedPoolLock() { DeleteCriticalSection(&Lock); }
+	CRITICAL_SECTION Lock;
+} SharedPoolLock;
+
+#define LOCK_SHARED() EnterCriticalSection(&SharedPoolLock.Lock)
+#define UNLOCK_SHARED() LeaveCriticalSection(&SharedPoolLock.Lock)
+
+#else
+
+static pthread_mutex_t SharedPoolLock = PTHREAD_MUTEX_INITIALIZER;
+
+#define LOCK_SHARED() pthread_mutex_lock(&SharedPoolLock)
+#define UNLOCK_SHARED() pthread_mutex_unlock(&SharedPoolLock)
+
+#endif
+
+
+//! constructor
+CThreadPool::CThreadPool(u32 threadCount)
+: Sync(new SSync), ReferenceCounter(1), Function(0), UserData(0), JobCount(0),
+	NextJob(0), Pending(0), Batch(0), Quit(false)
+{
+	if (!threadCount)
+		threadCount = getProcessorCount();
+
+#ifdef _IRR_WINDOWS_API_
+	InitializeCriticalSection(&Sync->Lock);
+	InitializeCriticalSection(&Sync->RunLock);
+	Sync->Start = CreateSemaphore(0, 0, 0x7fffffff, 0);
+	Sync->Done = CreateEvent(0, FALSE, FALSE, 0);
+#else
+	pthread_mutex_init(&Sync->Lock, 0);
+	pthread_mutex_init(&Sync->RunLock, 0);
+	pthread_cond_init(&Sync->Start, 0);
+	pthread_cond_init(&Sync->Done, 0);
+#endif
+
+	// the calling thread is slot 0
+	for (u32 i=1; i<threadCount; ++i)
+	{
+		SWorker* worker = new SWorker;
+		worker->Pool = this;
+		worker->Slot = i;
+
+#ifdef _IRR_WINDOWS_API_
+		worker->Thread = CreateThread(0, 0, SWorker::entry, worker, 0, 0);
+		if (!worker->Thread)
+#else
+		if (pthread_create(&worker->Thread, 0, SWorker::entry, worker))
+#endif
+		{
+			delete worker;
+			break;
+		}
+
+		Workers.push_back(worker);
+	}
+}
+
+
+//! destructor
+CThreadPool::~CThreadPool()
+{
+	LOCK(Sync);
+	Quit = true;
+#ifdef _IRR_WINDOWS_API_
+	ReleaseSemaphore(Sync->Start, Workers.size(), 0);
+#else
+	pthread_cond_broadcast(&Sync->Start);
+#endif
+	UNLOCK(Sync);
+
+	for (u32 i=0; i<Workers.size(); ++i)
+	{
+#ifdef _IRR_WINDOWS_API_
+		WaitForSingleObject(Workers[i]->Thread, INFINITE);
+		CloseHandle(Workers[i]->Thread);
+#else
+		pthread_join(Workers[i]->Thread, 0);
+#endif
+		delete Workers[i];
+	}
+
+#ifdef _IRR_WINDOWS_API_
+	CloseHandle(Sync->Start);
+	CloseHandle(Sync->Done);
+	DeleteCriticalSection(&Sync->RunLock);
+	DeleteCriticalSection(&Sync->Lock);
+#else
+	pthread_cond_destroy(&Sync->Done);
+	pthread_cond_destroy(&Sync->Start);
+	pthread_mutex_destroy(&Sync->RunLock);
+	pthread_mutex_destroy(&Sync->Lock);
+#endif
+	delete Sync;
+}
+
+
+//! Adds a reference to the pool
+void CThreadPool::grab()
+{
+	LOCK_SHARED();
+	++ReferenceCounter;
+	UNLOCK_SHARED();
+}
+
+
+//! Releases a reference, the pool is deleted when the last one is released
+bool CThreadPool::drop()
+{
+	LOCK_SHARED();
+	const bool last = (--ReferenceCounter == 0);
+	// a new user gets a new pool while this one shuts down
+	if (last && SharedPool == this)
+		SharedPool = 0;
+	UNLOCK_SHARED();
+
+	if (last)
+		delete this;
+
+	return last;
+}
+
+
+//! Returns the number of threads, including the calling thread
+u32 CThreadPool::getThreadCount() const
+{
+	return Workers.size() + 1;
+}
+
+
+//! Runs a batch of jobs and returns when all of them are done
+void CThreadPool::run(JobFunction function, void* userData, u32 jobCount)
+{
+	if (Workers.empty() || jobCount < 2)
+	{
+		for (u32 i=0; i<jobCount; ++i)
+			function(userData, i, 0);
+		return;
+	}
+
+#ifdef _IRR_WINDOWS_API_
+	EnterCriticalSection(&Sync->RunLock);
+#else
+	pthread_mutex_lock(&Sync->RunLock);
+#endif
+
+	LOCK(Sync);
+	Function = function;
+	UserData = userData;
+	JobCount = jobCount;
+	NextJob = 0;
+	Pending = jobCount;
+	++Batch;
+#ifdef _IRR_WINDOWS_API_
+	ReleaseSemaphore(Sync->Start, core::min_(Workers.size(), jobCount-1), 0);
+#else
+	pthread_cond_broadcast(&Sync->Start);
+#endif
+	UNLOCK(Sync);
+
+	work(0);
+
+#ifdef _IRR_WINDOWS_API_
+	WaitForSingleObject(Sync->Done, INFINITE);
+	LeaveCriticalSection(&Sync->RunLock);
+#else
+	LOCK(Sync);
+	while (Pending)
+		pthread_cond_wait(&Sync->Done, &Sync->Lock);
+	UNLOCK(Sync);
+	pthread_mutex_unlock(&Sync->RunLock);
+#endif
+}
+
+
+//! runs jobs of the current batch until none are left
+void CThreadPool::work(u32 slot)
+{
+	for (;;)
+	{
+		LOCK(Sync);
+		if (NextJob >= JobCount)
+		{
+			UNLOCK(Sync);
+			return;
+		}
+		const u32 job = NextJob++;
+		JobFunction function = Function;
+		void* userData = UserData;
+		UNLOCK(Sync);
+
+		function(userData, job, slot);
+
+		LOCK(Sync);
+		if (--Pending == 0)
+		{
+#ifdef _IRR_WINDOWS_API_
+			SetEvent(Sync->Done);
+#else
+			pthread_cond_broadcast(&Sync->Done);
+#endif
+		}
+		UNLOCK(Sync);
+	}
+}
+
+
+void CThreadPool::workerMain(SWorker* worker)
+{
+	CThreadPool* pool = worker->Pool;
+
+#ifdef _IRR_WINDOWS_API_
+	for (;;)
+	{
+		WaitForSingleObject(pool->Sync->Start, INFINITE);
+
+		LOCK(pool->Sync);
+		const bool quit = pool->Quit;
+		UNLOCK(pool->Sync);
+
+		if (quit)
+			break;
+
+		pool->work(worker->Slot);
+	}
+#else
+	LOCK(pool->Sync);
+	u32 batch = pool->Batch;
+	for (;;)
+	{
+		while (!pool->Quit && pool->Batch == batch)
+			pthread_cond_wait(&pool->Sync->Start, &pool->Sync->Lock);
+
+		if (pool->Quit)
+			break;
+
+		batch = pool->Batch;
+		UNLOCK(pool->Sync);
+		pool->work(worker->Slot);
+		LOCK(pool->Sync);
+	}
+	UNLOCK(pool->Sync);
+#endif
+}
+
+
+//! Returns the number of processors of the system
+u32 CThreadPool::getProcessorCount()
+{
+#ifdef _IRR_WINDOWS_API_
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	const s32 count = (s32)info.dwNumberOfProcessors;
+#else
+	const s32 count = (s32)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return (u32)core::s32_clamp(count, 1, 32);
+}
+
+
+//! Returns the pool shared by all users inside the engine
+CThreadPool* CThreadPool::createSharedPool()
+{
+	LOCK_SHARED();
+	if (SharedPool)
+		++SharedPool->ReferenceCounter;
+	else
+		SharedPool = new CThreadPool();
+
+	CThreadPool* pool = SharedPool;
+	UNLOCK_SHARED();
+
+	return pool;
+}
+
+#undef LOCK
+#undef UNLOCK
+#undef LOCK_SHARED
+#undef UNLOCK_SHARED
+
+} // end namespace irr
+
@@ -0,0 +1,90 @@
+// Copyright (C) 2002-2008 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_THREAD_POOL_H_INCLUDED__
+#define __C_THREAD_POOL_H_INCLUDED__
+
+#include "irrArray.h"
+
+namespace irr
+{
+
+//! Fixed set of worker threads running batches of independent jobs.
+/** The calling thread always takes part in a batch, so a pool of N threads
+runs N jobs at a time and a pool of 1 thread runs everything on the caller.
+Batches from different threads are run one after another.
+The pool is reference counted like IReferenceCounted, but grab() and drop()
+are thread safe, as the shared pool is used by the devices of all threads. */
+class CThreadPool
+{
+public:
+
+	//! Job callback
+	/** \param userData Pointer passed to run()
+	\param job Index of the job, in [0, jobCount)
+	\param slot Index of the thread running the job, in [0, getThreadCount()).
+	Jobs of one batch never run at the same time with the same slot, so the
+	slot can be used to pick per thread scratch memory. */
+	typedef void (*JobFunction)(void* userData, u32 job, u32 slot);
+
+	//! constructor
+	/** \param threadCount Number of threads including the caller, 0 for one per processor */
+	CThreadPool(u32 threadCount=0);
+
+	//! destructor
+	virtual ~CThreadPool();
+
+	//! Adds a reference to the pool
+	void grab();
+
+	//! Releases a reference, the pool is deleted when the last one is released
+	/** \return True if the pool was deleted. */
+	bool drop();
+
+	//! Returns the number of threads, including the calling thread
+	u32 getThreadCount() const;
+
+	//! Runs a batch of jobs and returns when all of them are done
+	void run(JobFunction function, void* userData, u32 jobCount);
+
+	//! Returns the number of processors of the system
+	static u32 getProcessorCount();
+
+	//! Returns the pool shared by all users inside the engine
+	/** The pool has one thread per processor and is created on first use.
+	\return Pointer to the pool. Drop it when it is no longer needed, the
+	pool is destroyed when its last user drops it. */
+	static CThreadPool* createSharedPool();
+
+private:
+
+	struct SWorker;
+
+	//! runs jobs of the current batch until none are left
+	void work(u32 slot);
+
+	static void workerMain(SWorker* worker);
+
+	core::array<SWorker*> Workers;
+
+	//! platform specific synchronization objects
+	struct SSync;
+	SSync* Sync;
+
+	//! changed with the lock of the shared pool held
+	u32 ReferenceCounter;
+
+	JobFunction Function;
+	void* UserData;
+	u32 JobCount;
+	u32 NextJob;
+	u32 Pending;
+	u32 Batch;
+	bool Quit;
+};
+
+} // end namespace irr
+
+#endif
+
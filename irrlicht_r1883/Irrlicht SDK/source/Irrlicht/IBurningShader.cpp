@@ -23,7 +23,8 @@ namespace video
 	};
 
 	IBurningShader::IBurningShader(IDepthBuffer* zbuffer)
-		:RenderTarget(0),DepthBuffer(zbuffer)
+		:RenderTarget(0),DepthBuffer(zbuffer),
+		RenderBandStart(0),RenderBandEnd(0x7FFFFFFF)
 	{
 		#ifdef _DEBUG
 		setDebugName("IBurningShader");
@@ -106,6 +107,87 @@ namespace video
 	}
 
 
+	//! sets a texture state returned by getTextureParam of another shader
+	void IBurningShader::setTextureParam( u32 stage, const sInternalTexture &texture )
+	{
+		IT[stage] = texture;
+
+		// not grabbed, so it must not be dropped
+		IT[stage].Texture = 0;
+	}
+
+
+	//! restricts drawing to the rows yStart up to yEnd - 1 of the render target
+	void IBurningShader::setRenderBand ( s32 yStart, s32 yEnd )
+	{
+		RenderBandStart = yStart;
+		RenderBandEnd = yEnd;
+	}
+
+
+	//! creates all triangle renderers used by the driver, sharing one zbuffer
+	void createBurningShaders ( IBurningShader* shader[ETR2_COUNT], IDepthBuffer* zbuffer )
+	{
+		irr::memset32 ( shader, 0, sizeof ( IBurningShader* ) * ETR2_COUNT );
+		//shader[ETR_FLAT] = createTRFlat2(zbuffer);
+		//shader[ETR_FLAT_WIRE] = createTRFlatWire2(zbuffer);
+		shader[ETR_GOURAUD] = createTriangleRendererGouraud2(zbuffer);
+		shader[ETR_GOURAUD_ALPHA] = createTriangleRendererGouraudAlpha2(zbuffer );
+		shader[ETR_GOURAUD_ALPHA_NOZ] = createTRGouraudAlphaNoZ2(zbuffer );
+		//shader[ETR_GOURAUD_WIRE] = createTriangleRendererGouraudWire2(zbuffer);
+		//shader[ETR_TEXTURE_FLAT] = createTriangleRendererTextureFlat2(zbuffer);
+		//shader[ETR_TEXTURE_FLAT_WIRE] = createTriangleRendererTextureFlatWire2(zbuffer);
+		shader[ETR_TEXTURE_GOURAUD] = createTriangleRendererTextureGouraud2(zbuffer);
+		shader[ETR_TEXTURE_GOURAUD_LIGHTMAP] = createTriangleRendererTextureLightMap2_M1(zbuffer);
+		shader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M2] = createTriangleRendererTextureLightMap2_M2(zbuffer);
+		shader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M4] = createTriangleRendererGTextureLightMap2_M4(zbuffer);
+		shader[ETR_TEXTURE_LIGHTMAP_M4] = createTriangleRendererTextureLightMap2_M4(zbuffer);
+		shader[ETR_TEXTURE_GOURAUD_LIGHTMAP_ADD] = createTriangleRendererTextureLightMap2_Add(zbuffer);
+		shader[ETR_TEXTURE_GOURAUD_DETAIL_MAP] = createTriangleRendererTextureDetailMap2(zbuffer);
+
+		shader[ETR_TEXTURE_GOURAUD_WIRE] = createTriangleRendererTextureGouraudWire2(zbuffer);
+		shader[ETR_TEXTURE_GOURAUD_NOZ] = createTRTextureGouraudNoZ2();
+		shader[ETR_TEXTURE_GOURAUD_ADD] = createTRTextureGouraudAdd2(zbuffer);
+		shader[ETR_TEXTURE_GOURAUD_ADD_NO_Z] = createTRTextureGouraudAddNoZ2(zbuffer);
+		shader[ETR_TEXTURE_GOURAUD_VERTEX_ALPHA] = createTriangleRendererTextureVertexAlpha2 ( zbuffer );
+
+		shader[ETR_TEXTURE_GOURAUD_ALPHA] = createTRTextureGouraudAlpha(zbuffer );
+		shader[ETR_TEXTURE_GOURAUD_ALPHA_NOZ] = createTRTextureGouraudAlphaNoZ( zbuffer );
+
+		shader[ETR_TEXTURE_BLEND] = createTRTextureBlend( zbuffer );
+
+		shader[ETR_REFERENCE] = createTriangleRendererReference ( zbuffer );
+	}
+
+
+	//! sets the render states of a material to a triangle renderer
+	void setBurningShaderMaterial ( IBurningShader* shader, EBurningFFShader type,
+		const SBurningShaderMaterial &material )
+	{
+		shader->setZCompareFunc ( material.org.ZBuffer );
+		switch ( type )
+		{
+			case ETR_TEXTURE_GOURAUD_ALPHA:
+			case ETR_TEXTURE_GOURAUD_ALPHA_NOZ:
+				shader->setParam ( 0, material.org.MaterialTypeParam );
+				break;
+
+			case EMT_ONETEXTURE_BLEND:
+			{
+				E_BLEND_FACTOR srcFact,dstFact;
+				E_MODULATE_FUNC modulate;
+				unpack_texureBlendFunc ( srcFact, dstFact, modulate, material.org.MaterialTypeParam );
+				shader->setParam ( 0, material.org.MaterialTypeParam );
+			}
+			break;
+			default:
+			break;
+		}
+
+		shader->setMaterial ( material );
+	}
+
+
 
 } // end namespace video
 } // end namespace irr
@@ -109,6 +109,18 @@ namespace video
 
 		//! sets the Texture
 		virtual void setTextureParam( u32 stage, video::CSoftwareTexture2* texture, s32 lodLevel);
+
+		//! sets a texture state returned by getTextureParam of another shader
+		/** The texture is not grabbed and has to stay valid while drawing,
+			so threads of the driver can use it. */
+		void setTextureParam( u32 stage, const sInternalTexture &texture );
+
+		//! returns the texture state set by setTextureParam
+		const sInternalTexture& getTextureParam( u32 stage ) const { return IT[stage]; }
+
+		//! restricts drawing to the rows yStart up to yEnd - 1 of the render target
+		void setRenderBand ( s32 yStart, s32 yEnd );
+
 		virtual void drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c ) = 0;
 		virtual void drawLine ( const s4DVertex *a,const s4DVertex *b) {};
 
@@ -127,6 +139,10 @@ namespace video
 
 		sInternalTexture IT[ BURNING_MATERIAL_MAX_TEXTURES ];
 
+		// rows drawn to, scanlines outside are stepped over
+		s32 RenderBandStart;
+		s32 RenderBandEnd;
+
 		static const tFixPointu dithermask[ 4 * 4];
 	};
 
@@ -161,6 +177,13 @@ namespace video
 
 	IBurningShader* createTriangleRendererReference(IDepthBuffer* zbuffer);
 
+	//! creates all triangle renderers used by the driver, sharing one zbuffer
+	void createBurningShaders ( IBurningShader* shader[ETR2_COUNT], IDepthBuffer* zbuffer );
+
+	//! sets the render states of a material to a triangle renderer
+	void setBurningShaderMaterial ( IBurningShader* shader, EBurningFFShader type,
+		const SBurningShaderMaterial &material );
+
 
 
 } // end namespace video
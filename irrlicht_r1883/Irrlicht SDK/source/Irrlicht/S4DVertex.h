@@ -376,6 +376,9 @@ struct SCacheInfo
 
 #define VERTEXCACHE_ELEMENT	16
 #define VERTEXCACHE_MISS 0xFFFFFFFF
+
+// meshes with less vertices are transformed one vertex at a time
+#define VERTEXCACHE_BATCH_MIN_VERTICES 64
 struct SVertexCache
 {
 	SVertexCache (): mem ( VERTEXCACHE_ELEMENT * 2, 128 ) {}
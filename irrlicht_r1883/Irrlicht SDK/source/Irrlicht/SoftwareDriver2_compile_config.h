@@ -62,6 +62,11 @@
 
 // Derivate flags
 
+// transform, clip test and light four vertices at once
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define SOFTWARE_DRIVER_2_SSE
+#endif
+
 // texture format
 #ifdef SOFTWARE_DRIVER_2_32BIT
 	#define	BURNINGSHADER_COLOR_FORMAT	ECF_A8R8G8B8
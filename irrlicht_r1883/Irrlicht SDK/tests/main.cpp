@@ -39,6 +39,9 @@ int main()
 	RUN_TEST(disambiguateTextures);
 	RUN_TEST(drawPixel);
 	RUN_TEST(md2Animation);
+	RUN_TEST(textureResidency);
+	RUN_TEST(rasterizerThreads);
+	RUN_TEST(optimizeVertexCache);
 
 	(void)printf("\nTests finished. %d test%s failed.\n", fails, 1 == fails ? "" : "s");
 	
@@ -0,0 +1,164 @@
+// Tests the MESH_OPTIMIZE_VERTEX_CACHE flag of the scene manager.
+// Meshes are loaded once as they are and once optimized. The optimized ones
+// must have the same triangles with the same winding, and their average
+// cache miss ratio must not be higher than before.
+
+#include "irrlicht.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+using namespace video;
+using namespace io;
+using namespace gui;
+
+//! A triangle by the positions and texture coordinates of its corners
+/** The corners are rotated to the smallest of the three rotations, which
+keeps the winding but makes triangles comparable wherever they start. */
+struct STriangle
+{
+	vector3df Pos[3];
+	vector2df TCoords[3];
+
+	static bool less(const vector3df& p0, const vector2df& t0,
+		const vector3df& p1, const vector2df& t1)
+	{
+		const f32 a[5] = { p0.X, p0.Y, p0.Z, t0.X, t0.Y };
+		const f32 b[5] = { p1.X, p1.Y, p1.Z, t1.X, t1.Y };
+		for (u32 i = 0; i < 5; ++i)
+			if (a[i] != b[i])
+				return a[i] < b[i];
+		return false;
+	}
+
+	void set(const IMeshBuffer* mb, u32 i0, u32 i1, u32 i2)
+	{
+		const u32 idx[3] = { i0, i1, i2 };
+		for (u32 first = 0; first < 3; ++first)
+		{
+			STriangle rotated;
+			for (u32 i = 0; i < 3; ++i)
+			{
+				rotated.Pos[i] = mb->getPosition(idx[(first + i) % 3]);
+				rotated.TCoords[i] = mb->getTCoords(idx[(first + i) % 3]);
+			}
+
+			if (!first || rotated < *this)
+				*this = rotated;
+		}
+	}
+
+	bool operator<(const STriangle& other) const
+	{
+		for (u32 i = 0; i < 3; ++i)
+		{
+			if (less(Pos[i], TCoords[i], other.Pos[i], other.TCoords[i]))
+				return true;
+			if (less(other.Pos[i], other.TCoords[i], Pos[i], TCoords[i]))
+				return false;
+		}
+		return false;
+	}
+
+	bool operator==(const STriangle& other) const
+	{
+		return !(*this < other) && !(other < *this);
+	}
+};
+
+
+//! Returns the sorted triangles of a mesh buffer
+static void getTriangles(const IMeshBuffer* mb, array<STriangle>& triangles)
+{
+	const u32 indexCount = mb->getIndexCount() - mb->getIndexCount() % 3;
+	triangles.set_used(indexCount / 3);
+
+	for (u32 i = 0; i < indexCount; i += 3)
+	{
+		if (mb->getIndexType() == EIT_32BIT)
+		{
+			const u32* idx = (const u32*) mb->getIndices();
+			triangles[i / 3].set(mb, idx[i], idx[i + 1], idx[i + 2]);
+		}
+		else
+		{
+			const u16* idx = mb->getIndices();
+			triangles[i / 3].set(mb, idx[i], idx[i + 1], idx[i + 2]);
+		}
+	}
+
+	// set_used() keeps the array marked as sorted
+	triangles.set_sorted(false);
+	triangles.sort();
+}
+
+
+//! Loads a mesh as it is and optimized, and compares both
+static bool testMesh(IrrlichtDevice* device, const c8* filename, bool reduceOverdraw)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	IMeshManipulator* manipulator = device->getVideoDriver()->getMeshManipulator();
+
+	smgr->getParameters()->setAttribute(MESH_OPTIMIZE_VERTEX_CACHE, false);
+	IAnimatedMesh* original = smgr->getMesh(filename);
+	if (!original)
+		return false;
+
+	original->grab();
+	smgr->getMeshCache()->removeMesh(original);
+
+	smgr->getParameters()->setAttribute(MESH_OPTIMIZE_VERTEX_CACHE, true);
+	smgr->getParameters()->setAttribute(MESH_OPTIMIZE_OVERDRAW, reduceOverdraw);
+	IAnimatedMesh* optimized = smgr->getMesh(filename);
+
+	bool result = optimized != 0;
+	if (result)
+	{
+		IMesh* before = original->getMesh(0);
+		IMesh* after = optimized->getMesh(0);
+
+		result = before->getMeshBufferCount() == after->getMeshBufferCount();
+
+		array<STriangle> trianglesBefore;
+		array<STriangle> trianglesAfter;
+		for (u32 b = 0; result && b < before->getMeshBufferCount(); ++b)
+		{
+			getTriangles(before->getMeshBuffer(b), trianglesBefore);
+			getTriangles(after->getMeshBuffer(b), trianglesAfter);
+
+			result = trianglesBefore.size() == trianglesAfter.size();
+			for (u32 i = 0; result && i < trianglesBefore.size(); ++i)
+				result = trianglesBefore[i] == trianglesAfter[i];
+		}
+
+		result &= manipulator->getAverageCacheMissRatio(after) <=
+			manipulator->getAverageCacheMissRatio(before);
+
+		smgr->getMeshCache()->removeMesh(optimized);
+	}
+
+	smgr->getParameters()->setAttribute(MESH_OPTIMIZE_VERTEX_CACHE, false);
+	smgr->getParameters()->setAttribute(MESH_OPTIMIZE_OVERDRAW, false);
+	original->drop();
+
+	return result;
+}
+
+
+bool optimizeVertexCache(void)
+{
+	IrrlichtDevice *device = createDevice( EDT_NULL, dimension2d<s32>(160, 120));
+	if (!device)
+		return false;
+
+	bool passed = true;
+
+	passed &= testMesh(device, "../media/earth.x", false);
+	passed &= testMesh(device, "../media/earth.x", true);
+	passed &= testMesh(device, "../media/dwarf.x", false);
+	passed &= testMesh(device, "../media/dwarf.x", true);
+
+	device->drop();
+
+	return passed;
+}
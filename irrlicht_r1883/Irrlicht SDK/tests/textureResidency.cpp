@@ -0,0 +1,163 @@
+// Tests IVideoDriver::setTextureBudget() and setTextureReloadCallBack().
+// Textures are used in different frames with a budget which only fits some
+// of them. The least recently used ones have to be evicted first, render
+// targets and textures used in the current frame never, and the reload
+// callback has to bring evicted textures back with their content.
+
+#include "irrlicht.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+using namespace video;
+using namespace io;
+using namespace gui;
+
+//! Fills reloaded textures with red and counts the reloads
+class CRedReloadCallBack : public ITextureReloadCallBack
+{
+public:
+
+	CRedReloadCallBack(IVideoDriver* driver) : Driver(driver), Reloads(0) {}
+
+	virtual IImage* OnReloadTexture(const ITexture* texture)
+	{
+		++Reloads;
+		IImage* image = Driver->createImage(ECF_A8R8G8B8, texture->getOriginalSize());
+		image->fill(SColor(255, 255, 0, 0));
+		return image;
+	}
+
+	IVideoDriver* Driver;
+	u32 Reloads;
+};
+
+
+//! Draws a frame in which only the given textures are used
+static void frame(IVideoDriver* driver, ITexture* used0 = 0, ITexture* used1 = 0)
+{
+	driver->beginScene(true, true, SColor(255, 0, 0, 0));
+	if (used0)
+		driver->makeTextureResident(used0);
+	if (used1)
+		driver->makeTextureResident(used1);
+	driver->endScene();
+}
+
+
+//! Returns the color of the top left pixel of a texture
+static SColor firstPixel(IVideoDriver* driver, ITexture* texture)
+{
+	SColor color(0);
+
+	void* data = texture->lock(true);
+	if (!data)
+		return color;
+
+	IImage* image = driver->createImageFromData(texture->getColorFormat(), texture->getSize(), data);
+	texture->unlock();
+
+	if (image)
+	{
+		color = image->getPixel(0, 0);
+		image->drop();
+	}
+
+	return color;
+}
+
+
+static bool runTestWithDriver(E_DRIVER_TYPE driverType)
+{
+	IrrlichtDevice *device = createDevice( driverType, dimension2d<s32>(64, 64));
+	if (!device)
+		return true; // Treat a failure to create a driver as benign; this saves a lot of #ifdefs
+
+	IVideoDriver* driver = device->getVideoDriver();
+
+	CRedReloadCallBack* callback = new CRedReloadCallBack(driver);
+	driver->setTextureReloadCallBack(callback);
+
+	// the textures start blue, so reloaded ones can be told apart
+	IImage* blue = driver->createImage(ECF_A8R8G8B8, dimension2d<s32>(16, 16));
+	blue->fill(SColor(255, 0, 0, 255));
+
+	ITexture* tex[4];
+	for (u32 i = 0; i < 4; ++i)
+	{
+		stringc name("residency");
+		name += stringc(i);
+		tex[i] = driver->addTexture(name.c_str(), blue);
+	}
+	blue->drop();
+	ITexture* target = driver->addRenderTargetTexture(dimension2d<s32>(16, 16));
+
+	bool result = tex[0] && tex[1] && tex[2] && tex[3] && target;
+	if (!result)
+	{
+		driver->setTextureReloadCallBack(0);
+		callback->drop();
+		device->drop();
+		return false;
+	}
+
+	const u32 size = tex[0]->getTextureMemorySize();
+
+	// use them in the order 3, 1, 2, 0, the render target never
+	frame(driver, tex[3]);
+	frame(driver, tex[1]);
+	frame(driver, tex[2]);
+	frame(driver, tex[0]);
+
+	for (u32 i = 0; i < 4; ++i)
+		result &= !tex[i]->isEvicted();
+
+	// leaves room for three textures and the render target
+	driver->setTextureBudget(1, 3 * size + target->getTextureMemorySize());
+	frame(driver);
+	result &= tex[3]->isEvicted();
+	result &= !tex[0]->isEvicted() && !tex[1]->isEvicted() && !tex[2]->isEvicted();
+
+	// the next one in the order of use
+	driver->setTextureBudget(1, 2 * size + target->getTextureMemorySize());
+	frame(driver);
+	result &= tex[1]->isEvicted();
+	result &= !tex[0]->isEvicted() && !tex[2]->isEvicted();
+
+	// nothing fits, but the textures of this frame and the render target stay
+	driver->setTextureBudget(1, 1);
+	frame(driver, tex[0], tex[3]);
+	result &= tex[2]->isEvicted();
+	result &= !tex[0]->isEvicted() && !tex[3]->isEvicted();
+	result &= !target->isEvicted();
+	result &= callback->Reloads == 1;
+
+	// the callback brings back the content, and is not asked for resident textures
+	result &= firstPixel(driver, tex[3]) == SColor(255, 255, 0, 0);
+	result &= firstPixel(driver, tex[0]) == SColor(255, 0, 0, 255);
+
+	result &= driver->makeTextureResident(tex[1]);
+	result &= !tex[1]->isEvicted();
+	result &= callback->Reloads == 2;
+	result &= firstPixel(driver, tex[1]) == SColor(255, 255, 0, 0);
+
+	u32 imageBytes, textureBytes;
+	driver->getTextureMemoryUsage(imageBytes, textureBytes);
+	result &= textureBytes == 3 * size + target->getTextureMemorySize();
+
+	driver->setTextureReloadCallBack(0);
+	callback->drop();
+	device->drop();
+
+	return result;
+}
+
+
+bool textureResidency(void)
+{
+	bool passed = true;
+
+	passed &= runTestWithDriver(EDT_BURNINGSVIDEO);
+
+	return passed;
+}
@@ -0,0 +1,273 @@
+#if COMPILE_WITH_FREETYPE || !WIN32
+#include "main.h"
+#include "CGUITTBillboardSceneNode.h"
+
+namespace irr
+{
+namespace gui
+{
+
+//! constructor
+CGUITTBillboardSceneNode::CGUITTBillboardSceneNode(scene::ISceneNode* parent, scene::ISceneManager* mgr, s32 id,
+		CGUITTFont* font, const wchar_t* text,
+		const core::vector3df& position, const core::dimension2d<f32>& size,
+		video::SColor colorTop, video::SColor colorBottom)
+	: scene::IBillboardTextSceneNode(parent, mgr, id, position), Font(font), Texture(0),
+	TextPixels(1,1), ImagePixels(1,1), TextOrigin(0,0)
+{
+	#ifdef _DEBUG
+	setDebugName("CGUITTBillboardSceneNode");
+	#endif
+
+	if (Font)
+		Font->grab();
+
+	Material.MaterialType = video::EMT_TRANSPARENT_ALPHA_CHANNEL;
+
+	indices[0] = 0;
+	indices[1] = 2;
+	indices[2] = 1;
+	indices[3] = 0;
+	indices[4] = 3;
+	indices[5] = 2;
+
+	vertices[0].TCoords.set(1.0f, 1.0f);
+	vertices[1].TCoords.set(1.0f, 0.0f);
+	vertices[2].TCoords.set(0.0f, 0.0f);
+	vertices[3].TCoords.set(0.0f, 1.0f);
+
+	setColor(colorTop, colorBottom);
+
+	Size = size;
+	setText(text);
+	setSize(size);
+}
+
+
+//! destructor
+CGUITTBillboardSceneNode::~CGUITTBillboardSceneNode()
+{
+	if (Texture)
+		SceneManager->getVideoDriver()->removeTexture(Texture);
+
+	if (Font)
+		Font->drop();
+}
+
+
+//! pre render event
+void CGUITTBillboardSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Texture)
+		SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! render
+void CGUITTBillboardSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	scene::ICameraSceneNode* camera = SceneManager->getActiveCamera();
+
+	if (!camera || !driver || !Texture)
+		return;
+
+	// make billboard look to camera
+
+	core::vector3df pos = getAbsolutePosition();
+
+	core::vector3df campos = camera->getAbsolutePosition();
+	core::vector3df target = camera->getTarget();
+	core::vector3df up = camera->getUpVector();
+	core::vector3df view = target - campos;
+	view.normalize();
+
+	core::vector3df horizontal = up.crossProduct(view);
+	if ( horizontal.getLength() == 0 )
+	{
+		horizontal.set(up.Y,up.X,up.Z);
+	}
+	horizontal.normalize();
+
+	core::vector3df vertical = horizontal.crossProduct(view);
+	vertical.normalize();
+
+	// the glyphs may reach out of the text box, so the quad is not centered on the node
+	pos += horizontal * QuadCenter.X - vertical * QuadCenter.Y;
+
+	horizontal *= HalfQuad.Width;
+	vertical *= HalfQuad.Height;
+
+	view *= -1.0f;
+
+	for (s32 i=0; i<4; ++i)
+		vertices[i].Normal = view;
+
+	vertices[0].Pos = pos + horizontal + vertical;
+	vertices[1].Pos = pos + horizontal - vertical;
+	vertices[2].Pos = pos - horizontal - vertical;
+	vertices[3].Pos = pos - horizontal + vertical;
+
+	// draw
+
+	if ( DebugDataVisible & scene::EDS_BBOX )
+	{
+		driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+		driver->draw3DBox(BBox, video::SColor(0,208,195,152));
+	}
+
+	driver->setTransform(video::ETS_WORLD, core::IdentityMatrix);
+
+	driver->setMaterial(Material);
+
+	driver->drawIndexedTriangleList(vertices, 4, indices, 2);
+}
+
+
+//! returns the axis aligned bounding box of this node
+const core::aabbox3d<f32>& CGUITTBillboardSceneNode::getBoundingBox() const
+{
+	return BBox;
+}
+
+
+//! sets the text string
+void CGUITTBillboardSceneNode::setText(const wchar_t* text)
+{
+	if (!text)
+		text = L"";
+
+	if (Texture && Text == text)
+		return;
+
+	Text = text;
+	rebuild();
+}
+
+
+//! sets the color of the text
+void CGUITTBillboardSceneNode::setTextColor(video::SColor color)
+{
+	setColor(color);
+}
+
+
+//! sets the size of the text box in world units
+void CGUITTBillboardSceneNode::setSize(const core::dimension2d<f32>& size)
+{
+	Size = size;
+
+	if (Size.Width == 0.0f)
+		Size.Width = 1.0f;
+
+	if (Size.Height == 0.0f )
+		Size.Height = 1.0f;
+
+	updateGeometry();
+}
+
+
+//! gets the size of the text box in world units
+const core::dimension2d<f32>& CGUITTBillboardSceneNode::getSize() const
+{
+	return Size;
+}
+
+
+video::SMaterial& CGUITTBillboardSceneNode::getMaterial(u32 i)
+{
+	return Material;
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CGUITTBillboardSceneNode::getMaterialCount() const
+{
+	return 1;
+}
+
+
+//! Set the color of all vertices of the billboard
+void CGUITTBillboardSceneNode::setColor(const video::SColor & overallColor)
+{
+	for (u32 vertex = 0; vertex < 4; ++vertex)
+		vertices[vertex].Color = overallColor;
+}
+
+
+//! Set the color of the top and bottom vertices of the billboard
+void CGUITTBillboardSceneNode::setColor(const video::SColor & topColor, const video::SColor & bottomColor)
+{
+	vertices[0].Color = bottomColor;
+	vertices[1].Color = topColor;
+	vertices[2].Color = topColor;
+	vertices[3].Color = bottomColor;
+}
+
+
+//! Gets the color of the top and bottom vertices of the billboard
+void CGUITTBillboardSceneNode::getColor(video::SColor & topColor, video::SColor & bottomColor) const
+{
+	topColor = vertices[1].Color;
+	bottomColor = vertices[0].Color;
+}
+
+
+//! renders the text into the texture and fits the quad to it
+void CGUITTBillboardSceneNode::rebuild()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	if (Texture)
+	{
+		driver->removeTexture(Texture);
+		Texture = 0;
+	}
+
+	video::IImage* img = Font ? Font->createTextImage(Text.c_str(), TextOrigin) : 0;
+	if (img)
+	{
+		const core::dimension2d<s32> dim = Font->getDimension(Text.c_str());
+		TextPixels.Width = core::max_(dim.Width, 1);
+		TextPixels.Height = core::max_(dim.Height, 1);
+		ImagePixels = img->getDimension();
+
+		c8 name[64];
+		sprintf(name, "TTFontBillboard%p", (void*)this);
+		Texture = driver->addTexture(name, img);
+		img->drop();
+	}
+
+	Material.setTexture(0, Texture);
+	updateGeometry();
+}
+
+
+//! fits the quad and the bounding box to the size
+void CGUITTBillboardSceneNode::updateGeometry()
+{
+	const f32 scalex = Size.Width / TextPixels.Width;
+	const f32 scaley = Size.Height / TextPixels.Height;
+
+	HalfQuad.Width = 0.5f * ImagePixels.Width * scalex;
+	HalfQuad.Height = 0.5f * ImagePixels.Height * scaley;
+
+	// center of the image relative to the center of the text box, y going up
+	QuadCenter.X = (0.5f * (ImagePixels.Width - TextPixels.Width) - TextOrigin.X) * scalex;
+	QuadCenter.Y = -(0.5f * (ImagePixels.Height - TextPixels.Height) - TextOrigin.Y) * scaley;
+
+	// the quad turns with the camera
+	const f32 radius = core::vector2df(HalfQuad.Width, HalfQuad.Height).getLength() + QuadCenter.getLength();
+	BBox.MinEdge.set(-radius,-radius,-radius);
+	BBox.MaxEdge.set(radius,radius,radius);
+}
+
+} // end namespace gui
+} // end namespace irr
+
+#endif
@@ -0,0 +1,102 @@
+#if COMPILE_WITH_FREETYPE || !WIN32
+
+#ifndef __C_GUI_TT_BILLBOARD_SCENE_NODE_H_INCLUDED__
+#define __C_GUI_TT_BILLBOARD_SCENE_NODE_H_INCLUDED__
+
+#include "CGUITTFont.h"
+
+namespace irr
+{
+namespace gui
+{
+
+//! Billboard showing a string of a TrueType font.
+/** The whole string is rendered into one texture, so the text is a single
+quad facing the camera and is drawn with one call. The texture is only
+rebuilt when the text changes, colors are vertex colors. */
+class CGUITTBillboardSceneNode : public scene::IBillboardTextSceneNode
+{
+public:
+
+	//! constructor
+	CGUITTBillboardSceneNode(scene::ISceneNode* parent, scene::ISceneManager* mgr, s32 id,
+		CGUITTFont* font, const wchar_t* text,
+		const core::vector3df& position, const core::dimension2d<f32>& size,
+		video::SColor colorTop, video::SColor colorBottom);
+
+	//! destructor
+	virtual ~CGUITTBillboardSceneNode();
+
+	//! pre render event
+	virtual void OnRegisterSceneNode();
+
+	//! render
+	virtual void render();
+
+	//! returns the axis aligned bounding box of this node
+	virtual const core::aabbox3d<f32>& getBoundingBox() const;
+
+	//! sets the text string
+	virtual void setText(const wchar_t* text);
+
+	//! sets the color of the text
+	virtual void setTextColor(video::SColor color);
+
+	//! sets the size of the text box in world units
+	virtual void setSize(const core::dimension2d<f32>& size);
+
+	//! gets the size of the text box in world units
+	virtual const core::dimension2d<f32>& getSize() const;
+
+	virtual video::SMaterial& getMaterial(u32 i);
+
+	//! returns amount of materials used by this scene node.
+	virtual u32 getMaterialCount() const;
+
+	//! Returns type of the scene node
+	virtual scene::ESCENE_NODE_TYPE getType() const { return scene::ESNT_TEXT; }
+
+	//! Set the color of all vertices of the billboard
+	virtual void setColor(const video::SColor & overallColor);
+
+	//! Set the color of the top and bottom vertices of the billboard
+	virtual void setColor(const video::SColor & topColor, const video::SColor & bottomColor);
+
+	//! Gets the color of the top and bottom vertices of the billboard
+	virtual void getColor(video::SColor & topColor, video::SColor & bottomColor) const;
+
+private:
+
+	//! renders the text into the texture and fits the quad to it
+	void rebuild();
+
+	//! fits the quad and the bounding box to the size
+	void updateGeometry();
+
+	CGUITTFont* Font;
+	core::stringw Text;
+	video::ITexture* Texture;
+
+	//! size of the text box, and of the text image in pixels
+	core::dimension2d<f32> Size;
+	core::dimension2d<s32> TextPixels;
+	core::dimension2d<s32> ImagePixels;
+	core::position2d<s32> TextOrigin;
+
+	//! half extents of the quad and offset of its center from the node, in world units
+	core::dimension2d<f32> HalfQuad;
+	core::vector2df QuadCenter;
+
+	core::aabbox3d<f32> BBox;
+	video::SMaterial Material;
+
+	video::S3DVertex vertices[4];
+	u16 indices[6];
+};
+
+} // end namespace gui
+} // end namespace irr
+
+#endif
+
+#endif
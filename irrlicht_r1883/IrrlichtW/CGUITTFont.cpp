@@ -1,6 +1,8 @@
 #if COMPILE_WITH_FREETYPE || !WIN32
 #include "main.h"
 #include "CGUITTFont.h"
+#include "CGUITTBillboardSceneNode.h"
+#include <freetype/ftoutln.h>
 // >> Add by uirou for multibyte language start
 //#include "os.h"
 // << Add by uirou for multibyte language end
@@ -9,22 +11,281 @@ namespace irr
 namespace gui
 {
 
+CGUITTGlyphAtlas::CGUITTGlyphAtlas(video::IVideoDriver* driver, u32 cellWidth, u32 cellHeight, u32 maxPages)
+: Driver(driver), Head(-1), Tail(-1), CurrentStamp(1), PageSize(512),
+	CellWidth(cellWidth), CellHeight(cellHeight)
+{
+	while (PageSize < 2048 && (CellWidth * 8 > PageSize || CellHeight * 8 > PageSize))
+		PageSize <<= 1;
+	CellWidth = core::min_(CellWidth, PageSize);
+	CellHeight = core::min_(CellHeight, PageSize);
+
+	CellsX = PageSize / CellWidth;
+	CellsPerPage = CellsX * (PageSize / CellHeight);
+
+	// Direct3D 8 wants the coverage in all channels
+	WhiteIsCoverage = (Driver->getDriverType() == video::EDT_DIRECT3D8);
+
+	Pages.set_used(maxPages);
+	for (u32 i = 0;i < maxPages;i++){
+		Pages[i].Texture = 0;
+		Pages[i].Locked = 0;
+	}
+
+	const u32 cells = maxPages * CellsPerPage;
+	Owner.set_used(cells);
+	Stamp.set_used(cells);
+	Prev.set_used(cells);
+	Next.set_used(cells);
+	GlyphSize.set_used(cells);
+}
+
+CGUITTGlyphAtlas::~CGUITTGlyphAtlas()
+{
+	for (u32 i = 0;i < Pages.size();i++){
+		if (Pages[i].Texture){
+			if (Pages[i].Locked)
+				Pages[i].Texture->unlock();
+			Driver->removeTexture(Pages[i].Texture);
+		}
+	}
+}
+
+void CGUITTGlyphAtlas::beginBatch()
+{
+	++CurrentStamp;
+}
+
+s32 CGUITTGlyphAtlas::allocate(bool mono, s32* owner)
+{
+	s32 cell = -1;
+	u32 i;
+
+	// a free cell of a page of the same kind
+	for (i = 0;i < Pages.size() && cell < 0;i++){
+		if (Pages[i].Texture && Pages[i].Mono == mono && Pages[i].FreeCell >= 0){
+			cell = Pages[i].FreeCell;
+			Pages[i].FreeCell = Next[cell];
+		}
+	}
+
+	// a new page
+	for (i = 0;i < Pages.size() && cell < 0;i++){
+		if (!Pages[i].Texture){
+			createPage(i, mono);
+			cell = Pages[i].FreeCell;
+			Pages[i].FreeCell = Next[cell];
+		}
+	}
+
+	// the least recently drawn glyph of the same kind
+	for (s32 c = Tail;c >= 0 && cell < 0 && Stamp[c] != CurrentStamp;c = Prev[c]){
+		if (Pages[getPageOfCell(c)].Mono == mono){
+			evict(c);
+			cell = c;
+		}
+	}
+
+	// the page of the other kind which was drawn longest ago
+	if (cell < 0){
+		s32 page = -1;
+		for (i = 0;i < Pages.size();i++){
+			if (Pages[i].Texture && Pages[i].Mono != mono && Pages[i].LastStamp != CurrentStamp &&
+				(page < 0 || Pages[i].LastStamp < Pages[page].LastStamp))
+				page = i;
+		}
+		if (page < 0)
+			return -1;
+
+		releasePage(page);
+		createPage(page, mono);
+		cell = Pages[page].FreeCell;
+		Pages[page].FreeCell = Next[cell];
+	}
+
+	Owner[cell] = owner;
+	GlyphSize[cell] = core::dimension2d<s32>(0, 0);
+	Stamp[cell] = CurrentStamp;
+	Pages[getPageOfCell(cell)].LastStamp = CurrentStamp;
+	link(cell);
+	return cell;
+}
+
+void CGUITTGlyphAtlas::upload(s32 cell, const u8* coverage, u32 width, u32 height, u32 pitch)
+{
+	width = core::min_(width, CellWidth - 1);
+	height = core::min_(height, CellHeight - 1);
+	GlyphSize[cell] = core::dimension2d<s32>(width, height);
+
+	SPage& page = Pages[getPageOfCell(cell)];
+	if (!page.Locked){
+		page.Locked = (u8*)page.Texture->lock();
+		page.Pitch = page.Texture->getPitch();
+		if (!page.Locked)
+			return;
+	}
+
+	const core::rect<s32> r = getCellRect(cell);
+
+	const bool is32 = (page.Texture->getColorFormat() == video::ECF_A8R8G8B8);
+	for (u32 y = 0;y < CellHeight;y++){
+		u8 *row = page.Locked + (r.UpperLeftCorner.Y + y) * page.Pitch;
+		const u8 *pt = (y < height) ? coverage + y * pitch : 0;
+		if (is32){
+			u32 *texp = (u32*)row + r.UpperLeftCorner.X;
+			for (u32 x = 0;x < CellWidth;x++){
+				const u32 c = (pt && x < width) ? pt[x] : 0;
+				if (!c){
+					texp[x] = 0;
+				} else if (WhiteIsCoverage){
+					texp[x] = c * 0x01010101;
+				} else {
+					texp[x] = (c << 24) | 0xffffff;
+				}
+			}
+		} else {
+			u16 *texp = (u16*)row + r.UpperLeftCorner.X;
+			for (u32 x = 0;x < CellWidth;x++){
+				texp[x] = (pt && x < width && pt[x] >= 0x80) ? 0xffff : 0;
+			}
+		}
+	}
+}
+
+void CGUITTGlyphAtlas::touch(s32 cell)
+{
+	Stamp[cell] = CurrentStamp;
+	Pages[getPageOfCell(cell)].LastStamp = CurrentStamp;
+	if (Head != cell){
+		unlink(cell);
+		link(cell);
+	}
+}
+
+void CGUITTGlyphAtlas::commit()
+{
+	for (u32 i = 0;i < Pages.size();i++){
+		if (Pages[i].Locked){
+			Pages[i].Texture->unlock();
+			Pages[i].Locked = 0;
+		}
+	}
+}
+
+void CGUITTGlyphAtlas::clear()
+{
+	for (u32 i = 0;i < Pages.size();i++){
+		if (Pages[i].Texture)
+			releasePage(i);
+	}
+}
+
+core::rect<s32> CGUITTGlyphAtlas::getCellRect(s32 cell) const
+{
+	const u32 local = cell % CellsPerPage;
+	const s32 x = (local % CellsX) * CellWidth;
+	const s32 y = (local / CellsX) * CellHeight;
+	return core::rect<s32>(x, y, x + GlyphSize[cell].Width, y + GlyphSize[cell].Height);
+}
+
+void CGUITTGlyphAtlas::createPage(u32 page, bool mono)
+{
+	c8 name[128];
+	sprintf(name,"TTFontAtlas%p_%d",(void*)this,page);
+
+	video::IImage *img;
+	if (mono){
+		u16 *texd16 = new u16[PageSize*PageSize];
+		memset(texd16,0,PageSize*PageSize*sizeof(u16));
+		img = Driver->createImageFromData(video::ECF_A1R5G5B5,core::dimension2d<s32>(PageSize,PageSize),texd16);
+		delete [] texd16;
+	} else {
+		u32 *texd = new u32[PageSize*PageSize];
+		memset(texd,0,PageSize*PageSize*sizeof(u32));
+		img = Driver->createImageFromData(video::ECF_A8R8G8B8,core::dimension2d<s32>(PageSize,PageSize),texd);
+		delete [] texd;
+	}
+
+	bool flg16 = Driver->getTextureCreationFlag(video::ETCF_ALWAYS_16_BIT);
+	bool flg32 = Driver->getTextureCreationFlag(video::ETCF_ALWAYS_32_BIT);
+	bool flgmip = Driver->getTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS);
+	Driver->setTextureCreationFlag(video::ETCF_ALWAYS_16_BIT,mono);
+	Driver->setTextureCreationFlag(video::ETCF_ALWAYS_32_BIT,!mono);
+	Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS,false);
+	Pages[page].Texture = Driver->addTexture(name,img);
+	img->drop();
+	Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS,flgmip);
+	Driver->setTextureCreationFlag(video::ETCF_ALWAYS_32_BIT,flg32);
+	Driver->setTextureCreationFlag(video::ETCF_ALWAYS_16_BIT,flg16);
+
+	Pages[page].Mono = mono;
+	Pages[page].Locked = 0;
+	Pages[page].LastStamp = 0;
+
+	// all cells of the page are free
+	const s32 first = page * CellsPerPage;
+	for (u32 i = 0;i < CellsPerPage;i++){
+		Owner[first + i] = 0;
+		Next[first + i] = (i + 1 < CellsPerPage) ? first + i + 1 : -1;
+	}
+	Pages[page].FreeCell = first;
+}
+
+void CGUITTGlyphAtlas::releasePage(u32 page)
+{
+	const s32 first = page * CellsPerPage;
+	for (u32 i = 0;i < CellsPerPage;i++){
+		if (Owner[first + i])
+			evict(first + i);
+	}
+
+	if (Pages[page].Locked)
+		Pages[page].Texture->unlock();
+	Driver->removeTexture(Pages[page].Texture);
+	Pages[page].Texture = 0;
+	Pages[page].Locked = 0;
+}
+
+void CGUITTGlyphAtlas::evict(s32 cell)
+{
+	*Owner[cell] = -1;
+	Owner[cell] = 0;
+	unlink(cell);
+}
+
+void CGUITTGlyphAtlas::link(s32 cell)
+{
+	Prev[cell] = -1;
+	Next[cell] = Head;
+	if (Head >= 0)
+		Prev[Head] = cell;
+	Head = cell;
+	if (Tail < 0)
+		Tail = cell;
+}
+
+void CGUITTGlyphAtlas::unlink(s32 cell)
+{
+	if (Prev[cell] >= 0)
+		Next[Prev[cell]] = Next[cell];
+	else
+		Head = Next[cell];
+	if (Next[cell] >= 0)
+		Prev[Next[cell]] = Prev[cell];
+	else
+		Tail = Prev[cell];
+}
+
 CGUITTGlyph::CGUITTGlyph() : IReferenceCounted ()
 {
-	tex = NULL;
-	tex16 = NULL;
 	image = NULL;
+	slot = -1;
+	slot16 = -1;
 }
 
 CGUITTGlyph::~CGUITTGlyph()
 {
-	if (image) delete image;
-	if (tex){
-		Driver->removeTexture(tex);
-	}
-	if (tex16){
-		Driver->removeTexture(tex16);
-	}
+	if (image) delete [] image;
 }
 
 // >> add solehome's code for memory access error begin
@@ -34,162 +295,119 @@ void CGUITTGlyph::init()
    setDebugName("CGUITTGlyph");
    #endif
 
-   tex = NULL;
-   tex16 = NULL;
    image = NULL;
+   slot = -1;
+   slot16 = -1;
+   top = left = 0;
+   texw = texh = 0;
+   top16 = left16 = 0;
+   texw16 = texh16 = 0;
+   offset = 0;
 }
 // << add solehome's code for memory access error end
 
 void CGUITTGlyph::cache(u32 idx)
 {
+	// the bitmap of the outline covers its control box, rounded out to whole pixels
 	FT_Set_Pixel_Sizes(*face,0,size);
 	if (!FT_Load_Glyph(*face,idx,FT_LOAD_NO_HINTING|FT_LOAD_NO_BITMAP)){
 		FT_GlyphSlot glyph = (*face)->glyph;
-		FT_Bitmap  bits;
 		if (glyph->format == ft_glyph_format_outline ){
-			if (!FT_Render_Glyph( glyph, FT_RENDER_MODE_NORMAL)){
-				bits = glyph->bitmap;
-				u8 *pt = bits.buffer;
-				image = new u8[bits.width * bits.rows];
-				memcpy(image,pt,bits.width * bits.rows);
-				top = glyph->bitmap_top;
-				left = glyph->bitmap_left;
-				imgw = 1;
-				imgh = 1;
-				texw = bits.width;
-				texh = bits.rows;
-				for(;;){
-					if (imgw > texw){
-						break;
-					} else {
-						imgw <<= 1;
-					}
-				}
-				for(;;){
-					if (imgh > texh){
-						break;
-					} else {
-						imgh <<= 1;
-					}
-				}
-				if (imgw > imgh){
-					imgh = imgw;
-				} else {
-					imgw = imgh;
-				}
-				u32 *texd = new u32[imgw*imgh];
-				memset(texd,0,imgw*imgh*sizeof(u32));
-				u32 *texp = texd;
-				offset = size - bits.rows;
-				bool cflag = (Driver->getDriverType() == video::EDT_DIRECT3D8);
-				for (int i = 0;i < bits.rows;i++){
-					u32 *rowp = texp;
-					for (int j = 0;j < bits.width;j++){
-						if (*pt){
-							if (cflag){
-								*rowp = *pt;
-								*rowp *= 0x01010101;
-							} else {
-								*rowp = *pt << 24;
-								*rowp |= 0xffffff;
-							}
-						} else {
-							*rowp = 0;
-						}
-						pt++;
-						rowp++;
-					}
-					texp += imgw;
-				}
-				c8 name[128];
-				sprintf(name,"TTFontGlyph%d",idx);
-				video::IImage *img = Driver->createImageFromData(video::ECF_A8R8G8B8,core::dimension2d<s32>(imgw,imgh),texd);
-				bool flg16 = Driver->getTextureCreationFlag(video::ETCF_ALWAYS_16_BIT);
-				bool flg32 = Driver->getTextureCreationFlag(video::ETCF_ALWAYS_32_BIT);
-				bool flgmip = Driver->getTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS);
-				Driver->setTextureCreationFlag(video::ETCF_ALWAYS_16_BIT,false);
-				Driver->setTextureCreationFlag(video::ETCF_ALWAYS_32_BIT,true);
-				Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS,false);
-				if (tex){
-					Driver->removeTexture(tex);
-				}
-				tex = Driver->addTexture(name,img);
-				img->drop();
-//				tex->drop();
-				Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS,flgmip);
-				Driver->setTextureCreationFlag(video::ETCF_ALWAYS_32_BIT,flg32);
-				Driver->setTextureCreationFlag(video::ETCF_ALWAYS_16_BIT,flg16);
-				delete texd;
-				cached = true;
+			FT_BBox cbox;
+			FT_Outline_Get_CBox(&glyph->outline,&cbox);
+			cbox.xMin &= ~63;
+			cbox.yMin &= ~63;
+			cbox.xMax = (cbox.xMax + 63) & ~63;
+			cbox.yMax = (cbox.yMax + 63) & ~63;
+			left = cbox.xMin >> 6;
+			top = cbox.yMax >> 6;
+			texw = (cbox.xMax - cbox.xMin) >> 6;
+			texh = (cbox.yMax - cbox.yMin) >> 6;
+			offset = size - texh;
+		}
+	}
+	cached = true;
+}
+
+bool CGUITTGlyph::rasterize(u32 idx, bool mono, core::array<u8>& coverage)
+{
+	FT_Set_Pixel_Sizes(*face,0,size);
+	if (mono){
+		if (FT_Load_Glyph(*face,idx,FT_LOAD_NO_HINTING|FT_LOAD_RENDER|FT_LOAD_MONOCHROME))
+			return false;
+	} else {
+		if (FT_Load_Glyph(*face,idx,FT_LOAD_NO_HINTING|FT_LOAD_NO_BITMAP))
+			return false;
+		if ((*face)->glyph->format != ft_glyph_format_outline)
+			return false;
+		if (FT_Render_Glyph((*face)->glyph,FT_RENDER_MODE_NORMAL))
+			return false;
+	}
+
+	FT_GlyphSlot glyph = (*face)->glyph;
+	FT_Bitmap bits = glyph->bitmap;
+	coverage.set_used(bits.width * bits.rows);
+	for (int y = 0;y < bits.rows;y++){
+		const u8 *pt = bits.buffer + y * bits.pitch;
+		u8 *rowp = coverage.pointer() + y * bits.width;
+		for (int x = 0;x < bits.width;x++){
+			if (mono){
+				rowp[x] = (pt[x / 8] & (0x80 >> (x % 8))) ? 0xff : 0;
+			} else {
+				rowp[x] = pt[x];
 			}
 		}
 	}
-	if (!FT_Load_Glyph(*face,idx,FT_LOAD_NO_HINTING|FT_LOAD_RENDER|FT_LOAD_MONOCHROME)){
-		FT_GlyphSlot glyph = (*face)->glyph;
-		FT_Bitmap bits = glyph->bitmap;
-		u8 *pt = bits.buffer;
+
+	if (mono){
 		top16 = glyph->bitmap_top;
 		left16 = glyph->bitmap_left;
-		imgw16 = 1;
-		imgh16 = 1;
 		texw16 = bits.width;
 		texh16 = bits.rows;
-		for(;;){
-			if (imgw16 >= texw16){
-				break;
-			} else {
-				imgw16 <<= 1;
-			}
-		}
-		for(;;){
-			if (imgh16 >= texh16){
-				break;
-			} else {
-				imgh16 <<= 1;
-			}
-		}
-		if (imgw16 > imgh16){
-			imgh16 = imgw16;
-		} else {
-			imgw16 = imgh16;
-		}
-		u16 *texd16 = new u16[imgw16*imgh16];
-		memset(texd16,0,imgw16*imgh16*sizeof(u16));
-		u16 *texp16 = texd16;
-		offset = size - bits.rows;
-		for (int y = 0;y < bits.rows;y++){
-			u16 *rowp = texp16;
-			for (int x = 0;x < bits.width;x++){
-				if (pt[y * bits.pitch + (x / 8)] & (0x80 >> (x % 8))){
-					*rowp = 0xffff;
-				}
-				rowp++;
-			}
-			texp16 += imgw16;
-		}
-		c8 name[128];
-		sprintf(name,"TTFontGlyph%d_16",idx);
-		video::IImage *img = Driver->createImageFromData(video::ECF_A1R5G5B5,core::dimension2d<s32>(imgw16,imgh16),texd16);
-		bool flg16 = Driver->getTextureCreationFlag(video::ETCF_ALWAYS_16_BIT);
-		bool flg32 = Driver->getTextureCreationFlag(video::ETCF_ALWAYS_32_BIT);
-		bool flgmip = Driver->getTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS);
-		Driver->setTextureCreationFlag(video::ETCF_ALWAYS_16_BIT,true);
-		Driver->setTextureCreationFlag(video::ETCF_ALWAYS_32_BIT,false);
-		Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS,false);
-		tex16 = Driver->addTexture(name,img);
-		img->drop();
-		Driver->makeColorKeyTexture(tex16,video::SColor(0,0,0,0));
-		Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS,flgmip);
-		Driver->setTextureCreationFlag(video::ETCF_ALWAYS_32_BIT,flg32);
-		Driver->setTextureCreationFlag(video::ETCF_ALWAYS_16_BIT,flg16);
-		delete texd16;
+	} else {
+		top = glyph->bitmap_top;
+		left = glyph->bitmap_left;
+		texw = bits.width;
+		texh = bits.rows;
+	}
+	offset = size - bits.rows;
+	return true;
+}
+
+bool CGUITTGlyph::upload(u32 idx, bool mono, CGUITTGlyphAtlas* atlas)
+{
+	core::array<u8> coverage;
+	if (!rasterize(idx,mono,coverage))
+		return false;
+
+	s32 &cell = mono ? slot16 : slot;
+	cell = atlas->allocate(mono,&cell);
+	if (cell < 0)
+		return false;
+
+	if (mono){
+		atlas->upload(cell,coverage.const_pointer(),texw16,texh16,texw16);
+	} else {
+		atlas->upload(cell,coverage.const_pointer(),texw,texh,texw);
 	}
+	return true;
+}
+
+void CGUITTGlyph::cacheImage(u32 idx)
+{
+	core::array<u8> coverage;
+	if (!rasterize(idx,false,coverage))
+		return;
+
+	if (image) delete [] image;
+	image = new u8[coverage.size() ? coverage.size() : 1];
+	memcpy(image,coverage.const_pointer(),coverage.size());
 }
 
 //! constructor
 CGUITTFont::CGUITTFont(video::IVideoDriver* driver)
 // >> Modified for Ver.1.3 begin
-: Driver(driver), GlobalKerningWidth(0), GlobalKerningHeight(0)
+: Driver(driver), Atlas(0), GlobalKerningWidth(0), GlobalKerningHeight(0)
 //: Driver(driver)
 // << Modified for Ver.1.3 begin
 {
@@ -213,6 +431,7 @@ CGUITTFont::~CGUITTFont()
 //		if (Glyphs[i].cached){
 //		}
 //	}
+	if (Atlas)	delete Atlas;
 	if (attached)	tt_face->drop();
 	attached = false;
 	if (Driver)	Driver->drop();
@@ -293,6 +512,16 @@ bool CGUITTFont::attach(CGUITTFace *Face,u32 size)
 
 	this->size = size;
 
+	// one atlas cell holds the largest glyph of the face
+	if (Atlas)	delete Atlas;
+	FT_Set_Pixel_Sizes(tt_face->face,0,size);
+	const FT_Size_Metrics &metrics = tt_face->face->size->metrics;
+	u32 cellw = (metrics.max_advance + 63) >> 6;
+	u32 cellh = (metrics.ascender - metrics.descender + 63) >> 6;
+	cellw = core::s32_clamp(cellw,size,size * 2) + 1;
+	cellh = core::s32_clamp(cellh,size,size * 2) + 1;
+	Atlas = new CGUITTGlyphAtlas(Driver,cellw,cellh);
+
 // >> add solehome's code for memory access error begin
 	CGUITTGlyph tmp;  // for access the __vfptr of CGUITTGlyph
 	int*tmp2;
@@ -440,65 +669,87 @@ void CGUITTFont::draw(const wchar_t* text, const core::rect<s32>& position, vide
 			offset.Y = ((position.getHeight() - textDimension.Height)>>1) + offset.Y;
 	}
 
+	if (!TransParency)	color.color |= 0xff000000;
+
+	const bool software = AntiAlias && (Driver->getDriverType() == video::EDT_SOFTWARE);
+	const bool mono = !AntiAlias;
+	Atlas->beginBatch();
+
 	u32 n;
 
 	while(*text)
 	{
 		n = getGlyphByChar(*text);
-		if ( n > 0){
-			if (AntiAlias){
-				s32 imgw = Glyphs[n-1].imgw;
-				s32 imgh = Glyphs[n-1].imgh;
-				s32 texw = Glyphs[n-1].texw;
-				s32 texh = Glyphs[n-1].texh;
-				s32 offx = Glyphs[n-1].left;
-				s32 offy = Glyphs[n-1].size - Glyphs[n-1].top;
-				if (Driver->getDriverType() != video::EDT_SOFTWARE){
-					if (!TransParency)	color.color |= 0xff000000;
-					Driver->draw2DImage(Glyphs[n-1].tex,core::position2d<s32>(offset.X+offx,offset.Y+offy),core::rect<s32>(0,0,imgw-1,imgh-1),clip,color,true);
-				} else {
-					s32 a = color.getAlpha();
-					s32 r = color.getRed();
-					s32 g = color.getGreen();
-					s32 b = color.getBlue();
-					u8 *pt = Glyphs[n-1].image;
-					if (!TransParency)	a = 255;
-					for (int y = 0;y < texh;y++){
-						for (int x = 0;x < texw;x++){
-							if (!clip || clip->isPointInside(core::position2d<s32>(offset.X+x+offx,offset.Y+y+offy))){
-								if (*pt){
-									Driver->draw2DRectangle(video::SColor((a * *pt)/255,r,g,b),core::rect<s32>(offset.X+x+offx,offset.Y+y+offy,offset.X+x+offx+1,offset.Y+y+offy+1));
-								}
-								pt++;
-							}
+		if ( n > 0 && Glyphs[n-1].texw && Glyphs[n-1].texh){
+			CGUITTGlyph &glyph = Glyphs[n-1];
+			if (software){
+				if (!glyph.image)	glyph.cacheImage(n);
+				s32 a = color.getAlpha();
+				s32 r = color.getRed();
+				s32 g = color.getGreen();
+				s32 b = color.getBlue();
+				s32 texw = glyph.texw;
+				s32 texh = glyph.texh;
+				s32 offx = glyph.left;
+				s32 offy = glyph.size - glyph.top;
+				u8 *pt = glyph.image;
+				for (int y = 0;pt && y < texh;y++){
+					for (int x = 0;x < texw;x++,pt++){
+						if (*pt && (!clip || clip->isPointInside(core::position2d<s32>(offset.X+x+offx,offset.Y+y+offy)))){
+							Driver->draw2DRectangle(video::SColor((a * *pt)/255,r,g,b),core::rect<s32>(offset.X+x+offx,offset.Y+y+offy,offset.X+x+offx+1,offset.Y+y+offy+1));
 						}
 					}
 				}
 			} else {
-				s32 imgw = Glyphs[n-1].imgw16;
-				s32 imgh = Glyphs[n-1].imgh16;
-				s32 texw = Glyphs[n-1].texw16;
-				s32 texh = Glyphs[n-1].texh16;
-				s32 offx = Glyphs[n-1].left16;
-				s32 offy = Glyphs[n-1].size - Glyphs[n-1].top16;
-				if (!TransParency){
-					color.color |= 0xff000000;
+				s32 cell = mono ? glyph.slot16 : glyph.slot;
+				if (cell < 0 && !glyph.upload(n,mono,Atlas)){
+					// every cell holds a glyph of this batch, draw them to make room
+					flushBatch(color,clip);
+					Atlas->beginBatch();
+					glyph.upload(n,mono,Atlas);
+				}
+				cell = mono ? glyph.slot16 : glyph.slot;
+				if (cell >= 0){
+					Atlas->touch(cell);
+					s32 offx = mono ? glyph.left16 : glyph.left;
+					s32 offy = glyph.size - (mono ? glyph.top16 : glyph.top);
+					BatchPages.push_back(Atlas->getPageOfCell(cell));
+					BatchPositions.push_back(core::position2d<s32>(offset.X+offx,offset.Y+offy));
+					BatchRects.push_back(Atlas->getCellRect(cell));
 				}
-				Driver->draw2DImage(Glyphs[n-1].tex16,core::position2d<s32>(offset.X+offx,offset.Y+offy),core::rect<s32>(0,0,imgw-1,imgh-1),clip,color,true);
 			}
+		}
 // >> Modified for Ver.1.3 begin
-			offset.X += getWidthFromCharacter(*text) + GlobalKerningWidth;
-//			offset.X += getWidthFromCharacter(*text);
-// << Modified for Ver.1.3 end
-		} else {
-// >> Modified for Ver.1.3 begin
-			offset.X += getWidthFromCharacter(*text) + GlobalKerningWidth;
-//			offset.X += getWidthFromCharacter(*text);
+		offset.X += getWidthFromCharacter(*text) + GlobalKerningWidth;
+//		offset.X += getWidthFromCharacter(*text);
 // << Modified for Ver.1.3 end
-		}
 
 		++text;
 	}
+
+	flushBatch(color,clip);
+}
+
+void CGUITTFont::flushBatch(video::SColor color, const core::rect<s32>* clip)
+{
+	Atlas->commit();
+
+	for (u32 page = 0;page < Atlas->getMaxPageCount() && BatchPages.size();page++){
+		PagePositions.set_used(0);
+		PageRects.set_used(0);
+		for (u32 i = 0;i < BatchPages.size();i++){
+			if (BatchPages[i] == page){
+				PagePositions.push_back(BatchPositions[i]);
+				PageRects.push_back(BatchRects[i]);
+			}
+		}
+		if (PagePositions.size())
+			Driver->draw2DImageBatch(Atlas->getPageTexture(page),PagePositions,PageRects,clip,color,true);
+	}
+
+	BatchPages.set_used(0);
+	BatchPositions.set_used(0);
+	BatchRects.set_used(0);
 }
 
 //! Calculates the index of the character in the text which is on a specific position.
@@ -548,57 +799,78 @@ s32 CGUITTFont::getKerningHeight () const
 
 scene::ISceneNode *CGUITTFont::createBillboard(const wchar_t* text, core::dimension2d<f32> size, scene::ISceneManager *scene,scene::ISceneNode *parent,s32 id){
 
-	scene::ISceneNode *node = scene->addEmptySceneNode(parent,id);
+	if (!parent)	parent = scene->getRootSceneNode();
 
-	core::dimension2d<s32> textDimension;
-	textDimension = getDimension(text);
-	
-	float scalex = size.Width / textDimension.Width;
-	float scaley = size.Height / textDimension.Height;
-	
-	core::vector3df offset = core::vector3df(0.0f,0.0f,0.0f);
+	scene::ISceneNode *node = new CGUITTBillboardSceneNode(parent,scene,id,this,text,
+		core::vector3df(0.0f,0.0f,0.0f),size,video::SColor(0xffffffff),video::SColor(0xffffffff));
+	node->drop();
 
-	offset.X = 0 - (f32)(textDimension.Width >> 1);
-	offset.Y = 0 - (f32)(textDimension.Height >>1);
+	return	node;
+}
 
-	u32 n;
-	while(*text)
-	{
-		n = getGlyphByChar(*text);
+video::IImage* CGUITTFont::createTextImage(const wchar_t* text, core::position2d<s32>& origin)
+{
+	const bool mono = !AntiAlias;
+
+	// the glyphs may reach out of the text box
+	const core::dimension2d<s32> textDimension = getDimension(text);
+	s32 minx = 0, miny = 0;
+	s32 maxx = textDimension.Width, maxy = textDimension.Height;
+	s32 x = 0;
+	for (const wchar_t* p = text;*p;++p){
+		u32 n = getGlyphByChar(*p);
 		if (n){
-			s32 imgw,imgh,texw,texh,offx,offy;
-			video::ITexture *tex;
-			if (AntiAlias){
-				imgw = Glyphs[n-1].imgw;
-				imgh = Glyphs[n-1].imgh;
-				texw = Glyphs[n-1].texw;
-				texh = Glyphs[n-1].texh;
-				offx = Glyphs[n-1].left;
-				offy = Glyphs[n-1].size - Glyphs[n-1].top;
-				tex = Glyphs[n-1].tex;
-			} else {
-				imgw = Glyphs[n-1].imgw16;
-				imgh = Glyphs[n-1].imgh16;
-				texw = Glyphs[n-1].texw16;
-				texh = Glyphs[n-1].texh16;
-				offx = Glyphs[n-1].left16;
-				offy = Glyphs[n-1].size - Glyphs[n-1].top16;
-				tex = Glyphs[n-1].tex16;
+			const CGUITTGlyph &glyph = Glyphs[n-1];
+			const s32 offx = x + glyph.left;
+			const s32 offy = glyph.size - glyph.top;
+			minx = core::min_(minx,offx);
+			miny = core::min_(miny,offy);
+			maxx = core::max_(maxx,offx + (s32)glyph.texw + 1);
+			maxy = core::max_(maxy,offy + (s32)glyph.texh + 1);
+		}
+		x += getWidthFromCharacter(*p) + GlobalKerningWidth;
+	}
+	if (maxx <= minx || maxy <= miny)
+		return 0;
+
+	const s32 w = maxx - minx;
+	const s32 h = maxy - miny;
+	u32 *texd = new u32[w*h];
+	memset(texd,0,w*h*sizeof(u32));
+
+	core::array<u8> coverage;
+	x = -minx;
+	for (const wchar_t* p = text;*p;++p){
+		u32 n = getGlyphByChar(*p);
+		if (n && Glyphs[n-1].texw && Glyphs[n-1].rasterize(n,mono,coverage)){
+			const CGUITTGlyph &glyph = Glyphs[n-1];
+			const s32 gw = mono ? glyph.texw16 : glyph.texw;
+			const s32 gh = mono ? glyph.texh16 : glyph.texh;
+			const s32 offx = x + (mono ? glyph.left16 : glyph.left);
+			const s32 offy = glyph.size - (mono ? glyph.top16 : glyph.top) - miny;
+			for (s32 gy = 0;gy < gh;gy++){
+				if (offy + gy < 0 || offy + gy >= h)
+					continue;
+				for (s32 gx = 0;gx < gw;gx++){
+					if (offx + gx < 0 || offx + gx >= w)
+						continue;
+					u32 &texel = texd[(offy + gy) * w + offx + gx];
+					const u32 c = core::max_(texel >> 24,(u32)coverage[gy * gw + gx]);
+					texel = c ? (c << 24) | 0xffffff : 0;
+				}
 			}
-			
-//			scene::IAxialBillboardSceneNode *bill = scene->addAxialBillboardSceneNode(node,core::vector3df(1,1,1),imgw,core::vector3df(offset.X,offset.Y-offy,0),id);
-			scene::IBillboardSceneNode *bill = scene->addBillboardSceneNode(node,core::dimension2d<f32>(imgw*scalex,imgh*scaley),core::vector3df(offset.X*scalex,offset.Y*scaley-offy*scaley,0),id);
-			//bill->setScale(core::vector3df(0.1f,0.1f,0.1f));
-			bill->setMaterialTexture(0,tex);
-			bill->setMaterialType(video::EMT_TRANSPARENT_ALPHA_CHANNEL);
-			bill->setVisible(true);
 		}
-		offset.X += getWidthFromCharacter(*text);
-		++text;
+		x += getWidthFromCharacter(*p) + GlobalKerningWidth;
 	}
 
-	return	node;
+	video::IImage *img = Driver->createImageFromData(video::ECF_A8R8G8B8,core::dimension2d<s32>(w,h),texd);
+	delete [] texd;
+
+	origin.X = -minx;
+	origin.Y = -miny;
+	return img;
 }
+
 #if	0
 
 #endif
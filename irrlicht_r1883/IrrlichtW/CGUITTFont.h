@@ -43,6 +43,84 @@ public:
 #endif
 };
 
+//! Texture pages shared by the glyphs of a font.
+/** Each page is a grid of equally sized cells holding one glyph each, so
+all glyphs of a string mostly come from one texture. When all pages are
+full the glyph which was drawn longest ago is evicted. */
+class CGUITTGlyphAtlas
+{
+public:
+	CGUITTGlyphAtlas(video::IVideoDriver* driver, u32 cellWidth, u32 cellHeight, u32 maxPages=4);
+	~CGUITTGlyphAtlas();
+
+	//! starts a new batch, only cells not drawn in the current batch can be evicted
+	void beginBatch();
+
+	//! reserves a cell for a glyph, -1 if every cell is used by the current batch
+	/** *owner is set to -1 when the cell is evicted later on. */
+	s32 allocate(bool mono, s32* owner);
+
+	//! copies a 8 bit coverage bitmap into a cell
+	void upload(s32 cell, const u8* coverage, u32 width, u32 height, u32 pitch);
+
+	//! marks a cell as drawn in the current batch
+	void touch(s32 cell);
+
+	//! sends all changed pages to the driver
+	void commit();
+
+	//! evicts all glyphs and frees the pages
+	void clear();
+
+	u32 getMaxPageCount() const { return Pages.size(); }
+	u32 getPageOfCell(s32 cell) const { return cell / CellsPerPage; }
+	video::ITexture* getPageTexture(u32 page) const { return Pages[page].Texture; }
+
+	//! returns the part of the page covered by the glyph uploaded into a cell
+	core::rect<s32> getCellRect(s32 cell) const;
+
+private:
+	struct SPage
+	{
+		video::ITexture* Texture;
+		bool Mono;
+		u8* Locked;
+		u32 Pitch;
+		s32 FreeCell;
+		u32 LastStamp;
+	};
+
+	void createPage(u32 page, bool mono);
+	void releasePage(u32 page);
+	void evict(s32 cell);
+	void link(s32 cell);
+	void unlink(s32 cell);
+
+	video::IVideoDriver* Driver;
+	core::array<SPage> Pages;
+
+	//! per cell, Next is also the free list of a page
+	core::array<s32*> Owner;
+	core::array<u32> Stamp;
+	core::array<s32> Prev;
+	core::array<s32> Next;
+
+	//! glyph size as uploaded, clamped to the cell
+	core::array<core::dimension2d<s32> > GlyphSize;
+
+	//! most and least recently drawn cell
+	s32 Head;
+	s32 Tail;
+	u32 CurrentStamp;
+
+	u32 PageSize;
+	u32 CellWidth;
+	u32 CellHeight;
+	u32 CellsX;
+	u32 CellsPerPage;
+	bool WhiteIsCoverage;
+};
+
 #ifdef VIREFERENCECOUNTED
 class CGUITTGlyph : public /* virtual */ IReferenceCounted // intentionally not virtual because these objects are not C++ constructed but are byte-wise memory-initialized
 #else
@@ -57,26 +135,30 @@ public:
 // >> Add solehome's code for memory access error begin
 	void init();
 // << Add solehome's code for memory access error end
+	//! loads the metrics of the glyph, nothing is rendered
 	void cache(u32 idx);
+	//! renders the glyph variant for a render mode into an atlas cell
+	bool upload(u32 idx, bool mono, CGUITTGlyphAtlas* atlas);
+	//! renders the anti aliased coverage into image
+	void cacheImage(u32 idx);
+	//! renders the glyph to 8 bit coverage, monochrome glyphs are 0 or 255
+	bool rasterize(u32 idx, bool mono, core::array<u8>& coverage);
 #ifdef VIREFERENCECOUNTED
 	virtual void dummy() {return;}
 #endif
 	FT_Face *face;
 	u32 size;
-	u32 top;
-	u32 left;
+	s32 top;
+	s32 left;
 	u32 texw;
 	u32 texh;
-	u32 imgw;
-	u32 imgh;
-	video::ITexture *tex;
-	u32 top16;
-	u32 left16;
+	s32 top16;
+	s32 left16;
 	u32 texw16;
 	u32 texh16;
-	u32 imgw16;
-	u32 imgh16;
-	video::ITexture *tex16;
+	//! atlas cells, -1 if not in the atlas
+	s32 slot;
+	s32 slot16;
 	s32 offset;
 	u8 *image;
 };
@@ -115,15 +197,29 @@ public:
 
 	scene::ISceneNode *createBillboard(const wchar_t* text, core::dimension2d<f32> size, scene::ISceneManager *scene,scene::ISceneNode *parent,s32 id);
 
+	//! renders a whole string into a white image with the coverage in the alpha channel
+	/** \param origin is set to the position of the upper left corner of the text in the image
+	\return 0 for empty strings */
+	video::IImage* createTextImage(const wchar_t* text, core::position2d<s32>& origin);
+
 	bool AntiAlias;
 	bool TransParency;
 	bool attached;
 private:
 	s32 getWidthFromCharacter(wchar_t c) const;
 	u32 getGlyphByChar(wchar_t c);
+	//! draws the queued glyphs, one call per atlas page
+	void flushBatch(video::SColor color, const core::rect<s32>* clip);
 	video::IVideoDriver* Driver;
 	core::array< CGUITTGlyph > Glyphs;
 	CGUITTFace *tt_face;
+	CGUITTGlyphAtlas *Atlas;
+	//! glyphs queued by draw()
+	core::array<u32> BatchPages;
+	core::array< core::position2d<s32> > BatchPositions;
+	core::array< core::rect<s32> > BatchRects;
+	core::array< core::position2d<s32> > PagePositions;
+	core::array< core::rect<s32> > PageRects;
 // >> Add for Ver.1.3 begin
 	s32 GlobalKerningWidth, GlobalKerningHeight;
 // << Add for Ver.1.3 end
@@ -62,6 +62,17 @@ IntPtr CreateDeviceA(E_DRIVER_TYPE type, M_DIM2DS dim, int bits, bool full, bool
     return createDeviceEx(params);
 }
 
+IntPtr CreateOffscreenDevice(E_DRIVER_TYPE type, M_DIM2DS dim, bool alpha)
+{
+    SIrrlichtCreationParameters params;
+    params.DeviceType = EIDT_OFFSCREEN;
+    params.WindowSize = MU_DIM2DS(dim);
+    params.DriverType = type;
+    params.WithAlphaChannel = alpha;
+    params.EventReceiver = new EventReceiver();
+    return createDeviceEx(params);
+}
+
 void Device_SetWindowCaption(IntPtr device, M_STRING caption)
 {
     GetDeviceFromIntPtr(device)->setWindowCaption(MU_WCHAR(caption));
@@ -127,6 +138,11 @@ bool Device_IsWindowActive(IntPtr device)
     _FIX_BOOL_MARSHAL_BUG(GetDeviceFromIntPtr(device)->isWindowActive());
 }
 
+IntPtr Device_GetFrameImage(IntPtr device)
+{
+    return GetDeviceFromIntPtr(device)->getFrameImage();
+}
+
 void Device_SetResizeable(IntPtr device, bool resizeable)
 {
      GetDeviceFromIntPtr(device)->setResizeAble(resizeable);
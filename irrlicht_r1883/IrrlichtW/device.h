@@ -6,6 +6,7 @@ extern "C"
  
     EXPORT IntPtr CreateDevice(E_DRIVER_TYPE type, M_DIM2DS dim, int bits, bool full, bool stencil, bool vsync, bool antialias);
     EXPORT IntPtr CreateDeviceA(E_DRIVER_TYPE type, M_DIM2DS dim, int bits, bool full, bool stencil, bool vsync, bool antialias, IntPtr handle);
+    EXPORT IntPtr CreateOffscreenDevice(E_DRIVER_TYPE type, M_DIM2DS dim, bool alpha);
     EXPORT void Device_SetWindowCaption(IntPtr device, M_STRING caption);
     EXPORT IntPtr Device_GetSceneManager(IntPtr device);
     EXPORT IntPtr Device_GetVideoDriver(IntPtr device);
@@ -20,6 +21,7 @@ extern "C"
     EXPORT IntPtr Device_GetLogger(IntPtr device);
     EXPORT M_STRING Device_GetVersion(IntPtr device);
     EXPORT bool Device_IsWindowActive(IntPtr device);
+    EXPORT IntPtr Device_GetFrameImage(IntPtr device);
     EXPORT void Device_SetResizeable(IntPtr device, bool resizeable);
     EXPORT void Device_SetCallback(IntPtr device, EVENTCALLBACK);
 
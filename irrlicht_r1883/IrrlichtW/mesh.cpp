@@ -90,6 +90,94 @@ IMeshBuffer* GetMBForIntPtr(IntPtr mb)
 	return ((IMeshBuffer*)mb);
 }
 
+/*
+ * Bulk vertex/index helpers. The buffer's arrays are resized once and the
+ * caller's contiguous block is copied in a single pass, so a whole buffer
+ * crosses the managed boundary in one call.
+ */
+
+template <class T>
+static void MeshBuffer_CopyIn(core::array<T>& arr, u32 first, const void* src, int count)
+{
+	// counts come from the managed side, negative ones are rejected
+	if (count <= 0)
+	{
+		if (!count)
+			arr.set_used(first);
+		return;
+	}
+
+	arr.set_used(first + count);
+	memcpy(static_cast<void*>(arr.pointer() + first), src, count * sizeof(T));
+}
+
+// Sets a single element, growing the array by doubling when the index is
+// past its end, so that a buffer filled one vertex at a time stays linear.
+template <class T>
+static void MeshBuffer_SetElement(core::array<T>& arr, u32 nr, const T& element)
+{
+	if (nr == arr.size())
+	{
+		arr.push_back(element);
+		return;
+	}
+
+	if (nr > arr.size())
+	{
+		if (nr >= arr.allocated_size())
+			arr.reallocate(core::max_(nr + 1, arr.allocated_size() * 2 + 1));
+		arr.set_used(nr + 1);
+	}
+	arr[nr] = element;
+}
+
+static u32 MeshBuffer_GetVertexPitch(IntPtr meshb)
+{
+	switch(MeshBuffer_GetVertexType(meshb))
+	{
+		case EVT_2TCOORDS:
+			return sizeof(S3DVertex2TCoords);
+		case EVT_TANGENTS:
+			return sizeof(S3DVertexTangents);
+		default:
+			return sizeof(S3DVertex);
+	}
+}
+
+static void MeshBuffer_CopyVertices(IntPtr meshb, u32 first, const void* vertices, int count)
+{
+	switch(MeshBuffer_GetVertexType(meshb))
+	{
+		case EVT_STANDARD:
+			MeshBuffer_CopyIn(((SMeshBuffer*)meshb)->Vertices, first, vertices, count);
+			break;
+		case EVT_2TCOORDS:
+			MeshBuffer_CopyIn(((SMeshBufferLightMap*)meshb)->Vertices, first, vertices, count);
+			break;
+		case EVT_TANGENTS:
+			MeshBuffer_CopyIn(((SMeshBufferTangents*)meshb)->Vertices, first, vertices, count);
+			break;
+	}
+	GetMBForIntPtr(meshb)->setDirty(EBT_VERTEX);
+}
+
+static void MeshBuffer_CopyIndices(IntPtr meshb, u32 first, const unsigned short* indices, int count)
+{
+	switch(MeshBuffer_GetVertexType(meshb))
+	{
+		case EVT_STANDARD:
+			MeshBuffer_CopyIn(((SMeshBuffer*)meshb)->Indices, first, indices, count);
+			break;
+		case EVT_2TCOORDS:
+			MeshBuffer_CopyIn(((SMeshBufferLightMap*)meshb)->Indices, first, indices, count);
+			break;
+		case EVT_TANGENTS:
+			MeshBuffer_CopyIn(((SMeshBufferTangents*)meshb)->Indices, first, indices, count);
+			break;
+	}
+	GetMBForIntPtr(meshb)->setDirty(EBT_INDEX);
+}
+
 IntPtr MeshBuffer_Create(int type)
 {
 	if(type == 0)
@@ -122,25 +210,43 @@ int MeshBuffer_GetIndexCount(IntPtr meshb)
 
 void MeshBuffer_GetIndices(IntPtr meshb, unsigned short* indices)
 {
-	int count = GetMBForIntPtr(meshb)->getIndexCount();
-	for(int i = 0; i < count; i++)
-		indices[i] = GetMBForIntPtr(meshb)->getIndices()[i];
+	IMeshBuffer *mb = GetMBForIntPtr(meshb);
+	memcpy(indices, mb->getIndices(), mb->getIndexCount() * sizeof(u16));
 }
 
+// Copies the caller's indices. The array used to adopt the pointer, which
+// left the buffer freeing memory it did not own.
 void MeshBuffer_SetIndices(IntPtr meshb, unsigned short* indices, int count)
 {
-		switch(MeshBuffer_GetVertexType(meshb))
-		{
-			case EVT_STANDARD:
-				((SMeshBuffer*)meshb)->Indices.set_pointer(indices, count);
-				break;
-			case EVT_2TCOORDS:
-				((SMeshBufferLightMap*)meshb)->Indices.set_pointer(indices, count);
-				break;
-			case EVT_TANGENTS:
-				((SMeshBufferTangents*)meshb)->Indices.set_pointer(indices, count);
-				break;
-		}
+	MeshBuffer_CopyIndices(meshb, 0, indices, count);
+}
+
+void MeshBuffer_AppendIndices(IntPtr meshb, unsigned short* indices, int count)
+{
+	MeshBuffer_CopyIndices(meshb, GetMBForIntPtr(meshb)->getIndexCount(), indices, count);
+}
+
+// Resizes the index array and returns its storage so the caller can fill
+// it in place, without an intermediate copy.
+unsigned short* MeshBuffer_MapIndices(IntPtr meshb, int count)
+{
+	if (count < 0)
+		return 0;
+
+	switch(MeshBuffer_GetVertexType(meshb))
+	{
+		case EVT_STANDARD:
+			((SMeshBuffer*)meshb)->Indices.set_used(count);
+			break;
+		case EVT_2TCOORDS:
+			((SMeshBufferLightMap*)meshb)->Indices.set_used(count);
+			break;
+		case EVT_TANGENTS:
+			((SMeshBufferTangents*)meshb)->Indices.set_used(count);
+			break;
+	}
+	GetMBForIntPtr(meshb)->setDirty(EBT_INDEX);
+	return GetMBForIntPtr(meshb)->getIndices();
 }
 
 unsigned short MeshBuffer_GetIndex(IntPtr meshb, unsigned int nr)
@@ -199,14 +305,52 @@ IntPtr MeshBuffer_GetVertex(IntPtr meshb, unsigned int nr)
 
 void MeshBuffer_SetVertex(IntPtr meshb, unsigned int nr, IntPtr vert)
 {
-	SMeshBuffer *mb = ((SMeshBuffer*)meshb);
-	if(nr >= mb->getVertexCount())
+	MeshBuffer_SetElement(((SMeshBuffer*)meshb)->Vertices, nr, *((S3DVertex*)vert));
+}
+
+void MeshBuffer_GetVertices(IntPtr meshb, IntPtr vertices)
+{
+	IMeshBuffer *mb = GetMBForIntPtr(meshb);
+	memcpy(vertices, mb->getVertices(), mb->getVertexCount() * MeshBuffer_GetVertexPitch(meshb));
+}
+
+void MeshBuffer_SetVertices(IntPtr meshb, IntPtr vertices, int count)
+{
+	MeshBuffer_CopyVertices(meshb, 0, vertices, count);
+}
+
+void MeshBuffer_AppendVertices(IntPtr meshb, IntPtr vertices, int count)
+{
+	MeshBuffer_CopyVertices(meshb, GetMBForIntPtr(meshb)->getVertexCount(), vertices, count);
+}
+
+// Same as MeshBuffer_MapIndices for the vertex array.
+IntPtr MeshBuffer_MapVertices(IntPtr meshb, int count)
+{
+	if (count < 0)
+		return 0;
+
+	switch(MeshBuffer_GetVertexType(meshb))
 	{
-		mb->Vertices.push_back(*((S3DVertex*)vert));
-		MeshBuffer_SetVertex(meshb, nr, vert);
+		case EVT_STANDARD:
+			((SMeshBuffer*)meshb)->Vertices.set_used(count);
+			break;
+		case EVT_2TCOORDS:
+			((SMeshBufferLightMap*)meshb)->Vertices.set_used(count);
+			break;
+		case EVT_TANGENTS:
+			((SMeshBufferTangents*)meshb)->Vertices.set_used(count);
+			break;
 	}
-	else
-		(((S3DVertex*)(mb->getVertices()))[nr]) = *((S3DVertex*)vert);
+	GetMBForIntPtr(meshb)->setDirty(EBT_VERTEX);
+	return GetMBForIntPtr(meshb)->getVertices();
+}
+
+void MeshBuffer_SetBuffers(IntPtr meshb, IntPtr vertices, int vertexCount, unsigned short* indices, int indexCount)
+{
+	MeshBuffer_CopyVertices(meshb, 0, vertices, vertexCount);
+	MeshBuffer_CopyIndices(meshb, 0, indices, indexCount);
+	GetMBForIntPtr(meshb)->recalculateBoundingBox();
 }
 void MeshBuffer_SetColor(IntPtr meshb, M_SCOLOR color)
 {
@@ -230,14 +374,7 @@ IntPtr MeshBuffer_GetVertex2T(IntPtr meshb, unsigned int nr)
 
 void MeshBuffer_SetVertex2T(IntPtr meshb, unsigned int nr, IntPtr vert)
 {
-	SMeshBufferLightMap *mb = ((SMeshBufferLightMap*)meshb);
-	if(nr >= mb->getVertexCount())
-	{
-		mb->Vertices.push_back(*((S3DVertex2TCoords*)vert));
-		MeshBuffer_SetVertex2T(meshb, nr, vert);
-	}
-	else
-		(((S3DVertex2TCoords*)(mb->getVertices()))[nr]) = *((S3DVertex2TCoords*)vert);
+	MeshBuffer_SetElement(((SMeshBufferLightMap*)meshb)->Vertices, nr, *((S3DVertex2TCoords*)vert));
 }
 
 /*
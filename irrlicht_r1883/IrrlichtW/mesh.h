@@ -26,6 +26,8 @@ extern "C"
 	EXPORT int MeshBuffer_GetIndexCount(IntPtr meshb);
 	EXPORT void MeshBuffer_GetIndices(IntPtr meshb, unsigned short* indices);
 	EXPORT void MeshBuffer_SetIndices(IntPtr meshb, unsigned short* indices, int count);
+	EXPORT void MeshBuffer_AppendIndices(IntPtr meshb, unsigned short* indices, int count);
+	EXPORT unsigned short* MeshBuffer_MapIndices(IntPtr meshb, int count);
 	EXPORT unsigned short MeshBuffer_GetIndex(IntPtr meshb, unsigned int nr);
 	EXPORT void MeshBuffer_SetIndex(IntPtr meshb, unsigned int nr, unsigned short val);
 	EXPORT IntPtr MeshBuffer_GetMaterial(IntPtr meshb);
@@ -34,6 +36,12 @@ extern "C"
 	EXPORT E_VERTEX_TYPE MeshBuffer_GetVertexType(IntPtr meshb);
 	EXPORT IntPtr MeshBuffer_GetVertex(IntPtr meshb, unsigned int nr);
 	EXPORT void MeshBuffer_SetVertex(IntPtr meshb, unsigned int nr, IntPtr vert);
+	// Bulk access: vertices is a contiguous block of the buffer's vertex type
+	EXPORT void MeshBuffer_GetVertices(IntPtr meshb, IntPtr vertices);
+	EXPORT void MeshBuffer_SetVertices(IntPtr meshb, IntPtr vertices, int count);
+	EXPORT void MeshBuffer_AppendVertices(IntPtr meshb, IntPtr vertices, int count);
+	EXPORT IntPtr MeshBuffer_MapVertices(IntPtr meshb, int count);
+	EXPORT void MeshBuffer_SetBuffers(IntPtr meshb, IntPtr vertices, int vertexCount, unsigned short* indices, int indexCount);
 	EXPORT IntPtr MeshBuffer_GetVertex2T(IntPtr meshb, unsigned int nr);
 	EXPORT void MeshBuffer_SetVertex2T(IntPtr meshb, unsigned int nr, IntPtr vert);
 	EXPORT void MeshBuffer_SetColor(IntPtr meshb, M_SCOLOR color);
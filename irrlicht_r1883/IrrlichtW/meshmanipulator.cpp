@@ -29,6 +29,21 @@ IntPtr MeshManipulator_CreateMeshUniquePrimitives(IntPtr mm, IntPtr mesh)
     return GetMMForIntPtr(mm)->createMeshUniquePrimitives((IMesh*)mesh);
 }
 
+IntPtr MeshManipulator_CreateMeshWelded(IntPtr mm, IntPtr mesh, float tolerance, unsigned int colorTolerance, unsigned int *weldedCount)
+{
+    return GetMMForIntPtr(mm)->createMeshWelded((IMesh*)mesh, tolerance, colorTolerance, weldedCount);
+}
+
+void MeshManipulator_OptimizeVertexCache(IntPtr mm, IntPtr mesh, bool reorderVertices, bool reduceOverdraw, float *acmrBefore, float *acmrAfter)
+{
+    GetMMForIntPtr(mm)->optimizeVertexCache((IMesh*)mesh, reorderVertices, reduceOverdraw, acmrBefore, acmrAfter);
+}
+
+float MeshManipulator_GetAverageCacheMissRatio(IntPtr mm, IntPtr mesh, unsigned int cacheSize)
+{
+    return GetMMForIntPtr(mm)->getAverageCacheMissRatio((IMesh*)mesh, cacheSize);
+}
+
 void MeshManipulator_MakePlanarTextureMapping(IntPtr mm, IntPtr mesh, float resolution)
 {
     GetMMForIntPtr(mm)->makePlanarTextureMapping((IMesh*)mesh, resolution);
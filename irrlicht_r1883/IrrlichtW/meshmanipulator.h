@@ -4,6 +4,9 @@ extern "C"
 {
 	EXPORT IntPtr MeshManipulator_CreateMeshWithTangents(IntPtr mm, IntPtr mesh);
 	EXPORT IntPtr MeshManipulator_CreateMeshUniquePrimitives(IntPtr mm, IntPtr mesh);
+	EXPORT IntPtr MeshManipulator_CreateMeshWelded(IntPtr mm, IntPtr mesh, float tolerance, unsigned int colorTolerance, unsigned int *weldedCount);
+	EXPORT void MeshManipulator_OptimizeVertexCache(IntPtr mm, IntPtr mesh, bool reorderVertices, bool reduceOverdraw, float *acmrBefore, float *acmrAfter);
+	EXPORT float MeshManipulator_GetAverageCacheMissRatio(IntPtr mm, IntPtr mesh, unsigned int cacheSize);
 	EXPORT void MeshManipulator_MakePlanarTextureMapping(IntPtr mm, IntPtr mesh, float resolution);
 
 	EXPORT void MeshManipulator_FlipSurfaces(IntPtr mm, IntPtr mesh);
@@ -21,11 +21,11 @@ class Affector : public IParticleAffector
 
     void affect(u32 now, SParticle* particlearray, u32 count)
     {
-		IntPtr *intptrarr = new IntPtr[count];
+		// the pointer array is kept between frames
+		_pointers.set_used(count);
 		for(unsigned int i = 0; i < count; i++)
-			intptrarr[i] = &particlearray[i];
-		_callback(now, intptrarr, count);
-		delete[] intptrarr;
+			_pointers[i] = &particlearray[i];
+		_callback(now, _pointers.pointer(), count);
     }
 
 	E_PARTICLE_AFFECTOR_TYPE getType() const
@@ -35,6 +35,28 @@ class Affector : public IParticleAffector
 
     protected:
     AFFECTORCALLBACK _callback;
+	core::array<IntPtr> _pointers;
+};
+
+// hands the whole particle array to the callback in one call
+class BlockAffector : public IParticleAffector
+{
+    public:
+    BlockAffector(AFFECTORBLOCKCALLBACK call) : _callback(call) {}
+
+    void affect(u32 now, SParticle* particlearray, u32 count)
+    {
+		if (count)
+			_callback(now, particlearray, count);
+    }
+
+	E_PARTICLE_AFFECTOR_TYPE getType() const
+	{
+		return EPAT_NONE;
+	}
+
+    protected:
+    AFFECTORBLOCKCALLBACK _callback;
 };
 
 void Particle_AddAffectorA(IntPtr part, AFFECTORCALLBACK affector)
@@ -44,6 +66,13 @@ void Particle_AddAffectorA(IntPtr part, AFFECTORCALLBACK affector)
 	GetPSSFromIntPtr(part)->addAffector(af);
 }
 
+void Particle_AddAffectorBlock(IntPtr part, AFFECTORBLOCKCALLBACK affector)
+{
+	BlockAffector *af = new BlockAffector(affector);
+	GetPSSFromIntPtr(part)->addAffector(af);
+	af->drop();
+}
+
 IntPtr Particle_CreateBoxEmitter(IntPtr part,M_BOX3D box, M_VECT3DF direction, unsigned int minPPS, unsigned int maxPPS, M_SCOLOR minSC, M_SCOLOR maxSC, unsigned int minLT, unsigned int maxLT, int maxAngleDegrees)
 {
 	return GetPSSFromIntPtr(part)->createBoxEmitter(MU_BOX3D(box), MU_VECT3DF(direction), minPPS, maxPPS, MU_SCOLOR(minSC), MU_SCOLOR(maxSC), minLT, maxLT, maxAngleDegrees);
@@ -116,6 +145,13 @@ class Emitter : public IParticleEmitter
             Particles.push_back(*(SParticle*)part[i]);
     }
 
+    void AddParticleBlock(const SParticle *part, int count)
+    {
+        const u32 used = Particles.size();
+        Particles.set_used(used + count);
+        memcpy(static_cast<void*>(Particles.pointer() + used), part, count * sizeof(SParticle));
+    }
+
     virtual void setDirection( const core::vector3df& newDirection )
 	{
         Direction = newDirection ;
@@ -212,6 +248,12 @@ class Emitter : public IParticleEmitter
      ((Emitter*)emitter)->AddParticles(part, count);
  }
 
+void Emitter_AddParticleBlock(IntPtr emitter, IntPtr particles, int count)
+{
+    if (particles && count > 0)
+        ((Emitter*)emitter)->AddParticleBlock((const SParticle*)particles, count);
+}
+
 void Emitter_SetMinStartSize(IntPtr emitter, M_DIM2DF size)
 {
     ((Emitter*)emitter)->setMinStartSize(MU_DIM2DF(size));
@@ -245,6 +287,11 @@ void Particle_SetParticlesAreGlobal(IntPtr part, bool global)
     GetPSSFromIntPtr(part)->setParticlesAreGlobal(global);
 }
 
+void Particle_SetPackedParticles(IntPtr part, bool on)
+{
+    GetPSSFromIntPtr(part)->setPackedParticles(on);
+}
+
 void Particle_SetParticleSize(IntPtr part, M_DIM2DF size)
 {
     GetPSSFromIntPtr(part)->setParticleSize(MU_DIM2DF(size));
@@ -256,6 +303,11 @@ IntPtr SParticle_Create()
 	return new SParticle();
 }
 
+int SParticle_GetSize()
+{
+	return sizeof(SParticle);
+}
+
 void SParticle_GetPos(IntPtr particle, M_VECT3DF vect)
 {
 	SParticle *part = ((SParticle*)particle);
@@ -6,7 +6,22 @@ extern "C"
     
 	typedef void (STDCALL AFFECTORCALLBACK)(unsigned int, IntPtr*, int);
 
+	// Receives the particles of a system as one contiguous block of SParticle.
+	// The block is only valid during the call and is updated in place.
+	// SParticle layout, 68 bytes, 4 byte packing, no padding:
+	//    0 float pos[3]
+	//   12 float vector[3]
+	//   24 uint  startTime
+	//   28 uint  endTime
+	//   32 uint  color (A8R8G8B8)
+	//   36 uint  startColor (A8R8G8B8)
+	//   40 float startVector[3]
+	//   52 float size[2] (width, height)
+	//   60 float startSize[2] (width, height)
+	typedef void (STDCALL AFFECTORBLOCKCALLBACK)(unsigned int now, IntPtr particles, int count);
+
     EXPORT void Emitter_AddParticle(IntPtr emitter, IntPtr *part, int count);
+	EXPORT void Emitter_AddParticleBlock(IntPtr emitter, IntPtr particles, int count);
     EXPORT void Emitter_SetMinStartSize(IntPtr emitter, M_DIM2DF size);
     EXPORT void Emitter_SetMaxStartSize(IntPtr emitter, M_DIM2DF size);
     EXPORT void Emitter_GetMinStartSize(IntPtr emitter, M_DIM2DF size);
@@ -14,6 +29,7 @@ extern "C"
 
     EXPORT void Particle_AddAffector(IntPtr part, IntPtr affector);
     EXPORT void Particle_AddAffectorA(IntPtr part, AFFECTORCALLBACK affector);
+	EXPORT void Particle_AddAffectorBlock(IntPtr part, AFFECTORBLOCKCALLBACK affector);
     EXPORT IntPtr Particle_CreateBoxEmitter(IntPtr part,M_BOX3D box, M_VECT3DF direction, unsigned int minPPS, unsigned int maxPPS, M_SCOLOR minSC, M_SCOLOR maxSC, unsigned int minLT, unsigned int maxLT, int maxAngleDegrees);
     EXPORT IntPtr Particle_CreateFadeOutParticleAffector(IntPtr part, M_SCOLOR tgtColor, unsigned int timeNeeded);
     EXPORT IntPtr Particle_CreateGravityAffector(IntPtr part, M_VECT3DF gravity, unsigned int timeForceLost);
@@ -22,8 +38,10 @@ extern "C"
     EXPORT void Particle_SetEmitter(IntPtr part, IntPtr emitter);
 	EXPORT void Particle_SetEmitterA(IntPtr part, EMITTERCALLBACK callback);
     EXPORT void Particle_SetParticlesAreGlobal(IntPtr part, bool global);
+    EXPORT void Particle_SetPackedParticles(IntPtr part, bool on);
     EXPORT void Particle_SetParticleSize(IntPtr part, M_DIM2DF size);
 	EXPORT IntPtr SParticle_Create();
+	EXPORT int SParticle_GetSize();
 	EXPORT void SParticle_GetPos(IntPtr particle, M_VECT3DF vect);
 	EXPORT void SParticle_SetPos(IntPtr particle, M_VECT3DF vect);
 	EXPORT void SParticle_GetVect(IntPtr particle, M_VECT3DF vect);
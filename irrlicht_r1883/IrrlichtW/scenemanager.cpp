@@ -202,6 +202,11 @@ IntPtr SceneManager_CreateOctTreeTriangleSelector(IntPtr scenemanager, IntPtr me
     return GetSceneFromIntPtr(scenemanager)->createOctTreeTriangleSelector((IMesh*)mesh, (ISceneNode*)node, minimalPolysPerNode);
 }
 
+IntPtr SceneManager_CreateBVHTriangleSelector(IntPtr scenemanager, IntPtr mesh, IntPtr node, int maximalPolysPerLeaf)
+{
+    return GetSceneFromIntPtr(scenemanager)->createBVHTriangleSelector((IMesh*)mesh, (ISceneNode*)node, maximalPolysPerLeaf);
+}
+
 IntPtr SceneManager_CreateRotationAnimator(IntPtr scenemanager, M_VECT3DF rotation)
 {
     return GetSceneFromIntPtr(scenemanager)->createRotationAnimator(MU_VECT3DF(rotation));
@@ -409,3 +414,8 @@ IntPtr SceneManager_GetSceneNodeFromType (IntPtr mgr, IntPtr snode, int type)
 {
 	return (GetSceneFromIntPtr(mgr)->getSceneNodeFromType((ESCENE_NODE_TYPE)type, (ISceneNode*)snode));
 }
+
+void SceneManager_SkinMeshes (IntPtr mgr, IntPtr *meshes, int count)
+{
+	GetSceneFromIntPtr(mgr)->skinMeshes((ISkinnedMesh* const*)meshes, count);
+}
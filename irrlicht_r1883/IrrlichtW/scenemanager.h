@@ -35,6 +35,7 @@ extern "C"
     EXPORT IntPtr SceneManager_CreateFlyStraightAnimator(IntPtr scenemanager, M_VECT3DF startPoint, M_VECT3DF endPoint, unsigned int time, bool loop);
     EXPORT IntPtr SceneManager_CreateMetaTriangleSelector(IntPtr scenemanager);
     EXPORT IntPtr SceneManager_CreateOctTreeTriangleSelector(IntPtr scenemanager, IntPtr mesh, IntPtr node, int minimalPolysPerNode);
+    EXPORT IntPtr SceneManager_CreateBVHTriangleSelector(IntPtr scenemanager, IntPtr mesh, IntPtr node, int maximalPolysPerLeaf);
     EXPORT IntPtr SceneManager_CreateRotationAnimator(IntPtr scenemanager, M_VECT3DF rotation);
 	EXPORT IntPtr SceneManager_CreateFollowSplineAnimator(IntPtr scenemanager, int starttime, float *Xs, float *Ys, float *Zs, int arraysize, float speed, float tightness);
     EXPORT IntPtr SceneManager_CreateTerrainTriangleSelector(IntPtr scenemanager, IntPtr node, int LOD);
@@ -79,5 +80,6 @@ extern "C"
 	EXPORT bool SceneManager_PostEventFromUser (IntPtr mgr, IntPtr event);
 
 	EXPORT IntPtr SceneManager_GetSceneNodeFromType (IntPtr mgr, IntPtr snode, int type);	
+	EXPORT void SceneManager_SkinMeshes (IntPtr mgr, IntPtr *meshes, int count);
 	
 }
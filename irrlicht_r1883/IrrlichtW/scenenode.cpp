@@ -365,6 +365,11 @@ void TerrainSceneNode_GetMeshBufferForLOD(IntPtr terrain, IDynamicMeshBuffer *mb
 	((ITerrainSceneNode*)terrain)->getMeshBufferForLOD((IDynamicMeshBuffer&)*mb, lod);
 }
 
+bool TerrainSceneNode_UpdateHeightMap(IntPtr terrain, float* data, int x, int z, int sizeX, int sizeZ)
+{
+    return ((ITerrainSceneNode*)terrain)->updateHeightMap(data, x, z, sizeX, sizeZ);
+}
+
 void LightSceneNode_GetLight(IntPtr light, M_SCOLORF ambient, 
                              M_SCOLORF diffuse, 
                              M_SCOLORF specular, 
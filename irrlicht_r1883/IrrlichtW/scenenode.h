@@ -74,6 +74,7 @@ extern "C"
     EXPORT void TerrainSceneNode_SetDynamicSelectorUpdate(IntPtr terrain, bool bVal);
     EXPORT void TerrainSceneNode_SetLODOfPatch(IntPtr terrain, int patchX, int patchZ, int LOD);
     EXPORT void TerrainSceneNode_GetMeshBufferForLOD(IntPtr terrain, IMeshBuffer *mb, int lod);
+    EXPORT bool TerrainSceneNode_UpdateHeightMap(IntPtr terrain, float* data, int x, int z, int sizeX, int sizeZ);
 
     EXPORT void LightSceneNode_GetLight(IntPtr light, M_SCOLORF ambient, 
                                         M_SCOLORF diffuse, 
@@ -86,5 +86,10 @@ void SkinnedMesh_SkinMesh(IntPtr mesh)
 	GetMeshFromIntPtr(mesh)->skinMesh();
 }
 
+void SkinnedMesh_SetPackedSkinning(IntPtr mesh, bool on)
+{
+	GetMeshFromIntPtr(mesh)->setPackedSkinning(on);
+}
+
 
 
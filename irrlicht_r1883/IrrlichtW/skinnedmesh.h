@@ -20,4 +20,5 @@ extern "C"
     EXPORT void SkinnedMesh_AnimateMesh(IntPtr mesh, f32 frame, f32 blend);
     EXPORT void SkinnedMesh_ConvertMeshToTangents(IntPtr mesh);
 	EXPORT void SkinnedMesh_SkinMesh(IntPtr mesh);
+	EXPORT void SkinnedMesh_SetPackedSkinning(IntPtr mesh, bool on);
 }
@@ -209,9 +209,9 @@ void VideoDriver_DrawIndexedTriangleFanT(IntPtr videodriver, IntPtr *vertices, i
 
 void VideoDriver_DrawVertexPrimitiveList(IntPtr videodriver, IntPtr *vertices, int vertexCount, unsigned short *indexList, int triangleCount, E_VERTEX_TYPE vType, E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
 {
-	S3DVertex *list;
-	S3DVertex2TCoords *list2;
-	S3DVertexTangents *list3;
+	S3DVertex *list = 0;
+	S3DVertex2TCoords *list2 = 0;
+	S3DVertexTangents *list3 = 0;
 	switch(vType)
 	{
 		default:
@@ -259,6 +259,26 @@ void VideoDriver_DrawVertexPrimitiveList(IntPtr videodriver, IntPtr *vertices, i
 		delete[] list3;
 }
 
+/*
+ * Block draws: vertices points to a contiguous array of vType vertices, which
+ * is handed straight to the driver without a per-draw copy.
+ */
+
+void VideoDriver_DrawIndexedTriangleListBlock(IntPtr videodriver, IntPtr vertices, int vertexCount, unsigned short *indexList, int triangleCount, E_VERTEX_TYPE vType)
+{
+	GetVideoFromIntPtr(videodriver)->drawVertexPrimitiveList(vertices, vertexCount, indexList, triangleCount, vType, EPT_TRIANGLES, EIT_16BIT);
+}
+
+void VideoDriver_DrawIndexedTriangleFanBlock(IntPtr videodriver, IntPtr vertices, int vertexCount, unsigned short *indexList, int triangleCount, E_VERTEX_TYPE vType)
+{
+	GetVideoFromIntPtr(videodriver)->drawVertexPrimitiveList(vertices, vertexCount, indexList, triangleCount, vType, EPT_TRIANGLE_FAN, EIT_16BIT);
+}
+
+void VideoDriver_DrawVertexPrimitiveListBlock(IntPtr videodriver, IntPtr vertices, int vertexCount, IntPtr indexList, int primitiveCount, E_VERTEX_TYPE vType, E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
+{
+	GetVideoFromIntPtr(videodriver)->drawVertexPrimitiveList(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType);
+}
+
 E_DRIVER_TYPE VideoDriver_GetDriverType(IntPtr videodriver)
 {
 	return GetVideoFromIntPtr(videodriver)->getDriverType();
@@ -286,6 +306,29 @@ void VideoDriver_RemoveTexture(IntPtr videodriver, IntPtr texture)
 	GetVideoFromIntPtr(videodriver)->removeTexture((ITexture*)texture);
 }
 
+void VideoDriver_SetTextureBudget(IntPtr videodriver, unsigned int imageBytes, unsigned int textureBytes)
+{
+	GetVideoFromIntPtr(videodriver)->setTextureBudget(imageBytes, textureBytes);
+}
+
+void VideoDriver_GetTextureMemoryUsage(IntPtr videodriver, unsigned int *outImageBytes, unsigned int *outTextureBytes)
+{
+	u32 imageBytes, textureBytes;
+	GetVideoFromIntPtr(videodriver)->getTextureMemoryUsage(imageBytes, textureBytes);
+	*outImageBytes = imageBytes;
+	*outTextureBytes = textureBytes;
+}
+
+bool VideoDriver_MakeTextureResident(IntPtr videodriver, IntPtr texture)
+{
+	_FIX_BOOL_MARSHAL_BUG(GetVideoFromIntPtr(videodriver)->makeTextureResident((ITexture*)texture));
+}
+
+void VideoDriver_SetRasterizerThreadCount(IntPtr videodriver, unsigned int threadCount)
+{
+	GetVideoFromIntPtr(videodriver)->setRasterizerThreadCount(threadCount);
+}
+
 void VideoDriver_RenameTexture(IntPtr videodriver, IntPtr texture, c8* name)
 {
 	GetVideoFromIntPtr(videodriver)->renameTexture((ITexture *)texture, name);
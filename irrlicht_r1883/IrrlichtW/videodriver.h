@@ -38,12 +38,19 @@ extern "C"
 	EXPORT void VideoDriver_DrawIndexedTriangleFanA(IntPtr videodriver, IntPtr *vertices, int vertexCount, unsigned short *indexList, int triangleCount);
 	EXPORT void VideoDriver_DrawIndexedTriangleFanT(IntPtr videodriver, IntPtr *vertices, int vertexCount, unsigned short *indexList, int triangleCount);	
 	EXPORT void VideoDriver_DrawVertexPrimitiveList(IntPtr videodriver, IntPtr *vertices, int vertexCount, unsigned short *indexList, int triangleCount, E_VERTEX_TYPE vType, E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType);
+	EXPORT void VideoDriver_DrawIndexedTriangleListBlock(IntPtr videodriver, IntPtr vertices, int vertexCount, unsigned short *indexList, int triangleCount, E_VERTEX_TYPE vType);
+	EXPORT void VideoDriver_DrawIndexedTriangleFanBlock(IntPtr videodriver, IntPtr vertices, int vertexCount, unsigned short *indexList, int triangleCount, E_VERTEX_TYPE vType);
+	EXPORT void VideoDriver_DrawVertexPrimitiveListBlock(IntPtr videodriver, IntPtr vertices, int vertexCount, IntPtr indexList, int primitiveCount, E_VERTEX_TYPE vType, E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType);
 	EXPORT void VideoDriver_DrawMeshBuffer(IntPtr videodriver, IntPtr meshbuffer);
 	EXPORT bool VideoDriver_GetTextureCreationFlag(IntPtr videodriver, E_TEXTURE_CREATION_FLAG flag);
 	EXPORT void VideoDriver_GetViewPort(IntPtr videodriver, M_RECT viewport);
 	EXPORT bool VideoDriver_QueryFeature(IntPtr videodriver, E_VIDEO_DRIVER_FEATURE feat);
 	EXPORT void VideoDriver_RemoveAllTextures(IntPtr videodriver);
 	EXPORT void VideoDriver_RemoveTexture(IntPtr videodriver, IntPtr texture);
+	EXPORT void VideoDriver_SetTextureBudget(IntPtr videodriver, unsigned int imageBytes, unsigned int textureBytes);
+	EXPORT void VideoDriver_GetTextureMemoryUsage(IntPtr videodriver, unsigned int *outImageBytes, unsigned int *outTextureBytes);
+	EXPORT bool VideoDriver_MakeTextureResident(IntPtr videodriver, IntPtr texture);
+	EXPORT void VideoDriver_SetRasterizerThreadCount(IntPtr videodriver, unsigned int threadCount);
 	EXPORT void VideoDriver_RenameTexture(IntPtr videodriver, IntPtr texture, c8* name);
 	EXPORT void VideoDriver_SetFog(IntPtr videodriver, M_SCOLOR color, bool linear, float start, float end, float density, bool pixel, bool range);
 	EXPORT void VideoDriver_SetMaterial(IntPtr videodriver, IntPtr material);
@@ -0,0 +1,189 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS `AS IS'
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+Decode benchmark: decodes every JPEG-2000 codestream (.j2c, .j2k, or JP2 file) of a directory
+at each reduce level and prints the throughput of each decoder stage in MPix/s.
+
+	j2k_bench [-r max_reduce] [-n repeat] [-t threads] directory
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+
+#include "openjpeg.h"
+
+typedef struct bench_file {
+	char *name;
+	unsigned char *data;
+	int length;
+	OPJ_CODEC_FORMAT format;
+} bench_file_t;
+
+static OPJ_CODEC_FORMAT bench_format(const unsigned char *data, int length) {
+	static const unsigned char j2k_magic[] = { 0xff, 0x4f, 0xff, 0x51 };
+	static const unsigned char jp2_magic[] = { 0x00, 0x00, 0x00, 0x0c, 0x6a, 0x50, 0x20, 0x20 };
+
+	if (length >= 4 && memcmp(data, j2k_magic, 4) == 0)
+		return CODEC_J2K;
+	if (length >= 8 && memcmp(data, jp2_magic, 8) == 0)
+		return CODEC_JP2;
+	return CODEC_UNKNOWN;
+}
+
+static int bench_load(const char *dirname, bench_file_t **files) {
+	DIR *dir = opendir(dirname);
+	struct dirent *entry;
+	int count = 0, size = 0;
+
+	*files = NULL;
+	if (!dir) {
+		fprintf(stderr, "cannot open directory %s\n", dirname);
+		return 0;
+	}
+	while ((entry = readdir(dir)) != NULL) {
+		char path[4096];
+		FILE *f;
+		long length;
+		unsigned char *data;
+
+		snprintf(path, sizeof(path), "%s/%s", dirname, entry->d_name);
+		f = fopen(path, "rb");
+		if (!f)
+			continue;
+		if (fseek(f, 0, SEEK_END) != 0 || (length = ftell(f)) <= 0) {
+			fclose(f);
+			continue;
+		}
+		fseek(f, 0, SEEK_SET);
+		data = (unsigned char*) malloc(length);
+		if (!data || fread(data, 1, length, f) != (size_t) length || bench_format(data, length) == CODEC_UNKNOWN) {
+			free(data);
+			fclose(f);
+			continue;
+		}
+		fclose(f);
+
+		if (count == size) {
+			size = size ? size * 2 : 64;
+			*files = (bench_file_t*) realloc(*files, size * sizeof(bench_file_t));
+		}
+		(*files)[count].name = strdup(entry->d_name);
+		(*files)[count].data = data;
+		(*files)[count].length = (int) length;
+		(*files)[count].format = bench_format(data, length);
+		count++;
+	}
+	closedir(dir);
+	return count;
+}
+
+static double bench_mpix(double pixels, double seconds) {
+	return seconds > 0 ? pixels / seconds * 1e-6 : 0;
+}
+
+int main(int argc, char **argv) {
+	const char *dirname = NULL;
+	int max_reduce = 5, repeat = 1, threads = 1;
+	bench_file_t *files;
+	int numfiles, reduce, i, j;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+			max_reduce = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+			repeat = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+			threads = atoi(argv[++i]);
+		} else if (argv[i][0] != '-') {
+			dirname = argv[i];
+		} else {
+			dirname = NULL;
+			break;
+		}
+	}
+	if (!dirname || repeat < 1 || max_reduce < 0) {
+		fprintf(stderr, "usage: %s [-r max_reduce] [-n repeat] [-t threads] directory\n", argv[0]);
+		return 1;
+	}
+
+	numfiles = bench_load(dirname, &files);
+	if (numfiles == 0) {
+		fprintf(stderr, "no codestream found in %s\n", dirname);
+		return 1;
+	}
+	opj_set_num_threads(threads);
+	printf("%d codestreams, %d repeat(s), %d thread(s), MPix/s of output pixels\n", numfiles, repeat, threads);
+	printf("reduce decoded failed     MPix    total       t2       t1      dwt      mct  headers  cblks/MPix\n");
+
+	for (reduce = 0; reduce <= max_reduce; reduce++) {
+		opj_decode_stats_t stats;
+		opj_dparameters_t parameters;
+		double pixels = 0;
+		int failed = 0;
+
+		memset(&stats, 0, sizeof(stats));
+		opj_set_default_decoder_parameters(&parameters);
+		parameters.cp_reduce = reduce;
+		parameters.stats = &stats;
+
+		for (j = 0; j < repeat; j++) {
+			for (i = 0; i < numfiles; i++) {
+				opj_dinfo_t *dinfo = opj_create_decompress(files[i].format);
+				opj_cio_t *cio;
+				opj_image_t *image;
+
+				opj_setup_decoder(dinfo, &parameters);
+				cio = opj_cio_open((opj_common_ptr) dinfo, files[i].data, files[i].length);
+				image = opj_decode(dinfo, cio);
+				if (image) {
+					pixels += (double) image->comps[0].w * image->comps[0].h;
+					opj_image_destroy(image);
+				} else {
+					failed++;
+				}
+				opj_cio_close(cio);
+				opj_destroy_decompress(dinfo);
+			}
+		}
+
+		printf("%6d %7d %6d %8.2f %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f %11.0f\n",
+			reduce, stats.images - failed, failed, pixels * 1e-6,
+			bench_mpix(pixels, stats.total_time),
+			bench_mpix(pixels, stats.t2_time),
+			bench_mpix(pixels, stats.t1_time),
+			bench_mpix(pixels, stats.dwt_time),
+			bench_mpix(pixels, stats.mct_time),
+			bench_mpix(pixels, stats.total_time - stats.t2_time - stats.t1_time - stats.dwt_time - stats.mct_time),
+			pixels > 0 ? stats.t1_cblks / (pixels * 1e-6) : 0);
+	}
+
+	for (i = 0; i < numfiles; i++) {
+		free(files[i].name);
+		free(files[i].data);
+	}
+	free(files);
+	return 0;
+}
@@ -47,6 +47,16 @@ void DotNetFree(MarshalledImage* image)
 	if (image->decoded != 0) delete[] image->decoded;
 }
 
+void DotNetSetDecodeThreads(int threads)
+{
+	opj_set_num_threads(threads);
+}
+
+int DotNetGetDecodeThreads()
+{
+	return opj_get_num_threads();
+}
+
 
 bool DotNetEncode(MarshalledImage* image, bool lossless)
 {
@@ -168,7 +178,284 @@ bool DotNetDecode(MarshalledImage* image)
 	}
 }
 
+bool DotNetDecodeReduced(MarshalledImage* image, int reduce, int maxLayers)
+{
+	opj_dparameters dparameters;
+
+	// a negative reduce would decode more resolutions than the codestream has
+	if (reduce < 0)
+		return false;
+	
+	try
+	{
+		opj_set_default_decoder_parameters(&dparameters);
+		dparameters.cp_reduce = reduce;
+		dparameters.cp_layer = maxLayers;
+		opj_dinfo_t* dinfo = opj_create_decompress(CODEC_J2K);
+		opj_setup_decoder(dinfo, &dparameters);
+		// image->length may be a prefix of the codestream, the decoder stops where the data does
+		opj_cio* cio = opj_cio_open((opj_common_ptr)dinfo, image->encoded, image->length);
+
+		opj_image* jp2_image = opj_decode(dinfo, cio); // decode happens here
+		if (jp2_image == NULL)
+			throw "opj_decode failed";
+
+		// the reduced size is only known to the components, x1/y1 stay at full resolution
+		image->width = jp2_image->comps[0].w;
+		image->height = jp2_image->comps[0].h;
+		image->components = jp2_image->numcomps;
+		int n = image->width * image->height;
+		image->decoded = new unsigned char[n * image->components];
+		
+		for (int i = 0; i < image->components; i++)
+			std::copy(jp2_image->comps[i].data, jp2_image->comps[i].data + n, image->decoded + i * n);
+
+		opj_image_destroy(jp2_image);
+		opj_destroy_decompress(dinfo);
+		opj_cio_close(cio);
+
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+bool DotNetDecodeInterleaved(MarshalledImage* image, int reduce, unsigned char* buffer, int stride, int size, int format)
+{
+	opj_dparameters dparameters;
+
+	if (reduce < 0)
+		return false;
+	
+	try
+	{
+		opj_set_default_decoder_parameters(&dparameters);
+		dparameters.cp_reduce = reduce;
+		dparameters.out_buffer = buffer;
+		dparameters.out_stride = stride;
+		dparameters.out_size = size;
+		dparameters.out_format = format == DOTNET_PIXEL_BGRA ? PIXFMT_BGRA : PIXFMT_RGBA;
+		opj_dinfo_t* dinfo = opj_create_decompress(CODEC_J2K);
+		opj_setup_decoder(dinfo, &dparameters);
+		opj_cio* cio = opj_cio_open((opj_common_ptr)dinfo, image->encoded, image->length);
+
+		opj_image* jp2_image = opj_decode(dinfo, cio); // decode happens here
+		if (jp2_image == NULL)
+			throw "opj_decode failed";
+
+		image->width = jp2_image->comps[0].w;
+		image->height = jp2_image->comps[0].h;
+		image->components = jp2_image->numcomps;
+		image->decoded = 0;
+
+		bool written = true;
+		if (jp2_image->comps[0].data != NULL)
+		{
+			// the decoder could not write the buffer itself (component precision, subsampling
+			// or buffer too small), interleave the components here
+			int w = image->width;
+			int h = image->height;
+			written = w * 4 <= stride && (h - 1) * stride + w * 4 <= size;
+			for (int y = 0; written && y < h; y++)
+			{
+				unsigned char* dst = buffer + y * stride;
+				for (int x = 0; x < w; x++)
+				{
+					unsigned char px[4] = { 0, 0, 0, 255 };
+					for (int c = 0; c < 4; c++)
+					{
+						// grey, grey + alpha, RGB or RGBA
+						int compno = image->components < 3 ? (c == 3 ? 1 : 0) : c;
+						if (compno >= image->components)
+							continue;
+						opj_image_comp_t* comp = &jp2_image->comps[compno];
+						if (comp->w != w || comp->h != h)
+							continue;
+						int v = comp->data[y * w + x] + (comp->sgnd ? 1 << (comp->prec - 1) : 0);
+						v = comp->prec > 8 ? v >> (comp->prec - 8) : v << (8 - comp->prec);
+						px[c] = (unsigned char)std::min(std::max(v, 0), 255);
+					}
+					dst[x * 4 + 0] = px[format == DOTNET_PIXEL_BGRA ? 2 : 0];
+					dst[x * 4 + 1] = px[1];
+					dst[x * 4 + 2] = px[format == DOTNET_PIXEL_BGRA ? 0 : 2];
+					dst[x * 4 + 3] = px[3];
+				}
+			}
+		}
+
+		opj_image_destroy(jp2_image);
+		opj_destroy_decompress(dinfo);
+		opj_cio_close(cio);
+
+		return written;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+struct DotNetDecoder
+{
+	opj_dinfo_t* dinfo;
+	// image->decoded of the last decode
+	unsigned char* decoded;
+	int size;
+};
+
+void* DotNetCreateDecoder()
+{
+	try
+	{
+		DotNetDecoder* decoder = new DotNetDecoder();
+		decoder->dinfo = opj_create_decompress(CODEC_J2K);
+		decoder->decoded = 0;
+		decoder->size = 0;
+		if (decoder->dinfo == NULL)
+		{
+			delete decoder;
+			return 0;
+		}
+		return decoder;
+	}
+	catch (...)
+	{
+		return 0;
+	}
+}
+
+void DotNetDestroyDecoder(void* decoder)
+{
+	DotNetDecoder* d = (DotNetDecoder*)decoder;
+	if (d == 0) return;
+	opj_destroy_decompress(d->dinfo);
+	if (d->decoded != 0) delete[] d->decoded;
+	delete d;
+}
+
+bool DotNetDecoderDecode(void* decoder, MarshalledImage* image, int reduce, int maxLayers)
+{
+	DotNetDecoder* d = (DotNetDecoder*)decoder;
+	opj_dparameters dparameters;
+
+	if (reduce < 0)
+		return false;
+	
+	try
+	{
+		if (d == 0)
+			throw "no decoder";
+
+		opj_set_default_decoder_parameters(&dparameters);
+		dparameters.cp_reduce = reduce;
+		dparameters.cp_layer = maxLayers;
+		opj_setup_decoder(d->dinfo, &dparameters);
+		opj_cio* cio = opj_cio_open((opj_common_ptr)d->dinfo, image->encoded, image->length);
+
+		opj_image* jp2_image = opj_decode(d->dinfo, cio); // decode happens here
+		opj_cio_close(cio);
+		if (jp2_image == NULL)
+			throw "opj_decode failed";
+
+		image->width = jp2_image->comps[0].w;
+		image->height = jp2_image->comps[0].h;
+		image->components = jp2_image->numcomps;
+		int n = image->width * image->height;
+		if (d->size < n * image->components)
+		{
+			if (d->decoded != 0) delete[] d->decoded;
+			d->decoded = 0;
+			d->size = 0;
+			d->decoded = new unsigned char[n * image->components];
+			d->size = n * image->components;
+		}
+		image->decoded = d->decoded;
+		
+		for (int i = 0; i < image->components; i++)
+			std::copy(jp2_image->comps[i].data, jp2_image->comps[i].data + n, image->decoded + i * n);
+
+		opj_image_destroy(jp2_image);
+
+		return true;
+	}
+	catch (...)
+	{
+		image->decoded = 0;
+		return false;
+	}
+}
+
+int DotNetDecodeBatch(MarshalledImage* images, int count)
+{
+	opj_dparameters dparameters;
+	int decoded = 0;
+
+	if (count <= 0)
+		return 0;
+
+	unsigned char** buffers = 0;
+	int* lengths = 0;
+	opj_image_t** jp2_images = 0;
+	try
+	{
+		buffers = new unsigned char*[count];
+		lengths = new int[count];
+		jp2_images = new opj_image_t*[count];
+		for (int i = 0; i < count; i++)
+		{
+			buffers[i] = images[i].encoded;
+			lengths[i] = images[i].length;
+			images[i].decoded = 0;
+		}
+
+		opj_set_default_decoder_parameters(&dparameters);
+		opj_decode_batch(CODEC_J2K, &dparameters, NULL, NULL, buffers, lengths, jp2_images, count); // decode happens here
+
+		for (int i = 0; i < count; i++)
+		{
+			opj_image* jp2_image = jp2_images[i];
+			if (jp2_image == NULL)
+				continue;
+
+			MarshalledImage* image = &images[i];
+			image->width = jp2_image->x1 - jp2_image->x0;
+			image->height = jp2_image->y1 - jp2_image->y0;
+			image->components = jp2_image->numcomps;
+			int n = image->width * image->height;
+			try
+			{
+				image->decoded = new unsigned char[n * image->components];
+				for (int c = 0; c < image->components; c++)
+					std::copy(jp2_image->comps[c].data, jp2_image->comps[c].data + n, image->decoded + c * n);
+				decoded++;
+			}
+			catch (...)
+			{
+				image->decoded = 0;
+			}
+
+			opj_image_destroy(jp2_image);
+		}
+	}
+	catch (...)
+	{
+	}
+
+	delete[] buffers;
+	delete[] lengths;
+	delete[] jp2_images;
+
+	return decoded;
+}
+
 bool DotNetDecodeWithInfo(MarshalledImage* image)
+{
+	return DotNetDecodeWithInfoAndStats(image, 0);
+}
+
+bool DotNetDecodeWithInfoAndStats(MarshalledImage* image, opj_decode_stats_t* stats)
 {
 	opj_dparameters dparameters;
 	opj_codestream_info_t info;
@@ -176,6 +463,7 @@ bool DotNetDecodeWithInfo(MarshalledImage* image)
 	try
 	{
 		opj_set_default_decoder_parameters(&dparameters);
+		dparameters.stats = stats;
 		opj_dinfo_t* dinfo = opj_create_decompress(CODEC_J2K);
 		opj_setup_decoder(dinfo, &dparameters);
 		opj_cio* cio = opj_cio_open((opj_common_ptr)dinfo, image->encoded, image->length);
@@ -30,9 +30,46 @@ struct MarshalledImage
 DLLEXPORT bool DotNetEncode(MarshalledImage* image, bool lossless);
 DLLEXPORT bool DotNetDecode(MarshalledImage* image);
 DLLEXPORT bool DotNetDecodeWithInfo(MarshalledImage* image);
+// DotNetDecodeWithInfo that also adds the time spent and work done by each decoder stage
+// to stats (see opj_decode_stats_t), which the caller zeroes first
+DLLEXPORT bool DotNetDecodeWithInfoAndStats(MarshalledImage* image, opj_decode_stats_t* stats);
+// decodes at 1/2^reduce of the full size using the first maxLayers quality layers (0 for all),
+// width and height are set to the reduced size. encoded/length may hold only the first bytes of
+// the codestream, in which case the image is decoded from the data received so far. A negative
+// reduce fails
+DLLEXPORT bool DotNetDecodeReduced(MarshalledImage* image, int reduce, int maxLayers);
+
+// channel order for DotNetDecodeInterleaved
+#define DOTNET_PIXEL_RGBA 0
+#define DOTNET_PIXEL_BGRA 1
+
+// decodes at 1/2^reduce of the full size straight into a caller-owned interleaved 8 bit/channel
+// buffer (rows stride bytes apart, size bytes in total) instead of image->decoded, which is left
+// empty. 1 component is written as grey, 2 as grey + alpha, 3 as RGB with opaque alpha, 4 as RGBA.
+// width, height and components are always set, false is returned if the buffer is too small
+DLLEXPORT bool DotNetDecodeInterleaved(MarshalledImage* image, int reduce, unsigned char* buffer, int stride, int size, int format);
+
+// a decoder keeps its work memory from one image to the next, which saves the allocations
+// of DotNetDecode when many images are decoded in a row. A decoder is used by one thread at a time
+DLLEXPORT void* DotNetCreateDecoder();
+DLLEXPORT void DotNetDestroyDecoder(void* decoder);
+// same as DotNetDecodeReduced, but image->decoded points to memory owned by the decoder: it stays
+// valid until the next decode or DotNetDestroyDecoder and must not be freed with DotNetFree
+DLLEXPORT bool DotNetDecoderDecode(void* decoder, MarshalledImage* image, int reduce, int maxLayers);
+
+// decodes count images at once on the decode threads (see DotNetSetDecodeThreads), returns the
+// number of images decoded. Each decoded image is set as by DotNetDecode (free with DotNetFree),
+// images that could not be decoded get decoded set to 0
+DLLEXPORT int DotNetDecodeBatch(MarshalledImage* images, int count);
+
 DLLEXPORT bool DotNetAllocEncoded(MarshalledImage* image);
 DLLEXPORT bool DotNetAllocDecoded(MarshalledImage* image);
 DLLEXPORT void DotNetFree(MarshalledImage* image);
 
+// number of threads decoding code-blocks and tile-components, shared by all decodes.
+// 0 or 1 decodes on the calling thread only (default)
+DLLEXPORT void DotNetSetDecodeThreads(int threads);
+DLLEXPORT int DotNetGetDecodeThreads();
+
 
 #endif
@@ -34,25 +34,21 @@
 #ifdef __SSE__
 #include <xmmintrin.h>
 #endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include "opj_includes.h"
 
 /** @defgroup DWT DWT - Implementation of a discrete wavelet transform */
 /*@{*/
 
-#define WS(i) v->mem[(i)*2]
-#define WD(i) v->mem[(1+(i)*2)]
-
 /** @name Local data structures */
 /*@{*/
 
-typedef struct dwt_local {
-	int* mem;
-	int dn;
-	int sn;
-	int cas;
-} dwt_t;
-
 typedef union {
 	float	f[4];
 } v4;
@@ -73,12 +69,36 @@ static const float K      = 1.230174105f; //  10078
 /* FIXME: What is this constant? */
 static const float c13318 = 1.625732422f;
 
-/*@}*/
-
 /**
-Virtual function type for wavelet transform in 1-D 
+Number of columns transformed together by the vertical 5-3 passes: 
+a row of the strip fills a cache line
+*/
+#define DWT_STRIP 16
+
+/*
+Integer vectors used by the 5-3 lifting steps
 */
-typedef void (*DWT1DFN)(dwt_t* v);
+#if defined(__AVX2__)
+#define DWT_VEC 8
+typedef __m256i dwt_vec_t;
+#define dwt_vload(p) _mm256_loadu_si256((const __m256i*)(p))
+#define dwt_vstore(p, x) _mm256_storeu_si256((__m256i*)(p), (x))
+#define dwt_vset1(c) _mm256_set1_epi32(c)
+#define dwt_vadd(a, b) _mm256_add_epi32((a), (b))
+#define dwt_vsub(a, b) _mm256_sub_epi32((a), (b))
+#define dwt_vsra(a, n) _mm256_sra_epi32((a), (n))
+#elif defined(__SSE2__)
+#define DWT_VEC 4
+typedef __m128i dwt_vec_t;
+#define dwt_vload(p) _mm_loadu_si128((const __m128i*)(p))
+#define dwt_vstore(p, x) _mm_storeu_si128((__m128i*)(p), (x))
+#define dwt_vset1(c) _mm_set1_epi32(c)
+#define dwt_vadd(a, b) _mm_add_epi32((a), (b))
+#define dwt_vsub(a, b) _mm_sub_epi32((a), (b))
+#define dwt_vsra(a, n) _mm_sra_epi32((a), (n))
+#endif
+
+/*@}*/
 
 /** @name Local static functions */
 /*@{*/
@@ -92,21 +112,30 @@ Forward lazy transform (vertical)
 */
 static void dwt_deinterleave_v(int *a, int *b, int dn, int sn, int x, int cas);
 /**
-Inverse lazy transform (horizontal)
+5-3 lifting step on a row: out[i] = a[i] +/- ((b[i+o] + b[i+o+1] + add) >> shift), 
+with the indices of b clamped to [0, nb)
+*/
+static void dwt_lift_53_row(int *out, const int *a, const int *b, int n, int nb, int o, int add, int shift, int neg);
+/**
+5-3 lifting step on n rows of cw samples: the same as dwt_lift_53_row with rows instead of samples
 */
-static void dwt_interleave_h(dwt_t* h, int *a);
+static void dwt_lift_53_cols(int *out, int os, const int *a, int as, const int *b, int bs, int n, int nb, int cw, int o, int add, int shift, int neg);
 /**
-Inverse lazy transform (vertical)
+Forward 5-3 wavelet transform in 1-D on a row, the result is deinterleaved
 */
-static void dwt_interleave_v(dwt_t* v, int *a, int x);
+static void dwt_encode_53_h(int *a, int *mem, int dn, int sn, int cas);
 /**
-Forward 5-3 wavelet transform in 1-D
+Forward 5-3 wavelet transform in 1-D on the cw columns of a strip, the result is deinterleaved
 */
-static void dwt_encode_1(int *a, int dn, int sn, int cas);
+static void dwt_encode_53_v(int *a, int *mem, int w, int cw, int dn, int sn, int cas);
 /**
-Inverse 5-3 wavelet transform in 1-D
+Inverse 5-3 wavelet transform in 1-D on a deinterleaved row
 */
-static void dwt_decode_1(dwt_t *v);
+static void dwt_decode_53_h(int *a, int *mem, int dn, int sn, int cas);
+/**
+Inverse 5-3 wavelet transform in 1-D on the cw deinterleaved columns of a strip
+*/
+static void dwt_decode_53_v(int *a, int *mem, int w, int cw, int dn, int sn, int cas);
 /**
 Forward 9-7 wavelet transform in 1-D
 */
@@ -116,9 +145,9 @@ Explicit calculation of the Quantization Stepsizes
 */
 static void dwt_encode_stepsize(int stepsize, int numbps, opj_stepsize_t *bandno_stepsize);
 /**
-Inverse wavelet transform in 2-D.
+Inverse 5-3 wavelet transform in 2-D.
 */
-static void dwt_decode_tile(opj_tcd_tilecomp_t* tilec, int i, DWT1DFN fn);
+static void dwt_decode_tile(opj_tcd_tilecomp_t* tilec, int i, opj_dwt_mem_t *mem);
 
 /*@}*/
 
@@ -177,95 +206,190 @@ static void dwt_deinterleave_v(int *a, int *b, int dn, int sn, int x, int cas) {
 }
 
 /* <summary>                             */
-/* Inverse lazy transform (horizontal).  */
+/* 5-3 lifting step on a row.            */
 /* </summary>                            */
-static void dwt_interleave_h(dwt_t* h, int *a) {
-    int *ai = a;
-    int *bi = h->mem + h->cas;
-    int  i	= h->sn;
-    while( i-- ) {
-      *bi = *(ai++);
-	  bi += 2;
-    }
-    ai	= a + h->sn;
-    bi	= h->mem + 1 - h->cas;
-    i	= h->dn ;
-    while( i-- ) {
-      *bi = *(ai++);
-	  bi += 2;
-    }
+static void dwt_lift_53_row(int *out, const int *a, const int *b, int n, int nb, int o, int add, int shift, int neg) {
+	/* b[i+o] and b[i+o+1] need no clamping for i in [lo, hi) */
+	int lo = int_min(int_max(-o, 0), n);
+	int hi = int_max(int_min(nb - 1 - o, n), lo);
+	int i;
+
+	for (i = 0; i < lo; i++) {
+		int t = (b[int_clamp(i + o, 0, nb - 1)] + b[int_clamp(i + o + 1, 0, nb - 1)] + add) >> shift;
+		out[i] = neg ? a[i] - t : a[i] + t;
+	}
+#ifdef DWT_VEC
+	{
+		const dwt_vec_t vadd = dwt_vset1(add);
+		const __m128i vshift = _mm_cvtsi32_si128(shift);
+		for (; i + DWT_VEC <= hi; i += DWT_VEC) {
+			dwt_vec_t t = dwt_vsra(dwt_vadd(dwt_vadd(dwt_vload(&b[i + o]), dwt_vload(&b[i + o + 1])), vadd), vshift);
+			dwt_vstore(&out[i], neg ? dwt_vsub(dwt_vload(&a[i]), t) : dwt_vadd(dwt_vload(&a[i]), t));
+		}
+	}
+#endif
+	for (; i < hi; i++) {
+		int t = (b[i + o] + b[i + o + 1] + add) >> shift;
+		out[i] = neg ? a[i] - t : a[i] + t;
+	}
+	for (; i < n; i++) {
+		int t = (b[int_clamp(i + o, 0, nb - 1)] + b[int_clamp(i + o + 1, 0, nb - 1)] + add) >> shift;
+		out[i] = neg ? a[i] - t : a[i] + t;
+	}
 }
 
-/* <summary>                             */  
-/* Inverse lazy transform (vertical).    */
-/* </summary>                            */ 
-static void dwt_interleave_v(dwt_t* v, int *a, int x) {
-    int *ai = a;
-    int *bi = v->mem + v->cas;
-    int  i = v->sn;
-    while( i-- ) {
-      *bi = *ai;
-	  bi += 2;
-	  ai += x;
-    }
-    ai = a + (v->sn * x);
-    bi = v->mem + 1 - v->cas;
-    i = v->dn ;
-    while( i-- ) {
-      *bi = *ai;
-	  bi += 2;  
-	  ai += x;
-    }
+/* <summary>                             */
+/* 5-3 lifting step on rows of a strip.  */
+/* </summary>                            */
+static void dwt_lift_53_cols(int *out, int os, const int *a, int as, const int *b, int bs, int n, int nb, int cw, int o, int add, int shift, int neg) {
+	int i, k;
+#ifdef DWT_VEC
+	const dwt_vec_t vadd = dwt_vset1(add);
+	const __m128i vshift = _mm_cvtsi32_si128(shift);
+#endif
+
+	for (i = 0; i < n; i++) {
+		const int *b0 = &b[int_clamp(i + o, 0, nb - 1) * bs];
+		const int *b1 = &b[int_clamp(i + o + 1, 0, nb - 1) * bs];
+		const int *ai = &a[i * as];
+		int *oi = &out[i * os];
+		k = 0;
+#ifdef DWT_VEC
+		for (; k + DWT_VEC <= cw; k += DWT_VEC) {
+			dwt_vec_t t = dwt_vsra(dwt_vadd(dwt_vadd(dwt_vload(&b0[k]), dwt_vload(&b1[k])), vadd), vshift);
+			dwt_vstore(&oi[k], neg ? dwt_vsub(dwt_vload(&ai[k]), t) : dwt_vadd(dwt_vload(&ai[k]), t));
+		}
+#endif
+		for (; k < cw; k++) {
+			int t = (b0[k] + b1[k] + add) >> shift;
+			oi[k] = neg ? ai[k] - t : ai[k] + t;
+		}
+	}
 }
 
+/* 
+In the 5-3 lifting steps below, L are the sn low-pass samples (even samples if cas = 0, 
+odd samples if cas = 1) and H the dn high-pass samples. The forward transform is
+	H[i] -= (L[i+ho] + L[i+ho+1]) >> 1
+	L[i] += (H[i+lo] + H[i+lo+1] + 2) >> 2
+with ho = 0, lo = -1 if cas = 0 and ho = -1, lo = 0 if cas = 1, and the inverse 
+transform undoes the two steps in reverse order.
+*/
+
+/* <summary>                                   */
+/* Forward 5-3 wavelet transform in 1-D (row). */
+/* </summary>                                  */
+static void dwt_encode_53_h(int *a, int *mem, int dn, int sn, int cas) {
+	int *l = mem;
+	int *h = mem + sn;
+	int i, j;
 
-/* <summary>                            */
-/* Forward 5-3 wavelet transform in 1-D. */
-/* </summary>                           */
-static void dwt_encode_1(int *a, int dn, int sn, int cas) {
-	int i;
-	
 	if (!cas) {
-		if ((dn > 0) || (sn > 1)) {	/* NEW :  CASE ONE ELEMENT */
-			for (i = 0; i < dn; i++) D(i) -= (S_(i) + S_(i + 1)) >> 1;
-			for (i = 0; i < sn; i++) S(i) += (D_(i - 1) + D_(i) + 2) >> 2;
-		}
-	} else {
-		if (!sn && dn == 1)		    /* NEW :  CASE ONE ELEMENT */
-			S(0) *= 2;
-		else {
-			for (i = 0; i < dn; i++) S(i) -= (DD_(i) + DD_(i - 1)) >> 1;
-			for (i = 0; i < sn; i++) D(i) += (SS_(i) + SS_(i + 1) + 2) >> 2;
+		if (!((dn > 0) || (sn > 1))) {	/* NEW :  CASE ONE ELEMENT */
+			return;
 		}
+	} else if (!sn && dn == 1) {		/* NEW :  CASE ONE ELEMENT */
+		a[0] *= 2;
+		return;
+	}
+
+	/* lazy transform */
+	i = 0;
+#ifdef __SSE2__
+	for (; i + 4 <= int_min(sn, dn); i += 4) {
+		__m128 x0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&a[2 * i]));
+		__m128 x1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&a[2 * i + 4]));
+		__m128i even = _mm_castps_si128(_mm_shuffle_ps(x0, x1, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i odd = _mm_castps_si128(_mm_shuffle_ps(x0, x1, _MM_SHUFFLE(3, 1, 3, 1)));
+		_mm_storeu_si128((__m128i*)&l[i], cas ? odd : even);
+		_mm_storeu_si128((__m128i*)&h[i], cas ? even : odd);
 	}
+#endif
+	for (j = i; j < sn; j++) l[j] = a[2 * j + cas];
+	for (j = i; j < dn; j++) h[j] = a[2 * j + 1 - cas];
+
+	dwt_lift_53_row(a + sn, h, l, dn, sn, cas ? -1 : 0, 0, 1, 1);
+	dwt_lift_53_row(a, l, a + sn, sn, dn, cas ? 0 : -1, 2, 2, 0);
 }
 
-/* <summary>                            */
-/* Inverse 5-3 wavelet transform in 1-D. */
-/* </summary>                           */ 
-static void dwt_decode_1_(int *a, int dn, int sn, int cas) {
+/* <summary>                                                */
+/* Forward 5-3 wavelet transform in 1-D (columns of a strip). */
+/* </summary>                                               */
+static void dwt_encode_53_v(int *a, int *mem, int w, int cw, int dn, int sn, int cas) {
 	int i;
-	
+
 	if (!cas) {
-		if ((dn > 0) || (sn > 1)) { /* NEW :  CASE ONE ELEMENT */
-			for (i = 0; i < sn; i++) S(i) -= (D_(i - 1) + D_(i) + 2) >> 2;
-			for (i = 0; i < dn; i++) D(i) += (S_(i) + S_(i + 1)) >> 1;
+		if (!((dn > 0) || (sn > 1))) {	/* NEW :  CASE ONE ELEMENT */
+			return;
 		}
-	} else {
-		if (!sn  && dn == 1)          /* NEW :  CASE ONE ELEMENT */
-			S(0) /= 2;
-		else {
-			for (i = 0; i < sn; i++) D(i) -= (SS_(i) + SS_(i + 1) + 2) >> 2;
-			for (i = 0; i < dn; i++) S(i) += (DD_(i) + DD_(i - 1)) >> 1;
+	} else if (!sn && dn == 1) {		/* NEW :  CASE ONE ELEMENT */
+		for (i = 0; i < cw; i++) a[i] *= 2;
+		return;
+	}
+
+	dwt_lift_53_cols(mem + sn * cw, cw, a + (1 - cas) * w, 2 * w, a + cas * w, 2 * w, dn, sn, cw, cas ? -1 : 0, 0, 1, 1);
+	dwt_lift_53_cols(mem, cw, a + cas * w, 2 * w, mem + sn * cw, cw, sn, dn, cw, cas ? 0 : -1, 2, 2, 0);
+	for (i = 0; i < sn + dn; i++) {
+		memcpy(&a[i * w], &mem[i * cw], cw * sizeof(int));
+	}
+}
+
+/* <summary>                                   */
+/* Inverse 5-3 wavelet transform in 1-D (row). */
+/* </summary>                                  */
+static void dwt_decode_53_h(int *a, int *mem, int dn, int sn, int cas) {
+	int *l = mem;
+	int *h = mem + sn;
+	int i, j;
+
+	if (!cas) {
+		if (!((dn > 0) || (sn > 1))) {	/* NEW :  CASE ONE ELEMENT */
+			return;
 		}
+	} else if (!sn && dn == 1) {		/* NEW :  CASE ONE ELEMENT */
+		a[0] /= 2;
+		return;
 	}
+
+	dwt_lift_53_row(l, a, a + sn, sn, dn, cas ? 0 : -1, 2, 2, 1);
+	dwt_lift_53_row(h, a + sn, l, dn, sn, cas ? -1 : 0, 0, 1, 0);
+
+	/* inverse lazy transform */
+	i = 0;
+#ifdef __SSE2__
+	for (; i + 4 <= int_min(sn, dn); i += 4) {
+		__m128i vl = _mm_loadu_si128((const __m128i*)&l[i]);
+		__m128i vh = _mm_loadu_si128((const __m128i*)&h[i]);
+		__m128i even = cas ? vh : vl;
+		__m128i odd = cas ? vl : vh;
+		_mm_storeu_si128((__m128i*)&a[2 * i], _mm_unpacklo_epi32(even, odd));
+		_mm_storeu_si128((__m128i*)&a[2 * i + 4], _mm_unpackhi_epi32(even, odd));
+	}
+#endif
+	for (j = i; j < sn; j++) a[2 * j + cas] = l[j];
+	for (j = i; j < dn; j++) a[2 * j + 1 - cas] = h[j];
 }
 
-/* <summary>                            */
-/* Inverse 5-3 wavelet transform in 1-D. */
-/* </summary>                           */ 
-static void dwt_decode_1(dwt_t *v) {
-	dwt_decode_1_(v->mem, v->dn, v->sn, v->cas);
+/* <summary>                                                  */
+/* Inverse 5-3 wavelet transform in 1-D (columns of a strip). */
+/* </summary>                                                 */
+static void dwt_decode_53_v(int *a, int *mem, int w, int cw, int dn, int sn, int cas) {
+	int i;
+
+	if (!cas) {
+		if (!((dn > 0) || (sn > 1))) {	/* NEW :  CASE ONE ELEMENT */
+			return;
+		}
+	} else if (!sn && dn == 1) {		/* NEW :  CASE ONE ELEMENT */
+		for (i = 0; i < cw; i++) a[i] /= 2;
+		return;
+	}
+
+	dwt_lift_53_cols(mem + cas * cw, 2 * cw, a, w, a + sn * w, w, sn, dn, cw, cas ? 0 : -1, 2, 2, 1);
+	dwt_lift_53_cols(mem + (1 - cas) * cw, 2 * cw, a + sn * w, w, mem + cas * cw, 2 * cw, dn, sn, cw, cas ? -1 : 0, 0, 1, 0);
+	for (i = 0; i < sn + dn; i++) {
+		memcpy(&a[i * w], &mem[i * cw], cw * sizeof(int));
+	}
 }
 
 /* <summary>                             */
@@ -324,15 +448,18 @@ static void dwt_encode_stepsize(int stepsize, int numbps, opj_stepsize_t *bandno
 /* Forward 5-3 wavelet transform in 2-D. */
 /* </summary>                           */
 void dwt_encode(opj_tcd_tilecomp_t * tilec) {
-	int i, j, k;
+	int i, j;
 	int *a = NULL;
-	int *aj = NULL;
-	int *bj = NULL;
+	int *mem = NULL;
 	int w, l;
 	
 	w = tilec->x1-tilec->x0;
 	l = tilec->numresolutions-1;
 	a = tilec->data;
+
+	/* the highest resolution is the largest */
+	mem = (int*)opj_aligned_malloc(int_max(1, int_max(tilec->resolutions[l].x1 - tilec->resolutions[l].x0, 
+		tilec->resolutions[l].y1 - tilec->resolutions[l].y0)) * DWT_STRIP * sizeof(int));
 	
 	for (i = 0; i < l; i++) {
 		int rw;			/* width of the resolution level computed                                                           */
@@ -353,34 +480,25 @@ void dwt_encode(opj_tcd_tilecomp_t * tilec) {
         
 		sn = rh1;
 		dn = rh - rh1;
-		bj = (int*)opj_malloc(rh * sizeof(int));
-		for (j = 0; j < rw; j++) {
-			aj = a + j;
-			for (k = 0; k < rh; k++)  bj[k] = aj[k*w];
-			dwt_encode_1(bj, dn, sn, cas_col);
-			dwt_deinterleave_v(bj, aj, dn, sn, w, cas_col);
+		for (j = 0; j < rw; j += DWT_STRIP) {
+			dwt_encode_53_v(a + j, mem, w, int_min(DWT_STRIP, rw - j), dn, sn, cas_col);
 		}
-		opj_free(bj);
 		
 		sn = rw1;
 		dn = rw - rw1;
-		bj = (int*)opj_malloc(rw * sizeof(int));
 		for (j = 0; j < rh; j++) {
-			aj = a + j * w;
-			for (k = 0; k < rw; k++)  bj[k] = aj[k];
-			dwt_encode_1(bj, dn, sn, cas_row);
-			dwt_deinterleave_h(bj, aj, dn, sn, cas_row);
+			dwt_encode_53_h(a + j * w, mem, dn, sn, cas_row);
 		}
-		opj_free(bj);
 	}
+	opj_aligned_free(mem);
 }
 
 
 /* <summary>                            */
 /* Inverse 5-3 wavelet transform in 2-D. */
 /* </summary>                           */
-void dwt_decode(opj_tcd_tilecomp_t* tilec, int numres) {
-	dwt_decode_tile(tilec, numres, &dwt_decode_1);
+void dwt_decode(opj_tcd_tilecomp_t* tilec, int numres, opj_dwt_mem_t *mem) {
+	dwt_decode_tile(tilec, numres, mem);
 }
 
 
@@ -514,11 +632,11 @@ static int dwt_decode_max_resolution(opj_tcd_resolution_t* restrict r, int i) {
 
 
 /* <summary>                            */
-/* Inverse wavelet transform in 2-D.     */
+/* Inverse 5-3 wavelet transform in 2-D. */
 /* </summary>                           */
-static void dwt_decode_tile(opj_tcd_tilecomp_t* tilec, int numres, DWT1DFN dwt_1D) {
-	dwt_t h;
-	dwt_t v;
+static void dwt_decode_tile(opj_tcd_tilecomp_t* tilec, int numres, opj_dwt_mem_t *mem) {
+	int *wmem;
+	opj_dwt_mem_t local = { NULL, 0 };
 
 	opj_tcd_resolution_t* tr = tilec->resolutions;
 
@@ -527,42 +645,31 @@ static void dwt_decode_tile(opj_tcd_tilecomp_t* tilec, int numres, DWT1DFN dwt_1
 
 	int w = tilec->x1 - tilec->x0;
 
-	h.mem = opj_aligned_malloc(dwt_decode_max_resolution(tr, numres) * sizeof(int));
-	v.mem = h.mem;
+	if (!mem) {
+		mem = &local;
+	}
+	wmem = (int*) dwt_mem_reserve(mem, dwt_decode_max_resolution(tr, numres) * DWT_STRIP * sizeof(int));
 
 	while( --numres) {
 		int * restrict tiledp = tilec->data;
+		int sn_h = rw;
+		int sn_v = rh;
 		int j;
 
 		++tr;
-		h.sn = rw;
-		v.sn = rh;
 
 		rw = tr->x1 - tr->x0;
 		rh = tr->y1 - tr->y0;
 
-		h.dn = rw - h.sn;
-		h.cas = tr->x0 % 2;
-
 		for(j = 0; j < rh; ++j) {
-			dwt_interleave_h(&h, &tiledp[j*w]);
-			(dwt_1D)(&h);
-			memcpy(&tiledp[j*w], h.mem, rw * sizeof(int));
+			dwt_decode_53_h(&tiledp[j*w], wmem, rw - sn_h, sn_h, tr->x0 % 2);
 		}
 
-		v.dn = rh - v.sn;
-		v.cas = tr->y0 % 2;
-
-		for(j = 0; j < rw; ++j){
-			int k;
-			dwt_interleave_v(&v, &tiledp[j], w);
-			(dwt_1D)(&v);
-			for(k = 0; k < rh; ++k) {
-				tiledp[k * w + j] = v.mem[k];
-			}
+		for(j = 0; j < rw; j += DWT_STRIP) {
+			dwt_decode_53_v(&tiledp[j], wmem, w, int_min(DWT_STRIP, rw - j), rh - sn_v, sn_v, tr->y0 % 2);
 		}
 	}
-	opj_aligned_free(h.mem);
+	dwt_mem_free(&local);
 }
 
 static void v4dwt_interleave_h(v4dwt_t* restrict w, float* restrict a, int x, int size){
@@ -743,9 +850,10 @@ static void v4dwt_decode(v4dwt_t* restrict dwt){
 /* <summary>                             */
 /* Inverse 9-7 wavelet transform in 2-D. */
 /* </summary>                            */
-void dwt_decode_real(opj_tcd_tilecomp_t* restrict tilec, int numres){
+void dwt_decode_real(opj_tcd_tilecomp_t* restrict tilec, int numres, opj_dwt_mem_t *mem){
 	v4dwt_t h;
 	v4dwt_t v;
+	opj_dwt_mem_t local = { NULL, 0 };
 
 	opj_tcd_resolution_t* res = tilec->resolutions;
 
@@ -754,7 +862,10 @@ void dwt_decode_real(opj_tcd_tilecomp_t* restrict tilec, int numres){
 
 	int w = tilec->x1 - tilec->x0;
 
-	h.wavelet = (v4*) opj_aligned_malloc((dwt_decode_max_resolution(res, numres)+5) * sizeof(v4));
+	if (!mem) {
+		mem = &local;
+	}
+	h.wavelet = (v4*) dwt_mem_reserve(mem, (dwt_decode_max_resolution(res, numres)+5) * sizeof(v4));
 	v.wavelet = h.wavelet;
 
 	while( --numres) {
@@ -820,6 +931,25 @@ void dwt_decode_real(opj_tcd_tilecomp_t* restrict tilec, int numres){
 		}
 	}
 
-	opj_aligned_free(h.wavelet);
+	dwt_mem_free(&local);
+}
+
+void* dwt_mem_reserve(opj_dwt_mem_t *mem, int size) {
+	if (mem->size < size) {
+		if (mem->data) {
+			opj_aligned_free(mem->data);
+		}
+		mem->data = opj_aligned_malloc(size);
+		mem->size = mem->data ? size : 0;
+	}
+	return mem->data;
+}
+
+void dwt_mem_free(opj_dwt_mem_t *mem) {
+	if (mem->data) {
+		opj_aligned_free(mem->data);
+	}
+	mem->data = NULL;
+	mem->size = 0;
 }
 
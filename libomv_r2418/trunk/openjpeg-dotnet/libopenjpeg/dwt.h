@@ -43,6 +43,16 @@ DWT.C are used by some function in TCD.C.
 /** @defgroup DWT DWT - Implementation of a discrete wavelet transform */
 /*@{*/
 
+/**
+Work memory of the inverse transforms. It only grows, so that it can be kept
+between tile-components and decodes instead of being allocated for each of them.
+*/
+typedef struct opj_dwt_mem {
+	/** 16 byte aligned work area */
+	void *data;
+	/** size of data in bytes */
+	int size;
+} opj_dwt_mem_t;
 
 /** @name Exported functions */
 /*@{*/
@@ -58,8 +68,9 @@ Inverse 5-3 wavelet tranform in 2-D.
 Apply a reversible inverse DWT transform to a component of an image.
 @param tilec Tile component information (current tile)
 @param numres Number of resolution levels to decode
+@param mem Work memory to use, NULL to allocate it for this call only
 */
-void dwt_decode(opj_tcd_tilecomp_t* tilec, int numres);
+void dwt_decode(opj_tcd_tilecomp_t* tilec, int numres, opj_dwt_mem_t *mem);
 /**
 Get the gain of a subband for the reversible 5-3 DWT.
 @param orient Number that identifies the subband (0->LL, 1->HL, 2->LH, 3->HH)
@@ -84,8 +95,21 @@ Inverse 9-7 wavelet transform in 2-D.
 Apply an irreversible inverse DWT transform to a component of an image.
 @param tilec Tile component information (current tile)
 @param numres Number of resolution levels to decode
+@param mem Work memory to use, NULL to allocate it for this call only
+*/
+void dwt_decode_real(opj_tcd_tilecomp_t* tilec, int numres, opj_dwt_mem_t *mem);
+/**
+Make sure a work memory holds at least size bytes. Its previous content is lost when it grows.
+@param mem Work memory
+@param size Number of bytes needed
+@return Returns the work area, NULL if it could not be allocated
+*/
+void* dwt_mem_reserve(opj_dwt_mem_t *mem, int size);
+/**
+Release the work memory of the inverse transforms
+@param mem Work memory filled by dwt_decode or dwt_decode_real
 */
-void dwt_decode_real(opj_tcd_tilecomp_t* tilec, int numres);
+void dwt_mem_free(opj_dwt_mem_t *mem);
 /**
 Get the gain of a subband for the irreversible 9-7 DWT.
 @param orient Number that identifies the subband (0->LL, 1->HL, 2->LH, 3->HH)
@@ -1558,7 +1558,10 @@ static void j2k_read_eoc(opj_j2k_t *j2k) {
 
 	/* if packets should be decoded */
 	if (j2k->cp->limit_decoding != DECODE_ALL_BUT_PACKETS) {
-		opj_tcd_t *tcd = tcd_create(j2k->cinfo);
+		opj_tcd_t *tcd = j2k->tcd;
+		if (!tcd) {
+			tcd = j2k->tcd = tcd_create(j2k->cinfo);
+		}
 		tcd_malloc_decode(tcd, j2k->image, j2k->cp);
 		for (i = 0; i < j2k->cp->tileno_size; i++) {
 			tcd_malloc_decode_tile(tcd, j2k->image, j2k->cp, i, j2k->cstr_info);
@@ -1569,11 +1572,13 @@ static void j2k_read_eoc(opj_j2k_t *j2k) {
 			tcd_free_decode_tile(tcd, i);
 			if (success == false) {
 				j2k->state |= J2K_STATE_ERR;
-				break;
+				/* a truncated codestream still decodes what it has of the other tiles */
+				if (!(j2k->state & J2K_STATE_NEOC)) {
+					break;
+				}
 			}
 		}
 		tcd_free_decode(tcd);
-		tcd_destroy(tcd);
 	}
 	/* if packets should not be decoded  */
 	else {
@@ -1730,27 +1735,40 @@ opj_j2k_t* j2k_create_decompress(opj_common_ptr cinfo) {
 	return j2k;
 }
 
-void j2k_destroy_decompress(opj_j2k_t *j2k) {
+/**
+Free what was read from the previous codestream (tile data, main and tile headers), 
+keeping the decoding parameters, so that the decompressor can decode another codestream
+@param j2k J2K decompressor handle
+*/
+static void j2k_free_decode_state(opj_j2k_t *j2k) {
 	int i = 0;
+	opj_cp_t *cp = j2k->cp;
 
-	if(j2k->tile_len != NULL) {
-		opj_free(j2k->tile_len);
-	}
 	if(j2k->tile_data != NULL) {
+		for(i = 0; cp && i < cp->tw * cp->th; i++) {
+			if(j2k->tile_data[i] != NULL) {
+				opj_free(j2k->tile_data[i]);
+			}
+		}
 		opj_free(j2k->tile_data);
+		j2k->tile_data = NULL;
+	}
+	if(j2k->tile_len != NULL) {
+		opj_free(j2k->tile_len);
+		j2k->tile_len = NULL;
 	}
 	if(j2k->default_tcp != NULL) {
 		opj_tcp_t *default_tcp = j2k->default_tcp;
 		if(default_tcp->ppt_data_first != NULL) {
 			opj_free(default_tcp->ppt_data_first);
 		}
-		if(j2k->default_tcp->tccps != NULL) {
-			opj_free(j2k->default_tcp->tccps);
+		if(default_tcp->tccps != NULL) {
+			opj_free(default_tcp->tccps);
 		}
-		opj_free(j2k->default_tcp);
+		memset(default_tcp, 0, sizeof(opj_tcp_t));
 	}
-	if(j2k->cp != NULL) {
-		opj_cp_t *cp = j2k->cp;
+	if(cp != NULL) {
+		opj_cp_t settings = *cp;
 		if(cp->tcps != NULL) {
 			for(i = 0; i < cp->tw * cp->th; i++) {
 				if(cp->tcps[i].ppt_data_first != NULL) {
@@ -1772,7 +1790,34 @@ void j2k_destroy_decompress(opj_j2k_t *j2k) {
 			opj_free(cp->comment);
 		}
 
-		opj_free(cp);
+		/* keep the parameters given to j2k_setup_decoder */
+		memset(cp, 0, sizeof(opj_cp_t));
+		cp->reduce = settings.reduce;
+		cp->layer = settings.layer;
+		cp->limit_decoding = settings.limit_decoding;
+		cp->out_buffer = settings.out_buffer;
+		cp->out_stride = settings.out_stride;
+		cp->out_size = settings.out_size;
+		cp->out_format = settings.out_format;
+		cp->stats = settings.stats;
+#ifdef USE_JPWL
+		cp->correct = settings.correct;
+		cp->exp_comps = settings.exp_comps;
+		cp->max_tiles = settings.max_tiles;
+#endif /* USE_JPWL */
+	}
+}
+
+void j2k_destroy_decompress(opj_j2k_t *j2k) {
+	j2k_free_decode_state(j2k);
+	if(j2k->default_tcp != NULL) {
+		opj_free(j2k->default_tcp);
+	}
+	if(j2k->cp != NULL) {
+		opj_free(j2k->cp);
+	}
+	if(j2k->tcd != NULL) {
+		tcd_destroy(j2k->tcd);
 	}
 	opj_free(j2k);
 }
@@ -1780,10 +1825,21 @@ void j2k_destroy_decompress(opj_j2k_t *j2k) {
 void j2k_setup_decoder(opj_j2k_t *j2k, opj_dparameters_t *parameters) {
 	if(j2k && parameters) {
 		/* create and initialize the coding parameters structure */
-		opj_cp_t *cp = (opj_cp_t*) opj_calloc(1, sizeof(opj_cp_t));
+		opj_cp_t *cp;
+		/* a decompressor may be set up again between two codestreams */
+		j2k_free_decode_state(j2k);
+		if(j2k->cp != NULL) {
+			opj_free(j2k->cp);
+		}
+		cp = (opj_cp_t*) opj_calloc(1, sizeof(opj_cp_t));
 		cp->reduce = parameters->cp_reduce;	
 		cp->layer = parameters->cp_layer;
 		cp->limit_decoding = parameters->cp_limit_decoding;
+		cp->out_buffer = parameters->out_buffer;
+		cp->out_stride = parameters->out_stride;
+		cp->out_size = parameters->out_size;
+		cp->out_format = parameters->out_format;
+		cp->stats = parameters->stats;
 
 #ifdef USE_JPWL
 		cp->correct = parameters->jpwl_correct;
@@ -1802,6 +1858,9 @@ opj_image_t* j2k_decode(opj_j2k_t *j2k, opj_cio_t *cio, opj_codestream_info_t *c
 
 	opj_common_ptr cinfo = j2k->cinfo;	
 
+	/* forget the previous codestream, if any */
+	j2k_free_decode_state(j2k);
+
 	j2k->cio = cio;
 	j2k->cstr_info = cstr_info;
 	if (cstr_info)
@@ -1815,7 +1874,15 @@ opj_image_t* j2k_decode(opj_j2k_t *j2k, opj_cio_t *cio, opj_codestream_info_t *c
 
 	for (;;) {
 		opj_dec_mstabent_t *e;
-		int id = cio_read(cio, 2);
+		int id;
+
+		/* the codestream stops between two tile-parts: decode what was received */
+		if (j2k->state == J2K_STATE_TPHSOT && cio_numbytesleft(cio) < 2) {
+			j2k->state = J2K_STATE_NEOC;
+			break;
+		}
+
+		id = cio_read(cio, 2);
 
 #ifdef USE_JPWL
 		/* we try to honor JPWL correction power */
@@ -1908,6 +1975,9 @@ opj_image_t* j2k_decode_jpt_stream(opj_j2k_t *j2k, opj_cio_t *cio,  opj_codestre
 
 	opj_common_ptr cinfo = j2k->cinfo;
 	
+	/* forget the previous codestream, if any */
+	j2k_free_decode_state(j2k);
+
 	j2k->cio = cio;
 
 	/* create an empty image */
@@ -228,6 +228,16 @@ typedef struct opj_cp {
 	int layer;
 	/** if == NO_LIMITATION, decode entire codestream; if == LIMIT_TO_MAIN_HEADER then only decode the main header */
 	OPJ_LIMIT_DECODING limit_decoding;
+	/** interleaved 8-bit buffer receiving the pixels, NULL to decode into the image components */
+	unsigned char *out_buffer;
+	/** distance in bytes between two rows of out_buffer */
+	int out_stride;
+	/** size in bytes of out_buffer */
+	int out_size;
+	/** channel order of out_buffer */
+	OPJ_PIXEL_FORMAT out_format;
+	/** decoder instrumentation, NULL if not requested */
+	opj_decode_stats_t *stats;
 	/** XTOsiz */
 	int tx0;
 	/** YTOsiz */
@@ -366,6 +376,11 @@ typedef struct opj_j2k {
 	opj_codestream_info_t *cstr_info;
 	/** pointer to the byte i/o stream */
 	opj_cio_t *cio;
+	/** 
+	decompression only : 
+	tile coder kept between images, so that its work memory is reused
+	*/
+	struct opj_tcd *tcd;
 } opj_j2k_t;
 
 /** @name Exported functions */
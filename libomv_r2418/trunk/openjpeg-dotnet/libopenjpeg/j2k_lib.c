@@ -44,16 +44,11 @@ double opj_clock(void) {
     QueryPerformanceCounter ( & t ) ;
     return ( t.QuadPart /(double) freq.QuadPart ) ;
 #else
-	/* Unix or Linux: use resource usage */
-    struct rusage t;
-    double procTime;
-    /* (1) Get the rusage data structure at this moment (man getrusage) */
-    getrusage(0,&t);
-    /* (2) What is the elapsed time ? - CPU time = User time + System time */
-	/* (2a) Get the seconds */
-    procTime = t.ru_utime.tv_sec + t.ru_stime.tv_sec;
-    /* (2b) More precisely! Get the microseconds part ! */
-    return ( procTime + (t.ru_utime.tv_usec + t.ru_stime.tv_usec) * 1e-6 ) ;
+	/* Unix or Linux: use the wall clock like WIN32, the CPU time of the 
+	process (getrusage) adds up the time of every decoding thread */
+    struct timeval t;
+    gettimeofday(&t, NULL);
+    return ( t.tv_sec + t.tv_usec * 1e-6 ) ;
 #endif
 }
 
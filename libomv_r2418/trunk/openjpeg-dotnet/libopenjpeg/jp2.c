@@ -153,6 +153,9 @@ static bool jp2_read_ihdr(opj_jp2_t *jp2, opj_cio_t *cio) {
 	jp2->h = cio_read(cio, 4);			/* HEIGHT */
 	jp2->w = cio_read(cio, 4);			/* WIDTH */
 	jp2->numcomps = cio_read(cio, 2);	/* NC */
+	if (jp2->comps) {	/* left by a previous codestream */
+		opj_free(jp2->comps);
+	}
 	jp2->comps = (opj_jp2_comps_t*) opj_malloc(jp2->numcomps * sizeof(opj_jp2_comps_t));
 
 	jp2->bpc = cio_read(cio, 1);		/* BPC */
@@ -390,6 +393,9 @@ static bool jp2_read_ftyp(opj_jp2_t *jp2, opj_cio_t *cio) {
 	jp2->brand = cio_read(cio, 4);		/* BR */
 	jp2->minversion = cio_read(cio, 4);	/* MinV */
 	jp2->numcl = (box.length - 16) / 4;
+	if (jp2->cl) {	/* left by a previous codestream */
+		opj_free(jp2->cl);
+	}
 	jp2->cl = (unsigned int *) opj_malloc(jp2->numcl * sizeof(unsigned int));
 
 	for (i = 0; i < (int)jp2->numcl; i++) {
@@ -29,6 +29,10 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "opj_includes.h"
 
 /* <summary> */
@@ -146,3 +150,137 @@ void mct_decode_real(
 double mct_getnorm_real(int compno) {
 	return mct_norms_real[compno];
 }
+
+#ifdef __SSE2__
+/* <summary> */
+/* Clamp 4 pixels to [0, 255] and store them interleaved. */
+/* </summary> */
+static INLINE void mct_store_rgba(__m128i r, __m128i g, __m128i b, __m128i a, unsigned char* dst) {
+	/* the saturating packs do the clamping */
+	__m128i x = _mm_packus_epi16(_mm_packs_epi32(r, b), _mm_packs_epi32(g, a));	/* r0-3 b0-3 g0-3 a0-3 */
+	x = _mm_unpacklo_epi8(x, _mm_srli_si128(x, 8));		/* r0 g0 r1 g1 r2 g2 r3 g3 b0 a0 b1 a1 ... */
+	x = _mm_unpacklo_epi16(x, _mm_srli_si128(x, 8));	/* r0 g0 b0 a0 r1 g1 b1 a1 ... */
+	_mm_storeu_si128((__m128i*)dst, x);
+}
+#endif
+
+/* <summary> */
+/* Inverse reversible MCT, DC level shift and interleave of a row. */
+/* </summary> */
+void mct_decode_rgba(
+		int* restrict c0,
+		int* restrict c1,
+		int* restrict c2,
+		int* restrict c3,
+		int n,
+		int mct,
+		int bgra,
+		unsigned char* restrict dst)
+{
+	int i = 0;
+	int ri = bgra ? 2 : 0;
+	int bi = bgra ? 0 : 2;
+#ifdef __SSE2__
+	const __m128i shift = _mm_set1_epi32(128);
+	const __m128i opaque = _mm_set1_epi32(255);
+	for (; i + 4 <= n; i += 4) {
+		__m128i r = _mm_loadu_si128((const __m128i*)&c0[i]);
+		__m128i g = _mm_loadu_si128((const __m128i*)&c1[i]);
+		__m128i b = _mm_loadu_si128((const __m128i*)&c2[i]);
+		__m128i a = c3 ? _mm_add_epi32(_mm_loadu_si128((const __m128i*)&c3[i]), shift) : opaque;
+		if (mct) {
+			__m128i y = r, u = g, v = b;
+			g = _mm_sub_epi32(y, _mm_srai_epi32(_mm_add_epi32(u, v), 2));
+			r = _mm_add_epi32(v, g);
+			b = _mm_add_epi32(u, g);
+		}
+		r = _mm_add_epi32(r, shift);
+		g = _mm_add_epi32(g, shift);
+		b = _mm_add_epi32(b, shift);
+		if (bgra) {
+			mct_store_rgba(b, g, r, a, &dst[i * 4]);
+		} else {
+			mct_store_rgba(r, g, b, a, &dst[i * 4]);
+		}
+	}
+#endif
+	for (; i < n; ++i) {
+		int r = c0[i];
+		int g = c1[i];
+		int b = c2[i];
+		if (mct) {
+			int y = r, u = g, v = b;
+			g = y - ((u + v) >> 2);
+			r = v + g;
+			b = u + g;
+		}
+		dst[i * 4 + ri] = (unsigned char) int_clamp(r + 128, 0, 255);
+		dst[i * 4 + 1] = (unsigned char) int_clamp(g + 128, 0, 255);
+		dst[i * 4 + bi] = (unsigned char) int_clamp(b + 128, 0, 255);
+		dst[i * 4 + 3] = c3 ? (unsigned char) int_clamp(c3[i] + 128, 0, 255) : 255;
+	}
+}
+
+/* <summary> */
+/* Inverse irreversible MCT, rounding, DC level shift and interleave of a row. */
+/* </summary> */
+void mct_decode_real_rgba(
+		float* restrict c0,
+		float* restrict c1,
+		float* restrict c2,
+		float* restrict c3,
+		int n,
+		int mct,
+		int bgra,
+		unsigned char* restrict dst)
+{
+	int i = 0;
+	int ri = bgra ? 2 : 0;
+	int bi = bgra ? 0 : 2;
+#ifdef __SSE2__
+	const __m128i shift = _mm_set1_epi32(128);
+	const __m128i opaque = _mm_set1_epi32(255);
+	const __m128 kr = _mm_set1_ps(1.402f);
+	const __m128 kgu = _mm_set1_ps(0.34413f);
+	const __m128 kgv = _mm_set1_ps(0.71414f);
+	const __m128 kb = _mm_set1_ps(1.772f);
+	for (; i + 4 <= n; i += 4) {
+		__m128 r = _mm_loadu_ps(&c0[i]);
+		__m128 g = _mm_loadu_ps(&c1[i]);
+		__m128 b = _mm_loadu_ps(&c2[i]);
+		__m128i ir, ig, ib;
+		__m128i a = c3 ? _mm_add_epi32(_mm_cvtps_epi32(_mm_loadu_ps(&c3[i])), shift) : opaque;
+		if (mct) {
+			/* same operations, in the same order, as mct_decode_real */
+			__m128 y = r, u = g, v = b;
+			r = _mm_add_ps(y, _mm_mul_ps(v, kr));
+			g = _mm_sub_ps(_mm_sub_ps(y, _mm_mul_ps(u, kgu)), _mm_mul_ps(v, kgv));
+			b = _mm_add_ps(y, _mm_mul_ps(u, kb));
+		}
+		/* cvtps rounds to nearest like lrintf */
+		ir = _mm_add_epi32(_mm_cvtps_epi32(r), shift);
+		ig = _mm_add_epi32(_mm_cvtps_epi32(g), shift);
+		ib = _mm_add_epi32(_mm_cvtps_epi32(b), shift);
+		if (bgra) {
+			mct_store_rgba(ib, ig, ir, a, &dst[i * 4]);
+		} else {
+			mct_store_rgba(ir, ig, ib, a, &dst[i * 4]);
+		}
+	}
+#endif
+	for (; i < n; ++i) {
+		float r = c0[i];
+		float g = c1[i];
+		float b = c2[i];
+		if (mct) {
+			float y = r, u = g, v = b;
+			r = y + (v * 1.402f);
+			g = y - (u * 0.34413f) - (v * (0.71414f));
+			b = y + (u * 1.772f);
+		}
+		dst[i * 4 + ri] = (unsigned char) int_clamp(lrintf(r) + 128, 0, 255);
+		dst[i * 4 + 1] = (unsigned char) int_clamp(lrintf(g) + 128, 0, 255);
+		dst[i * 4 + bi] = (unsigned char) int_clamp(lrintf(b) + 128, 0, 255);
+		dst[i * 4 + 3] = c3 ? (unsigned char) int_clamp(lrintf(c3[i]) + 128, 0, 255) : 255;
+	}
+}
@@ -90,6 +90,33 @@ Get norm of the basis function used for the irreversible multi-component transfo
 @return 
 */
 double mct_getnorm_real(int compno);
+/**
+Apply the reversible multi-component inverse transform (if mct is set) to a row of 8-bit samples,
+shift them to unsigned, clamp them and store them interleaved as RGBA/BGRA
+@param c0 Samples for luminance (or red) component
+@param c1 Samples for red chrominance (or green) component
+@param c2 Samples for blue chrominance (or blue) component
+@param c3 Samples for alpha component, NULL for opaque pixels
+@param n Number of samples in the row
+@param mct Apply the inverse transform if non zero
+@param bgra Store blue first instead of red if non zero
+@param dst Destination of the n interleaved pixels
+*/
+void mct_decode_rgba(int *c0, int *c1, int *c2, int *c3, int n, int mct, int bgra, unsigned char *dst);
+/**
+Apply the irreversible multi-component inverse transform (if mct is set) to a row of 8-bit samples,
+round them, shift them to unsigned, clamp them and store them interleaved as RGBA/BGRA.
+The result is the same as mct_decode_real followed by the conversion done in tcd_decode_tile.
+@param c0 Samples for luminance (or red) component
+@param c1 Samples for red chrominance (or green) component
+@param c2 Samples for blue chrominance (or blue) component
+@param c3 Samples for alpha component, NULL for opaque pixels
+@param n Number of samples in the row
+@param mct Apply the inverse transform if non zero
+@param bgra Store blue first instead of red if non zero
+@param dst Destination of the n interleaved pixels
+*/
+void mct_decode_real_rgba(float *c0, float *c1, float *c2, float *c3, int n, int mct, int bgra, unsigned char *dst);
 /* ----------------------------------------------------------------------- */
 /*@}*/
 
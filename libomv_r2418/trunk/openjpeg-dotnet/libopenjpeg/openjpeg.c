@@ -152,20 +152,119 @@ opj_image_t* OPJ_CALLCONV opj_decode(opj_dinfo_t *dinfo, opj_cio_t *cio) {
 }
 
 opj_image_t* OPJ_CALLCONV opj_decode_with_info(opj_dinfo_t *dinfo, opj_cio_t *cio, opj_codestream_info_t *cstr_info) {
+	opj_image_t *image = NULL;
+	opj_cp_t *cp = NULL;
+	opj_decode_stats_t *stats = NULL;
+	double total_time = opj_clock();
+	int start = 0;
+
 	if(dinfo && cio) {
+		start = cio_tell(cio);
 		switch(dinfo->codec_format) {
 			case CODEC_J2K:
-				return j2k_decode((opj_j2k_t*)dinfo->j2k_handle, cio, cstr_info);
+				image = j2k_decode((opj_j2k_t*)dinfo->j2k_handle, cio, cstr_info);
+				cp = ((opj_j2k_t*)dinfo->j2k_handle)->cp;
+				break;
 			case CODEC_JPT:
-				return j2k_decode_jpt_stream((opj_j2k_t*)dinfo->j2k_handle, cio, cstr_info);
+				image = j2k_decode_jpt_stream((opj_j2k_t*)dinfo->j2k_handle, cio, cstr_info);
+				cp = ((opj_j2k_t*)dinfo->j2k_handle)->cp;
+				break;
 			case CODEC_JP2:
-				return jp2_decode((opj_jp2_t*)dinfo->jp2_handle, cio, cstr_info);
+				image = jp2_decode((opj_jp2_t*)dinfo->jp2_handle, cio, cstr_info);
+				cp = ((opj_jp2_t*)dinfo->jp2_handle)->j2k->cp;
+				break;
 			case CODEC_UNKNOWN:
 			default:
 				break;
 		}
 	}
-	return NULL;
+	stats = cp ? cp->stats : NULL;
+	if(stats) {
+		stats->images++;
+		stats->codestream_bytes += cio_tell(cio) - start;
+		stats->total_time += opj_clock() - total_time;
+	}
+	return image;
+}
+
+typedef struct opj_decode_batch_job {
+	/** one decompressor per thread of the pool */
+	opj_dinfo_t **dinfos;
+	unsigned char **buffers;
+	int *lengths;
+	opj_image_t **images;
+} opj_decode_batch_job_t;
+
+static void opj_decode_batch_job(void *user_data, int jobno, int slot) {
+	opj_decode_batch_job_t *job = (opj_decode_batch_job_t*) user_data;
+	opj_cio_t *cio = opj_cio_open((opj_common_ptr)job->dinfos[slot], job->buffers[jobno], job->lengths[jobno]);
+
+	job->images[jobno] = NULL;
+	if (cio) {
+		job->images[jobno] = opj_decode(job->dinfos[slot], cio);
+		opj_cio_close(cio);
+	}
+}
+
+int OPJ_CALLCONV opj_decode_batch(OPJ_CODEC_FORMAT format, opj_dparameters_t *parameters, opj_event_mgr_t *event_mgr, void *context, 
+								  unsigned char **buffers, int *lengths, opj_image_t **images, int count) {
+	opj_thread_pool_t *pool;
+	opj_decode_batch_job_t job;
+	opj_dparameters_t batch_parameters;
+	int numslots, slotno, i, decoded = 0;
+
+	if (!parameters || !buffers || !lengths || !images || count <= 0) {
+		return 0;
+	}
+
+	/* the images of a batch cannot share an output buffer */
+	batch_parameters = *parameters;
+	batch_parameters.out_buffer = NULL;
+	batch_parameters.out_stride = 0;
+	batch_parameters.out_size = 0;
+	batch_parameters.stats = NULL;
+
+	pool = opj_thread_pool_acquire();
+	numslots = opj_thread_pool_size(pool);
+	job.dinfos = (opj_dinfo_t**) opj_calloc(numslots, sizeof(opj_dinfo_t*));
+	if (!job.dinfos) {
+		opj_thread_pool_release(pool);
+		return 0;
+	}
+	for (slotno = 0; slotno < numslots; slotno++) {
+		job.dinfos[slotno] = opj_create_decompress(format);
+		if (!job.dinfos[slotno]) {
+			break;
+		}
+		opj_set_event_mgr((opj_common_ptr)job.dinfos[slotno], event_mgr, context);
+		opj_setup_decoder(job.dinfos[slotno], &batch_parameters);
+	}
+
+	if (slotno == numslots) {
+		job.buffers = buffers;
+		job.lengths = lengths;
+		job.images = images;
+		/* each codestream is decoded by the decompressor of the thread running it, 
+		which keeps its work memory from one codestream to the next */
+		opj_thread_pool_run(pool, opj_decode_batch_job, &job, count);
+		for (i = 0; i < count; i++) {
+			if (images[i]) {
+				decoded++;
+			}
+		}
+	} else {
+		for (i = 0; i < count; i++) {
+			images[i] = NULL;
+		}
+	}
+
+	for (slotno = 0; slotno < numslots; slotno++) {
+		opj_destroy_decompress(job.dinfos[slotno]);
+	}
+	opj_free(job.dinfos);
+	opj_thread_pool_release(pool);
+
+	return decoded;
 }
 
 opj_cinfo_t* OPJ_CALLCONV opj_create_compress(OPJ_CODEC_FORMAT format) {
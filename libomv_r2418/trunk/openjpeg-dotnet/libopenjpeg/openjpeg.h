@@ -172,6 +172,14 @@ typedef enum LIMIT_DECODING {
 	DECODE_ALL_BUT_PACKETS = 2	/**< Decode everything except the JPEG 2000 packets */
 } OPJ_LIMIT_DECODING;
 
+/**
+Channel order of an interleaved 8-bit output buffer (see opj_dparameters_t::out_buffer)
+*/
+typedef enum PIXEL_FORMAT {
+	PIXFMT_RGBA = 0,	/**< red, green, blue, alpha */
+	PIXFMT_BGRA = 1		/**< blue, green, red, alpha */
+} OPJ_PIXEL_FORMAT;
+
 /* 
 ==========================================================
    event manager typedef definitions
@@ -367,6 +375,38 @@ typedef struct opj_cparameters {
 	char tcp_mct;
 } opj_cparameters_t;
 
+/**
+Time spent and work done by each stage of the decoder (see opj_dparameters_t::stats).
+Times are wall clock seconds. With several decoding threads, tier-1 and DWT times
+are the time the tile waited for all threads, not the sum of the threads' times.
+*/
+typedef struct opj_decode_stats {
+	/** number of codestreams decoded */
+	int images;
+	/** number of tiles decoded */
+	int tiles;
+	/** codestream bytes read, headers included */
+	int codestream_bytes;
+	/** packet bytes read by tier-2 */
+	int t2_bytes;
+	/** number of code-blocks decoded by tier-1 (code-blocks without data are not counted) */
+	int t1_cblks;
+	/** number of coding passes decoded by tier-1 */
+	int t1_passes;
+	/** number of samples produced by the DWT, summed over the components */
+	double samples;
+	/** total time spent in opj_decode */
+	double total_time;
+	/** time spent reading packet headers and code-block data (tier-2) */
+	double t2_time;
+	/** time spent decoding code-blocks (tier-1) */
+	double t1_time;
+	/** time spent in the inverse wavelet transform */
+	double dwt_time;
+	/** time spent in the inverse MCT, DC level shift and copy to the image or output buffer */
+	double mct_time;
+} opj_decode_stats_t;
+
 /**
 Decompression parameters
 */
@@ -419,6 +459,29 @@ typedef struct opj_dparameters {
 	*/
 	OPJ_LIMIT_DECODING cp_limit_decoding;
 
+	/**
+	Interleaved 8-bit buffer receiving the decoded pixels, or NULL to keep them in the image components.
+	The inverse MCT, DC level shift, clamping and interleaving are then done in a single pass, and the
+	components of the decoded image are returned without data.
+	A single component is written as grey, two as grey and alpha, three as RGB with an opaque alpha.
+	The buffer is only used for 8-bit unsigned components without subsampling and when it is large
+	enough for the (reduced) image; otherwise the image components are decoded as usual.
+	*/
+	unsigned char *out_buffer;
+	/** distance in bytes between two rows of out_buffer */
+	int out_stride;
+	/** size in bytes of out_buffer */
+	int out_size;
+	/** channel order of out_buffer */
+	OPJ_PIXEL_FORMAT out_format;
+
+	/**
+	Optional instrumentation, NULL by default. When set, each decode adds its timings and counters
+	to the structure, which the caller zeroes first. A structure must not be shared by decompressors 
+	running at the same time.
+	*/
+	opj_decode_stats_t *stats;
+
 } opj_dparameters_t;
 
 /** Common fields between JPEG-2000 compression and decompression master structs. */
@@ -820,12 +883,16 @@ OPJ_API void OPJ_CALLCONV opj_set_default_decoder_parameters(opj_dparameters_t *
 /**
 Setup the decoder decoding parameters using user parameters.
 Decoding parameters are returned in j2k->cp. 
+A decompressor can be set up again between two calls to opj_decode.
 @param dinfo decompressor handle
 @param parameters decompression parameters
 */
 OPJ_API void OPJ_CALLCONV opj_setup_decoder(opj_dinfo_t *dinfo, opj_dparameters_t *parameters);
 /**
-Decode an image from a JPEG-2000 codestream 
+Decode an image from a JPEG-2000 codestream. 
+A decompressor can decode several codestreams in turn: the work memory of the tile coder 
+(T1 contexts, DWT buffers, tile samples) is kept from one codestream to the next 
+and released by opj_destroy_decompress.
 @param dinfo decompressor handle
 @param cio Input buffer stream
 @return Returns a decoded image if successful, returns NULL otherwise
@@ -841,6 +908,34 @@ Decode an image from a JPEG-2000 codestream and extract the codestream informati
 */
 OPJ_API opj_image_t* OPJ_CALLCONV opj_decode_with_info(opj_dinfo_t *dinfo, opj_cio_t *cio, opj_codestream_info_t *cstr_info);
 /**
+Decode several codestreams at once, spread over the threads set with opj_set_num_threads. 
+Each thread decodes its codestreams with its own decompressor, reused from one codestream to the next.
+@param format Decoder to select
+@param parameters Decompression parameters, common to all codestreams (out_buffer and stats are ignored)
+@param event_mgr Event handler shared by the decompressors, NULL for no messages. It may be called from several threads at once.
+@param context Context passed to the event handler
+@param buffers Codestreams to decode
+@param lengths Length of each codestream
+@param images Returns the decoded image of each codestream, NULL if it could not be decoded
+@param count Number of codestreams
+@return Returns the number of codestreams decoded
+*/
+OPJ_API int OPJ_CALLCONV opj_decode_batch(OPJ_CODEC_FORMAT format, opj_dparameters_t *parameters, opj_event_mgr_t *event_mgr, void *context, 
+										  unsigned char **buffers, int *lengths, opj_image_t **images, int count);
+/**
+Set the number of threads used to decode code-blocks and tile-components.
+The setting is shared by every decompressor of the process. Decodes already running 
+finish on the previous setting.
+@param num_threads Number of threads, including the thread calling opj_decode. 
+0 or 1 (default) decodes everything on the calling thread.
+*/
+OPJ_API void OPJ_CALLCONV opj_set_num_threads(int num_threads);
+/**
+Get the number of threads used for decoding
+@return Returns the number of threads set with opj_set_num_threads, 1 if decoding is single threaded
+*/
+OPJ_API int OPJ_CALLCONV opj_get_num_threads(void);
+/**
 Creates a J2K/JP2 compression structure
 @param format Coder to select
 @return Returns a handle to a compressor if successful, returns NULL otherwise
@@ -97,6 +97,7 @@ static INLINE long lrintf(float f){
 #include "opj_malloc.h"
 #include "event.h"
 #include "cio.h"
+#include "thread.h"
 
 #include "image.h"
 #include "j2k.h"
@@ -217,6 +217,26 @@ static void t1_decode_cblk(
 		int orient,
 		int roishift,
 		int cblksty);
+/**
+Decode 1 code-block and store its coefficients in the tile-component
+@param t1 T1 handle
+@param tilec Tile-component the code-block belongs to
+@param resno Resolution level of the code-block
+@param band Sub-band of the code-block
+@param cblk Code-block to decode
+@param tccp Tile-component coding parameters
+*/
+static void t1_decode_cblk_tile(
+		opj_t1_t *t1,
+		opj_tcd_tilecomp_t* tilec,
+		int resno,
+		opj_tcd_band_t* band,
+		opj_tcd_cblk_dec_t* cblk,
+		opj_tccp_t* tccp);
+/**
+Thread pool job decoding one code-block (see t1_decode_cblks_mt)
+*/
+static void t1_decode_cblk_job(void *user_data, int jobno, int slot);
 
 /*@}*/
 
@@ -953,7 +973,7 @@ static void t1_decode_cblk(
 	mqc_setstate(mqc, T1_CTXNO_AGG, 0, 3);
 	mqc_setstate(mqc, T1_CTXNO_ZC, 0, 4);
 	
-	for (segno = 0; segno < cblk->numsegs; ++segno) {
+	for (segno = 0; segno < cblk->real_num_segs; ++segno) {
 		opj_tcd_seg_t *seg = &cblk->segs[segno];
 		
 		/* BYPASS mode */
@@ -968,7 +988,7 @@ static void t1_decode_cblk(
 			mqc_init_dec(mqc, (*seg->data) + seg->dataindex, seg->len);
 		}
 		
-		for (passno = 0; passno < seg->numpasses; ++passno) {
+		for (passno = 0; passno < seg->real_num_passes; ++passno) {
 			switch (passtype) {
 				case 0:
 					t1_dec_sigpass(t1, bpno+1, orient, type, cblksty);
@@ -1119,6 +1139,85 @@ void t1_encode_cblks(
 	} /* compno  */
 }
 
+static void t1_decode_cblk_tile(
+		opj_t1_t *t1,
+		opj_tcd_tilecomp_t* tilec,
+		int resno,
+		opj_tcd_band_t* band,
+		opj_tcd_cblk_dec_t* cblk,
+		opj_tccp_t* tccp)
+{
+	int* restrict datap;
+	void* restrict tiledp;
+	int cblk_w, cblk_h;
+	int x, y;
+	int i, j;
+
+	int tile_w = tilec->x1 - tilec->x0;
+
+	/* resolutions discarded by cp_reduce are not needed by the DWT */
+	if (resno >= tilec->minimum_num_resolutions) {
+		opj_free(cblk->data);
+		opj_free(cblk->segs);
+		return;
+	}
+
+	t1_decode_cblk(
+			t1,
+			cblk,
+			band->bandno,
+			tccp->roishift,
+			tccp->cblksty);
+
+	x = cblk->x0 - band->x0;
+	y = cblk->y0 - band->y0;
+	if (band->bandno & 1) {
+		opj_tcd_resolution_t* pres = &tilec->resolutions[resno - 1];
+		x += pres->x1 - pres->x0;
+	}
+	if (band->bandno & 2) {
+		opj_tcd_resolution_t* pres = &tilec->resolutions[resno - 1];
+		y += pres->y1 - pres->y0;
+	}
+
+	datap=t1->data;
+	cblk_w = t1->w;
+	cblk_h = t1->h;
+
+	if (tccp->roishift) {
+		int thresh = 1 << tccp->roishift;
+		for (j = 0; j < cblk_h; ++j) {
+			for (i = 0; i < cblk_w; ++i) {
+				int val = datap[(j * cblk_w) + i];
+				int mag = abs(val);
+				if (mag >= thresh) {
+					mag >>= tccp->roishift;
+					datap[(j * cblk_w) + i] = val < 0 ? -mag : mag;
+				}
+			}
+		}
+	}
+
+	tiledp=(void*)&tilec->data[(y * tile_w) + x];
+	if (tccp->qmfbid == 1) {
+		for (j = 0; j < cblk_h; ++j) {
+			for (i = 0; i < cblk_w; ++i) {
+				int tmp = datap[(j * cblk_w) + i];
+				((int*)tiledp)[(j * tile_w) + i] = tmp / 2;
+			}
+		}
+	} else {		/* if (tccp->qmfbid == 0) */
+		for (j = 0; j < cblk_h; ++j) {
+			for (i = 0; i < cblk_w; ++i) {
+				float tmp = datap[(j * cblk_w) + i] * band->stepsize;
+				((float*)tiledp)[(j * tile_w) + i] = tmp;
+			}
+		}
+	}
+	opj_free(cblk->data);
+	opj_free(cblk->segs);
+}
+
 void t1_decode_cblks(
 		opj_t1_t* t1,
 		opj_tcd_tilecomp_t* tilec,
@@ -1126,8 +1225,6 @@ void t1_decode_cblks(
 {
 	int resno, bandno, precno, cblkno;
 
-	int tile_w = tilec->x1 - tilec->x0;
-
 	for (resno = 0; resno < tilec->numresolutions; ++resno) {
 		opj_tcd_resolution_t* res = &tilec->resolutions[resno];
 
@@ -1138,67 +1235,13 @@ void t1_decode_cblks(
 				opj_tcd_precinct_t* precinct = &band->precincts[precno];
 
 				for (cblkno = 0; cblkno < precinct->cw * precinct->ch; ++cblkno) {
-					opj_tcd_cblk_dec_t* cblk = &precinct->cblks.dec[cblkno];
-					int* restrict datap;
-					void* restrict tiledp;
-					int cblk_w, cblk_h;
-					int x, y;
-					int i, j;
-
-					t1_decode_cblk(
+					t1_decode_cblk_tile(
 							t1,
-							cblk,
-							band->bandno,
-							tccp->roishift,
-							tccp->cblksty);
-
-					x = cblk->x0 - band->x0;
-					y = cblk->y0 - band->y0;
-					if (band->bandno & 1) {
-						opj_tcd_resolution_t* pres = &tilec->resolutions[resno - 1];
-						x += pres->x1 - pres->x0;
-					}
-					if (band->bandno & 2) {
-						opj_tcd_resolution_t* pres = &tilec->resolutions[resno - 1];
-						y += pres->y1 - pres->y0;
-					}
-
-					datap=t1->data;
-					cblk_w = t1->w;
-					cblk_h = t1->h;
-
-					if (tccp->roishift) {
-						int thresh = 1 << tccp->roishift;
-						for (j = 0; j < cblk_h; ++j) {
-							for (i = 0; i < cblk_w; ++i) {
-								int val = datap[(j * cblk_w) + i];
-								int mag = abs(val);
-								if (mag >= thresh) {
-									mag >>= tccp->roishift;
-									datap[(j * cblk_w) + i] = val < 0 ? -mag : mag;
-								}
-							}
-						}
-					}
-
-					tiledp=(void*)&tilec->data[(y * tile_w) + x];
-					if (tccp->qmfbid == 1) {
-						for (j = 0; j < cblk_h; ++j) {
-							for (i = 0; i < cblk_w; ++i) {
-								int tmp = datap[(j * cblk_w) + i];
-								((int*)tiledp)[(j * tile_w) + i] = tmp / 2;
-							}
-						}
-					} else {		/* if (tccp->qmfbid == 0) */
-						for (j = 0; j < cblk_h; ++j) {
-							for (i = 0; i < cblk_w; ++i) {
-								float tmp = datap[(j * cblk_w) + i] * band->stepsize;
-								((float*)tiledp)[(j * tile_w) + i] = tmp;
-							}
-						}
-					}
-					opj_free(cblk->data);
-					opj_free(cblk->segs);
+							tilec,
+							resno,
+							band,
+							&precinct->cblks.dec[cblkno],
+							tccp);
 				} /* cblkno */
 				opj_free(precinct->cblks.dec);
 			} /* precno */
@@ -1206,3 +1249,117 @@ void t1_decode_cblks(
 	} /* resno */
 }
 
+/* ----------------------------------------------------------------------- */
+
+/**
+Code-block decoding job, one per code-block of the tile
+*/
+typedef struct opj_t1_job {
+	opj_tcd_tilecomp_t* tilec;
+	opj_tccp_t* tccp;
+	opj_tcd_band_t* band;
+	opj_tcd_cblk_dec_t* cblk;
+	int resno;
+} opj_t1_job_t;
+
+/**
+Code-block jobs of a tile and the T1 handles of the threads running them
+*/
+typedef struct opj_t1_batch {
+	opj_t1_job_t* jobs;
+	opj_t1_t** t1s;
+} opj_t1_batch_t;
+
+static void t1_decode_cblk_job(void *user_data, int jobno, int slot) {
+	opj_t1_batch_t *batch = (opj_t1_batch_t*) user_data;
+	opj_t1_job_t *job = &batch->jobs[jobno];
+
+	t1_decode_cblk_tile(
+			batch->t1s[slot],
+			job->tilec,
+			job->resno,
+			job->band,
+			job->cblk,
+			job->tccp);
+}
+
+bool t1_decode_cblks_mt(
+		opj_thread_pool_t* pool,
+		opj_t1_t** t1s,
+		opj_tcd_tile_t* tile,
+		opj_tcp_t* tcp)
+{
+	int compno, resno, bandno, precno, cblkno;
+	int numjobs = 0;
+	opj_t1_batch_t batch;
+
+	for (compno = 0; compno < tile->numcomps; ++compno) {
+		opj_tcd_tilecomp_t* tilec = &tile->comps[compno];
+		for (resno = 0; resno < tilec->minimum_num_resolutions; ++resno) {
+			opj_tcd_resolution_t* res = &tilec->resolutions[resno];
+			for (bandno = 0; bandno < res->numbands; ++bandno) {
+				opj_tcd_band_t* band = &res->bands[bandno];
+				for (precno = 0; precno < res->pw * res->ph; ++precno) {
+					opj_tcd_precinct_t* precinct = &band->precincts[precno];
+					numjobs += precinct->cw * precinct->ch;
+				}
+			}
+		}
+	}
+
+	batch.jobs = (opj_t1_job_t*) opj_malloc(int_max(numjobs, 1) * sizeof(opj_t1_job_t));
+	if (!batch.jobs) {
+		return false;
+	}
+	/* each thread uses its own MQC/RAW state and data/flags scratch buffers */
+	batch.t1s = t1s;
+
+	/* code-blocks write to disjoint areas of their tile-component, so they can be decoded in any order */
+	numjobs = 0;
+	for (compno = 0; compno < tile->numcomps; ++compno) {
+		opj_tcd_tilecomp_t* tilec = &tile->comps[compno];
+		for (resno = 0; resno < tilec->minimum_num_resolutions; ++resno) {
+			opj_tcd_resolution_t* res = &tilec->resolutions[resno];
+			for (bandno = 0; bandno < res->numbands; ++bandno) {
+				opj_tcd_band_t* band = &res->bands[bandno];
+				for (precno = 0; precno < res->pw * res->ph; ++precno) {
+					opj_tcd_precinct_t* precinct = &band->precincts[precno];
+					for (cblkno = 0; cblkno < precinct->cw * precinct->ch; ++cblkno) {
+						opj_t1_job_t* job = &batch.jobs[numjobs++];
+						job->tilec = tilec;
+						job->tccp = &tcp->tccps[compno];
+						job->band = band;
+						job->cblk = &precinct->cblks.dec[cblkno];
+						job->resno = resno;
+					}
+				}
+			}
+		}
+	}
+
+	opj_thread_pool_run(pool, t1_decode_cblk_job, &batch, numjobs);
+	opj_free(batch.jobs);
+
+	for (compno = 0; compno < tile->numcomps; ++compno) {
+		opj_tcd_tilecomp_t* tilec = &tile->comps[compno];
+		for (resno = 0; resno < tilec->numresolutions; ++resno) {
+			opj_tcd_resolution_t* res = &tilec->resolutions[resno];
+			for (bandno = 0; bandno < res->numbands; ++bandno) {
+				opj_tcd_band_t* band = &res->bands[bandno];
+				for (precno = 0; precno < res->pw * res->ph; ++precno) {
+					opj_tcd_precinct_t* precinct = &band->precincts[precno];
+					if (resno >= tilec->minimum_num_resolutions) {
+						/* discarded resolutions were not queued, release their code-blocks here */
+						for (cblkno = 0; cblkno < precinct->cw * precinct->ch; ++cblkno) {
+							opj_free(precinct->cblks.dec[cblkno].data);
+							opj_free(precinct->cblks.dec[cblkno].segs);
+						}
+					}
+					opj_free(precinct->cblks.dec);
+				}
+			}
+		}
+	}
+
+	return true;
+}
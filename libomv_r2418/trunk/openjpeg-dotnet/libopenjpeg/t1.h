@@ -133,12 +133,23 @@ Encode the code-blocks of a tile
 */
 void t1_encode_cblks(opj_t1_t *t1, opj_tcd_tile_t *tile, opj_tcp_t *tcp);
 /**
-Decode the code-blocks of a tile
+Decode the code-blocks of a tile.
+Code-blocks of the resolutions beyond tilec->minimum_num_resolutions are released without being decoded.
 @param t1 T1 handle
 @param tile The tile to decode
 @param tcp Tile coding parameters
 */
 void t1_decode_cblks(opj_t1_t* t1, opj_tcd_tilecomp_t* tilec, opj_tccp_t* tccp);
+/**
+Decode the code-blocks of every component of a tile on a thread pool.
+The result is identical to calling t1_decode_cblks on each component.
+@param pool Thread pool running the code-blocks
+@param t1s One T1 handle per thread of the pool
+@param tile The tile to decode
+@param tcp Tile coding parameters
+@return Returns false if the job list could not be allocated, in which case nothing was decoded
+*/
+bool t1_decode_cblks_mt(opj_thread_pool_t* pool, opj_t1_t** t1s, opj_tcd_tile_t* tile, opj_tcp_t* tcp);
 /* ----------------------------------------------------------------------- */
 /*@}*/
 
@@ -65,6 +65,13 @@ static int t2_encode_packet(opj_tcd_tile_t *tile, opj_tcp_t *tcp, opj_pi_iterato
 */
 static void t2_init_seg(opj_tcd_cblk_dec_t* cblk, int index, int cblksty, int first);
 /**
+Check whether a resolution level is discarded in every component of a tile
+@param tile Tile being decoded
+@param resno Resolution level
+@return Returns true if resno is not decoded in any component
+*/
+static bool t2_all_resolutions_skipped(opj_tcd_tile_t *tile, int resno);
+/**
 Decode a packet of a tile from a source buffer
 @param t2 T2 handle
 @param src Source buffer
@@ -72,10 +79,12 @@ Decode a packet of a tile from a source buffer
 @param tile Tile for which to write the packets
 @param tcp Tile coding parameters
 @param pi Packet identity
+@param skip When true, the packet header is read to keep the code-block state up to date but the
+packet body is only stepped over: its data is neither copied nor decoded (discarded layers and resolutions)
 @return 
 */
 static int t2_decode_packet(opj_t2_t* t2, unsigned char *src, int len, opj_tcd_tile_t *tile, 
-														opj_tcp_t *tcp, opj_pi_iterator_t *pi, opj_packet_info_t *pack_info);
+														opj_tcp_t *tcp, opj_pi_iterator_t *pi, opj_packet_info_t *pack_info, bool skip);
 
 /*@}*/
 
@@ -294,6 +303,16 @@ static int t2_encode_packet(opj_tcd_tile_t * tile, opj_tcp_t * tcp, opj_pi_itera
 	return (c - dest);
 }
 
+static bool t2_all_resolutions_skipped(opj_tcd_tile_t *tile, int resno) {
+	int compno;
+	for (compno = 0; compno < tile->numcomps; compno++) {
+		if (resno < tile->comps[compno].minimum_num_resolutions) {
+			return false;
+		}
+	}
+	return true;
+}
+
 static void t2_init_seg(opj_tcd_cblk_dec_t* cblk, int index, int cblksty, int first) {
 	opj_tcd_seg_t* seg;
 	cblk->segs = (opj_tcd_seg_t*) opj_realloc(cblk->segs, (index + 1) * sizeof(opj_tcd_seg_t));
@@ -301,6 +320,7 @@ static void t2_init_seg(opj_tcd_cblk_dec_t* cblk, int index, int cblksty, int fi
 	seg->data = NULL;
 	seg->dataindex = 0;
 	seg->numpasses = 0;
+	seg->real_num_passes = 0;
 	seg->len = 0;
 	if (cblksty & J2K_CCP_CBLKSTY_TERMALL) {
 		seg->maxpasses = 1;
@@ -317,7 +337,7 @@ static void t2_init_seg(opj_tcd_cblk_dec_t* cblk, int index, int cblksty, int fi
 }
 
 static int t2_decode_packet(opj_t2_t* t2, unsigned char *src, int len, opj_tcd_tile_t *tile, 
-														opj_tcp_t *tcp, opj_pi_iterator_t *pi, opj_packet_info_t *pack_info) {
+														opj_tcp_t *tcp, opj_pi_iterator_t *pi, opj_packet_info_t *pack_info, bool skip) {
 	int bandno, cblkno;
 	unsigned char *c = src;
 
@@ -347,6 +367,7 @@ static int t2_decode_packet(opj_t2_t* t2, unsigned char *src, int len, opj_tcd_t
 			for (cblkno = 0; cblkno < prc->cw * prc->ch; cblkno++) {
 				opj_tcd_cblk_dec_t* cblk = &prc->cblks.dec[cblkno];
 				cblk->numsegs = 0;
+				cblk->real_num_segs = 0;
 			}
 		}
 	}
@@ -545,6 +566,19 @@ static int t2_decode_packet(opj_t2_t* t2, unsigned char *src, int len, opj_tcd_t
 					return -999;
 				}
 
+				if (skip) {
+					/* keep the pass count used to split the next packets into segments,
+					but leave the data of the code-block as it was */
+					c += seg->newlen;
+					seg->numpasses += seg->numnewpasses;
+					cblk->numnewpasses -= seg->numnewpasses;
+					if (cblk->numnewpasses > 0) {
+						seg++;
+						cblk->numsegs++;
+					}
+					continue;
+				}
+
 #ifdef USE_JPWL
 			/* we need here a j2k handle to verify if making a check to
 			the validity of cblocks parameters is selected from user (-W) */
@@ -575,6 +609,8 @@ static int t2_decode_packet(opj_t2_t* t2, unsigned char *src, int len, opj_tcd_t
 				cblk->len += seg->newlen;
 				seg->len += seg->newlen;
 				seg->numpasses += seg->numnewpasses;
+				seg->real_num_passes = seg->numpasses;
+				cblk->real_num_segs = cblk->numsegs;
 				cblk->numnewpasses -= seg->numnewpasses;
 				if (cblk->numnewpasses > 0) {
 					seg++;
@@ -700,22 +736,27 @@ int t2_decode_packets(opj_t2_t *t2, unsigned char *src, int len, int tileno, opj
 	
 	for (pino = 0; pino <= cp->tcps[tileno].numpocs; pino++) {
 		while (pi_next(&pi[pino])) {
-			if ((cp->layer==0) || (cp->layer>=((pi[pino].layno)+1))) {
-				opj_packet_info_t *pack_info;
-				if (cstr_info)
-					pack_info = &cstr_info->tile[tileno].packet[cstr_info->packno];
-				else
-					pack_info = NULL;
-				e = t2_decode_packet(t2, c, src + len - c, tile, &cp->tcps[tileno], &pi[pino], pack_info);
-			} else {
-				e = 0;
+			opj_packet_info_t *pack_info;
+			/* packets of discarded layers and resolutions are stepped over */
+			bool skip = (cp->layer != 0 && pi[pino].layno >= cp->layer)
+				|| (pi[pino].resno >= tile->comps[pi[pino].compno].minimum_num_resolutions);
+
+			/* without progression order changes, once the layer (LRCP) or the resolution (RLCP, RPCL)
+			progresses past the limit every remaining packet of the tile is skipped as well */
+			if (skip && cp->tcps[tileno].numpocs == 0 && !cstr_info) {
+				if (pi[pino].poc.prg == LRCP && cp->layer != 0 && pi[pino].layno >= cp->layer) {
+					break;
+				}
+				if ((pi[pino].poc.prg == RLCP || pi[pino].poc.prg == RPCL) && t2_all_resolutions_skipped(tile, pi[pino].resno)) {
+					break;
+				}
 			}
-			
-			/* progression in resolution */
-			image->comps[pi[pino].compno].resno_decoded =	
-				(e > 0) ? 
-				int_max(pi[pino].resno, image->comps[pi[pino].compno].resno_decoded) 
-				: image->comps[pi[pino].compno].resno_decoded;
+
+			if (cstr_info)
+				pack_info = &cstr_info->tile[tileno].packet[cstr_info->packno];
+			else
+				pack_info = NULL;
+			e = t2_decode_packet(t2, c, src + len - c, tile, &cp->tcps[tileno], &pi[pino], pack_info, skip);
 			n++;
 
 			/* INDEX >> */
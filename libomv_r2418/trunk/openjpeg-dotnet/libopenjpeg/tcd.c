@@ -101,6 +101,11 @@ opj_tcd_t* tcd_create(opj_common_ptr cinfo) {
 	opj_tcd_t *tcd = (opj_tcd_t*)opj_malloc(sizeof(opj_tcd_t));
 	if(!tcd) return NULL;
 	tcd->cinfo = cinfo;
+	tcd->t1s = NULL;
+	tcd->dwtmems = NULL;
+	tcd->numslots = 0;
+	tcd->compbufs = NULL;
+	tcd->numcompbufs = 0;
 	tcd->tcd_image = (opj_tcd_image_t*)opj_malloc(sizeof(opj_tcd_image_t));
 	if(!tcd->tcd_image) {
 		opj_free(tcd);
@@ -115,6 +120,17 @@ Destroy a previously created TCD handle
 */
 void tcd_destroy(opj_tcd_t *tcd) {
 	if(tcd) {
+		int i;
+		for (i = 0; i < tcd->numslots; i++) {
+			t1_destroy(tcd->t1s[i]);
+			dwt_mem_free(&tcd->dwtmems[i]);
+		}
+		opj_free(tcd->t1s);
+		opj_free(tcd->dwtmems);
+		for (i = 0; i < tcd->numcompbufs; i++) {
+			dwt_mem_free(&tcd->compbufs[i]);
+		}
+		opj_free(tcd->compbufs);
 		opj_free(tcd->tcd_image);
 		opj_free(tcd);
 	}
@@ -694,6 +710,7 @@ void tcd_malloc_decode_tile(opj_tcd_t *tcd, opj_image_t * image, opj_cp_t * cp,
 		tilec->y1 = int_ceildiv(tile->y1, image->comps[compno].dy);
 
 		tilec->numresolutions = tccp->numresolutions;
+		tilec->minimum_num_resolutions = tccp->numresolutions;
 		tilec->resolutions = (opj_tcd_resolution_t *) opj_malloc(tilec->numresolutions * sizeof(opj_tcd_resolution_t));
 		
 		for (resno = 0; resno < tilec->numresolutions; resno++) {
@@ -823,6 +840,7 @@ void tcd_malloc_decode_tile(opj_tcd_t *tcd, opj_image_t * image, opj_cp_t * cp,
 						cblk->x1 = int_min(cblkxend, prc->x1);
 						cblk->y1 = int_min(cblkyend, prc->y1);
 						cblk->numsegs = 0;
+						cblk->real_num_segs = 0;
 					}
 				} /* precno */
 			} /* bandno */
@@ -1313,15 +1331,211 @@ int tcd_encode_tile(opj_tcd_t *tcd, int tileno, unsigned char *dest, int len, op
 	return l;
 }
 
+/**
+Inverse DWT of one tile-component, run on the decoder thread pool
+*/
+typedef struct opj_tcd_dwt_job {
+	opj_tcd_tilecomp_t *tilec;
+	int numres;
+	int qmfbid;
+	/** DWT work memory of each thread */
+	opj_dwt_mem_t *mems;
+} opj_tcd_dwt_job_t;
+
+static void tcd_dwt_decode_job(void *user_data, int jobno, int slot) {
+	opj_tcd_dwt_job_t *job = &((opj_tcd_dwt_job_t*) user_data)[jobno];
+
+	if (job->numres > 0) {
+		if (job->qmfbid == 1) {
+			dwt_decode(job->tilec, job->numres, &job->mems[slot]);
+		} else {
+			dwt_decode_real(job->tilec, job->numres, &job->mems[slot]);
+		}
+	}
+}
+
+/**
+Count the code-blocks and coding passes tier-1 will decode and the samples the DWT will produce
+*/
+static void tcd_count_decode_work(opj_tcd_tile_t *tile, opj_decode_stats_t *stats) {
+	int compno, resno, bandno, precno, cblkno, segno;
+
+	for (compno = 0; compno < tile->numcomps; compno++) {
+		opj_tcd_tilecomp_t *tilec = &tile->comps[compno];
+		opj_tcd_resolution_t *res = &tilec->resolutions[tilec->minimum_num_resolutions - 1];
+		stats->samples += (double)(res->x1 - res->x0) * (res->y1 - res->y0);
+		for (resno = 0; resno < tilec->minimum_num_resolutions; resno++) {
+			res = &tilec->resolutions[resno];
+			for (bandno = 0; bandno < res->numbands; bandno++) {
+				opj_tcd_band_t *band = &res->bands[bandno];
+				for (precno = 0; precno < res->pw * res->ph; precno++) {
+					opj_tcd_precinct_t *prc = &band->precincts[precno];
+					for (cblkno = 0; cblkno < prc->cw * prc->ch; cblkno++) {
+						opj_tcd_cblk_dec_t *cblk = &prc->cblks.dec[cblkno];
+						if (cblk->real_num_segs > 0) {
+							stats->t1_cblks++;
+						}
+						for (segno = 0; segno < cblk->real_num_segs; segno++) {
+							stats->t1_passes += cblk->segs[segno].real_num_passes;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+Get the work memory needed to decode the current tile with numslots threads: a T1 handle and
+DWT memory per thread, and the sample buffers of the tile-components (tilec->data).
+All of it stays with the tcd and is reused by the next tiles and images.
+*/
+static bool tcd_reserve_decode_memory(opj_tcd_t *tcd, int numslots) {
+	opj_tcd_tile_t *tile = tcd->tcd_tile;
+	int compno;
+
+	if (tcd->numslots < numslots) {
+		opj_t1_t **t1s = (opj_t1_t**) opj_realloc(tcd->t1s, numslots * sizeof(opj_t1_t*));
+		opj_dwt_mem_t *dwtmems;
+		if (!t1s) {
+			return false;
+		}
+		tcd->t1s = t1s;
+		dwtmems = (opj_dwt_mem_t*) opj_realloc(tcd->dwtmems, numslots * sizeof(opj_dwt_mem_t));
+		if (!dwtmems) {
+			return false;
+		}
+		tcd->dwtmems = dwtmems;
+		for (; tcd->numslots < numslots; tcd->numslots++) {
+			tcd->t1s[tcd->numslots] = t1_create(tcd->cinfo);
+			if (!tcd->t1s[tcd->numslots]) {
+				return false;
+			}
+			tcd->dwtmems[tcd->numslots].data = NULL;
+			tcd->dwtmems[tcd->numslots].size = 0;
+		}
+	}
+
+	if (tcd->numcompbufs < tile->numcomps) {
+		opj_dwt_mem_t *compbufs = (opj_dwt_mem_t*) opj_realloc(tcd->compbufs, tile->numcomps * sizeof(opj_dwt_mem_t));
+		if (!compbufs) {
+			return false;
+		}
+		tcd->compbufs = compbufs;
+		for (; tcd->numcompbufs < tile->numcomps; tcd->numcompbufs++) {
+			tcd->compbufs[tcd->numcompbufs].data = NULL;
+			tcd->compbufs[tcd->numcompbufs].size = 0;
+		}
+	}
+	for (compno = 0; compno < tile->numcomps; ++compno) {
+		opj_tcd_tilecomp_t* tilec = &tile->comps[compno];
+		/* The +3 is headroom required by the vectorized DWT */
+		tilec->data = (int*) dwt_mem_reserve(&tcd->compbufs[compno], (((tilec->x1 - tilec->x0) * (tilec->y1 - tilec->y0))+3) * sizeof(int));
+		if (!tilec->data) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+Check whether the decoded pixels can go straight to cp->out_buffer
+*/
+static bool tcd_can_write_out_buffer(opj_tcd_t *tcd) {
+	opj_image_t *image = tcd->image;
+	opj_cp_t *cp = tcd->cp;
+	int compno;
+
+	if (!cp->out_buffer || image->numcomps < 1 || image->numcomps > 4) {
+		return false;
+	}
+	for (compno = 0; compno < image->numcomps; compno++) {
+		opj_image_comp_t *imagec = &image->comps[compno];
+		if (imagec->prec != 8 || imagec->sgnd || imagec->dx != 1 || imagec->dy != 1
+			|| imagec->w != image->comps[0].w || imagec->h != image->comps[0].h) {
+			return false;
+		}
+	}
+	return image->comps[0].w * 4 <= cp->out_stride
+		&& (image->comps[0].h - 1) * cp->out_stride + image->comps[0].w * 4 <= cp->out_size;
+}
+
+/**
+Inverse MCT, DC level shift, clamp and interleave of a tile into cp->out_buffer
+*/
+static void tcd_write_out_buffer(opj_tcd_t *tcd, opj_tcd_tile_t *tile) {
+	/* components feeding red, green, blue and alpha, -1 for opaque */
+	static const int planes[4][4] = { {0, 0, 0, -1}, {0, 0, 0, 1}, {0, 1, 2, -1}, {0, 1, 2, 3} };
+	const int *p = planes[tile->numcomps - 1];
+
+	opj_cp_t *cp = tcd->cp;
+	opj_tcp_t *tcp = tcd->tcp;
+	opj_image_comp_t *imagec = &tcd->image->comps[0];
+	opj_tcd_tilecomp_t *tilec = &tile->comps[0];
+	opj_tcd_resolution_t *res = &tilec->resolutions[imagec->resno_decoded];
+	int tw = tilec->x1 - tilec->x0;
+	int w = res->x1 - res->x0;
+	int offset_x = int_ceildivpow2(imagec->x0, imagec->factor);
+	int offset_y = int_ceildivpow2(imagec->y0, imagec->factor);
+	int mct = tcp->mct && tile->numcomps >= 3;
+	int bgra = cp->out_format == PIXFMT_BGRA;
+	int qmfbid = tcp->tccps[0].qmfbid;
+	int compno, i, j;
+
+	for (compno = 1; compno < tile->numcomps; compno++) {
+		if (tcp->tccps[compno].qmfbid != qmfbid) {
+			qmfbid = -1;
+		}
+	}
+
+	for (j = res->y0; j < res->y1; ++j) {
+		int row = (j - res->y0) * tw;
+		unsigned char *dst = cp->out_buffer + (j - offset_y) * cp->out_stride + (res->x0 - offset_x) * 4;
+
+		if (qmfbid == 1) {
+			mct_decode_rgba(
+					&tile->comps[p[0]].data[row],
+					&tile->comps[p[1]].data[row],
+					&tile->comps[p[2]].data[row],
+					p[3] < 0 ? NULL : &tile->comps[p[3]].data[row],
+					w, mct, bgra, dst);
+		} else if (qmfbid == 0) {
+			mct_decode_real_rgba(
+					&((float*)tile->comps[p[0]].data)[row],
+					&((float*)tile->comps[p[1]].data)[row],
+					&((float*)tile->comps[p[2]].data)[row],
+					p[3] < 0 ? NULL : &((float*)tile->comps[p[3]].data)[row],
+					w, mct, bgra, dst);
+		} else {
+			/* reversible and irreversible components mixed: no transform is possible, convert each sample */
+			for (i = 0; i < w; ++i) {
+				int ch;
+				for (ch = 0; ch < 4; ++ch) {
+					int v = 255;
+					if (p[ch] >= 0) {
+						opj_tcd_tilecomp_t *c = &tile->comps[p[ch]];
+						v = tcp->tccps[p[ch]].qmfbid == 1 ? c->data[row + i] : lrintf(((float*)c->data)[row + i]);
+						v = int_clamp(v + 128, 0, 255);
+					}
+					dst[i * 4 + (ch == 3 || ch == 1 || !bgra ? ch : 2 - ch)] = (unsigned char) v;
+				}
+			}
+		}
+	}
+}
+
 bool tcd_decode_tile(opj_tcd_t *tcd, unsigned char *src, int len, int tileno, opj_codestream_info_t *cstr_info) {
 	int l;
 	int compno;
 	int eof = 0;
-	double tile_time, t1_time, dwt_time;
+	double tile_time, t2_time, t1_time, dwt_time, mct_time;
+	opj_decode_stats_t *stats = tcd->cp->stats;
 	opj_tcd_tile_t *tile = NULL;
+	opj_tcd_dwt_job_t *dwt_jobs = NULL;
 
-	opj_t1_t *t1 = NULL;		/* T1 component */
 	opj_t2_t *t2 = NULL;		/* T2 component */
+	opj_thread_pool_t *pool = NULL;	/* worker threads, NULL when decoding on this thread only */
 	
 	tcd->tcd_tileno = tileno;
 	tcd->tcd_tile = &(tcd->tcd_image->tiles[tileno]);
@@ -1357,60 +1571,98 @@ bool tcd_decode_tile(opj_tcd_t *tcd, unsigned char *src, int len, int tileno, op
 		cstr_info->packno = 0;
 	}
 	/* << INDEX */
+
+	/* resolutions removed by cp_reduce are skipped by every stage of the decoder */
+	for (compno = 0; compno < tile->numcomps; compno++) {
+		opj_tcd_tilecomp_t *tilec = &tile->comps[compno];
+		tilec->minimum_num_resolutions = tilec->numresolutions - tcd->cp->reduce;
+		if (tilec->minimum_num_resolutions < 1) {
+			opj_event_msg(tcd->cinfo, EVT_ERROR, "Error decoding tile. The number of resolutions to remove [%d+1] is higher than the number "
+				" of resolutions in the original codestream [%d]\nModify the cp_reduce parameter.\n", tcd->cp->reduce, tilec->numresolutions);
+			return false;
+		}
+		if (tilec->minimum_num_resolutions > tilec->numresolutions) {
+			opj_event_msg(tcd->cinfo, EVT_ERROR, "Error decoding tile. The number of resolutions to remove [%d] is negative\nModify the cp_reduce parameter.\n", tcd->cp->reduce);
+			return false;
+		}
+		tcd->image->comps[compno].resno_decoded = tilec->minimum_num_resolutions - 1;
+	}
 	
 	/*--------------TIER2------------------*/
 	
+	t2_time = opj_clock();	/* time needed to decode a tile */
 	t2 = t2_create(tcd->cinfo, tcd->image, tcd->cp);
 	l = t2_decode_packets(t2, src, len, tileno, tile, cstr_info);
 	t2_destroy(t2);
+	t2_time = opj_clock() - t2_time;
 
 	if (l == -999) {
 		eof = 1;
 		opj_event_msg(tcd->cinfo, EVT_ERROR, "tcd_decode: incomplete bistream\n");
 	}
+
+	if (stats) {
+		stats->tiles++;
+		stats->t2_bytes += eof ? len : l;
+		stats->t2_time += t2_time;
+		tcd_count_decode_work(tile, stats);
+	}
 	
 	/*------------------TIER1-----------------*/
 	
 	t1_time = opj_clock();	/* time needed to decode a tile */
-	t1 = t1_create(tcd->cinfo);
-	for (compno = 0; compno < tile->numcomps; ++compno) {
-		opj_tcd_tilecomp_t* tilec = &tile->comps[compno];
-		/* The +3 is headroom required by the vectorized DWT */
-		tilec->data = (int*) opj_aligned_malloc((((tilec->x1 - tilec->x0) * (tilec->y1 - tilec->y0))+3) * sizeof(int));
-		t1_decode_cblks(t1, tilec, &tcd->tcp->tccps[compno]);
+	pool = opj_thread_pool_acquire();
+	if (!tcd_reserve_decode_memory(tcd, opj_thread_pool_size(pool))) {
+		opj_event_msg(tcd->cinfo, EVT_ERROR, "tcd_decode: not enough memory to decode the tile\n");
+		opj_thread_pool_release(pool);
+		return false;
+	}
+	if (opj_thread_pool_size(pool) < 2 || !t1_decode_cblks_mt(pool, tcd->t1s, tile, tcd->tcp)) {
+		for (compno = 0; compno < tile->numcomps; ++compno) {
+			t1_decode_cblks(tcd->t1s[0], &tile->comps[compno], &tcd->tcp->tccps[compno]);
+		}
 	}
-	t1_destroy(t1);
 	t1_time = opj_clock() - t1_time;
 	opj_event_msg(tcd->cinfo, EVT_INFO, "- tiers-1 took %f s\n", t1_time);
+	if (stats) {
+		stats->t1_time += t1_time;
+	}
 	
 	/*----------------DWT---------------------*/
 
 	dwt_time = opj_clock();	/* time needed to decode a tile */
+	dwt_jobs = (opj_tcd_dwt_job_t*) opj_malloc(tile->numcomps * sizeof(opj_tcd_dwt_job_t));
 	for (compno = 0; compno < tile->numcomps; compno++) {
 		opj_tcd_tilecomp_t *tilec = &tile->comps[compno];
-		int numres2decode;
-
-		if (tcd->cp->reduce != 0) {
-			tcd->image->comps[compno].resno_decoded =
-				tile->comps[compno].numresolutions - tcd->cp->reduce - 1;
-			if (tcd->image->comps[compno].resno_decoded < 0) {				
-				opj_event_msg(tcd->cinfo, EVT_ERROR, "Error decoding tile. The number of resolutions to remove [%d+1] is higher than the number "
-					" of resolutions in the original codestream [%d]\nModify the cp_reduce parameter.\n", tcd->cp->reduce, tile->comps[compno].numresolutions);
-				return false;
-			}
-		}
-
-		numres2decode = tcd->image->comps[compno].resno_decoded + 1;
-		if(numres2decode > 0){
-			if (tcd->tcp->tccps[compno].qmfbid == 1) {
-				dwt_decode(tilec, numres2decode);
-			} else {
-				dwt_decode_real(tilec, numres2decode);
-			}
-		}
+		dwt_jobs[compno].tilec = tilec;
+		dwt_jobs[compno].numres = tcd->image->comps[compno].resno_decoded + 1;
+		dwt_jobs[compno].qmfbid = tcd->tcp->tccps[compno].qmfbid;
+		dwt_jobs[compno].mems = tcd->dwtmems;
 	}
+	/* tile-components are transformed independently of each other */
+	opj_thread_pool_run(pool, tcd_dwt_decode_job, dwt_jobs, tile->numcomps);
+	opj_free(dwt_jobs);
+	opj_thread_pool_release(pool);
 	dwt_time = opj_clock() - dwt_time;
 	opj_event_msg(tcd->cinfo, EVT_INFO, "- dwt took %f s\n", dwt_time);
+	if (stats) {
+		stats->dwt_time += dwt_time;
+	}
+
+	mct_time = opj_clock();	/* time needed to output the tile */
+
+	/*----------OUTPUT BUFFER---------------*/
+
+	if (tcd_can_write_out_buffer(tcd)) {
+		/* MCT, DC level shift and interleave in a single pass, the image components get no data */
+		tcd_write_out_buffer(tcd, tile);
+		if (stats) {
+			stats->mct_time += opj_clock() - mct_time;
+		}
+		tile_time = opj_clock() - tile_time;	/* time needed to decode a tile */
+		opj_event_msg(tcd->cinfo, EVT_INFO, "- tile decoded in %f s\n", tile_time);
+		return eof ? false : true;
+	}
 
 	/*----------------MCT-------------------*/
 
@@ -1449,7 +1701,8 @@ bool tcd_decode_tile(opj_tcd_t *tcd, unsigned char *src, int len, int tileno, op
 
 		int i, j;
 		if(!imagec->data){
-			imagec->data = (int*) opj_malloc(imagec->w * imagec->h * sizeof(int));
+			/* zeroed, so that tiles missing from a truncated codestream do not leave garbage */
+			imagec->data = (int*) opj_calloc(imagec->w * imagec->h, sizeof(int));
 		}
 		if(tcd->tcp->tccps[compno].qmfbid == 1) {
 			for(j = res->y0; j < res->y1; ++j) {
@@ -1469,7 +1722,11 @@ bool tcd_decode_tile(opj_tcd_t *tcd, unsigned char *src, int len, int tileno, op
 				}
 			}
 		}
-		opj_aligned_free(tilec->data);
+		/* the sample buffer belongs to tcd->compbufs */
+		tilec->data = NULL;
+	}
+	if (stats) {
+		stats->mct_time += opj_clock() - mct_time;
 	}
 
 	tile_time = opj_clock() - tile_time;	/* time needed to decode a tile */
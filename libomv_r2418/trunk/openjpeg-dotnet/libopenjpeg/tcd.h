@@ -52,6 +52,7 @@ typedef struct opj_tcd_seg {
   int maxpasses;
   int numnewpasses;
   int newlen;
+  int real_num_passes;	/* number of passes whose data was kept (passes of skipped packets are not) */
 } opj_tcd_seg_t;
 
 /**
@@ -97,6 +98,7 @@ typedef struct opj_tcd_cblk_dec {
   int len;			/* length */
   int numnewpasses;		/* number of pass added to the code-blocks */
   int numsegs;			/* number of segments */
+  int real_num_segs;		/* number of segments with data to decode (segments of skipped packets are not) */
 } opj_tcd_cblk_dec_t;
 
 /**
@@ -140,6 +142,7 @@ FIXME: documentation
 typedef struct opj_tcd_tilecomp {
   int x0, y0, x1, y1;		/* dimension of component : left upper corner (x0, y0) right low corner (x1,y1) */
   int numresolutions;		/* number of resolutions level */
+  int minimum_num_resolutions;	/* number of resolutions level to decode, the others are skipped (cp_reduce) */
   opj_tcd_resolution_t *resolutions;	/* resolutions information */
   int *data;			/* data of the component */
   int numpix;			/* add fixed_quality */
@@ -198,6 +201,16 @@ typedef struct opj_tcd {
 	int tcd_tileno;
 	/** Time taken to encode a tile*/
 	double encoding_time;
+	/** decoding: T1 handle of each thread, kept between tiles and images */
+	struct opj_t1 **t1s;
+	/** decoding: DWT work memory of each thread, kept between tiles and images */
+	struct opj_dwt_mem *dwtmems;
+	/** decoding: number of threads t1s and dwtmems are allocated for */
+	int numslots;
+	/** decoding: sample buffers of the tile-components, kept between tiles and images */
+	struct opj_dwt_mem *compbufs;
+	/** decoding: number of entries in compbufs */
+	int numcompbufs;
 } opj_tcd_t;
 
 /** @name Exported functions */
@@ -0,0 +1,365 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS `AS IS'
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif /* WIN32 */
+#include "opj_includes.h"
+
+/** @defgroup THREAD THREAD - Implementation of a worker thread pool */
+/*@{*/
+
+/** @name Local data structures */
+/*@{*/
+
+#ifdef WIN32
+typedef HANDLE opj_thread_t;
+typedef CRITICAL_SECTION opj_mutex_t;
+typedef CONDITION_VARIABLE opj_cond_t;
+#define opj_mutex_init(m) InitializeCriticalSection(m)
+#define opj_mutex_destroy(m) DeleteCriticalSection(m)
+#define opj_mutex_lock(m) EnterCriticalSection(m)
+#define opj_mutex_unlock(m) LeaveCriticalSection(m)
+#define opj_cond_init(c) InitializeConditionVariable(c)
+#define opj_cond_destroy(c)
+#define opj_cond_wait(c, m) SleepConditionVariableCS(c, m, INFINITE)
+#define opj_cond_broadcast(c) WakeAllConditionVariable(c)
+/* a critical section can not be statically initialized */
+static SRWLOCK opj_global_lock = SRWLOCK_INIT;
+#define opj_global_lock_acquire() AcquireSRWLockExclusive(&opj_global_lock)
+#define opj_global_lock_release() ReleaseSRWLockExclusive(&opj_global_lock)
+#else
+typedef pthread_t opj_thread_t;
+typedef pthread_mutex_t opj_mutex_t;
+typedef pthread_cond_t opj_cond_t;
+#define opj_mutex_init(m) pthread_mutex_init(m, NULL)
+#define opj_mutex_destroy(m) pthread_mutex_destroy(m)
+#define opj_mutex_lock(m) pthread_mutex_lock(m)
+#define opj_mutex_unlock(m) pthread_mutex_unlock(m)
+#define opj_cond_init(c) pthread_cond_init(c, NULL)
+#define opj_cond_destroy(c) pthread_cond_destroy(c)
+#define opj_cond_wait(c, m) pthread_cond_wait(c, m)
+#define opj_cond_broadcast(c) pthread_cond_broadcast(c)
+static pthread_mutex_t opj_global_lock = PTHREAD_MUTEX_INITIALIZER;
+#define opj_global_lock_acquire() pthread_mutex_lock(&opj_global_lock)
+#define opj_global_lock_release() pthread_mutex_unlock(&opj_global_lock)
+#endif /* WIN32 */
+
+/**
+A batch of jobs submitted by opj_thread_pool_run. Lives on the stack of the submitter.
+*/
+typedef struct opj_batch {
+	/** job callback */
+	opj_job_fn fn;
+	/** user data given to each job */
+	void *user_data;
+	/** number of jobs of the batch */
+	int numjobs;
+	/** next job to hand out */
+	int nextjob;
+	/** number of jobs completed */
+	int numdone;
+	/** number of threads that joined the batch */
+	int numslots;
+	/** signaled when numdone reaches numjobs */
+	opj_cond_t done;
+	/** true while the batch is in the pool queue */
+	bool queued;
+	/** next batch in the pool queue */
+	struct opj_batch *next;
+} opj_batch_t;
+
+struct opj_thread_pool {
+	/** number of threads running jobs, including the submitting thread */
+	int num_threads;
+	/** worker threads (num_threads - 1) */
+	opj_thread_t *threads;
+	/** protects everything below and all queued batches */
+	opj_mutex_t lock;
+	/** signaled when a batch is queued or the pool shuts down */
+	opj_cond_t work;
+	/** queue of batches with jobs left to hand out */
+	opj_batch_t *head;
+	opj_batch_t *tail;
+	/** set by opj_thread_pool_destroy */
+	bool quit;
+	/** references held through opj_thread_pool_acquire, protected by opj_global_lock */
+	int refcount;
+};
+
+/*@}*/
+
+/** @name Local static functions */
+/*@{*/
+
+/**
+Remove a batch from the queue of a pool, if it is still there.
+The pool lock must be held.
+*/
+static void opj_thread_pool_unlink(opj_thread_pool_t *pool, opj_batch_t *batch);
+/**
+Run jobs of a batch until none are left to hand out.
+The pool lock must be held; it is released while a job runs.
+*/
+static void opj_thread_pool_work(opj_thread_pool_t *pool, opj_batch_t *batch);
+/**
+Entry point of the worker threads
+*/
+#ifdef WIN32
+static DWORD WINAPI opj_thread_pool_worker(LPVOID arg);
+#else
+static void* opj_thread_pool_worker(void *arg);
+#endif
+
+/*@}*/
+
+/*@}*/
+
+/** decoder pool set with opj_set_num_threads */
+static opj_thread_pool_t *opj_global_pool = NULL;
+
+/* ----------------------------------------------------------------------- */
+
+static void opj_thread_pool_unlink(opj_thread_pool_t *pool, opj_batch_t *batch) {
+	opj_batch_t *prev = NULL;
+	opj_batch_t *cur = pool->head;
+
+	if (!batch->queued)
+		return;
+
+	while (cur != batch) {
+		prev = cur;
+		cur = cur->next;
+	}
+	if (prev)
+		prev->next = batch->next;
+	else
+		pool->head = batch->next;
+	if (pool->tail == batch)
+		pool->tail = prev;
+	batch->queued = false;
+}
+
+static void opj_thread_pool_work(opj_thread_pool_t *pool, opj_batch_t *batch) {
+	int slot = batch->numslots++;
+
+	while (batch->nextjob < batch->numjobs) {
+		int jobno = batch->nextjob++;
+		if (batch->nextjob == batch->numjobs) {
+			/* nothing left to hand out, let the workers look at the next batch */
+			opj_thread_pool_unlink(pool, batch);
+		}
+		opj_mutex_unlock(&pool->lock);
+		batch->fn(batch->user_data, jobno, slot);
+		opj_mutex_lock(&pool->lock);
+		/* the submitter may release the batch as soon as the last job is counted */
+		if (++batch->numdone == batch->numjobs) {
+			opj_cond_broadcast(&batch->done);
+		}
+	}
+}
+
+#ifdef WIN32
+static DWORD WINAPI opj_thread_pool_worker(LPVOID arg) {
+#else
+static void* opj_thread_pool_worker(void *arg) {
+#endif
+	opj_thread_pool_t *pool = (opj_thread_pool_t*) arg;
+
+	opj_mutex_lock(&pool->lock);
+	for (;;) {
+		while (!pool->quit && pool->head == NULL) {
+			opj_cond_wait(&pool->work, &pool->lock);
+		}
+		if (pool->quit)
+			break;
+		opj_thread_pool_work(pool, pool->head);
+	}
+	opj_mutex_unlock(&pool->lock);
+
+	return 0;
+}
+
+/* ----------------------------------------------------------------------- */
+
+opj_thread_pool_t* opj_thread_pool_create(int num_threads) {
+	int i;
+	opj_thread_pool_t *pool = NULL;
+
+	if (num_threads < 1)
+		return NULL;
+
+	pool = (opj_thread_pool_t*) opj_calloc(1, sizeof(opj_thread_pool_t));
+	if (!pool)
+		return NULL;
+	pool->threads = (opj_thread_t*) opj_calloc(num_threads, sizeof(opj_thread_t));
+	if (!pool->threads) {
+		opj_free(pool);
+		return NULL;
+	}
+	opj_mutex_init(&pool->lock);
+	opj_cond_init(&pool->work);
+	pool->refcount = 1;
+
+	/* the thread calling opj_thread_pool_run is the first worker */
+	pool->num_threads = 1;
+	for (i = 1; i < num_threads; i++) {
+#ifdef WIN32
+		pool->threads[i - 1] = CreateThread(NULL, 0, opj_thread_pool_worker, pool, 0, NULL);
+		if (pool->threads[i - 1] == NULL)
+			break;
+#else
+		if (pthread_create(&pool->threads[i - 1], NULL, opj_thread_pool_worker, pool) != 0)
+			break;
+#endif
+		pool->num_threads++;
+	}
+
+	return pool;
+}
+
+void opj_thread_pool_destroy(opj_thread_pool_t *pool) {
+	int i;
+
+	if (!pool)
+		return;
+
+	opj_mutex_lock(&pool->lock);
+	pool->quit = true;
+	opj_cond_broadcast(&pool->work);
+	opj_mutex_unlock(&pool->lock);
+
+	for (i = 0; i < pool->num_threads - 1; i++) {
+#ifdef WIN32
+		WaitForSingleObject(pool->threads[i], INFINITE);
+		CloseHandle(pool->threads[i]);
+#else
+		pthread_join(pool->threads[i], NULL);
+#endif
+	}
+
+	opj_cond_destroy(&pool->work);
+	opj_mutex_destroy(&pool->lock);
+	opj_free(pool->threads);
+	opj_free(pool);
+}
+
+int opj_thread_pool_size(opj_thread_pool_t *pool) {
+	return pool ? pool->num_threads : 1;
+}
+
+void opj_thread_pool_run(opj_thread_pool_t *pool, opj_job_fn fn, void *user_data, int numjobs) {
+	opj_batch_t batch;
+
+	if (numjobs <= 0)
+		return;
+
+	if (!pool || pool->num_threads < 2 || numjobs == 1) {
+		int jobno;
+		for (jobno = 0; jobno < numjobs; jobno++) {
+			fn(user_data, jobno, 0);
+		}
+		return;
+	}
+
+	batch.fn = fn;
+	batch.user_data = user_data;
+	batch.numjobs = numjobs;
+	batch.nextjob = 0;
+	batch.numdone = 0;
+	batch.numslots = 0;
+	batch.queued = true;
+	batch.next = NULL;
+	opj_cond_init(&batch.done);
+
+	opj_mutex_lock(&pool->lock);
+	if (pool->tail)
+		pool->tail->next = &batch;
+	else
+		pool->head = &batch;
+	pool->tail = &batch;
+	opj_cond_broadcast(&pool->work);
+
+	opj_thread_pool_work(pool, &batch);
+	while (batch.numdone < batch.numjobs) {
+		opj_cond_wait(&batch.done, &pool->lock);
+	}
+	opj_thread_pool_unlink(pool, &batch);
+	opj_mutex_unlock(&pool->lock);
+
+	opj_cond_destroy(&batch.done);
+}
+
+opj_thread_pool_t* opj_thread_pool_acquire(void) {
+	opj_thread_pool_t *pool;
+
+	opj_global_lock_acquire();
+	pool = opj_global_pool;
+	if (pool)
+		pool->refcount++;
+	opj_global_lock_release();
+
+	return pool;
+}
+
+void opj_thread_pool_release(opj_thread_pool_t *pool) {
+	bool last;
+
+	if (!pool)
+		return;
+
+	opj_global_lock_acquire();
+	last = (--pool->refcount == 0);
+	opj_global_lock_release();
+
+	if (last)
+		opj_thread_pool_destroy(pool);
+}
+
+void OPJ_CALLCONV opj_set_num_threads(int num_threads) {
+	opj_thread_pool_t *pool = NULL;
+	opj_thread_pool_t *previous;
+
+	if (num_threads > 1)
+		pool = opj_thread_pool_create(num_threads);
+
+	opj_global_lock_acquire();
+	previous = opj_global_pool;
+	opj_global_pool = pool;
+	opj_global_lock_release();
+
+	/* decoders still running on the previous pool keep it alive until they release it */
+	opj_thread_pool_release(previous);
+}
+
+int OPJ_CALLCONV opj_get_num_threads(void) {
+	int num_threads;
+
+	opj_global_lock_acquire();
+	num_threads = opj_thread_pool_size(opj_global_pool);
+	opj_global_lock_release();
+
+	return num_threads;
+}
@@ -0,0 +1,95 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS `AS IS'
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __THREAD_H
+#define __THREAD_H
+/**
+@file thread.h
+@brief Implementation of a worker thread pool (THREAD)
+
+The functions in THREAD.C spread independent jobs (code-blocks, tile-components) over
+a fixed set of worker threads. The calling thread always takes part in the work, so a
+pool of N threads runs N jobs at a time and a pool of 1 thread is equivalent to the
+serial code path.
+*/
+
+/** @defgroup THREAD THREAD - Implementation of a worker thread pool */
+/*@{*/
+
+/**
+Job callback
+@param user_data Pointer given to opj_thread_pool_run
+@param jobno Index of the job to run, in [0, numjobs)
+@param slot Index of the thread running the job, in [0, opj_thread_pool_size()).
+Two jobs of the same batch never run at the same time with the same slot, so
+the slot can be used to pick per-thread scratch memory.
+*/
+typedef void (*opj_job_fn)(void *user_data, int jobno, int slot);
+
+typedef struct opj_thread_pool opj_thread_pool_t;
+
+/** @name Exported functions */
+/*@{*/
+/* ----------------------------------------------------------------------- */
+/**
+Create a new thread pool
+@param num_threads Total number of threads running jobs, including the calling thread
+@return Returns a new thread pool if successful, returns NULL otherwise
+*/
+opj_thread_pool_t* opj_thread_pool_create(int num_threads);
+/**
+Destroy a thread pool. No batch may be running on the pool.
+@param pool Thread pool to destroy
+*/
+void opj_thread_pool_destroy(opj_thread_pool_t *pool);
+/**
+Get the number of threads of a pool
+@param pool Thread pool
+@return Returns the number of threads, including the calling thread; 1 if pool is NULL
+*/
+int opj_thread_pool_size(opj_thread_pool_t *pool);
+/**
+Run a batch of jobs and wait for all of them to complete.
+Several threads may run batches on the same pool at the same time.
+@param pool Thread pool, or NULL to run every job on the calling thread
+@param fn Job callback
+@param user_data Pointer passed to each job
+@param numjobs Number of jobs in the batch
+*/
+void opj_thread_pool_run(opj_thread_pool_t *pool, opj_job_fn fn, void *user_data, int numjobs);
+/**
+Get a reference on the pool used by the decoder (see opj_set_num_threads)
+@return Returns the decoder pool, or NULL if decoding is single threaded
+*/
+opj_thread_pool_t* opj_thread_pool_acquire(void);
+/**
+Release a reference obtained with opj_thread_pool_acquire
+@param pool Thread pool, may be NULL
+*/
+void opj_thread_pool_release(opj_thread_pool_t *pool);
+/* ----------------------------------------------------------------------- */
+/*@}*/
+
+/*@}*/
+
+#endif /* __THREAD_H */